@@ -30,9 +30,9 @@
 #endif
 #include "../xxhash.h"
 
-#include <stdlib.h>  /* exit */
+#include <stdlib.h>  /* exit, malloc, free */
 #include <assert.h>
-#include <string.h>  /* memcmp */
+#include <string.h>  /* memcmp, memcpy, memset */
 
 /* use #define to make them constant, required for initialization */
 #define PRIME32 2654435761U
@@ -402,6 +402,12 @@ static void XSUM_testXXH3(const void* data, const XSUM_testdata64_t* testData)
         }
     }
 
+    /* check that a seed context results in the same hash as XXH3_64bits_withSeed() */
+    {   XXH3_seedContext_t context;
+        (void)XXH3_initSeedContext(&context, seed);
+        XSUM_checkResult64(XXH3_64bits_withSeedContext(data, len, &context), Nresult);
+    }
+
     /* streaming API test */
     {   XXH3_state_t* const state = XXH3_createState();
         assert(state != NULL);
@@ -446,6 +452,14 @@ static void XSUM_testXXH3(const void* data, const XSUM_testdata64_t* testData)
             }
         }
 
+        /* seed context, after a reset with an external secret */
+        {   XXH3_seedContext_t context;
+            (void)XXH3_initSeedContext(&context, seed);
+            (void)XXH3_64bits_reset_withSeedContext(state, &context);
+            XSUM_XXH3_randomUpdate(state, data, len, &XXH3_64bits_update);
+            XSUM_checkResult64(XXH3_64bits_digest(state), Nresult);
+        }
+
         XXH3_freeState(state);
     }
 
@@ -474,6 +488,15 @@ static void XSUM_testXXH3_withSecret(const void* data, const void* secret,
         XSUM_checkResult64(Dresult, Nresult);
     }
 
+    /* check that a prepared secret results in the same hash as XXH3_64bits_withSecret() */
+    {   unsigned char workspace[XXH3_PREPARED_SECRET_SIZE(XXH3_SECRET_DEFAULT_SIZE)];
+        const XXH3_preparedSecret_t* prepared;
+        assert(secretSize <= XXH3_SECRET_DEFAULT_SIZE);
+        prepared = XXH3_initPreparedSecret(workspace, sizeof(workspace), secret, secretSize);
+        assert(prepared != NULL);
+        XSUM_checkResult64(XXH3_64bits_withPreparedSecret(data, len, prepared), Nresult);
+    }
+
     /* streaming API test */
     {   XXH3_state_t *state = XXH3_createState();
         assert(state != NULL);
@@ -554,6 +577,12 @@ static void XSUM_testXXH128(const void* data, const XSUM_testdata128_t* testData
         }
     }
 
+    /* check that a seed context results in the same hash as XXH3_128bits_withSeed() */
+    {   XXH3_seedContext_t context;
+        (void)XXH3_initSeedContext(&context, seed);
+        XSUM_checkResult128(XXH3_128bits_withSeedContext(data, len, &context), Nresult);
+    }
+
     /* streaming API test */
     {   XXH3_state_t *state = XXH3_createState();
         assert(state != NULL);
@@ -599,6 +628,14 @@ static void XSUM_testXXH128(const void* data, const XSUM_testdata128_t* testData
             }
         }
 
+        /* seed context, after a reset with an external secret */
+        {   XXH3_seedContext_t context;
+            (void)XXH3_initSeedContext(&context, seed);
+            (void)XXH3_128bits_reset_withSeedContext(state, &context);
+            XSUM_XXH3_randomUpdate(state, data, len, &XXH3_128bits_update);
+            XSUM_checkResult128(XXH3_128bits_digest(state), Nresult);
+        }
+
         XXH3_freeState(state);
     }
 }
@@ -623,6 +660,15 @@ static void XSUM_testXXH128_withSecret(const void* data, const void* secret, siz
         XSUM_checkResult128(Dresult, Nresult);
     }
 
+    /* check that a prepared secret results in the same hash as XXH3_128bits_withSecret() */
+    {   unsigned char workspace[XXH3_PREPARED_SECRET_SIZE(XXH3_SECRET_DEFAULT_SIZE)];
+        const XXH3_preparedSecret_t* prepared;
+        assert(secretSize <= XXH3_SECRET_DEFAULT_SIZE);
+        prepared = XXH3_initPreparedSecret(workspace, sizeof(workspace), secret, secretSize);
+        assert(prepared != NULL);
+        XSUM_checkResult128(XXH3_128bits_withPreparedSecret(data, len, prepared), Nresult);
+    }
+
     /* streaming API test */
     {   XXH3_state_t* const state = XXH3_createState();
         assert(state != NULL);
@@ -679,6 +725,707 @@ static void XSUM_testSecretGenerator(const void* customSeed, const XSUM_testdata
     nbTests++;
 }
 
+/*
+ * Hashes keys of all XXH3 test vector lengths in a single batch,
+ * starting each key at a different, mostly unaligned, offset within @data,
+ * and checks that each result is identical to XXH3_64bits().
+ */
+static void XSUM_testXXH3_batch(const XSUM_U8* data, size_t dataSize,
+                                const XSUM_testdata64_t* testData, size_t nbTests)
+{
+#define XSUM_BATCH_MAX 32
+    const void* ptrs[XSUM_BATCH_MAX];
+    size_t lens[XSUM_BATCH_MAX];
+    XXH64_hash_t expected[XSUM_BATCH_MAX];
+    XXH64_hash_t results[XSUM_BATCH_MAX];
+    size_t nbKeys = 0;
+    size_t i;
+
+    for (i = 0; i < nbTests; i++) {
+        size_t const len = testData[i].len;
+        size_t offset = (nbKeys * 13) % 64;
+        if (testData[i].seed != 0) continue;
+        assert(nbKeys < XSUM_BATCH_MAX);
+        assert(len <= dataSize);
+        if (offset > dataSize - len) offset = dataSize - len;
+        lens[nbKeys] = len;
+        ptrs[nbKeys] = data + offset;
+        expected[nbKeys] = XXH3_64bits(ptrs[nbKeys], len);
+        nbKeys++;
+    }
+    XXH3_64bits_batch(ptrs, lens, nbKeys, results);
+    for (i = 0; i < nbKeys; i++) {
+        XSUM_checkResult64(results[i], expected[i]);
+    }
+    /* check that every position in the list, with or without prefetching, gives the same result */
+    for (i = 1; i < nbKeys; i++) {
+        XXH3_64bits_batch(ptrs + i, lens + i, nbKeys - i, results);
+        XSUM_checkResult64(results[0], expected[i]);
+        XSUM_checkResult64(results[nbKeys - i - 1], expected[nbKeys - 1]);
+    }
+}
+
+/*
+ * Checks that hashing arrays of integer keys
+ * produces exactly the same results as XXH3_64bits() on each key.
+ * The number of keys is chosen to exercise both the vector loops and their tails.
+ */
+static void XSUM_testXXH3_intArrays(const XSUM_U8* data)
+{
+#define XSUM_NB_INT_KEYS 37
+    XXH32_hash_t  keys32[XSUM_NB_INT_KEYS];
+    XXH64_hash_t  keys64[XSUM_NB_INT_KEYS];
+    XXH128_hash_t keys128[XSUM_NB_INT_KEYS];
+    XXH64_hash_t  results[XSUM_NB_INT_KEYS];
+    size_t n;
+
+    memcpy(keys32, data, sizeof(keys32));
+    memcpy(keys64, data + sizeof(keys32), sizeof(keys64));
+    memcpy(keys128, data + sizeof(keys32) + sizeof(keys64), sizeof(keys128));
+
+    XXH3_64bits_u32_array(keys32, XSUM_NB_INT_KEYS, results);
+    for (n = 0; n < XSUM_NB_INT_KEYS; n++)
+        XSUM_checkResult64(results[n], XXH3_64bits(keys32 + n, sizeof(keys32[n])));
+
+    XXH3_64bits_u64_array(keys64, XSUM_NB_INT_KEYS, results);
+    for (n = 0; n < XSUM_NB_INT_KEYS; n++)
+        XSUM_checkResult64(results[n], XXH3_64bits(keys64 + n, sizeof(keys64[n])));
+
+    XXH3_64bits_u128_array(keys128, XSUM_NB_INT_KEYS, results);
+    for (n = 0; n < XSUM_NB_INT_KEYS; n++)
+        XSUM_checkResult64(results[n], XXH3_64bits(keys128 + n, sizeof(keys128[n])));
+}
+
+/*
+ * Checks that hashing several independent inputs at once
+ * produces exactly the same results as hashing them one by one.
+ * Lengths are mixed, so that long inputs are grouped,
+ * and cross block boundaries at different stripes.
+ */
+static void XSUM_testXXH3_multi(const XSUM_U8* data, size_t dataLen)
+{
+#define XSUM_NB_MULTI_INPUTS 11
+    static const size_t lens[XSUM_NB_MULTI_INPUTS] = { 2048, 2367, 0, 1100, 241, 240, 1025, 1024, 2300, 17, 1500 };
+    const void* inputs[XSUM_NB_MULTI_INPUTS];
+    XXH64_hash_t results64[XSUM_NB_MULTI_INPUTS];
+    XXH128_hash_t results128[XSUM_NB_MULTI_INPUTS];
+    size_t n;
+
+    for (n = 0; n < XSUM_NB_MULTI_INPUTS; n++) {
+        /* vary alignment */
+        size_t const offset = (n <= dataLen - lens[n]) ? n : dataLen - lens[n];
+        inputs[n] = data + offset;
+    }
+    XXH3_64bits_multi(inputs, lens, XSUM_NB_MULTI_INPUTS, results64);
+    XXH3_128bits_multi(inputs, lens, XSUM_NB_MULTI_INPUTS, results128);
+    for (n = 0; n < XSUM_NB_MULTI_INPUTS; n++) {
+        XSUM_checkResult64(results64[n], XXH3_64bits(inputs[n], lens[n]));
+        XSUM_checkResult128(results128[n], XXH3_128bits(inputs[n], lens[n]));
+    }
+}
+
+/*
+ * Checks seeded streaming states, whose secret is only derived once the input
+ * exceeds the internal buffer: the digest may have to derive it itself,
+ * and a state reset with the same seed may reuse it.
+ */
+static void XSUM_testXXH3_seededStreams(const XSUM_U8* data)
+{
+    static const size_t lens[] = { 100, 241, 256, 257, 10, 2000, 250 };
+    static const XXH64_hash_t seeds[] = { PRIME32, PRIME64 };
+    XXH3_state_t* const state = XXH3_createState();
+    size_t s, n;
+
+    assert(state != NULL);
+    for (s = 0; s < sizeof(seeds)/sizeof(seeds[0]); s++) {
+        for (n = 0; n < sizeof(lens)/sizeof(lens[0]); n++) {
+            (void)XXH3_64bits_reset_withSeed(state, seeds[s]);
+            (void)XXH3_64bits_update(state, data, lens[n]);
+            XSUM_checkResult64(XXH3_64bits_digest(state), XXH3_64bits_withSeed(data, lens[n], seeds[s]));
+            (void)XXH3_128bits_reset_withSeed(state, seeds[s]);
+            (void)XXH3_128bits_update(state, data, lens[n]);
+            XSUM_checkResult128(XXH3_128bits_digest(state), XXH3_128bits_withSeed(data, lens[n], seeds[s]));
+    }   }
+    (void)XXH3_freeState(state);
+}
+
+/*
+ * Checks that compact streaming states produce the same hashes as single-shot calls,
+ * with the default secret, a seed context, and a custom secret.
+ */
+static void XSUM_testXXH3_compactState(const XSUM_U8* data, const void* secret, size_t secretSize)
+{
+    static const size_t lens[] = { 0, 1, 100, 240, 241, 256, 257, 1000, 2367 };
+    XXH3_seedContext_t context;
+    XXH3_compactState_t state;
+    size_t n, split;
+
+    (void)XXH3_initSeedContext(&context, PRIME64);
+    for (n = 0; n < sizeof(lens)/sizeof(lens[0]); n++) {
+        size_t const len = lens[n];
+        for (split = 0; split <= len; split += len/3 + 1) {
+            (void)XXH3_compact_reset(&state);
+            (void)XXH3_compact_update(&state, data, split);
+            (void)XXH3_compact_update(&state, data + split, len - split);
+            XSUM_checkResult64(XXH3_compact_64bits_digest(&state), XXH3_64bits(data, len));
+            XSUM_checkResult128(XXH3_compact_128bits_digest(&state), XXH3_128bits(data, len));
+
+            (void)XXH3_compact_reset_withSeedContext(&state, &context);
+            (void)XXH3_compact_update(&state, data, split);
+            (void)XXH3_compact_update(&state, data + split, len - split);
+            XSUM_checkResult64(XXH3_compact_64bits_digest(&state), XXH3_64bits_withSeed(data, len, PRIME64));
+            XSUM_checkResult128(XXH3_compact_128bits_digest(&state), XXH3_128bits_withSeed(data, len, PRIME64));
+
+            (void)XXH3_compact_reset_withSecret(&state, secret, secretSize);
+            (void)XXH3_compact_update(&state, data, split);
+            (void)XXH3_compact_update(&state, data + split, len - split);
+            XSUM_checkResult64(XXH3_compact_64bits_digest(&state), XXH3_64bits_withSecret(data, len, secret, secretSize));
+            XSUM_checkResult128(XXH3_compact_128bits_digest(&state), XXH3_128bits_withSecret(data, len, secret, secretSize));
+    }   }
+}
+
+/*
+ * Checks that states are allocated by the allocator set with XXH_setAllocator(),
+ * and that states acquired from a pool hash correctly.
+ */
+static size_t XSUM_nbAllocs = 0;
+
+static void* XSUM_countingAlloc(void* opaque, size_t size)
+{
+    (void)opaque;
+    XSUM_nbAllocs++;
+    return malloc(size);
+}
+
+static void XSUM_countingFree(void* opaque, void* address)
+{
+    (void)opaque;
+    XSUM_nbAllocs--;   /* never invoked with NULL */
+    free(address);
+}
+
+static void XSUM_testAllocation(const XSUM_U8* data, size_t len)
+{
+    {   XXH_customMem const customMem = { XSUM_countingAlloc, XSUM_countingFree, NULL };
+        XXH_customMem const halfMem = { XSUM_countingAlloc, NULL, NULL };
+        XXH_customMem const defaultMem = { NULL, NULL, NULL };
+        XXH32_state_t* state32;
+        XXH64_state_t* state64;
+        XXH3_state_t* state3;
+        XXH_errorcode err;
+
+        err = XXH_setAllocator(halfMem);
+        assert(err == XXH_ERROR);
+        err = XXH_setAllocator(customMem);
+        assert(err == XXH_OK);
+        state32 = XXH32_createState();
+        state64 = XXH64_createState();
+        state3 = XXH3_createState();
+        assert(state32 != NULL && state64 != NULL && state3 != NULL);
+        if (XSUM_nbAllocs != 3) {
+            XSUM_log("\rError: custom allocator invoked %u times instead of 3 \n", (unsigned)XSUM_nbAllocs);
+            exit(1);
+        }
+        (void)XXH32_freeState(state32);
+        (void)XXH64_freeState(state64);
+        (void)XXH3_freeState(state3);
+        (void)XXH32_freeState(NULL);
+        (void)XXH64_freeState(NULL);
+        (void)XXH3_freeState(NULL);
+        if (XSUM_nbAllocs != 0) {
+            XSUM_log("\rError: custom allocator leaked %u allocations \n", (unsigned)XSUM_nbAllocs);
+            exit(1);
+        }
+        err = XXH_setAllocator(defaultMem);
+        assert(err == XXH_OK);
+        (void)err;
+    }
+
+    {   XXH3_statePool_t* const pool = XXH3_createStatePool(3);
+        XXH3_state_t* states[3];
+        XXH3_state_t* const foreign = XXH3_createState();
+        size_t n;
+        assert(pool != NULL && foreign != NULL);
+        for (n = 0; n < 3; n++) {
+            states[n] = XXH3_acquireState(pool);
+            assert(states[n] != NULL);
+        }
+        if (XXH3_acquireState(pool) != NULL || XXH3_releaseState(pool, foreign) != XXH_ERROR) {
+            XSUM_log("\rError: XXH3 state pool exceeded its capacity \n");
+            exit(1);
+        }
+        for (n = 0; n < 3; n++) {
+            (void)XXH3_64bits_reset_withSeed(states[n], (XXH64_hash_t)n);
+            (void)XXH3_64bits_update(states[n], data, len);
+            XSUM_checkResult64(XXH3_64bits_digest(states[n]), XXH3_64bits_withSeed(data, len, (XXH64_hash_t)n));
+        }
+        (void)XXH3_releaseState(pool, states[1]);
+        states[1] = XXH3_acquireState(pool);
+        assert(states[1] != NULL);
+        for (n = 0; n < 3; n++) (void)XXH3_releaseState(pool, states[n]);
+        (void)XXH3_freeState(foreign);
+        (void)XXH3_freeStatePool(pool);
+    }
+}
+
+/*
+ * Checks that scattered segments and 2D regions hash like their concatenation,
+ * with segment boundaries falling inside and on the edges of stripes.
+ */
+static void XSUM_testXXH3_iov(const XSUM_U8* data, size_t len)
+{
+    static const size_t segSizes[] = { 0, 1, 63, 64, 65, 7, 200, 1024 };
+    static const size_t lens[] = { 0, 1, 17, 240, 241, 1024, 1025, 2367 };
+    static XSUM_U8 rows[2367];
+    XXH_iovec_t iov[64];
+    XXH64_hash_t h64;
+    XXH128_hash_t h128;
+    size_t n, first;
+
+    for (n = 0; n < sizeof(lens)/sizeof(lens[0]); n++) {
+        size_t const total = lens[n] < len ? lens[n] : len;
+        for (first = 0; first < sizeof(segSizes)/sizeof(segSizes[0]); first++) {
+            size_t pos = 0, nbSegs = 0, s = first;
+            while (pos < total) {
+                size_t const size = (segSizes[s] < total - pos) ? segSizes[s] : total - pos;
+                iov[nbSegs].ptr = data + pos;
+                iov[nbSegs].size = size;
+                nbSegs++;
+                pos += size;
+                s = (s + 1) % (sizeof(segSizes)/sizeof(segSizes[0]));
+            }
+            assert(nbSegs <= sizeof(iov)/sizeof(iov[0]));
+            if (XXH3_64bits_iov(iov, nbSegs, &h64) != XXH_OK
+             || XXH3_128bits_iov(iov, nbSegs, &h128) != XXH_OK) {
+                XSUM_log("\rError: XXH3_*bits_iov() failed on %u segments \n", (unsigned)nbSegs);
+                exit(1);
+            }
+            XSUM_checkResult64(h64, XXH3_64bits(data, total));
+            XSUM_checkResult128(h128, XXH3_128bits(data, total));
+    }   }
+
+    {   static const size_t rowSizes[] = { 0, 3, 64, 100, 257 };
+        size_t const pitch = 300;
+        for (n = 0; n < sizeof(rowSizes)/sizeof(rowSizes[0]); n++) {
+            size_t const rowSize = rowSizes[n];
+            size_t const nbRows = len / pitch;
+            size_t r;
+            assert(rowSize * nbRows <= sizeof(rows));
+            for (r = 0; r < nbRows; r++)
+                memcpy(rows + r * rowSize, data + r * pitch, rowSize);
+            if (XXH3_64bits_2D(data, rowSize, nbRows, pitch, &h64) != XXH_OK
+             || XXH3_128bits_2D(data, rowSize, nbRows, pitch, &h128) != XXH_OK) {
+                XSUM_log("\rError: XXH3_*bits_2D() failed on %u rows \n", (unsigned)nbRows);
+                exit(1);
+            }
+            XSUM_checkResult64(h64, XXH3_64bits(rows, rowSize * nbRows));
+            XSUM_checkResult128(h128, XXH3_128bits(rows, rowSize * nbRows));
+    }   }
+
+    /*
+     * The total size overflows size_t: rejected before reading any segment.
+     * Segments alias the same memory, and their sizes wrap around to 16 bytes,
+     * which would otherwise select the short path.
+     */
+    {   size_t const half = (size_t)-1 / 2 + 1;
+        XXH_iovec_t wrapping[3];
+        wrapping[0].ptr = data; wrapping[0].size = half;
+        wrapping[1].ptr = data; wrapping[1].size = half;
+        wrapping[2].ptr = data; wrapping[2].size = 16;
+        if (XXH3_64bits_iov(wrapping, 3, &h64) != XXH_ERROR
+         || XXH3_128bits_iov(wrapping, 3, &h128) != XXH_ERROR
+         || XXH3_64bits_2D(data, half, 2, 0, &h64) != XXH_ERROR
+         || XXH3_128bits_2D(data, half, 2, 0, &h128) != XXH_ERROR) {
+            XSUM_log("\rError: an input larger than size_t was not rejected \n");
+            exit(1);
+        }
+    }
+}
+
+/*
+ * Checks that copy-and-hash functions copy the whole input,
+ * and return the same hashes as the regular functions.
+ */
+static void XSUM_testXXH3_copy(const XSUM_U8* data, size_t len)
+{
+    static const size_t lens[] = { 0, 1, 240, 241, 1024, 1025, 2367 };
+    static XSUM_U8 dst[2367];
+    XXH3_state_t state;
+    size_t n;
+
+    for (n = 0; n < sizeof(lens)/sizeof(lens[0]); n++) {
+        size_t const l = lens[n] < len ? lens[n] : len;
+        assert(l <= sizeof(dst));
+        memset(dst, 0, sizeof(dst));
+        XSUM_checkResult64(XXH3_64bits_copy(dst, data, l), XXH3_64bits(data, l));
+        if (memcmp(dst, data, l)) {
+            XSUM_log("\rError: XXH3_64bits_copy() did not copy %u bytes \n", (unsigned)l);
+            exit(1);
+        }
+        memset(dst, 0, sizeof(dst));
+        XSUM_checkResult128(XXH3_128bits_copy(dst, data, l), XXH3_128bits(data, l));
+        if (memcmp(dst, data, l)) {
+            XSUM_log("\rError: XXH3_128bits_copy() did not copy %u bytes \n", (unsigned)l);
+            exit(1);
+        }
+
+        memset(dst, 0, sizeof(dst));
+        (void)XXH3_64bits_reset(&state);
+        (void)XXH3_64bits_update_copy(&state, dst, data, l/3);
+        (void)XXH3_64bits_update_copy(&state, dst + l/3, data + l/3, l - l/3);
+        XSUM_checkResult64(XXH3_64bits_digest(&state), XXH3_64bits(data, l));
+        XSUM_checkResult128(XXH3_128bits_digest(&state), XXH3_128bits(data, l));
+        if (memcmp(dst, data, l)) {
+            XSUM_log("\rError: XXH3_64bits_update_copy() did not copy %u bytes \n", (unsigned)l);
+            exit(1);
+        }
+    }
+}
+
+/*
+ * Checks that the prefetch distance doesn't change hashes,
+ * including beyond XXH3_PREFETCH_DIST_MAX, where it is capped.
+ */
+static void XSUM_testPrefetchDistance(const XSUM_U8* data, size_t len)
+{
+    static const size_t distances[] = { 0, 64, 1000, XXH3_PREFETCH_DIST_MAX, XXH3_PREFETCH_DIST_MAX + 1, (size_t)-1 };
+    static const size_t lens[] = { 0, 240, 241, 1025, 2367 };
+    size_t n, l;
+
+    for (l = 0; l < sizeof(lens)/sizeof(lens[0]); l++) {
+        size_t const size = lens[l] < len ? lens[l] : len;
+        for (n = 0; n < sizeof(distances)/sizeof(distances[0]); n++) {
+            XSUM_checkResult64(XXH3_64bits_withPrefetchDistance(data, size, distances[n]),
+                               XXH3_64bits(data, size));
+            XSUM_checkResult128(XXH3_128bits_withPrefetchDistance(data, size, distances[n]),
+                                XXH3_128bits(data, size));
+    }   }
+}
+
+/*
+ * Checks that padded inputs hash like regular ones, for every short and mid-size length.
+ */
+static void XSUM_testXXH3_padded(const XSUM_U8* data, size_t len)
+{
+    size_t l;
+    for (l = 0; l <= 300 && l + XXH3_PADDING <= len; l++) {
+        XSUM_checkResult64(XXH3_64bits_padded(data, l), XXH3_64bits(data, l));
+        XSUM_checkResult64(XXH3_64bits_padded_withSeed(data, l, PRIME64), XXH3_64bits_withSeed(data, l, PRIME64));
+    }
+}
+
+static void XSUM_testXXH3_asciiFold(const XSUM_U8* data, size_t len)
+{
+    /* past 240 bytes, folding is done by blocks of 1024 bytes */
+    static const size_t lens[] = { 0, 1, 7, 9, 16, 17, 240, 241, 1024, 1025, 1087, 2049, 2112, 9000 };
+    static XSUM_U8 text[9001], lowered[9001];
+    size_t n, i;
+
+    /* every byte value, including non-ASCII ones, then the sanity buffer */
+    for (i = 0; i < sizeof(text); i++)
+        text[i] = (i < 256) ? (XSUM_U8)i : data[i % len];
+    for (i = 0; i < sizeof(text); i++)
+        lowered[i] = (text[i] >= 'A' && text[i] <= 'Z') ? (XSUM_U8)(text[i] + ('a' - 'A')) : text[i];
+
+    for (n = 0; n < sizeof(lens)/sizeof(lens[0]); n++) {
+        size_t const l = lens[n];
+        /* starts at an odd offset, to check unaligned inputs */
+        const XSUM_U8* const t = text + 1;
+        const XSUM_U8* const lw = lowered + 1;
+        assert(l < sizeof(text));
+        XSUM_checkResult64(XXH3_64bits_asciiFold(t, l), XXH3_64bits(lw, l));
+        XSUM_checkResult64(XXH3_64bits_asciiFold_withSeed(t, l, PRIME64), XXH3_64bits_withSeed(lw, l, PRIME64));
+        XSUM_checkResult128(XXH3_128bits_asciiFold(t, l), XXH3_128bits(lw, l));
+        XSUM_checkResult128(XXH3_128bits_asciiFold_withSeed(t, l, PRIME64), XXH3_128bits_withSeed(lw, l, PRIME64));
+    }
+}
+
+/*
+ * Checks that XXH64 typed appends give the same digests as XXH64()
+ * of the same little-endian bytes.
+ * XXH3 typed appends are checked by XSUM_checkXXH3_typedAppends().
+ */
+static void XSUM_testXXH64_typedAppends(const XSUM_U8* data, size_t len)
+{
+    static XSUM_U8 appended[1000 * 8];
+    XXH64_state_t state;
+    size_t pos = 0, n;
+
+    (void)XXH64_reset(&state, PRIME64);
+    for (n = 0; n < 1000; n++) {
+        const XSUM_U8* const p = data + (pos % (len - 8));
+        XSUM_U64 v = 0;
+        size_t size;
+        int i;
+        for (i = 7; i >= 0; i--) v = (v << 8) | p[i];  /* little-endian */
+        if (p[0] & 1) {
+            (void)XXH64_update_u64(&state, v);
+            size = 8;
+        } else {
+            (void)XXH64_update_u32(&state, (XSUM_U32)v);
+            size = 4;
+        }
+        memcpy(appended + pos, p, size);
+        pos += size;
+        XSUM_checkResult64(XXH64_digest(&state), XXH64(appended, pos, PRIME64));
+    }
+}
+
+/*
+ * Checks that XXH3_64bits_multiSeed() returns the same values as
+ * XXH3_64bits_withSeed() for each seed, including 0,
+ * with more seeds than fit in a group.
+ */
+static void XSUM_testXXH3_multiSeed(const XSUM_U8* data, size_t len)
+{
+    XXH64_hash_t seeds[37];
+    XXH64_hash_t out[37];
+    size_t n, s;
+
+    for (s = 0; s < 37; s++) seeds[s] = (XXH64_hash_t)s * PRIME64;
+    for (n = 0; n <= len; n += (n < 300) ? 7 : 233) {
+        size_t const nbSeeds = 1 + (n % 37);
+        XXH3_64bits_multiSeed(data, n, seeds, nbSeeds, out);
+        for (s = 0; s < nbSeeds; s++)
+            XSUM_checkResult64(out[s], XXH3_64bits_withSeed(data, n, seeds[s]));
+    }
+}
+
+/*
+ * Checks that XXH32 and XXH64 streaming states can be saved, then restored
+ * into a fresh state, and resumed into exactly the same hash as a single-shot call.
+ * XXH3 states are checked by XSUM_checkXXH3_saveState().
+ */
+static void XSUM_testSaveState(const XSUM_U8* data, size_t len)
+{
+    static const size_t splits[] = { 0, 5, 100, 240, 1000, 1030, 2000 };
+    size_t i;
+
+    for (i = 0; i < sizeof(splits)/sizeof(splits[0]); i++) {
+        size_t const split = splits[i];
+        XSUM_U8 saved[XXH64_SAVESTATE_SIZE_MAX];
+        size_t savedSize;
+
+        {   XXH32_state_t state, restored;
+            (void)XXH32_reset(&state, PRIME32);
+            (void)XXH32_update(&state, data, split);
+            savedSize = XXH32_saveState(&state, saved, XXH32_SAVESTATE_SIZE_MAX);
+            memset(&restored, 0xA5, sizeof(restored));
+            XSUM_checkResult32(XXH32_loadState(&restored, saved, savedSize), XXH_OK);
+            (void)XXH32_update(&restored, data + split, len - split);
+            XSUM_checkResult32(XXH32_digest(&restored), XXH32(data, len, PRIME32));
+        }
+        {   XXH64_state_t state, restored;
+            (void)XXH64_reset(&state, PRIME64);
+            (void)XXH64_update(&state, data, split);
+            savedSize = XXH64_saveState(&state, saved, XXH64_SAVESTATE_SIZE_MAX);
+            memset(&restored, 0xA5, sizeof(restored));
+            XSUM_checkResult32(XXH64_loadState(&restored, saved, savedSize), XXH_OK);
+            (void)XXH64_update(&restored, data + split, len - split);
+            XSUM_checkResult64(XXH64_digest(&restored), XXH64(data, len, PRIME64));
+        }
+    }
+}
+
+/*
+ * XXH3 streaming state checks:
+ * XSUM_testXXH3_states() runs each of them on the same stack state,
+ * once for each way of resetting it, listed in XSUM_XXH3_reset_e.
+ * A check resets the state with XSUM_XXH3_reset(),
+ * and compares its results with XSUM_XXH3_expected64() and XSUM_XXH3_expected128().
+ */
+typedef enum {
+    XSUM_XXH3_RESET_DEFAULT,   /* default secret */
+    XSUM_XXH3_RESET_SEED,      /* seed PRIME64 */
+    XSUM_XXH3_RESET_SECRET     /* custom secret */
+} XSUM_XXH3_reset_e;
+
+typedef struct {
+    XSUM_XXH3_reset_e reset;
+    const void* secret;    /* NULL, unless reset == XSUM_XXH3_RESET_SECRET */
+    size_t secretSize;
+} XSUM_XXH3_variant_t;
+
+typedef void (*XSUM_XXH3_stateCheck_f)(XXH3_state_t* state, const XSUM_XXH3_variant_t* variant,
+                                       const XSUM_U8* data, size_t len);
+
+static void XSUM_XXH3_reset(XXH3_state_t* state, const XSUM_XXH3_variant_t* variant)
+{
+    switch (variant->reset) {
+    case XSUM_XXH3_RESET_DEFAULT: (void)XXH3_64bits_reset(state); break;
+    case XSUM_XXH3_RESET_SEED:    (void)XXH3_64bits_reset_withSeed(state, PRIME64); break;
+    case XSUM_XXH3_RESET_SECRET:
+    default: (void)XXH3_64bits_reset_withSecret(state, variant->secret, variant->secretSize); break;
+    }
+}
+
+static XXH64_hash_t XSUM_XXH3_expected64(const XSUM_XXH3_variant_t* variant, const void* data, size_t len)
+{
+    switch (variant->reset) {
+    case XSUM_XXH3_RESET_DEFAULT: return XXH3_64bits(data, len);
+    case XSUM_XXH3_RESET_SEED:    return XXH3_64bits_withSeed(data, len, PRIME64);
+    case XSUM_XXH3_RESET_SECRET:
+    default: return XXH3_64bits_withSecret(data, len, variant->secret, variant->secretSize);
+    }
+}
+
+static XXH128_hash_t XSUM_XXH3_expected128(const XSUM_XXH3_variant_t* variant, const void* data, size_t len)
+{
+    switch (variant->reset) {
+    case XSUM_XXH3_RESET_DEFAULT: return XXH3_128bits(data, len);
+    case XSUM_XXH3_RESET_SEED:    return XXH3_128bits_withSeed(data, len, PRIME64);
+    case XSUM_XXH3_RESET_SECRET:
+    default: return XXH3_128bits_withSecret(data, len, variant->secret, variant->secretSize);
+    }
+}
+
+/*
+ * Checks that a state can be saved, then restored into a fresh state,
+ * and resumed into exactly the same hash as a single-shot call.
+ * The saved representation of a seeded state is also checked against a fixed value,
+ * to detect unintended changes to the format.
+ */
+static void XSUM_checkXXH3_saveState(XXH3_state_t* state, const XSUM_XXH3_variant_t* variant,
+                                     const XSUM_U8* data, size_t len)
+{
+    static const size_t splits[] = { 0, 5, 100, 240, 1000, 1030, 2000 };
+    XSUM_U8 saved[XXH3_SAVESTATE_SIZE_MAX];
+    XXH3_state_t restored;
+    size_t i;
+
+    for (i = 0; i < sizeof(splits)/sizeof(splits[0]); i++) {
+        size_t const split = splits[i];
+        size_t savedSize;
+        XSUM_XXH3_reset(state, variant);
+        (void)XXH3_64bits_update(state, data, split);
+        savedSize = XXH3_saveState(state, saved, sizeof(saved));
+        if (variant->reset == XSUM_XXH3_RESET_SEED && split == 1000)
+            XSUM_checkResult64(XXH64(saved, savedSize, 0), 0x27398A7DE3909BF9ULL);
+        memset(&restored, 0xA5, sizeof(restored));
+        XSUM_checkResult32(XXH3_loadState(&restored, saved, savedSize, variant->secret, variant->secretSize), XXH_OK);
+        (void)XXH3_64bits_update(&restored, data + split, len - split);
+        XSUM_checkResult64(XXH3_64bits_digest(&restored), XSUM_XXH3_expected64(variant, data, len));
+        XSUM_checkResult128(XXH3_128bits_digest(&restored), XSUM_XXH3_expected128(variant, data, len));
+        /* a different secret must be rejected */
+        if (variant->reset == XSUM_XXH3_RESET_SECRET)
+            XSUM_checkResult32(XXH3_loadState(&restored, saved, savedSize, data, variant->secretSize), XXH_ERROR);
+    }
+}
+
+/*
+ * Checks that typed appends give the same digests as a single-shot call
+ * on the same little-endian bytes.
+ * Enough values are appended to fill the internal buffer many times.
+ */
+static void XSUM_checkXXH3_typedAppends(XXH3_state_t* state, const XSUM_XXH3_variant_t* variant,
+                                        const XSUM_U8* data, size_t len)
+{
+    static XSUM_U8 appended[1000 * 8];
+    size_t pos = 0, n;
+
+    XSUM_XXH3_reset(state, variant);
+    for (n = 0; n < 1000; n++) {
+        const XSUM_U8* const p = data + (pos % (len - 8));
+        XSUM_U64 v = 0;
+        size_t size;
+        int i;
+        for (i = 7; i >= 0; i--) v = (v << 8) | p[i];  /* little-endian */
+        switch (p[0] & 3) {
+        case 0:  (void)XXH3_update_u8(state, (unsigned char)v);   size = 1; break;
+        case 1:  (void)XXH3_update_u16(state, (unsigned short)v); size = 2; break;
+        case 2:  (void)XXH3_update_u32(state, (XSUM_U32)v);       size = 4; break;
+        default: (void)XXH3_update_u64(state, v);                 size = 8; break;
+        }
+        memcpy(appended + pos, p, size);
+        pos += size;
+        XSUM_checkResult64(XXH3_64bits_digest(state), XSUM_XXH3_expected64(variant, appended, pos));
+        XSUM_checkResult128(XXH3_128bits_digest(state), XSUM_XXH3_expected128(variant, appended, pos));
+    }
+}
+
+/*
+ * Checks that hashing a suffix after a captured prefix gives the same result
+ * as single-shot hashing of the concatenation,
+ * around the short input limit, the internal buffer size and block boundaries.
+ */
+static void XSUM_checkXXH3_prefix(XXH3_state_t* state, const XSUM_XXH3_variant_t* variant,
+                                  const XSUM_U8* data, size_t len)
+{
+    static const size_t prefixLens[] = { 0, 1, 63, 64, 100, 240, 256, 257, 300, 700, 1000 };
+    static const size_t suffixLens[] = { 0, 1, 17, 63, 64, 65, 140, 192, 256, 257, 500, 1100 };
+    XXH3_prefix_t prefix;
+    size_t p, s;
+
+    for (p = 0; p < sizeof(prefixLens)/sizeof(prefixLens[0]); p++) {
+        size_t const prefixLen = prefixLens[p];
+        const XSUM_U8* const suffix = data + prefixLen;
+        XSUM_XXH3_reset(state, variant);
+        (void)XXH3_64bits_update(state, data, prefixLen);
+        (void)XXH3_prefix_capture(&prefix, state);
+        for (s = 0; s < sizeof(suffixLens)/sizeof(suffixLens[0]); s++) {
+            size_t const totalLen = prefixLen + suffixLens[s];
+            assert(totalLen <= len);
+            XSUM_checkResult64(XXH3_64bits_withPrefix(&prefix, suffix, suffixLens[s]),
+                               XSUM_XXH3_expected64(variant, data, totalLen));
+            XSUM_checkResult128(XXH3_128bits_withPrefix(&prefix, suffix, suffixLens[s]),
+                                XSUM_XXH3_expected128(variant, data, totalLen));
+    }   }
+}
+
+/*
+ * Checks that XXH3_dual_digest(), and XXH3_dual() or XXH3_dual_withSeed()
+ * when the reset kind has one, return the same values
+ * as the separate 64-bit and 128-bit functions, on both sides of XXH3_MIDSIZE_MAX.
+ */
+static void XSUM_checkXXH3_dual(XXH3_state_t* state, const XSUM_XXH3_variant_t* variant,
+                                const XSUM_U8* data, size_t len)
+{
+    size_t n;
+
+    for (n = 0; n <= len; n += (n < 300) ? 1 : 131) {
+        XXH64_hash_t h64;
+        XXH128_hash_t h128;
+        if (variant->reset != XSUM_XXH3_RESET_SECRET) {
+            if (variant->reset == XSUM_XXH3_RESET_SEED)
+                XXH3_dual_withSeed(data, n, PRIME64, &h64, &h128);
+            else
+                XXH3_dual(data, n, &h64, &h128);
+            XSUM_checkResult64(h64, XSUM_XXH3_expected64(variant, data, n));
+            XSUM_checkResult128(h128, XSUM_XXH3_expected128(variant, data, n));
+        }
+
+        XSUM_XXH3_reset(state, variant);
+        (void)XXH3_64bits_update(state, data, n / 3);
+        (void)XXH3_64bits_update(state, data + n / 3, n - n / 3);
+        XXH3_dual_digest(state, &h64, &h128);
+        XSUM_checkResult64(h64, XSUM_XXH3_expected64(variant, data, n));
+        XSUM_checkResult128(h128, XSUM_XXH3_expected128(variant, data, n));
+    }
+}
+
+static void XSUM_testXXH3_states(const XSUM_U8* data, size_t len, const void* secret, size_t secretSize)
+{
+    static const XSUM_XXH3_stateCheck_f checks[] = {
+        XSUM_checkXXH3_saveState,
+        XSUM_checkXXH3_typedAppends,
+        XSUM_checkXXH3_prefix,
+        XSUM_checkXXH3_dual
+    };
+    XXH3_state_t state;
+    XSUM_XXH3_variant_t variant;
+    int reset;
+    size_t c;
+
+    XXH3_INITSTATE(&state);
+    for (reset = XSUM_XXH3_RESET_DEFAULT; reset <= XSUM_XXH3_RESET_SECRET; reset++) {
+        variant.reset = (XSUM_XXH3_reset_e)reset;
+        variant.secret = (reset == XSUM_XXH3_RESET_SECRET) ? secret : NULL;
+        variant.secretSize = (reset == XSUM_XXH3_RESET_SECRET) ? secretSize : 0;
+        for (c = 0; c < sizeof(checks)/sizeof(checks[0]); c++)
+            checks[c](&state, &variant, data, len);
+    }
+}
+
 /*!
  * XSUM_sanityCheck():
  * Runs a sanity check before the benchmark.
@@ -708,6 +1455,27 @@ XSUM_API void XSUM_sanityCheck(void)
     for (i = 0; i < (sizeof(XSUM_XXH3_testdata)/sizeof(XSUM_XXH3_testdata[0])); i++) {
         XSUM_testXXH3(sanityBuffer, &XSUM_XXH3_testdata[i]);
     }
+    /* XXH3_64bits, batch of keys */
+    XSUM_testXXH3_batch(sanityBuffer, sizeof(sanityBuffer), XSUM_XXH3_testdata, sizeof(XSUM_XXH3_testdata)/sizeof(XSUM_XXH3_testdata[0]));
+    /* XXH3_64bits, arrays of integer keys */
+    assert(SANITY_BUFFER_SIZE >= XSUM_NB_INT_KEYS * (4 + 8 + 16));
+    XSUM_testXXH3_intArrays(sanityBuffer);
+    /* streaming state serialization */
+    XSUM_testSaveState(sanityBuffer, sizeof(sanityBuffer));
+    /* XXH3, several independent inputs */
+    XSUM_testXXH3_multi(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH3_seededStreams(sanityBuffer);
+    XSUM_testXXH3_compactState(sanityBuffer, secret, secretSize);
+    XSUM_testAllocation(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH3_iov(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH3_copy(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testPrefetchDistance(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH3_padded(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH3_asciiFold(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH64_typedAppends(sanityBuffer, sizeof(sanityBuffer));
+    XSUM_testXXH3_multiSeed(sanityBuffer, sizeof(sanityBuffer));
+    /* XXH3 streaming states, for each kind of reset */
+    XSUM_testXXH3_states(sanityBuffer, sizeof(sanityBuffer), secret, secretSize);
     /* XXH3_64bits, custom secret */
     for (i = 0; i < (sizeof(XSUM_XXH3_withSecret_testdata)/sizeof(XSUM_XXH3_withSecret_testdata[0])); i++) {
         XSUM_testXXH3_withSecret(sanityBuffer, secret, secretSize, &XSUM_XXH3_withSecret_testdata[i]);
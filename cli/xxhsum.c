@@ -1348,6 +1348,11 @@ XSUM_API int XSUM_main(int argc, const char* argv[])
     /* Check benchmark mode */
     if (benchmarkMode) {
         XSUM_logVerbose(2, FULL_WELCOME_MESSAGE(exename) );
+#ifdef XXHSUM_DISPATCH
+        {   static const char* const vectorNames[] = { "scalar", "sse2", "avx2", "avx512" };
+            XSUM_logVerbose(2, "XXH3 dispatched to %s \n", vectorNames[XXH_getDispatchedVector()]);
+        }
+#endif
         XSUM_sanityCheck();
         g_nbIterations = nbIterations;
         if (selectBenchIDs == 0) memcpy(g_testIDs, k_testIDs_default, (size_t)g_nbTestFunctions);
@@ -0,0 +1,217 @@
+/*
+ * Measures how much a hashing thread slows down a cache-sensitive thread
+ * Part of the xxHash project
+ * Copyright (C) 2019-2021 Yann Collet
+ * GPL v2 License
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * You can contact the author at:
+ * - xxHash homepage: https://www.xxhash.com
+ * - xxHash source repository: https://github.com/Cyan4973/xxHash
+ */
+
+/*
+ * A victim thread chases pointers through a working set that fits in cache,
+ * while a hasher thread hashes a large buffer with XXH3_64bits() in a loop.
+ * The victim's speed, in loads per CPU-second of its own thread,
+ * is reported alone and next to the hasher.
+ *
+ * Build it twice to compare prefetch modes:
+ *   make ntaVictim ntaVictim_nta
+ *
+ * Usage: ntaVictim [victimKB [hashMB [seconds [runs]]]]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+/* ===  dependencies  === */
+
+#include <stdio.h>       /* printf */
+#include <stdlib.h>      /* malloc, atoi, qsort */
+#include <string.h>      /* memset */
+#include <pthread.h>
+#include <time.h>        /* clock_gettime */
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+
+/* ===  victim  === */
+
+#define CACHELINE 64
+
+typedef struct {
+    size_t* chain;      /* one entry per cache line: index of the next line */
+    size_t nbLines;
+    double seconds;
+    double loadsPerSec; /* result */
+} victim_t;
+
+static double threadSeconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static double wallSeconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* links all cache lines of @chain in a single random cycle */
+static void victim_init(victim_t* v, size_t workingSet)
+{
+    size_t const stride = CACHELINE / sizeof(size_t);
+    size_t* order;
+    size_t n;
+
+    v->nbLines = workingSet / CACHELINE;
+    v->chain = (size_t*)malloc(v->nbLines * CACHELINE);
+    order = (size_t*)malloc(v->nbLines * sizeof(size_t));
+    if (v->chain == NULL || order == NULL) { fprintf(stderr, "allocation failed \n"); exit(1); }
+    for (n = 0; n < v->nbLines; n++) order[n] = n;
+    srand(1);
+    for (n = v->nbLines - 1; n > 0; n--) {
+        size_t const r = (size_t)rand() % (n + 1);
+        size_t const tmp = order[n]; order[n] = order[r]; order[r] = tmp;
+    }
+    for (n = 0; n < v->nbLines; n++)
+        v->chain[order[n] * stride] = order[(n + 1) % v->nbLines] * stride;
+    free(order);
+}
+
+static void* victim_run(void* arg)
+{
+    victim_t* const v = (victim_t*)arg;
+    double const wallEnd = wallSeconds() + v->seconds;
+    double const start = threadSeconds();
+    size_t volatile sink;
+    size_t pos = 0;
+    unsigned long long loads = 0;
+
+    while (wallSeconds() < wallEnd) {
+        int i;
+        for (i = 0; i < 4096; i++) pos = v->chain[pos];
+        loads += 4096;
+    }
+    sink = pos;
+    (void)sink;
+    v->loadsPerSec = (double)loads / (threadSeconds() - start);
+    return NULL;
+}
+
+
+/* ===  hasher  === */
+
+typedef struct {
+    const void* buffer;
+    size_t size;
+    pthread_mutex_t lock;
+    int stop;
+    double bytesPerSec; /* result */
+} hasher_t;
+
+static void* hasher_run(void* arg)
+{
+    hasher_t* const h = (hasher_t*)arg;
+    double const start = threadSeconds();
+    XXH64_hash_t volatile sink = 0;
+    unsigned long long bytes = 0;
+
+    for (;;) {
+        int stop;
+        pthread_mutex_lock(&h->lock);
+        stop = h->stop;
+        pthread_mutex_unlock(&h->lock);
+        if (stop) break;
+        sink += XXH3_64bits(h->buffer, h->size);
+        bytes += h->size;
+    }
+    h->bytesPerSec = (double)bytes / (threadSeconds() - start);
+    return NULL;
+}
+
+
+/* ===  main  === */
+
+static int compareDoubles(const void* a, const void* b)
+{
+    double const x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+#define RUNS_MAX 31
+
+int main(int argc, const char** argv)
+{
+    size_t const victimKB = (argc > 1) ? (size_t)atoi(argv[1]) : 1024;
+    size_t const hashMB   = (argc > 2) ? (size_t)atoi(argv[2]) : 1024;
+    double const seconds  = (argc > 3) ? atof(argv[3]) : 1.0;
+    int runs              = (argc > 4) ? atoi(argv[4]) : 7;
+    double alone[RUNS_MAX], shared[RUNS_MAX], hashSpeed[RUNS_MAX];
+    victim_t v;
+    hasher_t h;
+    void* buffer;
+    int r;
+
+    if (runs < 1) runs = 1;
+    if (runs > RUNS_MAX) runs = RUNS_MAX;
+    victim_init(&v, victimKB << 10);
+    v.seconds = seconds;
+    buffer = malloc(hashMB << 20);
+    if (buffer == NULL) { fprintf(stderr, "allocation failed \n"); return 1; }
+    memset(buffer, 0x5A, hashMB << 20);
+    h.buffer = buffer;
+    h.size = hashMB << 20;
+    pthread_mutex_init(&h.lock, NULL);
+
+    /* alternate both measurements, so that they see the same machine state */
+    for (r = 0; r < runs; r++) {
+        pthread_t victimThread, hasherThread;
+
+        pthread_create(&victimThread, NULL, victim_run, &v);
+        pthread_join(victimThread, NULL);
+        alone[r] = v.loadsPerSec;
+
+        h.stop = 0;
+        pthread_create(&hasherThread, NULL, hasher_run, &h);
+        pthread_create(&victimThread, NULL, victim_run, &v);
+        pthread_join(victimThread, NULL);
+        pthread_mutex_lock(&h.lock);
+        h.stop = 1;
+        pthread_mutex_unlock(&h.lock);
+        pthread_join(hasherThread, NULL);
+        shared[r] = v.loadsPerSec;
+        hashSpeed[r] = h.bytesPerSec;
+    }
+    qsort(alone, (size_t)runs, sizeof(double), compareDoubles);
+    qsort(shared, (size_t)runs, sizeof(double), compareDoubles);
+    qsort(hashSpeed, (size_t)runs, sizeof(double), compareDoubles);
+
+    printf("XXH_PREFETCH_NTA=%d, victim %u KB, hasher %u MB, median of %d runs \n",
+           XXH_PREFETCH_NTA, (unsigned)victimKB, (unsigned)hashMB, runs);
+    printf("victim alone       : %7.1f M loads/s \n", alone[runs/2] / 1e6);
+    printf("victim + hasher    : %7.1f M loads/s \n", shared[runs/2] / 1e6);
+    printf("hasher             : %7.2f GB/s \n", hashSpeed[runs/2] / 1e9);
+
+    pthread_mutex_destroy(&h.lock);
+    free(buffer);
+    free(v.chain);
+    return 0;
+}
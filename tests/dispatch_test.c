@@ -0,0 +1,195 @@
+// xxHash/tests/dispatch_test.c
+// SPDX-License-Identifier: GPL-2.0-only
+//
+// Building
+// ========
+//
+// cc dispatch_test.c ../xxhash.c ../xxh_x86dispatch.c && ./a.out
+//
+/*
+Checks that every XXH3 function routed by xxh_x86dispatch.c returns the
+same result as the reference implementation of xxhash.c, for each vector
+implementation the host supports.
+*/
+#define XXH_STATIC_LINKING_ONLY
+#define XXH_DISPATCH_DISABLE_REPLACE
+#include "../xxh_x86dispatch.h"
+
+#include <stdio.h>  /* printf */
+#include <stdlib.h> /* malloc, free */
+#include <string.h> /* memcmp, memset */
+
+#define PRIME32 2654435761U
+#define PRIME64 11400714785074694797ULL
+
+static void fillTestBuffer(unsigned char* buffer, size_t len)
+{
+    XXH64_hash_t byteGen = PRIME32;
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        buffer[i] = (unsigned char)(byteGen>>56);
+        byteGen *= PRIME64;
+    }
+}
+
+static int g_errors = 0;
+
+static void check64(const char* name, int vecID, size_t len, XXH64_hash_t result, XXH64_hash_t expected)
+{
+    if (result == expected) return;
+    printf("%s (vector %d, len %u): got %016llx, expected %016llx \n", name, vecID, (unsigned)len,
+           (unsigned long long)result, (unsigned long long)expected);
+    g_errors++;
+}
+
+static void check128(const char* name, int vecID, size_t len, XXH128_hash_t result, XXH128_hash_t expected)
+{
+    check64(name, vecID, len, result.low64, expected.low64);
+    check64(name, vecID, len, result.high64, expected.high64);
+}
+
+/* feeds @input by irregular segments */
+static void update3(XXH3_state_t* state, const unsigned char* input, size_t len)
+{
+    size_t pos = 0, seg = 1;
+    while (pos < len) {
+        size_t const n = (len - pos < seg) ? len - pos : seg;
+        XXH3_64bits_update_dispatch(state, input + pos, n);
+        pos += n;
+        seg = seg * 3 + 7;
+    }
+}
+
+static void testVector(int vecID, const unsigned char* buffer, size_t maxLen,
+                       const unsigned char* secret, size_t secretSize)
+{
+    static const XXH64_hash_t seeds[] = { 0, PRIME32, PRIME64 };
+    XXH3_seedContext_t contexts[sizeof(seeds)/sizeof(seeds[0])];
+    XXH3_state_t ref, state;
+    size_t len, s;
+
+    XXH3_INITSTATE(&ref);
+    XXH3_INITSTATE(&state);
+    for (s = 0; s < sizeof(seeds)/sizeof(seeds[0]); s++)
+        (void)XXH3_initSeedContext(&contexts[s], seeds[s]);
+
+    {   unsigned char s1[XXH3_SECRET_DEFAULT_SIZE], s2[XXH3_SECRET_DEFAULT_SIZE];
+        for (s = 0; s < sizeof(seeds)/sizeof(seeds[0]); s++) {
+            XXH3_generateSecret_fromSeed(s1, seeds[s]);
+            XXH3_generateSecret_fromSeed_dispatch(s2, seeds[s]);
+            if (memcmp(s1, s2, sizeof(s1))) {
+                printf("XXH3_generateSecret_fromSeed_dispatch (vector %d, seed %u): mismatch \n",
+                       vecID, (unsigned)s);
+                g_errors++;
+    }   }   }
+
+    for (len = 0; len <= maxLen; len += (len < 300) ? 1 : 97) {
+        for (s = 0; s < sizeof(seeds)/sizeof(seeds[0]); s++) {
+            XXH64_hash_t const seed = seeds[s];
+            check64("XXH3_64bits_withSeed_dispatch", vecID, len,
+                    XXH3_64bits_withSeed_dispatch(buffer, len, seed),
+                    XXH3_64bits_withSeed(buffer, len, seed));
+            check64("XXH3_64bits_withSecretandSeed_dispatch", vecID, len,
+                    XXH3_64bits_withSecretandSeed_dispatch(buffer, len, secret, secretSize, seed),
+                    XXH3_64bits_withSecretandSeed(buffer, len, secret, secretSize, seed));
+            check128("XXH3_128bits_withSeed_dispatch", vecID, len,
+                     XXH3_128bits_withSeed_dispatch(buffer, len, seed),
+                     XXH3_128bits_withSeed(buffer, len, seed));
+            check128("XXH3_128bits_withSecretandSeed_dispatch", vecID, len,
+                     XXH3_128bits_withSecretandSeed_dispatch(buffer, len, secret, secretSize, seed),
+                     XXH3_128bits_withSecretandSeed(buffer, len, secret, secretSize, seed));
+            check64("XXH3_64bits_withSeedContext_dispatch", vecID, len,
+                    XXH3_64bits_withSeedContext_dispatch(buffer, len, &contexts[s]),
+                    XXH3_64bits_withSeed(buffer, len, seed));
+            check128("XXH3_128bits_withSeedContext_dispatch", vecID, len,
+                     XXH3_128bits_withSeedContext_dispatch(buffer, len, &contexts[s]),
+                     XXH3_128bits_withSeed(buffer, len, seed));
+
+            /* seeded streaming */
+            XXH3_64bits_reset_withSeed(&ref, seed);
+            XXH3_64bits_update(&ref, buffer, len);
+            XXH3_64bits_reset_withSeed(&state, seed);
+            update3(&state, buffer, len);
+            check64("XXH3_64bits_digest_dispatch (seed)", vecID, len,
+                    XXH3_64bits_digest_dispatch(&state), XXH3_64bits_digest(&ref));
+            XXH3_128bits_reset_withSeed(&state, seed);
+            update3(&state, buffer, len);
+            check128("XXH3_128bits_digest_dispatch (seed)", vecID, len,
+                     XXH3_128bits_digest_dispatch(&state), XXH3_128bits_digest(&ref));
+        }
+        check64("XXH3_64bits_dispatch", vecID, len,
+                XXH3_64bits_dispatch(buffer, len), XXH3_64bits(buffer, len));
+        check64("XXH3_64bits_withSecret_dispatch", vecID, len,
+                XXH3_64bits_withSecret_dispatch(buffer, len, secret, secretSize),
+                XXH3_64bits_withSecret(buffer, len, secret, secretSize));
+        check128("XXH3_128bits_dispatch", vecID, len,
+                 XXH3_128bits_dispatch(buffer, len), XXH3_128bits(buffer, len));
+        check128("XXH3_128bits_withSecret_dispatch", vecID, len,
+                 XXH3_128bits_withSecret_dispatch(buffer, len, secret, secretSize),
+                 XXH3_128bits_withSecret(buffer, len, secret, secretSize));
+
+        /* streaming with a custom secret */
+        XXH3_128bits_reset_withSecret(&ref, secret, secretSize);
+        XXH3_128bits_update(&ref, buffer, len);
+        XXH3_128bits_reset_withSecret(&state, secret, secretSize);
+        update3(&state, buffer, len);
+        check64("XXH3_64bits_digest_dispatch (secret)", vecID, len,
+                XXH3_64bits_digest_dispatch(&state), XXH3_64bits_digest(&ref));
+        check128("XXH3_128bits_digest_dispatch (secret)", vecID, len,
+                 XXH3_128bits_digest_dispatch(&state), XXH3_128bits_digest(&ref));
+
+        /* save and load, resumed with the dispatched update and digest */
+        {   unsigned char saved[XXH3_SAVESTATE_SIZE_MAX];
+            size_t const half = len / 2;
+            size_t savedSize;
+            XXH3_64bits_reset(&ref);
+            XXH3_64bits_update(&ref, buffer, len);
+            XXH3_64bits_reset_withSeed(&state, 0);
+            update3(&state, buffer, half);
+            savedSize = XXH3_saveState(&state, saved, sizeof(saved));
+            memset(&state, 0, sizeof(state));
+            if (savedSize == 0 || XXH3_loadState(&state, saved, savedSize, NULL, 0) != XXH_OK) {
+                printf("XXH3_loadState (vector %d, len %u): default secret not restored \n",
+                       vecID, (unsigned)len);
+                g_errors++;
+                continue;
+            }
+            update3(&state, buffer + half, len - half);
+            check64("XXH3_64bits_digest_dispatch (restored)", vecID, len,
+                    XXH3_64bits_digest_dispatch(&state), XXH3_64bits_digest(&ref));
+        }
+    }
+}
+
+int main(void)
+{
+    static const char* const names[] = { "scalar", "sse2", "avx2", "avx512" };
+    size_t const maxLen = 3000;
+    size_t const secretSize = XXH3_SECRET_SIZE_MIN + 11;
+    unsigned char* const buffer = (unsigned char*)malloc(maxLen + secretSize);
+    int const initial = XXH_getDispatchedVector();
+    int vecID, nbTested = 0;
+
+    if (buffer == NULL) return 1;
+    fillTestBuffer(buffer, maxLen + secretSize);
+
+    for (vecID = XXH_SCALAR; vecID <= XXH_AVX512; vecID++) {
+        if (XXH_setDispatch(vecID) != XXH_OK) continue;
+        printf("Testing %s \n", names[vecID]);
+        testVector(vecID, buffer, maxLen, buffer + maxLen, secretSize);
+        nbTested++;
+    }
+    (void)XXH_setDispatch(initial);
+    free(buffer);
+
+    if (nbTested == 0) {
+        printf("No vector implementation could be selected \n");
+        return 1;
+    }
+    if (g_errors) {
+        printf("%d errors \n", g_errors);
+        return 1;
+    }
+    printf("All %d implementations match the reference \n", nbTested);
+    return 0;
+}
@@ -0,0 +1,146 @@
+// xxHash/tests/treehash_test.c
+// SPDX-License-Identifier: GPL-2.0-only
+//
+// Building
+// ========
+//
+// cc -pthread treehash_test.c ../xxhash.c ../xxh_treehash.c && ./a.out
+//
+/*
+Checks XXH3T against known results, checks that XXH3T_128bits() doesn't
+depend on the number of threads, and matches the XXH3T_state_t API fed with
+leaves in reverse order.
+Also checks that invalid leaf sizes and incomplete trees are rejected.
+*/
+#include "../xxh_treehash.h"
+
+#include <stdio.h>  /* printf */
+#include <stdlib.h> /* malloc, free, exit */
+
+#define PRIME32 2654435761U
+#define PRIME64 11400714785074694797ULL
+
+/* known results, with a leaf size of 1024 */
+static const struct {
+    size_t len;
+    XXH128_hash_t result;
+} knownResults[] = {
+    {    0, { 0xCD68D0FDDE5B8854ULL, 0xEEB7E14BE44532B1ULL } },  /* no leaf */
+    { 1024, { 0xE3B53616D627F365ULL, 0xDC1CCB6EAE7243B9ULL } },  /* 1 full leaf */
+    { 2367, { 0x0BB42F4A8A4FCBBDULL, 0xC4FD339D7B355EA9ULL } }   /* 2 full leaves + partial leaf */
+};
+
+static void fillTestBuffer(unsigned char* buffer, size_t len)
+{
+    XXH64_hash_t byteGen = PRIME32;
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        buffer[i] = (unsigned char)(byteGen>>56);
+        byteGen *= PRIME64;
+    }
+}
+
+/* feeds leaves in reverse order, through two states merged at the end */
+static XXH128_hash_t referenceTreeHash(const unsigned char* input, size_t len, size_t chunkSize)
+{
+    XXH3T_state_t even, odd;
+    size_t const nbLeaves = (len + chunkSize - 1) / chunkSize;
+    size_t n;
+    if (XXH3T_reset(&even, chunkSize) != XXH_OK) exit(1);
+    if (XXH3T_reset(&odd, chunkSize) != XXH_OK) exit(1);
+    for (n = nbLeaves; n-- > 0; ) {
+        size_t const start = n * chunkSize;
+        size_t const leafLen = (len - start < chunkSize) ? len - start : chunkSize;
+        if (XXH3T_addLeaf((n & 1) ? &odd : &even, n, input + start, leafLen) != XXH_OK) exit(1);
+    }
+    if (XXH3T_merge(&even, &odd) != XXH_OK) exit(1);
+    {   XXH128_hash_t result;
+        if (XXH3T_digest(&even, &result) != XXH_OK) exit(1);
+        return result;
+}   }
+
+int main(void)
+{
+    static const size_t lens[] = { 0, 1, 1024, 1025, 4096, 100000, 1000003 };
+    static const size_t chunkSizes[] = { 1024, 4096, 65536 };
+    static const unsigned threads[] = { 0, 1, 2, 3, 8, 1000 };
+    size_t const maxLen = 1000003;
+    unsigned char* const buffer = (unsigned char*)malloc(maxLen);
+    size_t l, c, t;
+    int errors = 0;
+
+    if (buffer == NULL) return 1;
+    fillTestBuffer(buffer, maxLen);
+
+    for (l = 0; l < sizeof(knownResults)/sizeof(knownResults[0]); l++) {
+        XXH128_hash_t const h = referenceTreeHash(buffer, knownResults[l].len, 1024);
+        if (!XXH128_isEqual(h, knownResults[l].result)) {
+            printf("XXH3T(len=%u, chunkSize=1024) mismatch \n", (unsigned)knownResults[l].len);
+            errors++;
+    }   }
+
+    for (l = 0; l < sizeof(lens)/sizeof(lens[0]); l++) {
+        for (c = 0; c < sizeof(chunkSizes)/sizeof(chunkSizes[0]); c++) {
+            XXH128_hash_t const ref = referenceTreeHash(buffer, lens[l], chunkSizes[c]);
+            for (t = 0; t < sizeof(threads)/sizeof(threads[0]); t++) {
+                XXH128_hash_t h;
+                if (XXH3T_128bits(buffer, lens[l], chunkSizes[c], threads[t], &h) != XXH_OK
+                  || !XXH128_isEqual(h, ref)) {
+                    printf("XXH3T_128bits(len=%u, chunkSize=%u, nbThreads=%u) mismatch \n",
+                           (unsigned)lens[l], (unsigned)chunkSizes[c], threads[t]);
+                    errors++;
+                }
+            }
+        }
+    }
+
+    /* a leaf size below XXH3T_CHUNKSIZE_MIN is an error, as in XXH3T_reset() */
+    {   XXH128_hash_t h;
+        if (XXH3T_128bits(buffer, 4096, XXH3T_CHUNKSIZE_MIN - 1, 2, &h) != XXH_ERROR) {
+            printf("XXH3T_128bits() accepted a leaf size below XXH3T_CHUNKSIZE_MIN \n");
+            errors++;
+    }   }
+
+    /* only the last leaf can be shorter than the leaf size */
+    {   XXH3T_state_t first, second;
+        if (XXH3T_reset(&first, 1024) != XXH_OK) exit(1);
+        if (XXH3T_reset(&second, 1024) != XXH_OK) exit(1);
+        if (XXH3T_addLeaf(&first, 1, buffer, 1000) != XXH_OK
+          || XXH3T_addLeaf(&first, 2, buffer, 1024) != XXH_ERROR
+          || XXH3T_addLeaf(&first, 0, buffer, 1024) != XXH_OK
+          || XXH3T_addLeaf(&first, 0, buffer, 10) != XXH_ERROR
+          || XXH3T_addLeaf(&second, 3, buffer, 1024) != XXH_OK
+          || XXH3T_merge(&first, &second) != XXH_ERROR
+          || XXH3T_merge(&second, &first) != XXH_ERROR) {
+            printf("XXH3T accepted a short leaf which isn't the last one \n");
+            errors++;
+    }   }
+
+    /* missing or repeated leaves are detected at digest time */
+    {   XXH3T_state_t state;
+        XXH128_hash_t h;
+        if (XXH3T_reset(&state, 1024) != XXH_OK) exit(1);
+        if (XXH3T_addLeaf(&state, 1, buffer + 1024, 1024) != XXH_OK) exit(1);
+        if (XXH3T_digest(&state, &h) != XXH_ERROR) {
+            printf("XXH3T_digest() accepted a tree without its first leaf \n");
+            errors++;
+        }
+        /* as many leaves as the largest index, but leaf 1 is repeated, leaf 0 missing */
+        if (XXH3T_addLeaf(&state, 1, buffer + 1024, 1024) != XXH_OK) exit(1);
+        if (XXH3T_digest(&state, &h) != XXH_ERROR) {
+            printf("XXH3T_digest() accepted a tree with a repeated leaf \n");
+            errors++;
+        }
+        if (XXH3T_reset(&state, 1024) != XXH_OK) exit(1);
+        if (XXH3T_addLeaf(&state, 0, buffer, 1024) != XXH_OK
+          || XXH3T_addLeaf(&state, 1, buffer + 1024, 1024) != XXH_OK
+          || XXH3T_digest(&state, &h) != XXH_OK) {
+            printf("XXH3T_digest() rejected a complete tree \n");
+            errors++;
+    }   }
+
+    free(buffer);
+    if (errors) return 1;
+    printf("XXH3T tree hash: OK \n");
+    return 0;
+}
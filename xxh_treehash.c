@@ -0,0 +1,304 @@
+/*
+ * xxHash - Extremely Fast Hash algorithm
+ * Copyright (C) 2026 Yann Collet
+ *
+ * BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * You can contact the author at:
+ *   - xxHash homepage: https://www.xxhash.com
+ *   - xxHash source repository: https://github.com/Cyan4973/xxHash
+ */
+
+
+/*!
+ * @file xxh_treehash.c
+ *
+ * XXH3T tree hashing.
+ *
+ * Optional add-on: xxhash.h itself never creates threads.
+ * This file provides the XXH3T_state_t streaming API, and XXH3T_128bits(),
+ * which splits the input into contiguous ranges of leaves, hashes each range
+ * on its own thread into a separate XXH3T_state_t, then merges them.
+ *
+ * Link with xxhash.o, and with `-pthread` on POSIX systems.
+ * Define `XXH_TREEHASH_NO_THREADS` to build a single-threaded version.
+ */
+
+#include "xxh_treehash.h"
+
+#include <stdlib.h>   /* malloc, free */
+#include <string.h>   /* memset */
+
+#if !defined(XXH_TREEHASH_NO_THREADS)
+#  if defined(_WIN32)
+#    include <windows.h>
+#  else
+#    include <pthread.h>
+#  endif
+#endif
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @def XXH_TREEHASH_MAX_THREADS
+ * @brief Upper limit on the number of threads created by XXH3T_128bits().
+ */
+#ifndef XXH_TREEHASH_MAX_THREADS
+#  define XXH_TREEHASH_MAX_THREADS 256
+#endif
+
+/* ==========================================
+ * XXH3T : streaming API
+ * ==========================================
+ */
+
+/*! @cond Doxygen ignores this part */
+static void XXH3T_writeLE64(unsigned char* dst, XXH64_hash_t v64)
+{
+    size_t i;
+    for (i = 0; i < 8; i++) dst[i] = (unsigned char)(v64 >> (8 * i));
+}
+
+/* Each leaf index is tagged by a bijective 64-bit hash, summed in indexSum */
+static XXH64_hash_t XXH3T_indexTag(XXH64_hash_t leafIndex)
+{
+    return XXH3_64bits_withSeed(NULL, 0, leafIndex);
+}
+/*! @endcond */
+
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_reset(XXH_NOESCAPE XXH3T_state_t* statePtr, size_t chunkSize)
+{
+    if (statePtr == NULL) return XXH_ERROR;
+    if (chunkSize < XXH3T_CHUNKSIZE_MIN) return XXH_ERROR;
+    memset(statePtr, 0, sizeof(*statePtr));
+    statePtr->chunkSize = chunkSize;
+    return XXH_OK;
+}
+
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_addLeaf(XXH_NOESCAPE XXH3T_state_t* statePtr, XXH64_hash_t leafIndex,
+              XXH_NOESCAPE const void* leaf, size_t leafLen)
+{
+    XXH128_canonical_t leafHash;
+    if (statePtr == NULL || leaf == NULL) return XXH_ERROR;
+    if (leafLen == 0 || leafLen > statePtr->chunkSize) return XXH_ERROR;
+    /* only the last leaf can be short */
+    if (leafLen < statePtr->chunkSize) {
+        if (statePtr->shortLeaf != 0 || leafIndex + 1 < statePtr->endLeaf) return XXH_ERROR;
+        statePtr->shortLeaf = leafIndex + 1;
+    } else if (statePtr->shortLeaf != 0 && leafIndex >= statePtr->shortLeaf) {
+        return XXH_ERROR;
+    }
+    XXH128_canonicalFromHash(&leafHash, XXH3_128bits(leaf, leafLen));
+    /* the leaf index is mixed in as a seed, so that leaves can't be swapped */
+    {   XXH128_hash_t const node = XXH3_128bits_withSeed(&leafHash, sizeof(leafHash), leafIndex);
+        statePtr->sumLo += node.low64;
+        statePtr->sumHi += node.high64;
+    }
+    statePtr->indexSum += XXH3T_indexTag(leafIndex);
+    statePtr->totalLen += leafLen;
+    statePtr->nbLeaves++;
+    if (leafIndex + 1 > statePtr->endLeaf) statePtr->endLeaf = leafIndex + 1;
+    return XXH_OK;
+}
+
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_merge(XXH_NOESCAPE XXH3T_state_t* dstState, XXH_NOESCAPE const XXH3T_state_t* srcState)
+{
+    if (dstState == NULL || srcState == NULL) return XXH_ERROR;
+    if (dstState->chunkSize != srcState->chunkSize) return XXH_ERROR;
+    /* only the last leaf can be short */
+    if (srcState->shortLeaf != 0) {
+        if (dstState->shortLeaf != 0 || dstState->endLeaf > srcState->shortLeaf) return XXH_ERROR;
+        dstState->shortLeaf = srcState->shortLeaf;
+    } else if (dstState->shortLeaf != 0 && srcState->endLeaf > dstState->shortLeaf) {
+        return XXH_ERROR;
+    }
+    if (srcState->endLeaf > dstState->endLeaf) dstState->endLeaf = srcState->endLeaf;
+    dstState->sumLo += srcState->sumLo;
+    dstState->sumHi += srcState->sumHi;
+    dstState->indexSum += srcState->indexSum;
+    dstState->totalLen += srcState->totalLen;
+    dstState->nbLeaves += srcState->nbLeaves;
+    return XXH_OK;
+}
+
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_digest(XXH_NOESCAPE const XXH3T_state_t* statePtr, XXH_NOESCAPE XXH128_hash_t* result)
+{
+    unsigned char parent[6 * sizeof(XXH64_hash_t)];
+    if (statePtr == NULL || result == NULL) return XXH_ERROR;
+    /* leaves [0, endLeaf) must all be present, each exactly once */
+    if (statePtr->nbLeaves != statePtr->endLeaf) return XXH_ERROR;
+    {   XXH64_hash_t expected = 0;
+        XXH64_hash_t n;
+        for (n = 0; n < statePtr->endLeaf; n++) expected += XXH3T_indexTag(n);
+        if (statePtr->indexSum != expected) return XXH_ERROR;
+    }
+    /* only the last leaf can be shorter than chunkSize */
+    if (statePtr->totalLen > statePtr->nbLeaves * statePtr->chunkSize) return XXH_ERROR;
+    if (statePtr->nbLeaves != 0
+      && statePtr->totalLen <= (statePtr->nbLeaves - 1) * statePtr->chunkSize) return XXH_ERROR;
+    XXH3T_writeLE64(parent +  0, XXH3T_VERSION);
+    XXH3T_writeLE64(parent +  8, statePtr->chunkSize);
+    XXH3T_writeLE64(parent + 16, statePtr->totalLen);
+    XXH3T_writeLE64(parent + 24, statePtr->nbLeaves);
+    XXH3T_writeLE64(parent + 32, statePtr->sumLo);
+    XXH3T_writeLE64(parent + 40, statePtr->sumHi);
+    *result = XXH3_128bits(parent, sizeof(parent));
+    return XXH_OK;
+}
+
+
+/* ==========================================
+ * XXH3T : multi-threaded one-shot
+ * ==========================================
+ */
+
+/*! @cond Doxygen ignores this part */
+typedef struct {
+    const unsigned char* input;
+    size_t len;
+    size_t chunkSize;
+    XXH64_hash_t firstLeaf;
+    XXH64_hash_t nbLeaves;
+    XXH3T_state_t state;
+} XXH3T_job_t;
+
+/* Hashes leaves [firstLeaf, firstLeaf+nbLeaves) into job->state */
+static void XXH3T_runJob(XXH3T_job_t* job)
+{
+    XXH64_hash_t n;
+    (void)XXH3T_reset(&job->state, job->chunkSize);
+    for (n = job->firstLeaf; n < job->firstLeaf + job->nbLeaves; n++) {
+        size_t const start = (size_t)n * job->chunkSize;
+        size_t const leafLen = (job->len - start < job->chunkSize) ? job->len - start : job->chunkSize;
+        (void)XXH3T_addLeaf(&job->state, n, job->input + start, leafLen);
+    }
+}
+
+#if !defined(XXH_TREEHASH_NO_THREADS)
+#  if defined(_WIN32)
+typedef HANDLE XXH3T_thread_t;
+static DWORD WINAPI XXH3T_worker(LPVOID opaque)
+{
+    XXH3T_runJob((XXH3T_job_t*)opaque);
+    return 0;
+}
+static int XXH3T_threadCreate(XXH3T_thread_t* thread, XXH3T_job_t* job)
+{
+    *thread = CreateThread(NULL, 0, XXH3T_worker, job, 0, NULL);
+    return *thread == NULL;
+}
+static void XXH3T_threadJoin(XXH3T_thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#  else
+typedef pthread_t XXH3T_thread_t;
+static void* XXH3T_worker(void* opaque)
+{
+    XXH3T_runJob((XXH3T_job_t*)opaque);
+    return NULL;
+}
+static int XXH3T_threadCreate(XXH3T_thread_t* thread, XXH3T_job_t* job)
+{
+    return pthread_create(thread, NULL, XXH3T_worker, job) != 0;
+}
+static void XXH3T_threadJoin(XXH3T_thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+#  endif
+#endif
+/*! @endcond */
+
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_128bits(XXH_NOESCAPE const void* input, size_t len, size_t chunkSize, unsigned nbThreads,
+              XXH_NOESCAPE XXH128_hash_t* result)
+{
+    XXH3T_job_t single;
+    XXH64_hash_t nbLeaves;
+
+    if (result == NULL) return XXH_ERROR;
+    if (chunkSize < XXH3T_CHUNKSIZE_MIN) return XXH_ERROR;
+    nbLeaves = (len + chunkSize - 1) / chunkSize;
+    if (nbThreads > XXH_TREEHASH_MAX_THREADS) nbThreads = XXH_TREEHASH_MAX_THREADS;
+    if (nbThreads > nbLeaves) nbThreads = (unsigned)nbLeaves;
+
+    single.input = (const unsigned char*)input;
+    single.len = len;
+    single.chunkSize = chunkSize;
+    single.firstLeaf = 0;
+    single.nbLeaves = nbLeaves;
+
+#if !defined(XXH_TREEHASH_NO_THREADS)
+    if (nbThreads > 1) {
+        XXH3T_job_t* const jobs = (XXH3T_job_t*)malloc(nbThreads * sizeof(XXH3T_job_t));
+        XXH3T_thread_t* const threads = (XXH3T_thread_t*)malloc(nbThreads * sizeof(XXH3T_thread_t));
+        if (jobs != NULL && threads != NULL) {
+            unsigned t, nbStarted = 0;
+            XXH64_hash_t firstLeaf = 0;
+            for (t = 0; t < nbThreads; t++) {
+                /* spread the remainder over the first jobs */
+                jobs[t] = single;
+                jobs[t].firstLeaf = firstLeaf;
+                jobs[t].nbLeaves = nbLeaves / nbThreads + (t < nbLeaves % nbThreads);
+                firstLeaf += jobs[t].nbLeaves;
+            }
+            /* job 0 runs on the calling thread */
+            for (t = 1; t < nbThreads; t++) {
+                if (XXH3T_threadCreate(&threads[t], &jobs[t])) break;
+                nbStarted = t;
+            }
+            XXH3T_runJob(&jobs[0]);
+            /* jobs which couldn't get a thread run here */
+            for (t = nbStarted + 1; t < nbThreads; t++) XXH3T_runJob(&jobs[t]);
+            for (t = 1; t <= nbStarted; t++) XXH3T_threadJoin(threads[t]);
+            for (t = 1; t < nbThreads; t++) (void)XXH3T_merge(&jobs[0].state, &jobs[t].state);
+            {   XXH_errorcode const err = XXH3T_digest(&jobs[0].state, result);
+                free(jobs);
+                free(threads);
+                return err;
+            }
+        }
+        free(jobs);
+        free(threads);
+    }
+#else
+    (void)nbThreads;
+#endif
+    XXH3T_runJob(&single);
+    return XXH3T_digest(&single.state, result);
+}
+
+#if defined (__cplusplus)
+}
+#endif
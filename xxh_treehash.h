@@ -0,0 +1,197 @@
+/*
+ * xxHash - XXH3T tree hashing
+ * Copyright (C) 2026 Yann Collet
+ *
+ * BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * You can contact the author at:
+ *   - xxHash homepage: https://www.xxhash.com
+ *   - xxHash source repository: https://github.com/Cyan4973/xxHash
+ */
+
+#ifndef XXH_TREEHASH_H_27391744621
+#define XXH_TREEHASH_H_27391744621
+
+/*
+ * This add-on is not part of libxxhash, and is not installed:
+ * compile xxh_treehash.c along with xxhash.c into your project,
+ * with `-pthread` on POSIX systems.
+ */
+
+#include "xxhash.h"  /* XXH64_hash_t, XXH128_hash_t */
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifdef XXH_NAMESPACE
+#  define XXH3T_reset XXH_NAME2(XXH_NAMESPACE, XXH3T_reset)
+#  define XXH3T_addLeaf XXH_NAME2(XXH_NAMESPACE, XXH3T_addLeaf)
+#  define XXH3T_merge XXH_NAME2(XXH_NAMESPACE, XXH3T_merge)
+#  define XXH3T_digest XXH_NAME2(XXH_NAMESPACE, XXH3T_digest)
+#  define XXH3T_128bits XXH_NAME2(XXH_NAMESPACE, XXH3T_128bits)
+#endif
+
+/* ===   XXH3T : tree hashing   === */
+
+/*!
+ * @brief Version of the XXH3T tree hashing format.
+ *
+ * XXH3T cuts the input into fixed-size leaves, which can be hashed
+ * independently, in any order, by any number of threads.
+ * Its result is different from XXH3, but it only depends on
+ * the input, the leaf size, and this version number.
+ *
+ * Format:
+ * - leaf `n` covers bytes `[n * chunkSize, min((n+1) * chunkSize, len))`;
+ * - each leaf is hashed with XXH3_128bits(),
+ *   then its canonical representation is hashed with
+ *   XXH3_128bits_withSeed(), using the leaf index as seed;
+ * - the resulting leaf nodes are summed, modulo 2^64, each half independently;
+ * - the parent hash is XXH3_128bits() of the little-endian 64-bit sequence
+ *   { XXH3T_VERSION, chunkSize, len, nbLeaves, sum.low64, sum.high64 }.
+ *
+ * Since the sum is commutative, leaves can be added in any order,
+ * and partial states can be merged.
+ */
+#define XXH3T_VERSION 1
+
+/*! @brief Minimum leaf size for XXH3T, in bytes. */
+#define XXH3T_CHUNKSIZE_MIN 1024
+
+/*!
+ * @brief Structure for the XXH3T streaming API.
+ *
+ * Its definition is exposed so that states can be allocated on stack,
+ * but its members are private, and may change between versions.
+ *
+ * @see XXH3T_reset()
+ */
+struct XXH3T_state_s {
+   XXH64_hash_t sumLo;       /*!< Sum of the low halves of leaf nodes. */
+   XXH64_hash_t sumHi;       /*!< Sum of the high halves of leaf nodes. */
+   XXH64_hash_t totalLen;    /*!< Total length of leaves added so far. */
+   XXH64_hash_t nbLeaves;    /*!< Number of leaves added so far. */
+   XXH64_hash_t chunkSize;   /*!< Leaf size. All leaves are this size, except the last one. */
+   XXH64_hash_t endLeaf;     /*!< Index of the last leaf added so far, plus one. */
+   XXH64_hash_t shortLeaf;   /*!< Index of the leaf shorter than @ref chunkSize plus one, 0 if none. */
+   XXH64_hash_t indexSum;    /*!< Sum of a hash of each leaf index, to detect missing and repeated leaves. */
+};   /* typedef'd to XXH3T_state_t */
+
+/*!
+ * @brief The state struct for the XXH3T streaming API.
+ * @see XXH3T_state_s for details.
+ */
+typedef struct XXH3T_state_s XXH3T_state_t;
+
+/*!
+ * @brief Resets an @ref XXH3T_state_t to begin a new tree hash.
+ *
+ * @param statePtr  The state to reset. It can be allocated on stack.
+ * @param chunkSize The leaf size, in bytes, must be >= @ref XXH3T_CHUNKSIZE_MIN.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH3T_reset(XXH_NOESCAPE XXH3T_state_t* statePtr, size_t chunkSize);
+
+/*!
+ * @brief Hashes one leaf and adds it to an @ref XXH3T_state_t.
+ *
+ * @param statePtr  The state to update.
+ * @param leafIndex The position of the leaf, starting at 0.
+ * @param leaf      The leaf content, at `leafIndex * chunkSize` within the whole input.
+ * @param leafLen   The leaf length, in bytes, must be `chunkSize`, except for the last leaf,
+ *                  which can be shorter, but not empty.
+ *
+ * Leaves can be added in any order, and from multiple states, later merged
+ * with XXH3T_merge(). Each leaf must be added exactly once:
+ * XXH3T_digest() fails if a leaf is missing or was added more than once.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure, including when a leaf shorter than
+ *         `chunkSize` wouldn't be the last one.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_addLeaf(XXH_NOESCAPE XXH3T_state_t* statePtr, XXH64_hash_t leafIndex,
+              XXH_NOESCAPE const void* leaf, size_t leafLen);
+
+/*!
+ * @brief Merges the leaves added to @p srcState into @p dstState.
+ *
+ * Both states must have been reset with the same leaf size,
+ * and must not share any leaf.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure, including when a leaf shorter than
+ *         `chunkSize` wouldn't be the last one.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_merge(XXH_NOESCAPE XXH3T_state_t* dstState, XXH_NOESCAPE const XXH3T_state_t* srcState);
+
+/*!
+ * @brief Calculates the XXH3T hash of all leaves added to @p statePtr.
+ *
+ * @param statePtr The state holding all leaves of the input.
+ * @param result   Receives the calculated 128-bit tree hash.
+ *
+ * The tree must be complete: leaves `0` to `n-1` must each have been added
+ * exactly once, where `n-1` is the largest leaf index.
+ * An incomplete tree, or a tree with a repeated leaf, is detected and rejected,
+ * with a false acceptance probability of 2^-64 for a repeated leaf.
+ * This check costs one short hash per leaf.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if the tree is incomplete, or a leaf was added twice.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_digest(XXH_NOESCAPE const XXH3T_state_t* statePtr, XXH_NOESCAPE XXH128_hash_t* result);
+
+/*!
+ * @brief Calculates the XXH3T tree hash of @p input, using up to @p nbThreads threads.
+ *
+ * The result only depends on @p input and @p chunkSize, never on @p nbThreads.
+ * It is identical to feeding all leaves into an XXH3T_state_t,
+ * see XXH3T_reset() and @ref XXH3T_VERSION for the format.
+ *
+ * @param input     The block of data to be hashed, at least @p len bytes in size.
+ * @param len       The length of @p input, in bytes.
+ * @param chunkSize The leaf size, in bytes, must be >= XXH3T_CHUNKSIZE_MIN.
+ * @param nbThreads Maximum number of threads. 0 and 1 mean no extra thread.
+ * @param result    Receives the calculated 128-bit tree hash.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p chunkSize is too small, as XXH3T_reset() does.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3T_128bits(XXH_NOESCAPE const void* input, size_t len, size_t chunkSize, unsigned nbThreads,
+              XXH_NOESCAPE XXH128_hash_t* result);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* XXH_TREEHASH_H_27391744621 */
@@ -44,6 +44,10 @@
  * with flags like `-mavx*`, `-march=native`, or `/arch:AVX*`, there will be
  * an error. See @ref XXH_X86DISPATCH_ALLOW_AVX for details.
  *
+ * The selected implementation can be queried with XXH_getDispatchedVector(),
+ * and lowered with the `XXH_DISPATCH` environment variable or XXH_setDispatch().
+ * Alternatively, see @ref XXH_DISPATCH_IFUNC to bind it once at load time.
+ *
  * @defgroup dispatch x86 Dispatcher
  * @{
  */
@@ -169,6 +173,29 @@ extern "C" {
 #  endif
 #endif /* XXH_DISPATCH_AVX512 */
 
+/*!
+ * @def XXH_DISPATCH_IFUNC
+ * @brief Resolves the dispatched functions at load time with GNU `ifunc`.
+ *
+ * By default, the `*_dispatch()` functions call the selected implementation
+ * through a table of function pointers, filled by a constructor.
+ *
+ * When XXH_DISPATCH_IFUNC is set to 1, each public `*_dispatch()` function is
+ * instead an `ifunc` symbol: the dynamic loader (or the startup code of a
+ * static binary) runs the CPUID check once and binds the symbol directly to
+ * the best complete implementation. Calls then cost a plain PLT call, with no
+ * pointer load nor NULL check, and short inputs also benefit from the wider
+ * instruction set.
+ *
+ * Requires GCC or Clang on an ELF target whose loader supports `ifunc`
+ * (glibc, FreeBSD; not musl). In this mode, the implementation is fixed at
+ * load time: the `XXH_DISPATCH` environment variable is ignored and
+ * XXH_setDispatch() can't change it.
+ */
+#ifndef XXH_DISPATCH_IFUNC
+#  define XXH_DISPATCH_IFUNC 0
+#endif
+
 /*!
  * @def XXH_TARGET_SSE2
  * @brief Allows a function to be compiled with SSE2 intrinsics.
@@ -224,6 +251,8 @@ extern "C" {
 #endif
 /*! @endcond */
 #include <assert.h>
+#include <stdlib.h>   /* getenv */
+#include <string.h>   /* strcmp */
 
 #ifndef XXH_DOXYGEN
 #define XXH_INLINE_ALL
@@ -249,6 +278,13 @@ extern "C" {
 #  define XXH_CONSTRUCTOR
 #  define XXH_DISPATCH_MAYBE_NULL 1
 #endif
+
+#if XXH_DISPATCH_IFUNC
+#  if !(defined(__GNUC__) && defined(__ELF__) && XXH_HAS_ATTRIBUTE(ifunc))
+#    error "XXH_DISPATCH_IFUNC requires GCC or Clang targeting ELF with ifunc support."
+#  endif
+#  define XXH_IFUNC(resolver) __attribute__((ifunc(resolver)))
+#endif
 /*! @endcond */
 
 
@@ -511,6 +547,7 @@ XXHL64_default_##suffix(XXH_NOESCAPE const void* XXH_RESTRICT input,          \
 {                                                                             \
     return XXH3_hashLong_64b_internal(                                        \
                input, len, XXH3_kSecret, sizeof(XXH3_kSecret),                \
+               XXH_PREFETCH_DIST,                                             \
                XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix            \
     );                                                                        \
 }                                                                             \
@@ -536,6 +573,7 @@ XXHL64_secret_##suffix(XXH_NOESCAPE const void* XXH_RESTRICT input,           \
 {                                                                             \
     return XXH3_hashLong_64b_internal(                                        \
                     input, len, secret, secretLen,                            \
+                    XXH_PREFETCH_DIST,                                        \
                     XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix       \
     );                                                                        \
 }                                                                             \
@@ -547,7 +585,8 @@ XXH3_update_##suffix(XXH_NOESCAPE XXH3_state_t* state,                        \
                      XXH_NOESCAPE const void* input, size_t len)              \
 {                                                                             \
     return XXH3_update(state, (const xxh_u8*)input, len,                      \
-                    XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix);     \
+                    XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix,      \
+                    XXH3_initCustomSecret_##suffix);                          \
 }                                                                             \
                                                                               \
 /* ===   XXH128 default variants   === */                                     \
@@ -558,6 +597,7 @@ XXHL128_default_##suffix(XXH_NOESCAPE  const void* XXH_RESTRICT input,        \
 {                                                                             \
     return XXH3_hashLong_128b_internal(                                       \
                     input, len, XXH3_kSecret, sizeof(XXH3_kSecret),           \
+                    XXH_PREFETCH_DIST,                                        \
                     XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix       \
     );                                                                        \
 }                                                                             \
@@ -572,6 +612,7 @@ XXHL128_secret_##suffix(XXH_NOESCAPE const void* XXH_RESTRICT input,          \
 {                                                                             \
     return XXH3_hashLong_128b_internal(                                       \
                     input, len, (const xxh_u8*)secret, secretLen,             \
+                    XXH_PREFETCH_DIST,                                        \
                     XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix);     \
 }                                                                             \
                                                                               \
@@ -584,12 +625,57 @@ XXHL128_seed_##suffix(XXH_NOESCAPE const void* XXH_RESTRICT input, size_t len,\
     return XXH3_hashLong_128b_withSeed_internal(input, len, seed,             \
                     XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix,      \
                     XXH3_initCustomSecret_##suffix);                          \
+}                                                                             \
+                                                                              \
+/* ===   XXH3, arrays of integer keys   === */                                \
+                                                                              \
+XXH_NO_INLINE target void                                                     \
+XXH3_u32Array_##suffix(XXH_NOESCAPE const XXH32_hash_t* keys, size_t nbKeys,  \
+                       XXH_NOESCAPE XXH64_hash_t* out)                        \
+{                                                                             \
+    XXH3_hashU32Array_##suffix(keys, nbKeys, out);                            \
+}                                                                             \
+                                                                              \
+XXH_NO_INLINE target void                                                     \
+XXH3_u64Array_##suffix(XXH_NOESCAPE const XXH64_hash_t* keys, size_t nbKeys,  \
+                       XXH_NOESCAPE XXH64_hash_t* out)                        \
+{                                                                             \
+    XXH3_hashU64Array_##suffix(keys, nbKeys, out);                            \
+}                                                                             \
+                                                                              \
+/* ===   XXH3 streaming digests   === */                                     \
+                                                                              \
+XXH_NO_INLINE target XXH64_hash_t                                             \
+XXH3_digest64_##suffix(XXH_NOESCAPE const XXH3_state_t* state)                \
+{                                                                             \
+    return XXH3_64bits_digest_internal(state,                                 \
+                    XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix,      \
+                    XXH3_initCustomSecret_##suffix);                          \
+}                                                                             \
+                                                                              \
+XXH_NO_INLINE target XXH128_hash_t                                            \
+XXH3_digest128_##suffix(XXH_NOESCAPE const XXH3_state_t* state)               \
+{                                                                             \
+    return XXH3_128bits_digest_internal(state,                                \
+                    XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix,      \
+                    XXH3_initCustomSecret_##suffix);                          \
+}                                                                             \
+                                                                              \
+/* ===   XXH3, secret generation from a seed   === */                         \
+                                                                              \
+XXH_NO_INLINE target void                                                     \
+XXH3_genSecret_##suffix(XXH_NOESCAPE void* secretBuffer, XXH64_hash_t seed)   \
+{                                                                             \
+    XXH3_generateSecret_fromSeed_internal(secretBuffer, seed,                 \
+                    XXH3_initCustomSecret_##suffix);                          \
 }
 
 /*! @endcond */
 /* End XXH_DEFINE_DISPATCH_FUNCS */
 
 /*! @cond Doxygen ignores this part */
+/* there is no SSE2 kernel for 32-bit keys: it is slower than scalar code */
+#define XXH3_hashU32Array_sse2 XXH3_hashU32Array_scalar
 #if XXH_DISPATCH_SCALAR
 XXH_DEFINE_DISPATCH_FUNCS(scalar, /* nothing */)
 #endif
@@ -601,6 +687,7 @@ XXH_DEFINE_DISPATCH_FUNCS(avx2, XXH_TARGET_AVX2)
 XXH_DEFINE_DISPATCH_FUNCS(avx512, XXH_TARGET_AVX512)
 #endif
 #undef XXH_DEFINE_DISPATCH_FUNCS
+#undef XXH3_hashU32Array_sse2
 /*! @endcond */
 
 /* ====    Dispatchers    ==== */
@@ -614,16 +701,32 @@ typedef XXH64_hash_t (*XXH3_dispatchx86_hashLong64_withSecret)(XXH_NOESCAPE cons
 
 typedef XXH_errorcode (*XXH3_dispatchx86_update)(XXH_NOESCAPE XXH3_state_t*, XXH_NOESCAPE const void*, size_t);
 
+typedef void (*XXH3_dispatchx86_u32Array)(XXH_NOESCAPE const XXH32_hash_t*, size_t, XXH_NOESCAPE XXH64_hash_t*);
+
+typedef void (*XXH3_dispatchx86_u64Array)(XXH_NOESCAPE const XXH64_hash_t*, size_t, XXH_NOESCAPE XXH64_hash_t*);
+
+typedef XXH64_hash_t (*XXH3_dispatchx86_digest64)(XXH_NOESCAPE const XXH3_state_t*);
+
+typedef XXH128_hash_t (*XXH3_dispatchx86_digest128)(XXH_NOESCAPE const XXH3_state_t*);
+
+typedef void (*XXH3_dispatchx86_genSecret)(XXH_NOESCAPE void*, XXH64_hash_t);
+
 typedef struct {
     XXH3_dispatchx86_hashLong64_default    hashLong64_default;
     XXH3_dispatchx86_hashLong64_withSeed   hashLong64_seed;
     XXH3_dispatchx86_hashLong64_withSecret hashLong64_secret;
     XXH3_dispatchx86_update                update;
+    XXH3_dispatchx86_u32Array              u32Array;
+    XXH3_dispatchx86_u64Array              u64Array;
+    XXH3_dispatchx86_digest64              digest;
+    XXH3_dispatchx86_genSecret             genSecret;
 } XXH_dispatchFunctions_s;
 
 #define XXH_NB_DISPATCHES 4
 /*! @endcond */
 
+#if !XXH_DISPATCH_IFUNC
+
 /*!
  * @private
  * @brief Table of dispatchers for @ref XXH3_64bits().
@@ -632,27 +735,31 @@ typedef struct {
  */
 static const XXH_dispatchFunctions_s XXH_kDispatch[XXH_NB_DISPATCHES] = {
 #if XXH_DISPATCH_SCALAR
-    /* Scalar */ { XXHL64_default_scalar, XXHL64_seed_scalar, XXHL64_secret_scalar, XXH3_update_scalar },
+    /* Scalar */ { XXHL64_default_scalar, XXHL64_seed_scalar, XXHL64_secret_scalar, XXH3_update_scalar, XXH3_u32Array_scalar, XXH3_u64Array_scalar,
+                   XXH3_digest64_scalar, XXH3_genSecret_scalar },
 #else
-    /* Scalar */ { NULL, NULL, NULL, NULL },
+    /* Scalar */ { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL },
 #endif
-    /* SSE2   */ { XXHL64_default_sse2,   XXHL64_seed_sse2,   XXHL64_secret_sse2,   XXH3_update_sse2 },
+    /* SSE2   */ { XXHL64_default_sse2,   XXHL64_seed_sse2,   XXHL64_secret_sse2,   XXH3_update_sse2,   XXH3_u32Array_sse2,   XXH3_u64Array_sse2,
+                   XXH3_digest64_sse2,   XXH3_genSecret_sse2 },
 #if XXH_DISPATCH_AVX2
-    /* AVX2   */ { XXHL64_default_avx2,   XXHL64_seed_avx2,   XXHL64_secret_avx2,   XXH3_update_avx2 },
+    /* AVX2   */ { XXHL64_default_avx2,   XXHL64_seed_avx2,   XXHL64_secret_avx2,   XXH3_update_avx2,   XXH3_u32Array_avx2,   XXH3_u64Array_avx2,
+                   XXH3_digest64_avx2,   XXH3_genSecret_avx2 },
 #else
-    /* AVX2   */ { NULL, NULL, NULL, NULL },
+    /* AVX2   */ { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL },
 #endif
 #if XXH_DISPATCH_AVX512
-    /* AVX512 */ { XXHL64_default_avx512, XXHL64_seed_avx512, XXHL64_secret_avx512, XXH3_update_avx512 }
+    /* AVX512 */ { XXHL64_default_avx512, XXHL64_seed_avx512, XXHL64_secret_avx512, XXH3_update_avx512, XXH3_u32Array_avx512, XXH3_u64Array_avx512,
+                   XXH3_digest64_avx512, XXH3_genSecret_avx512 }
 #else
-    /* AVX512 */ { NULL, NULL, NULL, NULL }
+    /* AVX512 */ { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
 #endif
 };
 /*!
  * @private
  * @brief The selected dispatch table for @ref XXH3_64bits().
  */
-static XXH_dispatchFunctions_s XXH_g_dispatch = { NULL, NULL, NULL, NULL };
+static XXH_dispatchFunctions_s XXH_g_dispatch = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
 
 
 /*! @cond Doxygen ignores this part */
@@ -667,6 +774,7 @@ typedef struct {
     XXH3_dispatchx86_hashLong128_withSeed   hashLong128_seed;
     XXH3_dispatchx86_hashLong128_withSecret hashLong128_secret;
     XXH3_dispatchx86_update                 update;
+    XXH3_dispatchx86_digest128              digest;
 } XXH_dispatch128Functions_s;
 /*! @endcond */
 
@@ -679,20 +787,20 @@ typedef struct {
  */
 static const XXH_dispatch128Functions_s XXH_kDispatch128[XXH_NB_DISPATCHES] = {
 #if XXH_DISPATCH_SCALAR
-    /* Scalar */ { XXHL128_default_scalar, XXHL128_seed_scalar, XXHL128_secret_scalar, XXH3_update_scalar },
+    /* Scalar */ { XXHL128_default_scalar, XXHL128_seed_scalar, XXHL128_secret_scalar, XXH3_update_scalar, XXH3_digest128_scalar },
 #else
-    /* Scalar */ { NULL, NULL, NULL, NULL },
+    /* Scalar */ { NULL, NULL, NULL, NULL, NULL },
 #endif
-    /* SSE2   */ { XXHL128_default_sse2,   XXHL128_seed_sse2,   XXHL128_secret_sse2,   XXH3_update_sse2 },
+    /* SSE2   */ { XXHL128_default_sse2,   XXHL128_seed_sse2,   XXHL128_secret_sse2,   XXH3_update_sse2,   XXH3_digest128_sse2 },
 #if XXH_DISPATCH_AVX2
-    /* AVX2   */ { XXHL128_default_avx2,   XXHL128_seed_avx2,   XXHL128_secret_avx2,   XXH3_update_avx2 },
+    /* AVX2   */ { XXHL128_default_avx2,   XXHL128_seed_avx2,   XXHL128_secret_avx2,   XXH3_update_avx2,   XXH3_digest128_avx2 },
 #else
-    /* AVX2   */ { NULL, NULL, NULL, NULL },
+    /* AVX2   */ { NULL, NULL, NULL, NULL, NULL },
 #endif
 #if XXH_DISPATCH_AVX512
-    /* AVX512 */ { XXHL128_default_avx512, XXHL128_seed_avx512, XXHL128_secret_avx512, XXH3_update_avx512 }
+    /* AVX512 */ { XXHL128_default_avx512, XXHL128_seed_avx512, XXHL128_secret_avx512, XXH3_update_avx512, XXH3_digest128_avx512 }
 #else
-    /* AVX512 */ { NULL, NULL, NULL, NULL }
+    /* AVX512 */ { NULL, NULL, NULL, NULL, NULL }
 #endif
 };
 
@@ -700,15 +808,74 @@ static const XXH_dispatch128Functions_s XXH_kDispatch128[XXH_NB_DISPATCHES] = {
  * @private
  * @brief The selected dispatch table for @ref XXH3_64bits().
  */
-static XXH_dispatch128Functions_s XXH_g_dispatch128 = { NULL, NULL, NULL, NULL };
+static XXH_dispatch128Functions_s XXH_g_dispatch128 = { NULL, NULL, NULL, NULL, NULL };
+
+/*!
+ * @private
+ * @brief The @ref XXH_VECTOR_TYPE of the selected dispatch tables, -1 until initialized.
+ */
+static int XXH_g_dispatchVector = -1;
+
+/*!
+ * @private
+ * @brief The best @ref XXH_VECTOR_TYPE supported by this CPU, as returned by XXH_featureTest().
+ */
+static int XXH_g_bestVector = -1;
+
+/*!
+ * @private
+ * @brief Reads the `XXH_DISPATCH` environment variable.
+ *
+ * Accepted values are `scalar`, `sse2`, `avx2` and `avx512`.
+ *
+ * @return The requested @ref XXH_VECTOR_TYPE, or -1 if unset or not recognized.
+ */
+static int XXH_dispatchFromEnv(void)
+{
+    static const char* const names[XXH_NB_DISPATCHES] = { "scalar", "sse2", "avx2", "avx512" };
+    const char* env;
+    int vecID;
+#if defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4996) /* getenv() may be unsafe */
+#endif
+    env = getenv("XXH_DISPATCH");
+#if defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+    if (env == NULL) return -1;
+    for (vecID = XXH_SCALAR; vecID < XXH_NB_DISPATCHES; vecID++) {
+        if (!strcmp(env, names[vecID])) return vecID;
+    }
+    XXH_debugPrint("Unknown XXH_DISPATCH value, ignored.");
+    return -1;
+}
+
+/*!
+ * @private
+ * @brief Sets the dispatch tables to @p vecID.
+ */
+static void XXH_selectDispatch(int vecID)
+{
+    assert(XXH_kDispatch[vecID].update != NULL);
+    XXH_g_dispatch = XXH_kDispatch[vecID];
+    XXH_g_dispatch128 = XXH_kDispatch128[vecID];
+    XXH_g_dispatchVector = vecID;
+}
 
 /*!
  * @private
  * @brief Runs a CPUID check and sets the correct dispatch tables.
+ *
+ * `XXH_DISPATCH` can request a lower implementation than the best one.
+ * A request the CPU doesn't support is capped to the best implementation,
+ * and a request for a variant which isn't compiled in
+ * selects the next supported one.
  */
-static XXH_CONSTRUCTOR void XXH_setDispatch(void)
+static XXH_CONSTRUCTOR void XXH_initDispatch(void)
 {
     int vecID = XXH_featureTest();
+    int const requested = XXH_dispatchFromEnv();
     XXH_STATIC_ASSERT(XXH_AVX512 == XXH_NB_DISPATCHES-1);
     assert(XXH_SCALAR <= vecID && vecID <= XXH_AVX512);
 #if !XXH_DISPATCH_SCALAR
@@ -720,8 +887,38 @@ static XXH_CONSTRUCTOR void XXH_setDispatch(void)
 #if !XXH_DISPATCH_AVX2
     assert(vecID != XXH_AVX2);
 #endif
-    XXH_g_dispatch = XXH_kDispatch[vecID];
-    XXH_g_dispatch128 = XXH_kDispatch128[vecID];
+    XXH_g_bestVector = vecID;
+    if (requested >= 0 && requested < vecID) {
+        vecID = requested;
+        while (XXH_kDispatch[vecID].update == NULL) vecID++;
+    }
+    XXH_selectDispatch(vecID);
+}
+
+/*!
+ * @brief Returns the @ref XXH_VECTOR_TYPE currently used by the dispatcher.
+ */
+int XXH_getDispatchedVector(void)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatchVector < 0)
+        XXH_initDispatch();
+    return XXH_g_dispatchVector;
+}
+
+/*!
+ * @brief Forces the dispatcher to use @p vecID.
+ *
+ * @return @ref XXH_OK on success,
+ *         @ref XXH_ERROR if @p vecID is not compiled in or not supported by this CPU.
+ */
+XXH_errorcode XXH_setDispatch(int vecID)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatchVector < 0)
+        XXH_initDispatch();
+    if (vecID < XXH_SCALAR || vecID > XXH_g_bestVector) return XXH_ERROR;
+    if (XXH_kDispatch[vecID].update == NULL) return XXH_ERROR;
+    XXH_selectDispatch(vecID);
+    return XXH_OK;
 }
 
 
@@ -734,7 +931,7 @@ XXH3_hashLong_64b_defaultSecret_selection(const void* XXH_RESTRICT input, size_t
 {
     (void)seed64; (void)secret; (void)secretLen;
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.hashLong64_default == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch.hashLong64_default(input, len);
 }
 
@@ -749,7 +946,7 @@ XXH3_hashLong_64b_withSeed_selection(const void* XXH_RESTRICT input, size_t len,
 {
     (void)secret; (void)secretLen;
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.hashLong64_seed == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch.hashLong64_seed(input, len, seed64);
 }
 
@@ -764,7 +961,7 @@ XXH3_hashLong_64b_withSecret_selection(const void* XXH_RESTRICT input, size_t le
 {
     (void)seed64;
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.hashLong64_secret == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch.hashLong64_secret(input, len, secret, secretLen);
 }
 
@@ -773,15 +970,50 @@ XXH64_hash_t XXH3_64bits_withSecret_dispatch(XXH_NOESCAPE const void* input, siz
     return XXH3_64bits_internal(input, len, 0, secret, secretLen, XXH3_hashLong_64b_withSecret_selection);
 }
 
+XXH64_hash_t XXH3_64bits_withSecretandSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen, XXH64_hash_t seed)
+{
+    if (len <= XXH3_MIDSIZE_MAX)
+        return XXH3_64bits_internal(input, len, seed, XXH3_kSecret, sizeof(XXH3_kSecret), NULL);
+    return XXH3_hashLong_64b_withSecret_selection(input, len, seed, (const xxh_u8*)secret, secretLen);
+}
+
 XXH_errorcode
 XXH3_64bits_update_dispatch(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
 {
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.update == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
 
     return XXH_g_dispatch.update(state, (const xxh_u8*)input, len);
 }
 
+XXH64_hash_t XXH3_64bits_digest_dispatch(XXH_NOESCAPE const XXH3_state_t* state)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.digest == NULL)
+        XXH_initDispatch();
+    return XXH_g_dispatch.digest(state);
+}
+
+void XXH3_generateSecret_fromSeed_dispatch(XXH_NOESCAPE void* secretBuffer, XXH64_hash_t seed)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.genSecret == NULL)
+        XXH_initDispatch();
+    XXH_g_dispatch.genSecret(secretBuffer, seed);
+}
+
+void XXH3_64bits_u32_array_dispatch(XXH_NOESCAPE const XXH32_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.u32Array == NULL)
+        XXH_initDispatch();
+    XXH_g_dispatch.u32Array(keys, nbKeys, out);
+}
+
+void XXH3_64bits_u64_array_dispatch(XXH_NOESCAPE const XXH64_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch.u64Array == NULL)
+        XXH_initDispatch();
+    XXH_g_dispatch.u64Array(keys, nbKeys, out);
+}
+
 /*! @endcond */
 
 
@@ -794,7 +1026,7 @@ XXH3_hashLong_128b_defaultSecret_selection(const void* input, size_t len,
 {
     (void)seed64; (void)secret; (void)secretLen;
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch128.hashLong128_default == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch128.hashLong128_default(input, len);
 }
 
@@ -809,7 +1041,7 @@ XXH3_hashLong_128b_withSeed_selection(const void* input, size_t len,
 {
     (void)secret; (void)secretLen;
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch128.hashLong128_seed == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch128.hashLong128_seed(input, len, seed64);
 }
 
@@ -824,7 +1056,7 @@ XXH3_hashLong_128b_withSecret_selection(const void* input, size_t len,
 {
     (void)seed64;
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch128.hashLong128_secret == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch128.hashLong128_secret(input, len, secret, secretLen);
 }
 
@@ -833,14 +1065,367 @@ XXH128_hash_t XXH3_128bits_withSecret_dispatch(XXH_NOESCAPE const void* input, s
     return XXH3_128bits_internal(input, len, 0, secret, secretLen, XXH3_hashLong_128b_withSecret_selection);
 }
 
+XXH128_hash_t XXH3_128bits_withSecretandSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen, XXH64_hash_t seed)
+{
+    if (len <= XXH3_MIDSIZE_MAX)
+        return XXH3_128bits_internal(input, len, seed, XXH3_kSecret, sizeof(XXH3_kSecret), NULL);
+    return XXH3_hashLong_128b_withSecret_selection(input, len, seed, secret, secretLen);
+}
+
 XXH_errorcode
 XXH3_128bits_update_dispatch(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
 {
     if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch128.update == NULL)
-        XXH_setDispatch();
+        XXH_initDispatch();
     return XXH_g_dispatch128.update(state, (const xxh_u8*)input, len);
 }
 
+XXH128_hash_t XXH3_128bits_digest_dispatch(XXH_NOESCAPE const XXH3_state_t* state)
+{
+    if (XXH_DISPATCH_MAYBE_NULL && XXH_g_dispatch128.digest == NULL)
+        XXH_initDispatch();
+    return XXH_g_dispatch128.digest(state);
+}
+
+/*! @endcond */
+
+#else /* XXH_DISPATCH_IFUNC */
+
+/*! @cond PRIVATE */
+/*!
+ * @private
+ * @brief Defines complete XXH3 functions for one vector implementation.
+ *
+ * These are the targets of the ifunc resolvers: unlike the `*_selection`
+ * wrappers of the pointer-table mode, they call the long-input kernels
+ * directly, and are compiled entirely for @p target.
+ *
+ * @param suffix The suffix for the functions, e.g. sse2 or scalar
+ * @param target XXH_TARGET_* or empty.
+ */
+#define XXH_DEFINE_IFUNC_FUNCS(suffix, target)                                \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHL64_defaultSecret_##suffix(const void* XXH_RESTRICT input, size_t len,     \
+                              XXH64_hash_t seed64,                            \
+                              const xxh_u8* XXH_RESTRICT secret,              \
+                              size_t secretLen)                               \
+{                                                                             \
+    (void)seed64; (void)secret; (void)secretLen;                              \
+    return XXHL64_default_##suffix(input, len);                               \
+}                                                                             \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHL64_withSeed_##suffix(const void* XXH_RESTRICT input, size_t len,          \
+                         XXH64_hash_t seed64,                                 \
+                         const xxh_u8* XXH_RESTRICT secret, size_t secretLen) \
+{                                                                             \
+    (void)secret; (void)secretLen;                                            \
+    return XXHL64_seed_##suffix(input, len, seed64);                          \
+}                                                                             \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHL64_withSecret_##suffix(const void* XXH_RESTRICT input, size_t len,        \
+                           XXH64_hash_t seed64,                               \
+                           const xxh_u8* XXH_RESTRICT secret,                 \
+                           size_t secretLen)                                  \
+{                                                                             \
+    (void)seed64;                                                             \
+    return XXHL64_secret_##suffix(input, len, secret, secretLen);             \
+}                                                                             \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHI64_default_##suffix(XXH_NOESCAPE const void* input, size_t len)           \
+{                                                                             \
+    return XXH3_64bits_internal(input, len, 0, XXH3_kSecret,                  \
+               sizeof(XXH3_kSecret), XXHL64_defaultSecret_##suffix);          \
+}                                                                             \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHI64_seed_##suffix(XXH_NOESCAPE const void* input, size_t len,              \
+                     XXH64_hash_t seed)                                       \
+{                                                                             \
+    return XXH3_64bits_internal(input, len, seed, XXH3_kSecret,               \
+               sizeof(XXH3_kSecret), XXHL64_withSeed_##suffix);               \
+}                                                                             \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHI64_secret_##suffix(XXH_NOESCAPE const void* input, size_t len,            \
+                       XXH_NOESCAPE const void* secret, size_t secretLen)     \
+{                                                                             \
+    return XXH3_64bits_internal(input, len, 0, secret, secretLen,             \
+               XXHL64_withSecret_##suffix);                                   \
+}                                                                             \
+                                                                              \
+static target XXH64_hash_t                                                    \
+XXHI64_secretSeed_##suffix(XXH_NOESCAPE const void* input, size_t len,        \
+                           XXH_NOESCAPE const void* secret, size_t secretLen, \
+                           XXH64_hash_t seed)                                 \
+{                                                                             \
+    if (len <= XXH3_MIDSIZE_MAX)                                              \
+        return XXH3_64bits_internal(input, len, seed, XXH3_kSecret,           \
+                   sizeof(XXH3_kSecret), NULL);                               \
+    return XXHL64_secret_##suffix(input, len, secret, secretLen);             \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHL128_defaultSecret_##suffix(const void* XXH_RESTRICT input, size_t len,    \
+                               XXH64_hash_t seed64,                           \
+                               const void* XXH_RESTRICT secret,               \
+                               size_t secretLen)                              \
+{                                                                             \
+    (void)seed64; (void)secret; (void)secretLen;                              \
+    return XXHL128_default_##suffix(input, len);                              \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHL128_withSeed_##suffix(const void* XXH_RESTRICT input, size_t len,         \
+                          XXH64_hash_t seed64,                                \
+                          const void* XXH_RESTRICT secret, size_t secretLen)  \
+{                                                                             \
+    (void)secret; (void)secretLen;                                            \
+    return XXHL128_seed_##suffix(input, len, seed64);                         \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHL128_withSecret_##suffix(const void* XXH_RESTRICT input, size_t len,       \
+                            XXH64_hash_t seed64,                              \
+                            const void* XXH_RESTRICT secret, size_t secretLen)\
+{                                                                             \
+    (void)seed64;                                                             \
+    return XXHL128_secret_##suffix(input, len, secret, secretLen);            \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHI128_default_##suffix(XXH_NOESCAPE const void* input, size_t len)          \
+{                                                                             \
+    return XXH3_128bits_internal(input, len, 0, XXH3_kSecret,                 \
+               sizeof(XXH3_kSecret), XXHL128_defaultSecret_##suffix);         \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHI128_seed_##suffix(XXH_NOESCAPE const void* input, size_t len,             \
+                      XXH64_hash_t seed)                                      \
+{                                                                             \
+    return XXH3_128bits_internal(input, len, seed, XXH3_kSecret,              \
+               sizeof(XXH3_kSecret), XXHL128_withSeed_##suffix);              \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHI128_secret_##suffix(XXH_NOESCAPE const void* input, size_t len,           \
+                        XXH_NOESCAPE const void* secret, size_t secretLen)    \
+{                                                                             \
+    return XXH3_128bits_internal(input, len, 0, secret, secretLen,            \
+               XXHL128_withSecret_##suffix);                                  \
+}                                                                             \
+                                                                              \
+static target XXH128_hash_t                                                   \
+XXHI128_secretSeed_##suffix(XXH_NOESCAPE const void* input, size_t len,       \
+                            XXH_NOESCAPE const void* secret, size_t secretLen,\
+                            XXH64_hash_t seed)                                \
+{                                                                             \
+    if (len <= XXH3_MIDSIZE_MAX)                                              \
+        return XXH3_128bits_internal(input, len, seed, XXH3_kSecret,          \
+                   sizeof(XXH3_kSecret), NULL);                               \
+    return XXHL128_secret_##suffix(input, len, secret, secretLen);            \
+}
+
+#if XXH_DISPATCH_SCALAR
+XXH_DEFINE_IFUNC_FUNCS(scalar, /* nothing */)
+#endif
+XXH_DEFINE_IFUNC_FUNCS(sse2, XXH_TARGET_SSE2)
+#if XXH_DISPATCH_AVX2
+XXH_DEFINE_IFUNC_FUNCS(avx2, XXH_TARGET_AVX2)
+#endif
+#if XXH_DISPATCH_AVX512
+XXH_DEFINE_IFUNC_FUNCS(avx512, XXH_TARGET_AVX512)
+#endif
+#undef XXH_DEFINE_IFUNC_FUNCS
+/*! @endcond */
+/* End XXH_DEFINE_IFUNC_FUNCS */
+
+/*!
+ * @private
+ * @brief The best @ref XXH_VECTOR_TYPE supported by this CPU, -1 until tested.
+ */
+static int XXH_g_bestVector = -1;
+
+/*!
+ * @private
+ * @brief Runs the CPUID check once, for all resolvers.
+ *
+ * Resolvers run while the loader is still relocating this module,
+ * so neither this function nor the resolvers may use the C library
+ * or any data requiring relocation, such as a table of function pointers.
+ */
+static int XXH_ifuncVector(void)
+{
+    if (XXH_g_bestVector < 0)
+        XXH_g_bestVector = XXH_featureTest();
+    return XXH_g_bestVector;
+}
+
+/*! @cond Doxygen ignores this part */
+typedef XXH64_hash_t (*XXH3_dispatchx86_64bits_default)(XXH_NOESCAPE const void*, size_t);
+
+typedef XXH64_hash_t (*XXH3_dispatchx86_64bits_withSeed)(XXH_NOESCAPE const void*, size_t, XXH64_hash_t);
+
+typedef XXH64_hash_t (*XXH3_dispatchx86_64bits_withSecret)(XXH_NOESCAPE const void*, size_t, XXH_NOESCAPE const void*, size_t);
+
+typedef XXH128_hash_t (*XXH3_dispatchx86_128bits_default)(XXH_NOESCAPE const void*, size_t);
+
+typedef XXH128_hash_t (*XXH3_dispatchx86_128bits_withSeed)(XXH_NOESCAPE const void*, size_t, XXH64_hash_t);
+
+typedef XXH128_hash_t (*XXH3_dispatchx86_128bits_withSecret)(XXH_NOESCAPE const void*, size_t, XXH_NOESCAPE const void*, size_t);
+
+typedef XXH64_hash_t (*XXH3_dispatchx86_64bits_withSecretandSeed)(XXH_NOESCAPE const void*, size_t, XXH_NOESCAPE const void*, size_t, XXH64_hash_t);
+
+typedef XXH128_hash_t (*XXH3_dispatchx86_128bits_withSecretandSeed)(XXH_NOESCAPE const void*, size_t, XXH_NOESCAPE const void*, size_t, XXH64_hash_t);
+
+#if XXH_DISPATCH_AVX512
+#  define XXH_IFUNC_SELECT_AVX512(f) if (vecID == XXH_AVX512) return f##_avx512;
+#else
+#  define XXH_IFUNC_SELECT_AVX512(f)
+#endif
+#if XXH_DISPATCH_AVX2
+#  define XXH_IFUNC_SELECT_AVX2(f) if (vecID == XXH_AVX2) return f##_avx2;
+#else
+#  define XXH_IFUNC_SELECT_AVX2(f)
+#endif
+#if XXH_DISPATCH_SCALAR
+#  define XXH_IFUNC_SELECT_SCALAR(f) if (vecID == XXH_SCALAR) return f##_scalar;
+#else
+#  define XXH_IFUNC_SELECT_SCALAR(f)
+#endif
+
+/*
+ * Defines f##_resolver(), returning the implementation of @f
+ * matching the CPU. XXH_featureTest() never returns a variant
+ * which isn't compiled in, hence the SSE2 fallback.
+ */
+#define XXH_DEFINE_RESOLVER(f, type)                                          \
+static type f##_resolver(void)                                                \
+{                                                                             \
+    int const vecID = XXH_ifuncVector();                                      \
+    XXH_IFUNC_SELECT_AVX512(f)                                                \
+    XXH_IFUNC_SELECT_AVX2(f)                                                  \
+    XXH_IFUNC_SELECT_SCALAR(f)                                                \
+    return f##_sse2;                                                          \
+}
+
+XXH_DEFINE_RESOLVER(XXHI64_default,     XXH3_dispatchx86_64bits_default)
+XXH_DEFINE_RESOLVER(XXHI64_seed,        XXH3_dispatchx86_64bits_withSeed)
+XXH_DEFINE_RESOLVER(XXHI64_secret,      XXH3_dispatchx86_64bits_withSecret)
+XXH_DEFINE_RESOLVER(XXHI64_secretSeed,  XXH3_dispatchx86_64bits_withSecretandSeed)
+XXH_DEFINE_RESOLVER(XXHI128_default,    XXH3_dispatchx86_128bits_default)
+XXH_DEFINE_RESOLVER(XXHI128_seed,       XXH3_dispatchx86_128bits_withSeed)
+XXH_DEFINE_RESOLVER(XXHI128_secret,     XXH3_dispatchx86_128bits_withSecret)
+XXH_DEFINE_RESOLVER(XXHI128_secretSeed, XXH3_dispatchx86_128bits_withSecretandSeed)
+XXH_DEFINE_RESOLVER(XXH3_update,        XXH3_dispatchx86_update)
+XXH_DEFINE_RESOLVER(XXH3_u32Array,      XXH3_dispatchx86_u32Array)
+XXH_DEFINE_RESOLVER(XXH3_u64Array,      XXH3_dispatchx86_u64Array)
+XXH_DEFINE_RESOLVER(XXH3_digest64,      XXH3_dispatchx86_digest64)
+XXH_DEFINE_RESOLVER(XXH3_digest128,     XXH3_dispatchx86_digest128)
+XXH_DEFINE_RESOLVER(XXH3_genSecret,     XXH3_dispatchx86_genSecret)
+
+#undef XXH_DEFINE_RESOLVER
+#undef XXH_IFUNC_SELECT_AVX512
+#undef XXH_IFUNC_SELECT_AVX2
+#undef XXH_IFUNC_SELECT_SCALAR
+/*! @endcond */
+
+/*!
+ * @brief Returns the @ref XXH_VECTOR_TYPE bound to the dispatched functions.
+ */
+int XXH_getDispatchedVector(void)
+{
+    return XXH_ifuncVector();
+}
+
+/*!
+ * @brief The implementation is bound at load time in this mode.
+ *
+ * @return @ref XXH_OK if @p vecID is the one already in use,
+ *         @ref XXH_ERROR otherwise.
+ */
+XXH_errorcode XXH_setDispatch(int vecID)
+{
+    return vecID == XXH_ifuncVector() ? XXH_OK : XXH_ERROR;
+}
+
+
+/* ====    XXH3 public functions    ==== */
+/*! @cond Doxygen ignores this part */
+
+XXH64_hash_t XXH3_64bits_dispatch(XXH_NOESCAPE const void* input, size_t len)
+    XXH_IFUNC("XXHI64_default_resolver");
+
+XXH64_hash_t XXH3_64bits_withSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+    XXH_IFUNC("XXHI64_seed_resolver");
+
+XXH64_hash_t XXH3_64bits_withSecret_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen)
+    XXH_IFUNC("XXHI64_secret_resolver");
+
+XXH64_hash_t XXH3_64bits_withSecretandSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen, XXH64_hash_t seed)
+    XXH_IFUNC("XXHI64_secretSeed_resolver");
+
+XXH_errorcode XXH3_64bits_update_dispatch(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
+    XXH_IFUNC("XXH3_update_resolver");
+
+XXH64_hash_t XXH3_64bits_digest_dispatch(XXH_NOESCAPE const XXH3_state_t* state)
+    XXH_IFUNC("XXH3_digest64_resolver");
+
+void XXH3_generateSecret_fromSeed_dispatch(XXH_NOESCAPE void* secretBuffer, XXH64_hash_t seed)
+    XXH_IFUNC("XXH3_genSecret_resolver");
+
+void XXH3_64bits_u32_array_dispatch(XXH_NOESCAPE const XXH32_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+    XXH_IFUNC("XXH3_u32Array_resolver");
+
+void XXH3_64bits_u64_array_dispatch(XXH_NOESCAPE const XXH64_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+    XXH_IFUNC("XXH3_u64Array_resolver");
+
+/*! @endcond */
+
+
+/* ====    XXH128 public functions    ==== */
+/*! @cond Doxygen ignores this part */
+
+XXH128_hash_t XXH3_128bits_dispatch(XXH_NOESCAPE const void* input, size_t len)
+    XXH_IFUNC("XXHI128_default_resolver");
+
+XXH128_hash_t XXH3_128bits_withSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+    XXH_IFUNC("XXHI128_seed_resolver");
+
+XXH128_hash_t XXH3_128bits_withSecret_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen)
+    XXH_IFUNC("XXHI128_secret_resolver");
+
+XXH128_hash_t XXH3_128bits_withSecretandSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen, XXH64_hash_t seed)
+    XXH_IFUNC("XXHI128_secretSeed_resolver");
+
+XXH_errorcode XXH3_128bits_update_dispatch(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
+    XXH_IFUNC("XXH3_update_resolver");
+
+XXH128_hash_t XXH3_128bits_digest_dispatch(XXH_NOESCAPE const XXH3_state_t* state)
+    XXH_IFUNC("XXH3_digest128_resolver");
+
+/*! @endcond */
+
+#endif /* XXH_DISPATCH_IFUNC */
+
+
+/* ====    XXH3 seed context    ==== */
+/*! @cond Doxygen ignores this part */
+
+XXH64_hash_t XXH3_64bits_withSeedContext_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const XXH3_seedContext_t* context)
+{
+    return XXH3_64bits_withSecretandSeed_dispatch(input, len, context->secret, sizeof(context->secret), context->seed);
+}
+
+XXH128_hash_t XXH3_128bits_withSeedContext_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const XXH3_seedContext_t* context)
+{
+    return XXH3_128bits_withSecretandSeed_dispatch(input, len, context->secret, sizeof(context->secret), context->seed);
+}
+
 /*! @endcond */
 
 #if defined (__cplusplus)
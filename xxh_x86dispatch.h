@@ -41,15 +41,59 @@
 extern "C" {
 #endif
 
+struct XXH3_seedContext_s;  /* defined in xxhash.h, with XXH_STATIC_LINKING_ONLY */
+
 XXH_PUBLIC_API XXH64_hash_t  XXH3_64bits_dispatch(XXH_NOESCAPE const void* input, size_t len);
 XXH_PUBLIC_API XXH64_hash_t  XXH3_64bits_withSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed);
 XXH_PUBLIC_API XXH64_hash_t  XXH3_64bits_withSecret_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen);
+XXH_PUBLIC_API XXH64_hash_t  XXH3_64bits_withSecretandSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen, XXH64_hash_t seed);
 XXH_PUBLIC_API XXH_errorcode XXH3_64bits_update_dispatch(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len);
+XXH_PUBLIC_API XXH64_hash_t  XXH3_64bits_digest_dispatch(XXH_NOESCAPE const XXH3_state_t* state);
+XXH_PUBLIC_API void XXH3_generateSecret_fromSeed_dispatch(XXH_NOESCAPE void* secretBuffer, XXH64_hash_t seed);
+XXH_PUBLIC_API XXH64_hash_t  XXH3_64bits_withSeedContext_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const struct XXH3_seedContext_s* context);
+XXH_PUBLIC_API void XXH3_64bits_u32_array_dispatch(XXH_NOESCAPE const XXH32_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out);
+XXH_PUBLIC_API void XXH3_64bits_u64_array_dispatch(XXH_NOESCAPE const XXH64_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out);
 
 XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_dispatch(XXH_NOESCAPE const void* input, size_t len);
 XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_withSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed);
 XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_withSecret_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen);
+XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_withSecretandSeed_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretLen, XXH64_hash_t seed);
 XXH_PUBLIC_API XXH_errorcode XXH3_128bits_update_dispatch(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len);
+XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_digest_dispatch(XXH_NOESCAPE const XXH3_state_t* state);
+XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_withSeedContext_dispatch(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const struct XXH3_seedContext_s* context);
+
+/*
+ * Values for XXH_getDispatchedVector() and XXH_setDispatch().
+ * These are the same as the XXH_VECTOR values in xxhash.h.
+ */
+#ifndef XXH_SCALAR
+#  define XXH_SCALAR 0
+#  define XXH_SSE2   1
+#  define XXH_AVX2   2
+#  define XXH_AVX512 3
+#endif
+
+/*
+ * Returns the implementation currently selected by the dispatcher:
+ * XXH_SCALAR, XXH_SSE2, XXH_AVX2 or XXH_AVX512.
+ *
+ * The implementation is selected once, from the CPU features.
+ * The environment variable `XXH_DISPATCH` (`scalar`, `sse2`, `avx2` or `avx512`)
+ * can request a lower one, for example to avoid AVX512 frequency reductions.
+ */
+XXH_PUBLIC_API int XXH_getDispatchedVector(void);
+
+/*
+ * Forces the dispatcher to use implementation @vecID.
+ * Returns XXH_ERROR, and changes nothing, if @vecID is not compiled in
+ * or not supported by the CPU.
+ * Not thread safe: call it before hashing from multiple threads.
+ *
+ * When xxh_x86dispatch.c is built with XXH_DISPATCH_IFUNC=1, functions are
+ * bound once at load time: `XXH_DISPATCH` is ignored, and XXH_setDispatch()
+ * only succeeds for the implementation already in use.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH_setDispatch(int vecID);
 
 #if defined (__cplusplus)
 }
@@ -66,8 +110,20 @@ XXH_PUBLIC_API XXH_errorcode XXH3_128bits_update_dispatch(XXH_NOESCAPE XXH3_stat
 # define XXH3_64bits_withSeed XXH3_64bits_withSeed_dispatch
 # undef  XXH3_64bits_withSecret
 # define XXH3_64bits_withSecret XXH3_64bits_withSecret_dispatch
+# undef  XXH3_64bits_withSecretandSeed
+# define XXH3_64bits_withSecretandSeed XXH3_64bits_withSecretandSeed_dispatch
 # undef  XXH3_64bits_update
 # define XXH3_64bits_update XXH3_64bits_update_dispatch
+# undef  XXH3_64bits_digest
+# define XXH3_64bits_digest XXH3_64bits_digest_dispatch
+# undef  XXH3_generateSecret_fromSeed
+# define XXH3_generateSecret_fromSeed XXH3_generateSecret_fromSeed_dispatch
+# undef  XXH3_64bits_withSeedContext
+# define XXH3_64bits_withSeedContext XXH3_64bits_withSeedContext_dispatch
+# undef  XXH3_64bits_u32_array
+# define XXH3_64bits_u32_array XXH3_64bits_u32_array_dispatch
+# undef  XXH3_64bits_u64_array
+# define XXH3_64bits_u64_array XXH3_64bits_u64_array_dispatch
 
 # undef  XXH128
 # define XXH128 XXH3_128bits_withSeed_dispatch
@@ -77,8 +133,14 @@ XXH_PUBLIC_API XXH_errorcode XXH3_128bits_update_dispatch(XXH_NOESCAPE XXH3_stat
 # define XXH3_128bits_withSeed XXH3_128bits_withSeed_dispatch
 # undef  XXH3_128bits_withSecret
 # define XXH3_128bits_withSecret XXH3_128bits_withSecret_dispatch
+# undef  XXH3_128bits_withSecretandSeed
+# define XXH3_128bits_withSecretandSeed XXH3_128bits_withSecretandSeed_dispatch
 # undef  XXH3_128bits_update
 # define XXH3_128bits_update XXH3_128bits_update_dispatch
+# undef  XXH3_128bits_digest
+# define XXH3_128bits_digest XXH3_128bits_digest_dispatch
+# undef  XXH3_128bits_withSeedContext
+# define XXH3_128bits_withSeedContext XXH3_128bits_withSeedContext_dispatch
 
 #endif /* XXH_DISPATCH_DISABLE_REPLACE */
 
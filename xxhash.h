@@ -391,6 +391,12 @@ extern "C" {
 #  undef XXH3_64bits_update
 #  undef XXH3_64bits_digest
 #  undef XXH3_generateSecret
+#  undef XXH3_64bits_batch
+#  undef XXH3_64bits_u32_array
+#  undef XXH3_64bits_u64_array
+#  undef XXH3_64bits_u128_array
+#  undef XXH3_64bits_multi
+#  undef XXH3_128bits_multi
     /* XXH3_128bits */
 #  undef XXH128
 #  undef XXH3_128bits
@@ -406,6 +412,75 @@ extern "C" {
 #  undef XXH128_cmp
 #  undef XXH128_canonicalFromHash
 #  undef XXH128_hashFromCanonical
+    /* state serialization */
+#  undef XXH32_saveState
+#  undef XXH32_loadState
+#  undef XXH64_saveState
+#  undef XXH64_loadState
+#  undef XXH3_saveState
+#  undef XXH3_loadState
+    /* seed context */
+#  undef XXH3_initSeedContext
+#  undef XXH3_64bits_withSeedContext
+#  undef XXH3_128bits_withSeedContext
+#  undef XXH3_64bits_reset_withSeedContext
+#  undef XXH3_128bits_reset_withSeedContext
+    /* prepared secret */
+#  undef XXH3_initPreparedSecret
+#  undef XXH3_64bits_withPreparedSecret
+#  undef XXH3_128bits_withPreparedSecret
+    /* compact state */
+#  undef XXH3_compact_reset
+#  undef XXH3_compact_reset_withSecret
+#  undef XXH3_compact_reset_withSeedContext
+#  undef XXH3_compact_update
+#  undef XXH3_compact_64bits_digest
+#  undef XXH3_compact_128bits_digest
+    /* allocation */
+#  undef XXH_setAllocator
+#  undef XXH3_createStatePool
+#  undef XXH3_freeStatePool
+#  undef XXH3_acquireState
+#  undef XXH3_releaseState
+    /* scatter-gather */
+#  undef XXH3_64bits_iov
+#  undef XXH3_128bits_iov
+#  undef XXH3_64bits_2D
+#  undef XXH3_128bits_2D
+    /* copy and hash */
+#  undef XXH3_64bits_copy
+#  undef XXH3_128bits_copy
+#  undef XXH3_64bits_update_copy
+#  undef XXH3_128bits_update_copy
+    /* prefetch distance */
+#  undef XXH3_64bits_withPrefetchDistance
+#  undef XXH3_128bits_withPrefetchDistance
+#  undef XXH3_calibrate
+    /* padded inputs */
+#  undef XXH3_64bits_padded
+#  undef XXH3_64bits_padded_withSeed
+    /* ASCII case-insensitive */
+#  undef XXH3_64bits_asciiFold
+#  undef XXH3_64bits_asciiFold_withSeed
+#  undef XXH3_128bits_asciiFold
+#  undef XXH3_128bits_asciiFold_withSeed
+    /* typed appends */
+#  undef XXH64_update_u32
+#  undef XXH64_update_u64
+#  undef XXH3_update_u8
+#  undef XXH3_update_u16
+#  undef XXH3_update_u32
+#  undef XXH3_update_u64
+    /* prefix checkpoints */
+#  undef XXH3_prefix_capture
+#  undef XXH3_64bits_withPrefix
+#  undef XXH3_128bits_withPrefix
+    /* dual width */
+#  undef XXH3_dual
+#  undef XXH3_dual_withSeed
+#  undef XXH3_dual_digest
+    /* multiple seeds */
+#  undef XXH3_64bits_multiSeed
     /* Finally, free the namespace itself */
 #  undef XXH_NAMESPACE
 
@@ -431,6 +506,20 @@ extern "C" {
 #  define XXH64_state_t XXH_IPREF(XXH64_state_t)
 #  define XXH3_state_s  XXH_IPREF(XXH3_state_s)
 #  define XXH3_state_t  XXH_IPREF(XXH3_state_t)
+#  define XXH3_seedContext_s XXH_IPREF(XXH3_seedContext_s)
+#  define XXH3_seedContext_t XXH_IPREF(XXH3_seedContext_t)
+#  define XXH3_preparedSecret_s XXH_IPREF(XXH3_preparedSecret_s)
+#  define XXH3_preparedSecret_t XXH_IPREF(XXH3_preparedSecret_t)
+#  define XXH3_compactState_s XXH_IPREF(XXH3_compactState_s)
+#  define XXH3_compactState_t XXH_IPREF(XXH3_compactState_t)
+#  define XXH3_statePool_s XXH_IPREF(XXH3_statePool_s)
+#  define XXH3_statePool_t XXH_IPREF(XXH3_statePool_t)
+#  define XXH_allocFunction XXH_IPREF(XXH_allocFunction)
+#  define XXH_freeFunction XXH_IPREF(XXH_freeFunction)
+#  define XXH_customMem XXH_IPREF(XXH_customMem)
+#  define XXH_iovec_t XXH_IPREF(XXH_iovec_t)
+#  define XXH3_prefix_s XXH_IPREF(XXH3_prefix_s)
+#  define XXH3_prefix_t XXH_IPREF(XXH3_prefix_t)
 #  define XXH128_hash_t XXH_IPREF(XXH128_hash_t)
    /* Ensure the header is parsed again, even if it was previously included */
 #  undef XXHASH_H_5627135585666179
@@ -496,6 +585,12 @@ extern "C" {
 #  define XXH3_64bits_digest XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_digest)
 #  define XXH3_generateSecret XXH_NAME2(XXH_NAMESPACE, XXH3_generateSecret)
 #  define XXH3_generateSecret_fromSeed XXH_NAME2(XXH_NAMESPACE, XXH3_generateSecret_fromSeed)
+#  define XXH3_64bits_batch XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_batch)
+#  define XXH3_64bits_u32_array XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_u32_array)
+#  define XXH3_64bits_u64_array XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_u64_array)
+#  define XXH3_64bits_u128_array XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_u128_array)
+#  define XXH3_64bits_multi XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_multi)
+#  define XXH3_128bits_multi XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_multi)
 /* XXH3_128bits */
 #  define XXH128 XXH_NAME2(XXH_NAMESPACE, XXH128)
 #  define XXH3_128bits XXH_NAME2(XXH_NAMESPACE, XXH3_128bits)
@@ -512,6 +607,75 @@ extern "C" {
 #  define XXH128_cmp     XXH_NAME2(XXH_NAMESPACE, XXH128_cmp)
 #  define XXH128_canonicalFromHash XXH_NAME2(XXH_NAMESPACE, XXH128_canonicalFromHash)
 #  define XXH128_hashFromCanonical XXH_NAME2(XXH_NAMESPACE, XXH128_hashFromCanonical)
+/* state serialization */
+#  define XXH32_saveState XXH_NAME2(XXH_NAMESPACE, XXH32_saveState)
+#  define XXH32_loadState XXH_NAME2(XXH_NAMESPACE, XXH32_loadState)
+#  define XXH64_saveState XXH_NAME2(XXH_NAMESPACE, XXH64_saveState)
+#  define XXH64_loadState XXH_NAME2(XXH_NAMESPACE, XXH64_loadState)
+#  define XXH3_saveState XXH_NAME2(XXH_NAMESPACE, XXH3_saveState)
+#  define XXH3_loadState XXH_NAME2(XXH_NAMESPACE, XXH3_loadState)
+/* seed context */
+#  define XXH3_initSeedContext XXH_NAME2(XXH_NAMESPACE, XXH3_initSeedContext)
+#  define XXH3_64bits_withSeedContext XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_withSeedContext)
+#  define XXH3_128bits_withSeedContext XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_withSeedContext)
+#  define XXH3_64bits_reset_withSeedContext XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_reset_withSeedContext)
+#  define XXH3_128bits_reset_withSeedContext XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_reset_withSeedContext)
+/* prepared secret */
+#  define XXH3_initPreparedSecret XXH_NAME2(XXH_NAMESPACE, XXH3_initPreparedSecret)
+#  define XXH3_64bits_withPreparedSecret XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_withPreparedSecret)
+#  define XXH3_128bits_withPreparedSecret XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_withPreparedSecret)
+/* compact state */
+#  define XXH3_compact_reset XXH_NAME2(XXH_NAMESPACE, XXH3_compact_reset)
+#  define XXH3_compact_reset_withSecret XXH_NAME2(XXH_NAMESPACE, XXH3_compact_reset_withSecret)
+#  define XXH3_compact_reset_withSeedContext XXH_NAME2(XXH_NAMESPACE, XXH3_compact_reset_withSeedContext)
+#  define XXH3_compact_update XXH_NAME2(XXH_NAMESPACE, XXH3_compact_update)
+#  define XXH3_compact_64bits_digest XXH_NAME2(XXH_NAMESPACE, XXH3_compact_64bits_digest)
+#  define XXH3_compact_128bits_digest XXH_NAME2(XXH_NAMESPACE, XXH3_compact_128bits_digest)
+/* allocation */
+#  define XXH_setAllocator XXH_NAME2(XXH_NAMESPACE, XXH_setAllocator)
+#  define XXH3_createStatePool XXH_NAME2(XXH_NAMESPACE, XXH3_createStatePool)
+#  define XXH3_freeStatePool XXH_NAME2(XXH_NAMESPACE, XXH3_freeStatePool)
+#  define XXH3_acquireState XXH_NAME2(XXH_NAMESPACE, XXH3_acquireState)
+#  define XXH3_releaseState XXH_NAME2(XXH_NAMESPACE, XXH3_releaseState)
+/* scatter-gather */
+#  define XXH3_64bits_iov XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_iov)
+#  define XXH3_128bits_iov XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_iov)
+#  define XXH3_64bits_2D XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_2D)
+#  define XXH3_128bits_2D XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_2D)
+/* copy and hash */
+#  define XXH3_64bits_copy XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_copy)
+#  define XXH3_128bits_copy XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_copy)
+#  define XXH3_64bits_update_copy XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_update_copy)
+#  define XXH3_128bits_update_copy XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_update_copy)
+/* prefetch distance */
+#  define XXH3_64bits_withPrefetchDistance XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_withPrefetchDistance)
+#  define XXH3_128bits_withPrefetchDistance XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_withPrefetchDistance)
+#  define XXH3_calibrate XXH_NAME2(XXH_NAMESPACE, XXH3_calibrate)
+/* padded inputs */
+#  define XXH3_64bits_padded XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_padded)
+#  define XXH3_64bits_padded_withSeed XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_padded_withSeed)
+/* ASCII case-insensitive */
+#  define XXH3_64bits_asciiFold XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_asciiFold)
+#  define XXH3_64bits_asciiFold_withSeed XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_asciiFold_withSeed)
+#  define XXH3_128bits_asciiFold XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_asciiFold)
+#  define XXH3_128bits_asciiFold_withSeed XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_asciiFold_withSeed)
+/* typed appends */
+#  define XXH64_update_u32 XXH_NAME2(XXH_NAMESPACE, XXH64_update_u32)
+#  define XXH64_update_u64 XXH_NAME2(XXH_NAMESPACE, XXH64_update_u64)
+#  define XXH3_update_u8 XXH_NAME2(XXH_NAMESPACE, XXH3_update_u8)
+#  define XXH3_update_u16 XXH_NAME2(XXH_NAMESPACE, XXH3_update_u16)
+#  define XXH3_update_u32 XXH_NAME2(XXH_NAMESPACE, XXH3_update_u32)
+#  define XXH3_update_u64 XXH_NAME2(XXH_NAMESPACE, XXH3_update_u64)
+/* prefix checkpoints */
+#  define XXH3_prefix_capture XXH_NAME2(XXH_NAMESPACE, XXH3_prefix_capture)
+#  define XXH3_64bits_withPrefix XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_withPrefix)
+#  define XXH3_128bits_withPrefix XXH_NAME2(XXH_NAMESPACE, XXH3_128bits_withPrefix)
+/* dual width */
+#  define XXH3_dual XXH_NAME2(XXH_NAMESPACE, XXH3_dual)
+#  define XXH3_dual_withSeed XXH_NAME2(XXH_NAMESPACE, XXH3_dual_withSeed)
+#  define XXH3_dual_digest XXH_NAME2(XXH_NAMESPACE, XXH3_dual_digest)
+/* multiple seeds */
+#  define XXH3_64bits_multiSeed XXH_NAME2(XXH_NAMESPACE, XXH3_64bits_multiSeed)
 #endif
 
 
@@ -1634,6 +1798,44 @@ XXH_PUBLIC_API XXH_PUREF XXH128_hash_t XXH128_hashFromCanonical(XXH_NOESCAPE con
  * Never use them in association with dynamic linking!
  ***************************************************************************** */
 
+#ifndef XXH_NO_STREAM
+/* ===   Custom memory allocation   === */
+
+/*! @brief Allocation function of an @ref XXH_customMem. */
+typedef void* (*XXH_allocFunction)(void* opaque, size_t size);
+/*! @brief Deallocation function of an @ref XXH_customMem. */
+typedef void  (*XXH_freeFunction)(void* opaque, void* address);
+/*!
+ * @brief A custom memory allocator.
+ * @p opaque is passed as first argument to both functions.
+ */
+typedef struct {
+    XXH_allocFunction customAlloc;
+    XXH_freeFunction customFree;
+    void* opaque;
+} XXH_customMem;
+
+/*!
+ * @brief Sets the allocator used by all `XXH*_createState()` functions.
+ *
+ * By default, states are allocated with `malloc()` and released with `free()`,
+ * or can't be allocated at all when @ref XXH_NO_STDLIB is set.
+ * A custom allocator works in both cases.
+ *
+ * This is a global setting, which is not thread-safe: it should be set
+ * once, before any state is created. States must be freed with the allocator
+ * they were created with.
+ *
+ * @param customMem The allocator. Both functions `NULL` restore the default.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if only one of the functions is `NULL`.
+ *
+ * @note With @ref XXH_INLINE_ALL, each translation unit has its own setting.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH_setAllocator(XXH_customMem customMem);
+#endif /* !XXH_NO_STREAM */
+
 /*
  * These definitions are only present to allow static allocation
  * of XXH states, on stack or in a struct, for example.
@@ -1661,6 +1863,56 @@ struct XXH32_state_s {
    XXH32_hash_t reserved;     /*!< Reserved field. Do not read nor write to it. */
 };   /* typedef'd to XXH32_state_t */
 
+#ifndef XXH_NO_STREAM
+/* ===   Streaming state serialization   === */
+
+/*!
+ * @brief Version of the serialization format of streaming states.
+ *
+ * Saved states only contain what is needed to resume hashing:
+ * accumulators, counters, and the pending part of the internal buffer.
+ * All fields are written in little-endian order, so a saved state can be
+ * resumed on any platform, by any build of the same format version.
+ *
+ * Every saved state starts with a 4-byte header:
+ * { XXH_SAVESTATE_VERSION, algorithm id, flags, buffered size or 0 }.
+ */
+#define XXH_SAVESTATE_VERSION 1
+
+/*! @brief Maximum size of a saved @ref XXH32_state_t, in bytes. */
+#define XXH32_SAVESTATE_SIZE_MAX (4 + 4 + 4*4 + 16)
+
+/*!
+ * @brief Saves an @ref XXH32_state_t into a portable binary representation.
+ *
+ * @param statePtr    The state to save. It is not modified.
+ * @param dst         The destination buffer.
+ * @param dstCapacity The size of @p dst, in bytes.
+ *                    @ref XXH32_SAVESTATE_SIZE_MAX is always enough.
+ *
+ * @return The number of bytes written into @p dst,
+ *         or 0 if @p dstCapacity is too small.
+ *
+ * @see XXH32_loadState()
+ */
+XXH_PUBLIC_API size_t XXH32_saveState(const XXH32_state_t* statePtr, void* dst, size_t dstCapacity);
+
+/*!
+ * @brief Restores an @ref XXH32_state_t saved with XXH32_saveState().
+ *
+ * The restored state continues exactly where the saved one stopped:
+ * XXH32_update() and XXH32_digest() can be called directly.
+ *
+ * @param statePtr The state to restore into.
+ * @param src      The saved representation.
+ * @param srcSize  The size of @p src, as returned by XXH32_saveState().
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p src is not a valid XXH32 saved state.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH32_loadState(XXH32_state_t* statePtr, const void* src, size_t srcSize);
+#endif /* !XXH_NO_STREAM */
+
 
 #ifndef XXH_NO_LONG_LONG  /* defined when there is no 64-bit support */
 
@@ -1685,6 +1937,41 @@ struct XXH64_state_s {
    XXH64_hash_t reserved64;   /*!< Reserved field. Do not read or write to it. */
 };   /* typedef'd to XXH64_state_t */
 
+#ifndef XXH_NO_STREAM
+/*! @brief Maximum size of a saved @ref XXH64_state_t, in bytes. */
+#define XXH64_SAVESTATE_SIZE_MAX (4 + 8 + 4*8 + 32)
+
+/*!
+ * @brief Saves an @ref XXH64_state_t into a portable binary representation.
+ *
+ * @see XXH32_saveState(): contract is the same.
+ */
+XXH_PUBLIC_API size_t XXH64_saveState(XXH_NOESCAPE const XXH64_state_t* statePtr, XXH_NOESCAPE void* dst, size_t dstCapacity);
+
+/*!
+ * @brief Restores an @ref XXH64_state_t saved with XXH64_saveState().
+ *
+ * @see XXH32_loadState(): contract is the same.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH64_loadState(XXH_NOESCAPE XXH64_state_t* statePtr, XXH_NOESCAPE const void* src, size_t srcSize);
+
+/*!
+ * @brief Appends @p value to the hash, in little-endian byte order.
+ *
+ * Same as XXH64_update() with the 4 bytes of @p value, but without a pointer
+ * and a length to handle: @p value is written straight into the internal buffer,
+ * and XXH64_update() is only called when the buffer fills.
+ * Meant for serializers hashing many small fields.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH64_update_u32(XXH_NOESCAPE XXH64_state_t* statePtr, XXH32_hash_t value);
+
+/*!
+ * @brief Appends @p value to the hash, in little-endian byte order.
+ * @see XXH64_update_u32()
+ */
+XXH_PUBLIC_API XXH_errorcode XXH64_update_u64(XXH_NOESCAPE XXH64_state_t* statePtr, XXH64_hash_t value);
+#endif /* !XXH_NO_STREAM */
+
 #ifndef XXH_NO_XXH3
 
 #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) /* >= C11 */
@@ -1754,7 +2041,7 @@ struct XXH3_state_s {
    XXH_ALIGN_MEMBER(64, XXH64_hash_t acc[8]);
        /*!< The 8 accumulators. See @ref XXH32_state_s::v and @ref XXH64_state_s::v */
    XXH_ALIGN_MEMBER(64, unsigned char customSecret[XXH3_SECRET_DEFAULT_SIZE]);
-       /*!< Used to store a custom secret generated from a seed. */
+       /*!< Used to store a custom secret generated from a seed, @see secretPending */
    XXH_ALIGN_MEMBER(64, unsigned char buffer[XXH3_INTERNALBUFFER_SIZE]);
        /*!< The internal buffer. @see XXH32_state_s::mem32 */
    XXH32_hash_t bufferedSize;
@@ -1771,14 +2058,46 @@ struct XXH3_state_s {
        /*!< Size of @ref customSecret or @ref extSecret */
    XXH64_hash_t seed;
        /*!< Seed for _withSeed variants. Must be zero otherwise, @see XXH3_INITSTATE() */
-   XXH64_hash_t reserved64;
-       /*!< Reserved field. */
+   XXH32_hash_t secretPending;
+       /*!< Non-zero while @ref customSecret is not yet derived from @ref seed.
+        *   It is derived when the input exceeds the internal buffer. */
+   XXH32_hash_t reserved32;
+       /*!< Reserved field. Needed for padding on 64-bit. */
    const unsigned char* extSecret;
        /*!< Reference to an external secret for the _withSecret variants, NULL
         *   for other variants. */
    /* note: there may be some padding at the end due to alignment on 64 bytes */
 }; /* typedef'd to XXH3_state_t */
 
+/*!
+ * @brief A seed, with the secret derived from it.
+ *
+ * For inputs larger than @ref XXH3_MIDSIZE_MAX, XXH3_64bits_withSeed() and
+ * XXH3_128bits_withSeed() derive a secret from the seed on every call.
+ * When the same seed is used many times, initialize an @ref XXH3_seedContext_t
+ * once with XXH3_initSeedContext(), then use the `_withSeedContext()` variants:
+ * they return exactly the same values as their `_withSeed()` counterparts,
+ * without the per-call secret derivation.
+ *
+ * A context is not modified by hashing functions: it can be shared
+ * between threads once initialized.
+ *
+ * @note This is only defined when @ref XXH_STATIC_LINKING_ONLY,
+ * @ref XXH_INLINE_ALL, or @ref XXH_IMPLEMENTATION is defined.
+ */
+struct XXH3_seedContext_s {
+   XXH_ALIGN_MEMBER(64, unsigned char secret[XXH3_SECRET_DEFAULT_SIZE]);
+       /*!< The secret derived from @ref seed, as by XXH3_generateSecret_fromSeed(). */
+   XXH64_hash_t seed;
+       /*!< The seed. */
+};   /* typedef'd to XXH3_seedContext_t */
+
+/*!
+ * @brief The type of a seed context.
+ * @see XXH3_seedContext_s for details.
+ */
+typedef struct XXH3_seedContext_s XXH3_seedContext_t;
+
 #undef XXH_ALIGN_MEMBER
 
 /*!
@@ -1985,6 +2304,96 @@ XXH3_128bits_withSecretandSeed(XXH_NOESCAPE const void* input, size_t length,
                                XXH_NOESCAPE const void* secret, size_t secretSize,
                                XXH64_hash_t seed64);
 
+/*!
+ * @brief Calculates the 64-bit XXH3 hash of many independent keys at once.
+ *
+ * @param ptrs   An array of @p nbKeys pointers to the keys to be hashed.
+ * @param lens   An array of @p nbKeys key lengths, in bytes.
+ * @param nbKeys The number of keys.
+ * @param out    An array receiving the @p nbKeys hash values.
+ *
+ * `out[n]` receives *exactly* the same value as `XXH3_64bits(ptrs[n], lens[n])`.
+ *
+ * This variant is designed for large sets of short keys scattered in memory,
+ * such as hash table construction or bulk lookups.
+ * It is a loop of XXH3_64bits(), which prefetches the first and last cache line
+ * of the key @ref XXH3_BATCH_PREFETCH_DIST positions ahead.
+ * It can only help when keys are not already in cache.
+ * Long keys are accepted, and simply follow the regular XXH3 path.
+ */
+XXH_PUBLIC_API void
+XXH3_64bits_batch(XXH_NOESCAPE const void* const* ptrs, XXH_NOESCAPE const size_t* lens,
+                  size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out);
+
+/*!
+ * @brief Calculates the 64-bit XXH3 hash of each key in an array of integers.
+ *
+ * @param keys   An array of @p nbKeys 32-bit keys.
+ * @param nbKeys The number of keys.
+ * @param out    An array receiving the @p nbKeys hash values.
+ *
+ * Each key is hashed as its in-memory representation:
+ * `out[n]` receives *exactly* the same value as `XXH3_64bits(&keys[n], sizeof(keys[n]))`.
+ *
+ * Several keys are processed in parallel using SIMD when available (SSE2, AVX2, AVX512),
+ * following @ref XXH_VECTOR, or the runtime selection of `xxh_x86dispatch.c`.
+ */
+XXH_PUBLIC_API void
+XXH3_64bits_u32_array(XXH_NOESCAPE const XXH32_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out);
+
+/*!
+ * @brief Calculates the 64-bit XXH3 hash of each key in an array of 64-bit integers.
+ *
+ * @see XXH3_64bits_u32_array(): contract is the same.
+ */
+XXH_PUBLIC_API void
+XXH3_64bits_u64_array(XXH_NOESCAPE const XXH64_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out);
+
+/*!
+ * @brief Calculates the 64-bit XXH3 hash of each key in an array of 128-bit integers.
+ *
+ * @see XXH3_64bits_u32_array(): contract is the same.
+ *
+ * Note: 16-byte keys require full 64x64->128 multiplications,
+ * which SIMD instruction sets don't offer. Keys are therefore hashed
+ * with scalar code, interleaved so that independent keys overlap.
+ */
+XXH_PUBLIC_API void
+XXH3_64bits_u128_array(XXH_NOESCAPE const XXH128_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out);
+
+/*!
+ * @brief Calculates the 64-bit XXH3 hash of several independent inputs.
+ *
+ * @param inputs   An array of @p nbInputs pointers to the inputs to be hashed.
+ * @param lens     An array of @p nbInputs input lengths, in bytes.
+ * @param nbInputs The number of inputs.
+ * @param out      An array receiving the @p nbInputs hash values.
+ *
+ * `out[n]` receives *exactly* the same value as `XXH3_64bits(inputs[n], lens[n])`.
+ *
+ * This variant is designed for medium to large inputs (a few KB to a few MB).
+ * On the SSE2 code path, up to 4 long inputs are advanced in lock-step
+ * through the long-input loop, so that the CPU can overlap their
+ * independent accumulations. This works best when the inputs
+ * in a group have similar lengths.
+ * Other code paths hash each input with their regular loop.
+ * See @ref XXH3_MULTI_LOCKSTEP.
+ */
+XXH_PUBLIC_API void
+XXH3_64bits_multi(XXH_NOESCAPE const void* const* inputs, XXH_NOESCAPE const size_t* lens,
+                  size_t nbInputs, XXH_NOESCAPE XXH64_hash_t* out);
+
+/*!
+ * @brief Calculates the 128-bit XXH3 hash of several independent inputs.
+ *
+ * `out[n]` receives *exactly* the same value as `XXH3_128bits(inputs[n], lens[n])`.
+ *
+ * @see XXH3_64bits_multi(): contract is the same.
+ */
+XXH_PUBLIC_API void
+XXH3_128bits_multi(XXH_NOESCAPE const void* const* inputs, XXH_NOESCAPE const size_t* lens,
+                   size_t nbInputs, XXH_NOESCAPE XXH128_hash_t* out);
+
 #ifndef XXH_NO_STREAM
 /*!
  * @brief Resets an @ref XXH3_state_t with secret data to begin a new hash.
@@ -2032,1238 +2441,1358 @@ XXH3_128bits_reset_withSecretandSeed(XXH_NOESCAPE XXH3_state_t* statePtr,
 
 #endif /* !XXH_NO_STREAM */
 
-#endif  /* !XXH_NO_XXH3 */
-#endif  /* XXH_NO_LONG_LONG */
-#if defined(XXH_INLINE_ALL) || defined(XXH_PRIVATE_API)
-#  define XXH_IMPLEMENTATION
-#endif
-
-#endif  /* defined(XXH_STATIC_LINKING_ONLY) && !defined(XXHASH_H_STATIC_13879238742) */
-
+/* ===   XXH3 seed context   === */
 
-/* ======================================================================== */
-/* ======================================================================== */
-/* ======================================================================== */
+/*!
+ * @brief Initializes an @ref XXH3_seedContext_t from a seed.
+ *
+ * @param context The context to initialize. It can be allocated on stack.
+ * @param seed    The 64-bit seed to alter the hash result predictably.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p context is `NULL`.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH3_initSeedContext(XXH_NOESCAPE XXH3_seedContext_t* context, XXH64_hash_t seed);
 
+/*!
+ * @brief 64-bit seeded variant of XXH3, using a precomputed seed context.
+ *
+ * @return The same value as `XXH3_64bits_withSeed(input, length, context->seed)`.
+ */
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_withSeedContext(XXH_NOESCAPE const void* input, size_t length,
+                            XXH_NOESCAPE const XXH3_seedContext_t* context);
 
-/*-**********************************************************************
- * xxHash implementation
- *-**********************************************************************
- * xxHash's implementation used to be hosted inside xxhash.c.
+/*!
+ * @brief 128-bit seeded variant of XXH3, using a precomputed seed context.
  *
- * However, inlining requires implementation to be visible to the compiler,
- * hence be included alongside the header.
- * Previously, implementation was hosted inside xxhash.c,
- * which was then #included when inlining was activated.
- * This construction created issues with a few build and install systems,
- * as it required xxhash.c to be stored in /include directory.
+ * @return The same value as `XXH3_128bits_withSeed(input, length, context->seed)`.
+ */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_128bits_withSeedContext(XXH_NOESCAPE const void* input, size_t length,
+                             XXH_NOESCAPE const XXH3_seedContext_t* context);
+
+#ifndef XXH_NO_STREAM
+/*!
+ * @brief Resets an @ref XXH3_state_t to begin a new hash, using a seed context.
  *
- * xxHash implementation is now directly integrated within xxhash.h.
- * As a consequence, xxhash.c is no longer needed in /include.
+ * The secret is copied into the state, so @p context can be released
+ * or reused afterwards. The state ends up exactly as after
+ * `XXH3_64bits_reset_withSeed(statePtr, context->seed)`.
  *
- * xxhash.c is still available and is still useful.
- * In a "normal" setup, when xxhash is not inlined,
- * xxhash.h only exposes the prototypes and public symbols,
- * while xxhash.c can be built into an object file xxhash.o
- * which can then be linked into the final binary.
- ************************************************************************/
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_reset_withSeedContext(XXH_NOESCAPE XXH3_state_t* statePtr,
+                                  XXH_NOESCAPE const XXH3_seedContext_t* context);
 
-#if ( defined(XXH_INLINE_ALL) || defined(XXH_PRIVATE_API) \
-   || defined(XXH_IMPLEMENTATION) ) && !defined(XXH_IMPLEM_13a8737387)
-#  define XXH_IMPLEM_13a8737387
+/*!
+ * @brief Resets an @ref XXH3_state_t to begin a new 128-bit hash, using a seed context.
+ *
+ * @see XXH3_64bits_reset_withSeedContext(). Contract is identical.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_reset_withSeedContext(XXH_NOESCAPE XXH3_state_t* statePtr,
+                                   XXH_NOESCAPE const XXH3_seedContext_t* context);
+#endif /* !XXH_NO_STREAM */
 
-/* *************************************
-*  Tuning parameters
-***************************************/
+/* ===   XXH3 prepared secret   === */
 
 /*!
- * @defgroup tuning Tuning parameters
- * @{
+ * @brief A custom secret, validated and laid out once for repeated use.
  *
- * Various macros to control xxHash's behavior.
+ * XXH3_64bits_withSecret() and XXH3_128bits_withSecret() accept a secret of
+ * any size and alignment, and derive the block geometry from its size on
+ * every call. When the same large secret is used many times, copy it once
+ * into a prepared secret with XXH3_initPreparedSecret(): the copy is aligned
+ * on 64 bytes, and the block geometry is computed once.
+ * The `_withPreparedSecret()` variants return exactly the same values as
+ * their `_withSecret()` counterparts.
+ *
+ * This type is opaque: it lives inside a workspace provided by the caller,
+ * which must be at least @ref XXH3_PREPARED_SECRET_SIZE(secretSize) bytes.
+ * It can be shared between threads once initialized, but must not be moved.
  */
-#ifdef XXH_DOXYGEN
+typedef struct XXH3_preparedSecret_s XXH3_preparedSecret_t;
+
 /*!
- * @brief Define this to disable 64-bit code.
+ * @brief Size, in bytes, of a workspace able to hold a prepared secret of @p secretSize bytes.
  *
- * Useful if only using the @ref XXH32_family and you have a strict C90 compiler.
+ * It includes room to align the workspace, so any buffer can be used.
  */
-#  define XXH_NO_LONG_LONG
-#  undef XXH_NO_LONG_LONG /* don't actually */
+#define XXH3_PREPARED_SECRET_SIZE(secretSize) ((size_t)(secretSize) + 2*64)
+
 /*!
- * @brief Controls how unaligned memory is accessed.
+ * @brief Prepares a custom secret inside @p workspace.
  *
- * By default, access to unaligned memory is controlled by `memcpy()`, which is
- * safe and portable.
+ * @param workspace     The memory to hold the prepared secret.
+ * @param workspaceSize The size of @p workspace, in bytes.
+ * @param secret        The secret data, as for XXH3_64bits_withSecret().
+ * @param secretSize    The length of @p secret, in bytes. Must be >= @ref XXH3_SECRET_SIZE_MIN.
  *
- * Unfortunately, on some target/compiler combinations, the generated assembly
- * is sub-optimal.
+ * @p secret is copied: it can be released or modified afterwards.
  *
- * The below switch allow selection of a different access method
- * in the search for improved performance.
+ * @return A pointer to the prepared secret, located within @p workspace.
+ * @return `NULL` if an argument is `NULL`, if @p secretSize is too small,
+ *         or if @p workspace is too small.
+ */
+XXH_PUBLIC_API XXH3_preparedSecret_t*
+XXH3_initPreparedSecret(void* workspace, size_t workspaceSize,
+                        XXH_NOESCAPE const void* secret, size_t secretSize);
+
+/*!
+ * @brief 64-bit variant of XXH3 with a prepared custom secret.
  *
- * @par Possible options:
+ * @return The same value as XXH3_64bits_withSecret() with the original secret.
+ */
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_withPreparedSecret(XXH_NOESCAPE const void* input, size_t length,
+                               XXH_NOESCAPE const XXH3_preparedSecret_t* prepared);
+
+/*!
+ * @brief 128-bit variant of XXH3 with a prepared custom secret.
  *
- *  - `XXH_FORCE_MEMORY_ACCESS=0` (default): `memcpy`
- *   @par
- *     Use `memcpy()`. Safe and portable. Note that most modern compilers will
- *     eliminate the function call and treat it as an unaligned access.
+ * @return The same value as XXH3_128bits_withSecret() with the original secret.
+ */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_128bits_withPreparedSecret(XXH_NOESCAPE const void* input, size_t length,
+                                XXH_NOESCAPE const XXH3_preparedSecret_t* prepared);
+
+#ifndef XXH_NO_STREAM
+/* ===   XXH3 compact streaming state   === */
+
+/*!
+ * @brief Structure for a compact XXH3 streaming state.
  *
- *  - `XXH_FORCE_MEMORY_ACCESS=1`: `__attribute__((aligned(1)))`
- *   @par
- *     Depends on compiler extensions and is therefore not portable.
- *     This method is safe _if_ your compiler supports it,
- *     and *generally* as fast or faster than `memcpy`.
+ * A lighter alternative to @ref XXH3_state_t, for applications keeping
+ * a large number of streams open simultaneously:
+ *  - The secret is not stored, but referenced: it is either the default secret,
+ *    a custom secret, or the secret of an @ref XXH3_seedContext_t, which can be
+ *    shared by all streams. It must remain valid while the state is in use.
+ *  - There is no 64-byte alignment requirement:
+ *    it can be allocated with `malloc()`, or embedded in another structure.
  *
- *  - `XXH_FORCE_MEMORY_ACCESS=2`: Direct cast
- *  @par
- *     Casts directly and dereferences. This method doesn't depend on the
- *     compiler, but it violates the C standard as it directly dereferences an
- *     unaligned pointer. It can generate buggy code on targets which do not
- *     support unaligned memory accesses, but in some circumstances, it's the
- *     only known way to get the most performance.
+ * Hashes are identical to those of @ref XXH3_state_t.
  *
- *  - `XXH_FORCE_MEMORY_ACCESS=3`: Byteshift
- *  @par
- *     Also portable. This can generate the best code on old compilers which don't
- *     inline small `memcpy()` calls, and it might also be faster on big-endian
- *     systems which lack a native byteswap instruction. However, some compilers
- *     will emit literal byteshifts even if the target supports unaligned access.
+ * The internal buffer can't be smaller than @ref XXH3_INTERNALBUFFER_SIZE:
+ * inputs up to @ref XXH3_MIDSIZE_MAX bytes must be kept entirely until the digest.
  *
+ * Compact states are not dispatched by `xxh_x86dispatch.c`:
+ * they always use the vector extension selected at compile time (@ref XXH_VECTOR).
  *
- * @warning
- *   Methods 1 and 2 rely on implementation-defined behavior. Use these with
- *   care, as what works on one compiler/platform/optimization level may cause
- *   another to read garbage data or even crash.
+ * @note This is only defined when @ref XXH_STATIC_LINKING_ONLY,
+ * @ref XXH_INLINE_ALL, or @ref XXH_IMPLEMENTATION is defined.
+ * Do never access the members of this struct directly.
+ */
+struct XXH3_compactState_s {
+   XXH64_hash_t acc[8];
+       /*!< The 8 accumulators. */
+   XXH64_hash_t totalLen;
+       /*!< Total length hashed. */
+   XXH64_hash_t seed;
+       /*!< Seed, when reset with a seed context. */
+   const unsigned char* secret;
+       /*!< Reference to the secret. */
+   XXH32_hash_t secretLimit;
+       /*!< Size of @ref secret, minus one stripe. */
+   XXH32_hash_t nbStripesSoFar;
+       /*!< Number of stripes processed in the current block. */
+   XXH32_hash_t bufferedSize;
+       /*!< The amount of memory in @ref buffer. */
+   XXH32_hash_t useSeed;
+       /*!< Whether short inputs are hashed with @ref seed. */
+   unsigned char buffer[XXH3_INTERNALBUFFER_SIZE];
+       /*!< The internal buffer. */
+};   /* typedef'd to XXH3_compactState_t */
+
+/*!
+ * @brief The type of a compact XXH3 streaming state.
+ * @see XXH3_compactState_s for details.
+ */
+typedef struct XXH3_compactState_s XXH3_compactState_t;
+
+/*!
+ * @brief Resets an @ref XXH3_compactState_t, to hash with the default secret.
  *
- * See https://fastcompression.blogspot.com/2015/08/accessing-unaligned-memory.html for details.
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p statePtr is `NULL`.
  *
- * Prefer these methods in priority order (0 > 3 > 1 > 2)
+ * @see XXH3_64bits_reset()
  */
-#  define XXH_FORCE_MEMORY_ACCESS 0
+XXH_PUBLIC_API XXH_errorcode XXH3_compact_reset(XXH_NOESCAPE XXH3_compactState_t* statePtr);
 
 /*!
- * @def XXH_SIZE_OPT
- * @brief Controls how much xxHash optimizes for size.
- *
- * xxHash, when compiled, tends to result in a rather large binary size. This
- * is mostly due to heavy usage to forced inlining and constant folding of the
- * @ref XXH3_family to increase performance.
+ * @brief Resets an @ref XXH3_compactState_t, to hash with a custom secret.
  *
- * However, some developers prefer size over speed. This option can
- * significantly reduce the size of the generated code. When using the `-Os`
- * or `-Oz` options on GCC or Clang, this is defined to 1 by default,
- * otherwise it is defined to 0.
+ * @p secret is referenced, not copied: it must remain valid and unmodified
+ * until the last digest of the stream.
  *
- * Most of these size optimizations can be controlled manually.
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure.
  *
- * This is a number from 0-2.
- *  - `XXH_SIZE_OPT` == 0: Default. xxHash makes no size optimizations. Speed
- *    comes first.
- *  - `XXH_SIZE_OPT` == 1: Default for `-Os` and `-Oz`. xxHash is more
- *    conservative and disables hacks that increase code size. It implies the
- *    options @ref XXH_NO_INLINE_HINTS == 1, @ref XXH_FORCE_ALIGN_CHECK == 0,
- *    and @ref XXH3_NEON_LANES == 8 if they are not already defined.
- *  - `XXH_SIZE_OPT` == 2: xxHash tries to make itself as small as possible.
- *    Performance may cry. For example, the single shot functions just use the
- *    streaming API.
+ * @see XXH3_64bits_reset_withSecret()
  */
-#  define XXH_SIZE_OPT 0
+XXH_PUBLIC_API XXH_errorcode
+XXH3_compact_reset_withSecret(XXH_NOESCAPE XXH3_compactState_t* statePtr,
+                              XXH_NOESCAPE const void* secret, size_t secretSize);
 
 /*!
- * @def XXH_FORCE_ALIGN_CHECK
- * @brief If defined to non-zero, adds a special path for aligned inputs (XXH32()
- * and XXH64() only).
- *
- * This is an important performance trick for architectures without decent
- * unaligned memory access performance.
+ * @brief Resets an @ref XXH3_compactState_t, to hash with the seed of a seed context.
  *
- * It checks for input alignment, and when conditions are met, uses a "fast
- * path" employing direct 32-bit/64-bit reads, resulting in _dramatically
- * faster_ read speed.
- *
- * The check costs one initial branch per hash, which is generally negligible,
- * but not zero.
+ * @p context is referenced, not copied: it must remain valid and unmodified
+ * until the last digest of the stream.
+ * Results are the same as with `XXH3_64bits_reset_withSeed(state, context->seed)`.
  *
- * Moreover, it's not useful to generate an additional code path if memory
- * access uses the same instruction for both aligned and unaligned
- * addresses (e.g. x86 and aarch64).
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_compact_reset_withSeedContext(XXH_NOESCAPE XXH3_compactState_t* statePtr,
+                                   XXH_NOESCAPE const XXH3_seedContext_t* context);
+
+/*!
+ * @brief Consumes a block of @p input into an @ref XXH3_compactState_t.
  *
- * In these cases, the alignment check can be removed by setting this macro to 0.
- * Then the code will always use unaligned memory access.
- * Align check is automatically disabled on x86, x64, ARM64, and some ARM chips
- * which are platforms known to offer good unaligned memory accesses performance.
+ * The same state serves both the 64-bit and the 128-bit digests.
  *
- * It is also disabled by default when @ref XXH_SIZE_OPT >= 1.
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR on failure.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_compact_update(XXH_NOESCAPE XXH3_compactState_t* statePtr,
+                    XXH_NOESCAPE const void* input, size_t length);
+
+/*!
+ * @brief Returns the 64-bit hash of the data ingested by an @ref XXH3_compactState_t.
  *
- * This option does not affect XXH3 (only XXH32 and XXH64).
+ * The state is left unaltered: more input can be ingested afterwards.
  */
-#  define XXH_FORCE_ALIGN_CHECK 0
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_compact_64bits_digest(XXH_NOESCAPE const XXH3_compactState_t* statePtr);
 
 /*!
- * @def XXH_NO_INLINE_HINTS
- * @brief When non-zero, sets all functions to `static`.
+ * @brief Returns the 128-bit hash of the data ingested by an @ref XXH3_compactState_t.
  *
- * By default, xxHash tries to force the compiler to inline almost all internal
- * functions.
+ * The state is left unaltered: more input can be ingested afterwards.
+ */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_compact_128bits_digest(XXH_NOESCAPE const XXH3_compactState_t* statePtr);
+
+/* ===   XXH3 state pool   === */
+
+/*!
+ * @brief A fixed set of @ref XXH3_state_t, allocated at once.
  *
- * This can usually improve performance due to reduced jumping and improved
- * constant folding, but significantly increases the size of the binary which
- * might not be favorable.
+ * Applications which create and free states at a high rate can acquire
+ * them from a pool instead: after XXH3_createStatePool(), neither
+ * XXH3_acquireState() nor XXH3_releaseState() invoke the allocator.
  *
- * Additionally, sometimes the forced inlining can be detrimental to performance,
- * depending on the architecture.
+ * A pool is not thread-safe: use one pool per thread.
+ */
+typedef struct XXH3_statePool_s XXH3_statePool_t;
+
+/*!
+ * @brief Allocates a pool of @p nbStates states, in a single allocation.
  *
- * XXH_NO_INLINE_HINTS marks all internal functions as static, giving the
- * compiler full control on whether to inline or not.
+ * @return An allocated pool on success.
+ * @return `NULL` if @p nbStates is 0, or on allocation failure.
  *
- * When not optimizing (-O0), using `-fno-inline` with GCC or Clang, or if
- * @ref XXH_SIZE_OPT >= 1, this will automatically be defined.
+ * @note Must be freed with XXH3_freeStatePool().
  */
-#  define XXH_NO_INLINE_HINTS 0
+XXH_PUBLIC_API XXH3_statePool_t* XXH3_createStatePool(size_t nbStates);
 
 /*!
- * @def XXH3_INLINE_SECRET
- * @brief Determines whether to inline the XXH3 withSecret code.
+ * @brief Frees a pool, and all the states it contains.
  *
- * When the secret size is known, the compiler can improve the performance
- * of XXH3_64bits_withSecret() and XXH3_128bits_withSecret().
+ * @return @ref XXH_OK.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH3_freeStatePool(XXH3_statePool_t* pool);
+
+/*!
+ * @brief Takes an @ref XXH3_state_t from @p pool.
  *
- * However, if the secret size is not known, it doesn't have any benefit. This
- * happens when xxHash is compiled into a global symbol. Therefore, if
- * @ref XXH_INLINE_ALL is *not* defined, this will be defined to 0.
+ * The state is initialized as by XXH3_createState().
  *
- * Additionally, this defaults to 0 on GCC 12+, which has an issue with function pointers
- * that are *sometimes* force inline on -Og, and it is impossible to automatically
- * detect this optimization level.
+ * @return A state on success.
+ * @return `NULL` if all states of @p pool are in use.
  */
-#  define XXH3_INLINE_SECRET 0
+XXH_PUBLIC_API XXH3_state_t* XXH3_acquireState(XXH_NOESCAPE XXH3_statePool_t* pool);
 
 /*!
- * @def XXH32_ENDJMP
- * @brief Whether to use a jump for `XXH32_finalize`.
+ * @brief Gives back to @p pool a state obtained with XXH3_acquireState().
  *
- * For performance, `XXH32_finalize` uses multiple branches in the finalizer.
- * This is generally preferable for performance,
- * but depending on exact architecture, a jmp may be preferable.
+ * Each acquired state must be released at most once.
  *
- * This setting is only possibly making a difference for very small inputs.
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p statePtr doesn't belong to @p pool.
  */
-#  define XXH32_ENDJMP 0
+XXH_PUBLIC_API XXH_errorcode XXH3_releaseState(XXH_NOESCAPE XXH3_statePool_t* pool, XXH3_state_t* statePtr);
+#endif /* !XXH_NO_STREAM */
+
+/* ===   XXH3 scatter-gather   === */
 
 /*!
- * @internal
- * @brief Redefines old internal names.
+ * @brief A segment of input, for XXH3_64bits_iov() and XXH3_128bits_iov().
  *
- * For compatibility with code that uses xxHash's internals before the names
- * were changed to improve namespacing. There is no other reason to use this.
+ * Its layout is the same as POSIX `struct iovec`.
  */
-#  define XXH_OLD_NAMES
-#  undef XXH_OLD_NAMES /* don't actually use, it is ugly. */
+typedef struct {
+    const void* ptr;  /*!< Start of the segment. Can be `NULL` if @ref size is 0. */
+    size_t size;      /*!< Size of the segment, in bytes. */
+} XXH_iovec_t;
 
 /*!
- * @def XXH_NO_STREAM
- * @brief Disables the streaming API.
+ * @brief 64-bit hash of the concatenation of @p iovcnt segments.
  *
- * When xxHash is not inlined and the streaming functions are not used, disabling
- * the streaming functions can improve code size significantly, especially with
- * the @ref XXH3_family which tends to make constant folded copies of itself.
+ * @param iov    The segments. They may overlap, or repeat the same memory.
+ * @param iovcnt Number of segments.
+ * @param result Receives the same value as XXH3_64bits() on the concatenated segments.
+ *
+ * Stripes are consumed directly from the segments. Only the stripes
+ * straddling a segment boundary, and inputs of at most
+ * @ref XXH3_MIDSIZE_MAX bytes, are copied into a small stack buffer.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR, and @p result is left unchanged,
+ *         if the total size of the segments doesn't fit in a `size_t`.
  */
-#  define XXH_NO_STREAM
-#  undef XXH_NO_STREAM /* don't actually */
-#endif /* XXH_DOXYGEN */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_iov(XXH_NOESCAPE const XXH_iovec_t* iov, size_t iovcnt,
+                XXH_NOESCAPE XXH64_hash_t* result);
+
 /*!
- * @}
+ * @brief 128-bit hash of the concatenation of @p iovcnt segments.
+ *
+ * @param result Receives the same value as XXH3_128bits() on the concatenated segments.
+ *
+ * @return @ref XXH_OK on success, or @ref XXH_ERROR as XXH3_64bits_iov().
+ * @see XXH3_64bits_iov()
  */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_iov(XXH_NOESCAPE const XXH_iovec_t* iov, size_t iovcnt,
+                 XXH_NOESCAPE XXH128_hash_t* result);
 
-#ifndef XXH_FORCE_MEMORY_ACCESS   /* can be defined externally, on command line for example */
-   /* prefer __packed__ structures (method 1) for GCC
-    * < ARMv7 with unaligned access (e.g. Raspbian armhf) still uses byte shifting, so we use memcpy
-    * which for some reason does unaligned loads. */
-#  if defined(__GNUC__) && !(defined(__ARM_ARCH) && __ARM_ARCH < 7 && defined(__ARM_FEATURE_UNALIGNED))
-#    define XXH_FORCE_MEMORY_ACCESS 1
-#  endif
-#endif
+/*!
+ * @brief 64-bit hash of a 2D region, such as the rows of an image.
+ *
+ * @param base    The first row.
+ * @param rowSize Size of each row, in bytes.
+ * @param nbRows  Number of rows.
+ * @param pitch   Distance between the start of two consecutive rows, in bytes.
+ * @param result  Receives the same value as XXH3_64bits() on the concatenated rows.
+ *
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR, and @p result is left unchanged,
+ *         if the total size, `rowSize * nbRows`, doesn't fit in a `size_t`.
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_2D(XXH_NOESCAPE const void* base, size_t rowSize, size_t nbRows, size_t pitch,
+               XXH_NOESCAPE XXH64_hash_t* result);
 
-#ifndef XXH_SIZE_OPT
-   /* default to 1 for -Os or -Oz */
-#  if (defined(__GNUC__) || defined(__clang__)) && defined(__OPTIMIZE_SIZE__)
-#    define XXH_SIZE_OPT 1
-#  else
-#    define XXH_SIZE_OPT 0
-#  endif
-#endif
+/*!
+ * @brief 128-bit hash of a 2D region.
+ *
+ * @param result Receives the same value as XXH3_128bits() on the concatenated rows.
+ *
+ * @return @ref XXH_OK on success, or @ref XXH_ERROR as XXH3_64bits_2D().
+ * @see XXH3_64bits_2D()
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_2D(XXH_NOESCAPE const void* base, size_t rowSize, size_t nbRows, size_t pitch,
+                XXH_NOESCAPE XXH128_hash_t* result);
 
-#ifndef XXH_FORCE_ALIGN_CHECK  /* can be defined externally */
-   /* don't check on sizeopt, x86, aarch64, or arm when unaligned access is available */
-#  if XXH_SIZE_OPT >= 1 || \
-      defined(__i386)  || defined(__x86_64__) || defined(__aarch64__) || defined(__ARM_FEATURE_UNALIGNED) \
-   || defined(_M_IX86) || defined(_M_X64)     || defined(_M_ARM64)    || defined(_M_ARM) /* visual */
-#    define XXH_FORCE_ALIGN_CHECK 0
-#  else
-#    define XXH_FORCE_ALIGN_CHECK 1
-#  endif
-#endif
+/* ===   XXH3 copy and hash   === */
 
-#ifndef XXH_NO_INLINE_HINTS
-#  if XXH_SIZE_OPT >= 1 || defined(__NO_INLINE__)  /* -O0, -fno-inline */
-#    define XXH_NO_INLINE_HINTS 1
-#  else
-#    define XXH_NO_INLINE_HINTS 0
-#  endif
-#endif
+/*!
+ * @brief Copies @p src into @p dst, and returns the 64-bit hash of @p src.
+ *
+ * Equivalent to `memcpy(dst, src, len)` followed by `XXH3_64bits(dst, len)`,
+ * but @p src is hashed one block at a time, right after it was copied,
+ * while it is still in cache. Large inputs are read from memory only once.
+ *
+ * @p dst and @p src must not overlap.
+ */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_copy(XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len);
 
-#ifndef XXH3_INLINE_SECRET
-#  if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12) \
-     || !defined(XXH_INLINE_ALL)
-#    define XXH3_INLINE_SECRET 0
-#  else
-#    define XXH3_INLINE_SECRET 1
-#  endif
-#endif
+/*!
+ * @brief Copies @p src into @p dst, and returns the 128-bit hash of @p src.
+ *
+ * @see XXH3_64bits_copy()
+ */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_copy(XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len);
 
-#ifndef XXH32_ENDJMP
-/* generally preferable for performance */
-#  define XXH32_ENDJMP 0
-#endif
+#ifndef XXH_NO_STREAM
+/*!
+ * @brief Copies @p src into @p dst, and consumes @p src into @p statePtr.
+ *
+ * Equivalent to `memcpy(dst, src, len)` followed by
+ * `XXH3_64bits_update(statePtr, dst, len)`, see XXH3_64bits_copy().
+ */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_update_copy(XXH_NOESCAPE XXH3_state_t* statePtr,
+                        XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len);
 
 /*!
- * @defgroup impl Implementation
- * @{
+ * @brief Copies @p src into @p dst, and consumes @p src into @p statePtr.
+ *
+ * @see XXH3_64bits_update_copy()
  */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_update_copy(XXH_NOESCAPE XXH3_state_t* statePtr,
+                         XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len);
+#endif /* !XXH_NO_STREAM */
 
+/* ===   XXH3 prefetch distance   === */
 
-/* *************************************
-*  Includes & Memory related functions
-***************************************/
-#if defined(XXH_NO_STREAM)
-/* nothing */
-#elif defined(XXH_NO_STDLIB)
+/*! @brief Largest distance used by XXH3_64bits_withPrefetchDistance(). */
+#define XXH3_PREFETCH_DIST_MAX 4096
 
-/* When requesting to disable any mention of stdlib,
- * the library loses the ability to invoked malloc / free.
- * In practice, it means that functions like `XXH*_createState()`
- * will always fail, and return NULL.
- * This flag is useful in situations where
- * xxhash.h is integrated into some kernel, embedded or limited environment
- * without access to dynamic allocation.
+/*!
+ * @brief Same as XXH3_64bits(), prefetching @p prefetchDistance bytes ahead.
+ *
+ * Other functions prefetch @ref XXH_PREFETCH_DIST bytes ahead, which is fixed
+ * at compile time. The best distance for long inputs depends on the host,
+ * see XXH3_calibrate(). Hash values do not depend on it.
+ *
+ * @param prefetchDistance How far ahead, in bytes, the long input loop prefetches.
+ *                         It is capped at @ref XXH3_PREFETCH_DIST_MAX.
+ *
+ * @return The same value as XXH3_64bits().
  */
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_withPrefetchDistance(XXH_NOESCAPE const void* input, size_t length, size_t prefetchDistance);
 
-static XXH_CONSTF void* XXH_malloc(size_t s) { (void)s; return NULL; }
-static void XXH_free(void* p) { (void)p; }
+/*!
+ * @brief Same as XXH3_128bits(), prefetching @p prefetchDistance bytes ahead.
+ *
+ * @return The same value as XXH3_128bits().
+ * @see XXH3_64bits_withPrefetchDistance()
+ */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_128bits_withPrefetchDistance(XXH_NOESCAPE const void* input, size_t length, size_t prefetchDistance);
 
-#else
+#if defined(XXH_CALIBRATE) && (XXH_CALIBRATE) && !defined(XXH_NO_STDLIB)
+/*!
+ * @brief Measures a few prefetch distances on this host, and returns the fastest.
+ *
+ * Hashes a temporary buffer of 8 MB with XXH3_64bits_withPrefetchDistance()
+ * and each candidate distance, timed with `clock()`.
+ * This takes a fraction of a second, and is meant to be called once at startup.
+ * It has no side effect: pass the result to the `_withPrefetchDistance()` functions.
+ *
+ * Only available when the implementation is compiled with @ref XXH_CALIBRATE=1,
+ * and not with @ref XXH_NO_STDLIB.
+ *
+ * @return The fastest prefetch distance, in bytes.
+ * @return @ref XXH_PREFETCH_DIST if the buffer can't be allocated.
+ */
+XXH_PUBLIC_API size_t XXH3_calibrate(void);
+#endif
 
-/*
- * Modify the local functions below should you wish to use
- * different memory routines for malloc() and free()
+/* ===   XXH3 padded inputs   === */
+
+/*!
+ * @brief Number of bytes after the end of the input that XXH3_64bits_padded() may read.
  */
-#include <stdlib.h>
+#define XXH3_PADDING 16
 
 /*!
- * @internal
- * @brief Modify this function to use a different routine than malloc().
+ * @brief Same as XXH3_64bits(), for inputs followed by readable padding.
+ *
+ * Up to @ref XXH3_PADDING bytes past `input + length` may be read,
+ * including when @p length is 0: @p input must never be `NULL`.
+ * The padding bytes don't influence the result.
+ *
+ * In exchange, inputs of up to @ref XXH3_MIDSIZE_MAX bytes are hashed
+ * with a single branch per size range (0-16, 17-128, 129-240),
+ * instead of one per length class and per 32 bytes.
+ * Latency is the same for all lengths of a range, and doesn't depend on
+ * branch prediction, which suits tables of keys of unpredictable lengths.
+ * When lengths are predictable, XXH3_64bits() is faster.
  */
-static XXH_MALLOCF void* XXH_malloc(size_t s) { return malloc(s); }
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_padded(XXH_NOESCAPE const void* input, size_t length);
 
 /*!
- * @internal
- * @brief Modify this function to use a different routine than free().
+ * @brief Same as XXH3_64bits_withSeed(), for inputs followed by readable padding.
+ *
+ * @see XXH3_64bits_padded()
  */
-static void XXH_free(void* p) { free(p); }
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_padded_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed);
 
-#endif  /* XXH_NO_STDLIB */
+/* ===   XXH3 ASCII case-insensitive   === */
 
-#include <string.h>
+/*!
+ * @brief 64-bit hash of @p input, with ASCII letters folded to lowercase.
+ *
+ * Returns exactly `XXH3_64bits()` of a copy of @p input in which bytes
+ * 'A' to 'Z' are replaced by 'a' to 'z'. All other bytes, including
+ * non-ASCII ones, are hashed as is.
+ * No copy is allocated: up to 240 bytes, words are folded as they are loaded.
+ * Longer inputs are folded by small blocks on the stack,
+ * each one hashed while it is still in cache.
+ *
+ * Useful for case-insensitive keys, such as HTTP header names or DNS labels.
+ */
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_asciiFold(XXH_NOESCAPE const void* input, size_t length);
 
 /*!
- * @internal
- * @brief Modify this function to use a different routine than memcpy().
+ * @brief Same as XXH3_64bits_withSeed(), with ASCII letters folded to lowercase.
+ * @see XXH3_64bits_asciiFold()
  */
-static void* XXH_memcpy(void* dest, const void* src, size_t size)
-{
-    return memcpy(dest,src,size);
-}
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_asciiFold_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed);
 
-#include <limits.h>   /* ULLONG_MAX */
+/*!
+ * @brief Same as XXH3_128bits(), with ASCII letters folded to lowercase.
+ * @see XXH3_64bits_asciiFold()
+ */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_128bits_asciiFold(XXH_NOESCAPE const void* input, size_t length);
 
+/*!
+ * @brief Same as XXH3_128bits_withSeed(), with ASCII letters folded to lowercase.
+ * @see XXH3_64bits_asciiFold()
+ */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_128bits_asciiFold_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed);
 
-/* *************************************
-*  Compiler Specific Options
-***************************************/
-#ifdef _MSC_VER /* Visual Studio warning fix */
-#  pragma warning(disable : 4127) /* disable: C4127: conditional expression is constant */
-#endif
-
-#if XXH_NO_INLINE_HINTS  /* disable inlining hints */
-#  if defined(__GNUC__) || defined(__clang__)
-#    define XXH_FORCE_INLINE static __attribute__((__unused__))
-#  else
-#    define XXH_FORCE_INLINE static
-#  endif
-#  define XXH_NO_INLINE static
-/* enable inlining hints */
-#elif defined(__GNUC__) || defined(__clang__)
-#  define XXH_FORCE_INLINE static __inline__ __attribute__((__always_inline__, __unused__))
-#  define XXH_NO_INLINE static __attribute__((__noinline__))
-#elif defined(_MSC_VER)  /* Visual Studio */
-#  define XXH_FORCE_INLINE static __forceinline
-#  define XXH_NO_INLINE static __declspec(noinline)
-#elif defined (__cplusplus) \
-  || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L))   /* C99 */
-#  define XXH_FORCE_INLINE static inline
-#  define XXH_NO_INLINE static
-#else
-#  define XXH_FORCE_INLINE static
-#  define XXH_NO_INLINE static
-#endif
+#ifndef XXH_NO_STREAM
+/* ===   XXH3 typed appends   === */
 
-#if XXH3_INLINE_SECRET
-#  define XXH3_WITH_SECRET_INLINE XXH_FORCE_INLINE
-#else
-#  define XXH3_WITH_SECRET_INLINE XXH_NO_INLINE
-#endif
+/*!
+ * @brief Appends @p value to the hash, for both 64 and 128-bit streaming.
+ *
+ * Same as XXH3_64bits_update() with the byte of @p value, but without a pointer
+ * and a length to handle: @p value is written straight into the internal buffer,
+ * and stripes are only consumed when the buffer fills.
+ * Meant for serializers hashing many small fields.
+ */
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u8(XXH_NOESCAPE XXH3_state_t* statePtr, unsigned char value);
 
+/*!
+ * @brief Appends the 2 bytes of @p value, in little-endian byte order.
+ * @see XXH3_update_u8()
+ */
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u16(XXH_NOESCAPE XXH3_state_t* statePtr, unsigned short value);
 
-/* *************************************
-*  Debug
-***************************************/
 /*!
- * @ingroup tuning
- * @def XXH_DEBUGLEVEL
- * @brief Sets the debugging level.
- *
- * XXH_DEBUGLEVEL is expected to be defined externally, typically via the
- * compiler's command line options. The value must be a number.
+ * @brief Appends the 4 bytes of @p value, in little-endian byte order.
+ * @see XXH3_update_u8()
  */
-#ifndef XXH_DEBUGLEVEL
-#  ifdef DEBUGLEVEL /* backwards compat */
-#    define XXH_DEBUGLEVEL DEBUGLEVEL
-#  else
-#    define XXH_DEBUGLEVEL 0
-#  endif
-#endif
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u32(XXH_NOESCAPE XXH3_state_t* statePtr, XXH32_hash_t value);
 
-#if (XXH_DEBUGLEVEL>=1)
-#  include <assert.h>   /* note: can still be disabled with NDEBUG */
-#  define XXH_ASSERT(c)   assert(c)
-#else
-#  if defined(__INTEL_COMPILER)
-#    define XXH_ASSERT(c)   XXH_ASSUME((unsigned char) (c))
-#  else
-#    define XXH_ASSERT(c)   XXH_ASSUME(c)
-#  endif
-#endif
+/*!
+ * @brief Appends the 8 bytes of @p value, in little-endian byte order.
+ * @see XXH3_update_u8()
+ */
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u64(XXH_NOESCAPE XXH3_state_t* statePtr, XXH64_hash_t value);
 
-/* note: use after variable declarations */
-#ifndef XXH_STATIC_ASSERT
-#  if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)    /* C11 */
-#    define XXH_STATIC_ASSERT_WITH_MESSAGE(c,m) do { _Static_assert((c),m); } while(0)
-#  elif defined(__cplusplus) && (__cplusplus >= 201103L)            /* C++11 */
-#    define XXH_STATIC_ASSERT_WITH_MESSAGE(c,m) do { static_assert((c),m); } while(0)
-#  else
-#    define XXH_STATIC_ASSERT_WITH_MESSAGE(c,m) do { struct xxh_sa { char x[(c) ? 1 : -1]; }; } while(0)
-#  endif
-#  define XXH_STATIC_ASSERT(c) XXH_STATIC_ASSERT_WITH_MESSAGE((c),#c)
-#endif
+/* ===   XXH3 prefix checkpoints   === */
 
 /*!
- * @internal
- * @def XXH_COMPILER_GUARD(var)
- * @brief Used to prevent unwanted optimizations for @p var.
+ * @brief A checkpoint of a stream, for hashing many keys sharing a common prefix.
  *
- * It uses an empty GCC inline assembly statement with a register constraint
- * which forces @p var into a general purpose register (eg eax, ebx, ecx
- * on x86) and marks it as modified.
+ * Feed the common prefix to an @ref XXH3_state_t, capture it once with
+ * XXH3_prefix_capture(), then hash each key's suffix with
+ * XXH3_64bits_withPrefix() or XXH3_128bits_withPrefix().
+ * The result is the digest of the prefix followed by the suffix.
  *
- * This is used in a few places to avoid unwanted autovectorization (e.g.
- * XXH32_round()). All vectorization we want is explicit via intrinsics,
- * and _usually_ isn't wanted elsewhere.
+ * Unlike XXH3_copyState() followed by an update and a digest, the checkpoint
+ * is never modified: each call only copies the accumulators and the buffered
+ * tail of the prefix, so its cost scales with the length of the suffix.
+ * A checkpoint can be shared by multiple threads.
  *
- * We also use it to prevent unwanted constant folding for AArch64 in
- * XXH3_initCustomSecret_scalar().
+ * If the state was reset with a custom secret, that secret is referenced,
+ * and must remain valid while the checkpoint is in use.
+ * A secret derived from a seed is copied into the checkpoint.
+ *
+ * @note This is only defined when @ref XXH_STATIC_LINKING_ONLY,
+ * @ref XXH_INLINE_ALL, or @ref XXH_IMPLEMENTATION is defined.
+ * Do never access the members of this struct directly.
  */
-#if defined(__GNUC__) || defined(__clang__)
-#  define XXH_COMPILER_GUARD(var) __asm__("" : "+r" (var))
-#else
-#  define XXH_COMPILER_GUARD(var) ((void)0)
-#endif
-
-/* Specifically for NEON vectors which use the "w" constraint, on
- * Clang. */
-#if defined(__clang__) && defined(__ARM_ARCH) && !defined(__wasm__)
-#  define XXH_COMPILER_GUARD_CLANG_NEON(var) __asm__("" : "+w" (var))
-#else
-#  define XXH_COMPILER_GUARD_CLANG_NEON(var) ((void)0)
-#endif
-
-/* *************************************
-*  Basic Types
-***************************************/
-#if !defined (__VMS) \
- && (defined (__cplusplus) \
- || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */) )
-#   ifdef _AIX
-#     include <inttypes.h>
-#   else
-#     include <stdint.h>
-#   endif
-    typedef uint8_t xxh_u8;
-#else
-    typedef unsigned char xxh_u8;
-#endif
-typedef XXH32_hash_t xxh_u32;
-
-#ifdef XXH_OLD_NAMES
-#  warning "XXH_OLD_NAMES is planned to be removed starting v0.9. If the program depends on it, consider moving away from it by employing newer type names directly"
-#  define BYTE xxh_u8
-#  define U8   xxh_u8
-#  define U32  xxh_u32
-#endif
+struct XXH3_prefix_s {
+   XXH64_hash_t acc[8];
+       /*!< The 8 accumulators, after the stripes consumed so far. */
+   XXH64_hash_t totalLen;
+       /*!< Length of the prefix. */
+   XXH64_hash_t seed;
+       /*!< Seed, see @ref XXH3_state_s::seed. */
+   const unsigned char* extSecret;
+       /*!< Reference to an external secret, NULL when using @ref customSecret. */
+   XXH32_hash_t secretLimit;
+       /*!< Size of the secret, minus one stripe. */
+   XXH32_hash_t nbStripesSoFar;
+       /*!< Number of stripes processed in the current block. */
+   XXH32_hash_t bufferedSize;
+       /*!< The amount of unconsumed prefix in @ref buffer. */
+   XXH32_hash_t useSeed;
+       /*!< Whether short inputs are hashed with @ref seed. */
+   unsigned char customSecret[XXH3_SECRET_DEFAULT_SIZE];
+       /*!< Secret derived from @ref seed. */
+   unsigned char buffer[XXH3_INTERNALBUFFER_SIZE];
+       /*!< The internal buffer of the state. */
+};   /* typedef'd to XXH3_prefix_t */
 
-/* ***   Memory access   *** */
+/*!
+ * @brief The type of a prefix checkpoint.
+ * @see XXH3_prefix_s for details.
+ */
+typedef struct XXH3_prefix_s XXH3_prefix_t;
 
 /*!
- * @internal
- * @fn xxh_u32 XXH_read32(const void* ptr)
- * @brief Reads an unaligned 32-bit integer from @p ptr in native endianness.
+ * @brief Captures the input ingested so far by @p statePtr as a prefix.
  *
- * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
+ * Works for both 64-bit and 128-bit streaming, whatever the reset variant.
+ * @p statePtr is not modified, and can continue ingesting input.
  *
- * @param ptr The pointer to read from.
- * @return The 32-bit native endian integer from the bytes at @p ptr.
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p prefix or @p statePtr is `NULL`.
  */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_prefix_capture(XXH_NOESCAPE XXH3_prefix_t* prefix, XXH_NOESCAPE const XXH3_state_t* statePtr);
 
 /*!
- * @internal
- * @fn xxh_u32 XXH_readLE32(const void* ptr)
- * @brief Reads an unaligned 32-bit little endian integer from @p ptr.
- *
- * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
+ * @brief Hashes the prefix captured in @p prefix, followed by @p suffix.
  *
- * @param ptr The pointer to read from.
- * @return The 32-bit little endian integer from the bytes at @p ptr.
+ * @return The same value as XXH3_64bits_digest() on the captured state,
+ *         after XXH3_64bits_update() with @p suffix.
  */
+XXH_PUBLIC_API XXH_PUREF XXH64_hash_t
+XXH3_64bits_withPrefix(XXH_NOESCAPE const XXH3_prefix_t* prefix,
+                       XXH_NOESCAPE const void* suffix, size_t length);
 
 /*!
- * @internal
- * @fn xxh_u32 XXH_readBE32(const void* ptr)
- * @brief Reads an unaligned 32-bit big endian integer from @p ptr.
- *
- * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
- *
- * @param ptr The pointer to read from.
- * @return The 32-bit big endian integer from the bytes at @p ptr.
+ * @brief Same as XXH3_64bits_withPrefix(), for XXH3_128bits_digest().
  */
+XXH_PUBLIC_API XXH_PUREF XXH128_hash_t
+XXH3_128bits_withPrefix(XXH_NOESCAPE const XXH3_prefix_t* prefix,
+                        XXH_NOESCAPE const void* suffix, size_t length);
+#endif /* !XXH_NO_STREAM */
+
+/* ===   XXH3 dual width   === */
 
 /*!
- * @internal
- * @fn xxh_u32 XXH_readLE32_align(const void* ptr, XXH_alignment align)
- * @brief Like @ref XXH_readLE32(), but has an option for aligned reads.
+ * @brief Calculates both the 64-bit and the 128-bit hash of @p input.
  *
- * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
- * Note that when @ref XXH_FORCE_ALIGN_CHECK == 0, the @p align parameter is
- * always @ref XXH_alignment::XXH_unaligned.
+ * @param input  The data to hash.
+ * @param length The length of @p input, in bytes.
+ * @param h64    Receives the same value as XXH3_64bits().
+ * @param h128   Receives the same value as XXH3_128bits().
  *
- * @param ptr The pointer to read from.
- * @param align Whether @p ptr is aligned.
- * @pre
- *   If @p align == @ref XXH_alignment::XXH_aligned, @p ptr must be 4 byte
- *   aligned.
- * @return The 32-bit little endian integer from the bytes at @p ptr.
+ * Beyond @ref XXH3_MIDSIZE_MAX bytes, both widths share the same accumulation,
+ * and only differ in finalization: @p input is read once,
+ * at about the cost of XXH3_128bits() alone.
+ * Shorter inputs are hashed twice, from cache.
+ *
+ * @pre @p h64 and @p h128 must not be `NULL`.
  */
+XXH_PUBLIC_API void
+XXH3_dual(XXH_NOESCAPE const void* input, size_t length,
+          XXH_NOESCAPE XXH64_hash_t* h64, XXH_NOESCAPE XXH128_hash_t* h128);
 
-#if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
-/*
- * Manual byteshift. Best for old compilers which don't inline memcpy.
- * We actually directly use XXH_readLE32 and XXH_readBE32.
+/*!
+ * @brief Same as XXH3_dual(), for XXH3_64bits_withSeed() and XXH3_128bits_withSeed().
  */
-#elif (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==2))
+XXH_PUBLIC_API void
+XXH3_dual_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed,
+                   XXH_NOESCAPE XXH64_hash_t* h64, XXH_NOESCAPE XXH128_hash_t* h128);
 
-/*
- * Force direct memory access. Only works on CPU which support unaligned memory
- * access in hardware.
+#ifndef XXH_NO_STREAM
+/*!
+ * @brief Same as XXH3_dual(), for XXH3_64bits_digest() and XXH3_128bits_digest().
+ *
+ * Works whether @p statePtr was reset with a 64-bit or 128-bit function.
  */
-static xxh_u32 XXH_read32(const void* memPtr) { return *(const xxh_u32*) memPtr; }
+XXH_PUBLIC_API void
+XXH3_dual_digest(XXH_NOESCAPE const XXH3_state_t* statePtr,
+                 XXH_NOESCAPE XXH64_hash_t* h64, XXH_NOESCAPE XXH128_hash_t* h128);
+#endif /* !XXH_NO_STREAM */
 
-#elif (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==1))
+/* ===   XXH3 multiple seeds   === */
 
-/*
- * __attribute__((aligned(1))) is supported by gcc and clang. Originally the
- * documentation claimed that it only increased the alignment, but actually it
- * can decrease it on gcc, clang, and icc:
- * https://gcc.gnu.org/bugzilla/show_bug.cgi?id=69502,
- * https://gcc.godbolt.org/z/xYez1j67Y.
+/*!
+ * @brief Calculates the 64-bit XXH3 hash of one input with several seeds.
+ *
+ * @param input   The data to hash.
+ * @param length  The length of @p input, in bytes.
+ * @param seeds   An array of @p nbSeeds seeds.
+ * @param nbSeeds The number of seeds.
+ * @param out     An array receiving the @p nbSeeds hash values.
+ *
+ * `out[n]` receives *exactly* the same value as
+ * `XXH3_64bits_withSeed(input, length, seeds[n])`.
+ *
+ * Meant for Bloom filters and MinHash, which need k hashes of each input.
+ * The input is dispatched once, and beyond @ref XXH3_MIDSIZE_MAX bytes,
+ * the secret of each seed is derived once.
+ * On the SSE2 code path, groups of up to 4 seeds are advanced in lock-step
+ * over each stripe of @p input, so that the CPU can overlap their
+ * independent accumulations. Other code paths run their regular loop per seed.
+ * See @ref XXH3_MULTI_LOCKSTEP.
  */
-#ifdef XXH_OLD_NAMES
-typedef union { xxh_u32 u32; } __attribute__((__packed__)) unalign;
-#endif
-static xxh_u32 XXH_read32(const void* ptr)
-{
-    typedef __attribute__((__aligned__(1))) xxh_u32 xxh_unalign32;
-    return *((const xxh_unalign32*)ptr);
-}
-
-#else
+XXH_PUBLIC_API void
+XXH3_64bits_multiSeed(XXH_NOESCAPE const void* input, size_t length,
+                      XXH_NOESCAPE const XXH64_hash_t* seeds, size_t nbSeeds,
+                      XXH_NOESCAPE XXH64_hash_t* out);
 
-/*
- * Portable and safe solution. Generally efficient.
- * see: https://fastcompression.blogspot.com/2015/08/accessing-unaligned-memory.html
+#ifndef XXH_NO_STREAM
+/*!
+ * @brief Maximum size of a saved @ref XXH3_state_t, in bytes.
+ *
+ * At most @ref XXH3_INTERNALBUFFER_SIZE bytes of input are saved.
  */
-static xxh_u32 XXH_read32(const void* memPtr)
-{
-    xxh_u32 val;
-    XXH_memcpy(&val, memPtr, sizeof(val));
-    return val;
-}
-
-#endif   /* XXH_FORCE_DIRECT_MEMORY_ACCESS */
-
-
-/* ***   Endianness   *** */
+#define XXH3_SAVESTATE_SIZE_MAX (4 + 8 + 8*8 + 4 + 4 + 8 + 4 + 8 + XXH3_INTERNALBUFFER_SIZE)
 
 /*!
- * @ingroup tuning
- * @def XXH_CPU_LITTLE_ENDIAN
- * @brief Whether the target is little endian.
+ * @brief Saves an @ref XXH3_state_t into a portable binary representation.
  *
- * Defined to 1 if the target is little endian, or 0 if it is big endian.
- * It can be defined externally, for example on the compiler command line.
+ * Works for both 64-bit and 128-bit streaming, whatever the reset variant.
+ * A seed is saved as is, and the secret derived from it is regenerated on load.
+ * A custom secret is not saved: only its size and a fingerprint are,
+ * so that XXH3_loadState() can check that the same secret is provided.
  *
- * If it is not defined,
- * a runtime check (which is usually constant folded) is used instead.
+ * @see XXH32_saveState(): contract is the same.
+ */
+XXH_PUBLIC_API size_t XXH3_saveState(XXH_NOESCAPE const XXH3_state_t* statePtr, XXH_NOESCAPE void* dst, size_t dstCapacity);
+
+/*!
+ * @brief Restores an @ref XXH3_state_t saved with XXH3_saveState().
  *
- * @note
- *   This is not necessarily defined to an integer constant.
+ * @param statePtr   The state to restore into.
+ * @param src        The saved representation.
+ * @param srcSize    The size of @p src, as returned by XXH3_saveState().
+ * @param secret     If the saved state was reset with a custom secret,
+ *                   the same secret, which must remain accessible
+ *                   for the lifetime of @p statePtr. Ignored otherwise, can be NULL.
+ * @param secretSize The size of @p secret, in bytes.
  *
- * @see XXH_isLittleEndian() for the runtime check.
- */
-#ifndef XXH_CPU_LITTLE_ENDIAN
-/*
- * Try to detect endianness automatically, to avoid the nonstandard behavior
- * in `XXH_isLittleEndian()`
+ * @return @ref XXH_OK on success.
+ * @return @ref XXH_ERROR if @p src is not a valid XXH3 saved state,
+ *         or if @p secret doesn't match the one the state was using.
  */
-#  if defined(_WIN32) /* Windows is always little endian */ \
-     || defined(__LITTLE_ENDIAN__) \
-     || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
-#    define XXH_CPU_LITTLE_ENDIAN 1
-#  elif defined(__BIG_ENDIAN__) \
-     || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
-#    define XXH_CPU_LITTLE_ENDIAN 0
-#  else
-/*!
- * @internal
- * @brief Runtime check for @ref XXH_CPU_LITTLE_ENDIAN.
- *
- * Most compilers will constant fold this.
- */
-static int XXH_isLittleEndian(void)
-{
-    /*
-     * Portable and well-defined behavior.
-     * Don't use static: it is detrimental to performance.
-     */
-    const union { xxh_u32 u; xxh_u8 c[4]; } one = { 1 };
-    return one.c[0];
-}
-#   define XXH_CPU_LITTLE_ENDIAN   XXH_isLittleEndian()
-#  endif
-#endif
-
+XXH_PUBLIC_API XXH_errorcode
+XXH3_loadState(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* src, size_t srcSize,
+               const void* secret, size_t secretSize);
 
+#endif /* !XXH_NO_STREAM */
 
+#endif  /* !XXH_NO_XXH3 */
+#endif  /* XXH_NO_LONG_LONG */
+#if defined(XXH_INLINE_ALL) || defined(XXH_PRIVATE_API)
+#  define XXH_IMPLEMENTATION
+#endif
 
-/* ****************************************
-*  Compiler-specific Functions and Macros
-******************************************/
-#define XXH_GCC_VERSION (__GNUC__ * 100 + __GNUC_MINOR__)
+#endif  /* defined(XXH_STATIC_LINKING_ONLY) && !defined(XXHASH_H_STATIC_13879238742) */
 
-#ifdef __has_builtin
-#  define XXH_HAS_BUILTIN(x) __has_builtin(x)
-#else
-#  define XXH_HAS_BUILTIN(x) 0
-#endif
 
+/* ======================================================================== */
+/* ======================================================================== */
+/* ======================================================================== */
 
 
-/*
- * C23 and future versions have standard "unreachable()".
- * Once it has been implemented reliably we can add it as an
- * additional case:
+/*-**********************************************************************
+ * xxHash implementation
+ *-**********************************************************************
+ * xxHash's implementation used to be hosted inside xxhash.c.
  *
- * ```
- * #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= XXH_C23_VN)
- * #  include <stddef.h>
- * #  ifdef unreachable
- * #    define XXH_UNREACHABLE() unreachable()
- * #  endif
- * #endif
- * ```
+ * However, inlining requires implementation to be visible to the compiler,
+ * hence be included alongside the header.
+ * Previously, implementation was hosted inside xxhash.c,
+ * which was then #included when inlining was activated.
+ * This construction created issues with a few build and install systems,
+ * as it required xxhash.c to be stored in /include directory.
  *
- * Note C++23 also has std::unreachable() which can be detected
- * as follows:
- * ```
- * #if defined(__cpp_lib_unreachable) && (__cpp_lib_unreachable >= 202202L)
- * #  include <utility>
- * #  define XXH_UNREACHABLE() std::unreachable()
- * #endif
- * ```
- * NB: `__cpp_lib_unreachable` is defined in the `<version>` header.
- * We don't use that as including `<utility>` in `extern "C"` blocks
- * doesn't work on GCC12
- */
-
-#if XXH_HAS_BUILTIN(__builtin_unreachable)
-#  define XXH_UNREACHABLE() __builtin_unreachable()
-
-#elif defined(_MSC_VER)
-#  define XXH_UNREACHABLE() __assume(0)
+ * xxHash implementation is now directly integrated within xxhash.h.
+ * As a consequence, xxhash.c is no longer needed in /include.
+ *
+ * xxhash.c is still available and is still useful.
+ * In a "normal" setup, when xxhash is not inlined,
+ * xxhash.h only exposes the prototypes and public symbols,
+ * while xxhash.c can be built into an object file xxhash.o
+ * which can then be linked into the final binary.
+ ************************************************************************/
 
-#else
-#  define XXH_UNREACHABLE()
-#endif
+#if ( defined(XXH_INLINE_ALL) || defined(XXH_PRIVATE_API) \
+   || defined(XXH_IMPLEMENTATION) ) && !defined(XXH_IMPLEM_13a8737387)
+#  define XXH_IMPLEM_13a8737387
 
-#if XXH_HAS_BUILTIN(__builtin_assume)
-#  define XXH_ASSUME(c) __builtin_assume(c)
-#else
-#  define XXH_ASSUME(c) if (!(c)) { XXH_UNREACHABLE(); }
-#endif
+/* *************************************
+*  Tuning parameters
+***************************************/
 
 /*!
- * @internal
- * @def XXH_rotl32(x,r)
- * @brief 32-bit rotate left.
+ * @defgroup tuning Tuning parameters
+ * @{
  *
- * @param x The 32-bit integer to be rotated.
- * @param r The number of bits to rotate.
- * @pre
- *   @p r > 0 && @p r < 32
- * @note
- *   @p x and @p r may be evaluated multiple times.
- * @return The rotated result.
+ * Various macros to control xxHash's behavior.
  */
-#if !defined(NO_CLANG_BUILTIN) && XXH_HAS_BUILTIN(__builtin_rotateleft32) \
-                               && XXH_HAS_BUILTIN(__builtin_rotateleft64)
-#  define XXH_rotl32 __builtin_rotateleft32
-#  define XXH_rotl64 __builtin_rotateleft64
-/* Note: although _rotl exists for minGW (GCC under windows), performance seems poor */
-#elif defined(_MSC_VER)
-#  define XXH_rotl32(x,r) _rotl(x,r)
-#  define XXH_rotl64(x,r) _rotl64(x,r)
-#else
-#  define XXH_rotl32(x,r) (((x) << (r)) | ((x) >> (32 - (r))))
-#  define XXH_rotl64(x,r) (((x) << (r)) | ((x) >> (64 - (r))))
-#endif
-
+#ifdef XXH_DOXYGEN
 /*!
- * @internal
- * @fn xxh_u32 XXH_swap32(xxh_u32 x)
- * @brief A 32-bit byteswap.
+ * @brief Define this to disable 64-bit code.
  *
- * @param x The 32-bit integer to byteswap.
- * @return @p x, byteswapped.
+ * Useful if only using the @ref XXH32_family and you have a strict C90 compiler.
  */
-#if defined(_MSC_VER)     /* Visual Studio */
-#  define XXH_swap32 _byteswap_ulong
-#elif XXH_GCC_VERSION >= 403
-#  define XXH_swap32 __builtin_bswap32
-#else
-static xxh_u32 XXH_swap32 (xxh_u32 x)
-{
-    return  ((x << 24) & 0xff000000 ) |
-            ((x <<  8) & 0x00ff0000 ) |
-            ((x >>  8) & 0x0000ff00 ) |
-            ((x >> 24) & 0x000000ff );
-}
-#endif
-
-
-/* ***************************
-*  Memory reads
-*****************************/
-
+#  define XXH_NO_LONG_LONG
+#  undef XXH_NO_LONG_LONG /* don't actually */
 /*!
- * @internal
- * @brief Enum to indicate whether a pointer is aligned.
+ * @brief Controls how unaligned memory is accessed.
+ *
+ * By default, access to unaligned memory is controlled by `memcpy()`, which is
+ * safe and portable.
+ *
+ * Unfortunately, on some target/compiler combinations, the generated assembly
+ * is sub-optimal.
+ *
+ * The below switch allow selection of a different access method
+ * in the search for improved performance.
+ *
+ * @par Possible options:
+ *
+ *  - `XXH_FORCE_MEMORY_ACCESS=0` (default): `memcpy`
+ *   @par
+ *     Use `memcpy()`. Safe and portable. Note that most modern compilers will
+ *     eliminate the function call and treat it as an unaligned access.
+ *
+ *  - `XXH_FORCE_MEMORY_ACCESS=1`: `__attribute__((aligned(1)))`
+ *   @par
+ *     Depends on compiler extensions and is therefore not portable.
+ *     This method is safe _if_ your compiler supports it,
+ *     and *generally* as fast or faster than `memcpy`.
+ *
+ *  - `XXH_FORCE_MEMORY_ACCESS=2`: Direct cast
+ *  @par
+ *     Casts directly and dereferences. This method doesn't depend on the
+ *     compiler, but it violates the C standard as it directly dereferences an
+ *     unaligned pointer. It can generate buggy code on targets which do not
+ *     support unaligned memory accesses, but in some circumstances, it's the
+ *     only known way to get the most performance.
+ *
+ *  - `XXH_FORCE_MEMORY_ACCESS=3`: Byteshift
+ *  @par
+ *     Also portable. This can generate the best code on old compilers which don't
+ *     inline small `memcpy()` calls, and it might also be faster on big-endian
+ *     systems which lack a native byteswap instruction. However, some compilers
+ *     will emit literal byteshifts even if the target supports unaligned access.
+ *
+ *
+ * @warning
+ *   Methods 1 and 2 rely on implementation-defined behavior. Use these with
+ *   care, as what works on one compiler/platform/optimization level may cause
+ *   another to read garbage data or even crash.
+ *
+ * See https://fastcompression.blogspot.com/2015/08/accessing-unaligned-memory.html for details.
+ *
+ * Prefer these methods in priority order (0 > 3 > 1 > 2)
  */
-typedef enum {
-    XXH_aligned,  /*!< Aligned */
-    XXH_unaligned /*!< Possibly unaligned */
-} XXH_alignment;
+#  define XXH_FORCE_MEMORY_ACCESS 0
 
-/*
- * XXH_FORCE_MEMORY_ACCESS==3 is an endian-independent byteshift load.
+/*!
+ * @def XXH_SIZE_OPT
+ * @brief Controls how much xxHash optimizes for size.
  *
- * This is ideal for older compilers which don't inline memcpy.
+ * xxHash, when compiled, tends to result in a rather large binary size. This
+ * is mostly due to heavy usage to forced inlining and constant folding of the
+ * @ref XXH3_family to increase performance.
+ *
+ * However, some developers prefer size over speed. This option can
+ * significantly reduce the size of the generated code. When using the `-Os`
+ * or `-Oz` options on GCC or Clang, this is defined to 1 by default,
+ * otherwise it is defined to 0.
+ *
+ * Most of these size optimizations can be controlled manually.
+ *
+ * This is a number from 0-2.
+ *  - `XXH_SIZE_OPT` == 0: Default. xxHash makes no size optimizations. Speed
+ *    comes first.
+ *  - `XXH_SIZE_OPT` == 1: Default for `-Os` and `-Oz`. xxHash is more
+ *    conservative and disables hacks that increase code size. It implies the
+ *    options @ref XXH_NO_INLINE_HINTS == 1, @ref XXH_FORCE_ALIGN_CHECK == 0,
+ *    and @ref XXH3_NEON_LANES == 8 if they are not already defined.
+ *  - `XXH_SIZE_OPT` == 2: xxHash tries to make itself as small as possible.
+ *    Performance may cry. For example, the single shot functions just use the
+ *    streaming API.
  */
-#if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
-
-XXH_FORCE_INLINE xxh_u32 XXH_readLE32(const void* memPtr)
-{
-    const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
-    return bytePtr[0]
-         | ((xxh_u32)bytePtr[1] << 8)
-         | ((xxh_u32)bytePtr[2] << 16)
-         | ((xxh_u32)bytePtr[3] << 24);
-}
-
-XXH_FORCE_INLINE xxh_u32 XXH_readBE32(const void* memPtr)
-{
-    const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
-    return bytePtr[3]
-         | ((xxh_u32)bytePtr[2] << 8)
-         | ((xxh_u32)bytePtr[1] << 16)
-         | ((xxh_u32)bytePtr[0] << 24);
-}
-
-#else
-XXH_FORCE_INLINE xxh_u32 XXH_readLE32(const void* ptr)
-{
-    return XXH_CPU_LITTLE_ENDIAN ? XXH_read32(ptr) : XXH_swap32(XXH_read32(ptr));
-}
-
-static xxh_u32 XXH_readBE32(const void* ptr)
-{
-    return XXH_CPU_LITTLE_ENDIAN ? XXH_swap32(XXH_read32(ptr)) : XXH_read32(ptr);
-}
-#endif
-
-XXH_FORCE_INLINE xxh_u32
-XXH_readLE32_align(const void* ptr, XXH_alignment align)
-{
-    if (align==XXH_unaligned) {
-        return XXH_readLE32(ptr);
-    } else {
-        return XXH_CPU_LITTLE_ENDIAN ? *(const xxh_u32*)ptr : XXH_swap32(*(const xxh_u32*)ptr);
-    }
-}
-
-
-/* *************************************
-*  Misc
-***************************************/
-/*! @ingroup public */
-XXH_PUBLIC_API unsigned XXH_versionNumber (void) { return XXH_VERSION_NUMBER; }
+#  define XXH_SIZE_OPT 0
 
+/*!
+ * @def XXH_FORCE_ALIGN_CHECK
+ * @brief If defined to non-zero, adds a special path for aligned inputs (XXH32()
+ * and XXH64() only).
+ *
+ * This is an important performance trick for architectures without decent
+ * unaligned memory access performance.
+ *
+ * It checks for input alignment, and when conditions are met, uses a "fast
+ * path" employing direct 32-bit/64-bit reads, resulting in _dramatically
+ * faster_ read speed.
+ *
+ * The check costs one initial branch per hash, which is generally negligible,
+ * but not zero.
+ *
+ * Moreover, it's not useful to generate an additional code path if memory
+ * access uses the same instruction for both aligned and unaligned
+ * addresses (e.g. x86 and aarch64).
+ *
+ * In these cases, the alignment check can be removed by setting this macro to 0.
+ * Then the code will always use unaligned memory access.
+ * Align check is automatically disabled on x86, x64, ARM64, and some ARM chips
+ * which are platforms known to offer good unaligned memory accesses performance.
+ *
+ * It is also disabled by default when @ref XXH_SIZE_OPT >= 1.
+ *
+ * This option does not affect XXH3 (only XXH32 and XXH64).
+ */
+#  define XXH_FORCE_ALIGN_CHECK 0
 
-/* *******************************************************************
-*  32-bit hash functions
-*********************************************************************/
 /*!
- * @}
- * @defgroup XXH32_impl XXH32 implementation
- * @ingroup impl
+ * @def XXH_NO_INLINE_HINTS
+ * @brief When non-zero, sets all functions to `static`.
  *
- * Details on the XXH32 implementation.
- * @{
+ * By default, xxHash tries to force the compiler to inline almost all internal
+ * functions.
+ *
+ * This can usually improve performance due to reduced jumping and improved
+ * constant folding, but significantly increases the size of the binary which
+ * might not be favorable.
+ *
+ * Additionally, sometimes the forced inlining can be detrimental to performance,
+ * depending on the architecture.
+ *
+ * XXH_NO_INLINE_HINTS marks all internal functions as static, giving the
+ * compiler full control on whether to inline or not.
+ *
+ * When not optimizing (-O0), using `-fno-inline` with GCC or Clang, or if
+ * @ref XXH_SIZE_OPT >= 1, this will automatically be defined.
  */
- /* #define instead of static const, to be used as initializers */
-#define XXH_PRIME32_1  0x9E3779B1U  /*!< 0b10011110001101110111100110110001 */
-#define XXH_PRIME32_2  0x85EBCA77U  /*!< 0b10000101111010111100101001110111 */
-#define XXH_PRIME32_3  0xC2B2AE3DU  /*!< 0b11000010101100101010111000111101 */
-#define XXH_PRIME32_4  0x27D4EB2FU  /*!< 0b00100111110101001110101100101111 */
-#define XXH_PRIME32_5  0x165667B1U  /*!< 0b00010110010101100110011110110001 */
+#  define XXH_NO_INLINE_HINTS 0
 
-#ifdef XXH_OLD_NAMES
-#  define PRIME32_1 XXH_PRIME32_1
-#  define PRIME32_2 XXH_PRIME32_2
-#  define PRIME32_3 XXH_PRIME32_3
-#  define PRIME32_4 XXH_PRIME32_4
-#  define PRIME32_5 XXH_PRIME32_5
-#endif
+/*!
+ * @def XXH3_INLINE_SECRET
+ * @brief Determines whether to inline the XXH3 withSecret code.
+ *
+ * When the secret size is known, the compiler can improve the performance
+ * of XXH3_64bits_withSecret() and XXH3_128bits_withSecret().
+ *
+ * However, if the secret size is not known, it doesn't have any benefit. This
+ * happens when xxHash is compiled into a global symbol. Therefore, if
+ * @ref XXH_INLINE_ALL is *not* defined, this will be defined to 0.
+ *
+ * Additionally, this defaults to 0 on GCC 12+, which has an issue with function pointers
+ * that are *sometimes* force inline on -Og, and it is impossible to automatically
+ * detect this optimization level.
+ */
+#  define XXH3_INLINE_SECRET 0
 
 /*!
- * @internal
- * @brief Normal stripe processing routine.
+ * @def XXH32_ENDJMP
+ * @brief Whether to use a jump for `XXH32_finalize`.
  *
- * This shuffles the bits so that any bit from @p input impacts several bits in
- * @p acc.
+ * For performance, `XXH32_finalize` uses multiple branches in the finalizer.
+ * This is generally preferable for performance,
+ * but depending on exact architecture, a jmp may be preferable.
  *
- * @param acc The accumulator lane.
- * @param input The stripe of input to mix.
- * @return The mixed accumulator lane.
+ * This setting is only possibly making a difference for very small inputs.
  */
-static xxh_u32 XXH32_round(xxh_u32 acc, xxh_u32 input)
-{
-    acc += input * XXH_PRIME32_2;
-    acc  = XXH_rotl32(acc, 13);
-    acc *= XXH_PRIME32_1;
-#if (defined(__SSE4_1__) || defined(__aarch64__) || defined(__wasm_simd128__)) && !defined(XXH_ENABLE_AUTOVECTORIZE)
-    /*
-     * UGLY HACK:
-     * A compiler fence is used to prevent GCC and Clang from
-     * autovectorizing the XXH32 loop (pragmas and attributes don't work for some
-     * reason) without globally disabling SSE4.1.
-     *
-     * The reason we want to avoid vectorization is because despite working on
-     * 4 integers at a time, there are multiple factors slowing XXH32 down on
-     * SSE4:
-     * - There's a ridiculous amount of lag from pmulld (10 cycles of latency on
-     *   newer chips!) making it slightly slower to multiply four integers at
-     *   once compared to four integers independently. Even when pmulld was
-     *   fastest, Sandy/Ivy Bridge, it is still not worth it to go into SSE
-     *   just to multiply unless doing a long operation.
-     *
-     * - Four instructions are required to rotate,
-     *      movqda tmp,  v // not required with VEX encoding
-     *      pslld  tmp, 13 // tmp <<= 13
-     *      psrld  v,   19 // x >>= 19
-     *      por    v,  tmp // x |= tmp
-     *   compared to one for scalar:
-     *      roll   v, 13    // reliably fast across the board
-     *      shldl  v, v, 13 // Sandy Bridge and later prefer this for some reason
-     *
-     * - Instruction level parallelism is actually more beneficial here because
-     *   the SIMD actually serializes this operation: While v1 is rotating, v2
-     *   can load data, while v3 can multiply. SSE forces them to operate
-     *   together.
-     *
-     * This is also enabled on AArch64, as Clang is *very aggressive* in vectorizing
-     * the loop. NEON is only faster on the A53, and with the newer cores, it is less
-     * than half the speed.
-     *
-     * Additionally, this is used on WASM SIMD128 because it JITs to the same
-     * SIMD instructions and has the same issue.
-     */
-    XXH_COMPILER_GUARD(acc);
-#endif
-    return acc;
-}
+#  define XXH32_ENDJMP 0
 
 /*!
  * @internal
- * @brief Mixes all bits to finalize the hash.
- *
- * The final mix ensures that all input bits have a chance to impact any bit in
- * the output digest, resulting in an unbiased distribution.
+ * @brief Redefines old internal names.
  *
- * @param hash The hash to avalanche.
- * @return The avalanched hash.
+ * For compatibility with code that uses xxHash's internals before the names
+ * were changed to improve namespacing. There is no other reason to use this.
  */
-static xxh_u32 XXH32_avalanche(xxh_u32 hash)
-{
-    hash ^= hash >> 15;
-    hash *= XXH_PRIME32_2;
-    hash ^= hash >> 13;
-    hash *= XXH_PRIME32_3;
-    hash ^= hash >> 16;
-    return hash;
-}
+#  define XXH_OLD_NAMES
+#  undef XXH_OLD_NAMES /* don't actually use, it is ugly. */
 
-#define XXH_get32bits(p) XXH_readLE32_align(p, align)
+/*!
+ * @def XXH_NO_STREAM
+ * @brief Disables the streaming API.
+ *
+ * When xxHash is not inlined and the streaming functions are not used, disabling
+ * the streaming functions can improve code size significantly, especially with
+ * the @ref XXH3_family which tends to make constant folded copies of itself.
+ */
+#  define XXH_NO_STREAM
+#  undef XXH_NO_STREAM /* don't actually */
 
 /*!
- * @internal
- * @brief Processes the last 0-15 bytes of @p ptr.
+ * @def XXH_PREFETCH_NTA
+ * @brief Streams long inputs through the cache hierarchy with non-temporal prefetches.
  *
- * There may be up to 15 bytes remaining to consume from the input.
- * This final stage will digest them to ensure that all input bytes are present
- * in the final mix.
+ * By default, the long input loop of the @ref XXH3_family prefetches ahead
+ * into all cache levels.
+ * When set to 1, input prefetches use the non-temporal hint instead (`prefetchnta` on x86).
+ * Other prefetches, such as the one of a secret derived from a seed, are unchanged.
  *
- * @param hash The hash to finalize.
- * @param ptr The pointer to the remaining input.
- * @param len The remaining length, modulo 16.
- * @param align Whether @p ptr is aligned.
- * @return The finalized hash.
- * @see XXH64_finalize().
+ * How the hint is handled depends on the CPU. On the Xeon it was measured on,
+ * hashing 1 GB got ~45% slower, and a thread chasing pointers next to the
+ * hasher ran no faster than with default prefetches.
+ * `tests/bench/ntaVictim.c` reproduces that measurement: check it on the
+ * target machine before enabling this.
+ * This has no effect when prefetching is disabled.
  */
-static XXH_PUREF xxh_u32
-XXH32_finalize(xxh_u32 hash, const xxh_u8* ptr, size_t len, XXH_alignment align)
-{
-#define XXH_PROCESS1 do {                             \
-    hash += (*ptr++) * XXH_PRIME32_5;                 \
-    hash = XXH_rotl32(hash, 11) * XXH_PRIME32_1;      \
-} while (0)
+#  define XXH_PREFETCH_NTA 0
 
-#define XXH_PROCESS4 do {                             \
-    hash += XXH_get32bits(ptr) * XXH_PRIME32_3;       \
-    ptr += 4;                                         \
-    hash  = XXH_rotl32(hash, 17) * XXH_PRIME32_4;     \
-} while (0)
+/*!
+ * @def XXH_CALIBRATE
+ * @brief Enables XXH3_calibrate().
+ *
+ * Calibration allocates an 8 MB buffer and pulls in `clock()` from `<time.h>`,
+ * so it is left out by default. Set to 1 to compile it.
+ * It has no effect with @ref XXH_NO_STDLIB.
+ */
+#  define XXH_CALIBRATE 0
+#endif /* XXH_DOXYGEN */
+/*!
+ * @}
+ */
 
-    if (ptr==NULL) XXH_ASSERT(len == 0);
+#ifndef XXH_FORCE_MEMORY_ACCESS   /* can be defined externally, on command line for example */
+   /* prefer __packed__ structures (method 1) for GCC
+    * < ARMv7 with unaligned access (e.g. Raspbian armhf) still uses byte shifting, so we use memcpy
+    * which for some reason does unaligned loads. */
+#  if defined(__GNUC__) && !(defined(__ARM_ARCH) && __ARM_ARCH < 7 && defined(__ARM_FEATURE_UNALIGNED))
+#    define XXH_FORCE_MEMORY_ACCESS 1
+#  endif
+#endif
 
-    /* Compact rerolled version; generally faster */
-    if (!XXH32_ENDJMP) {
-        len &= 15;
-        while (len >= 4) {
-            XXH_PROCESS4;
-            len -= 4;
-        }
-        while (len > 0) {
-            XXH_PROCESS1;
-            --len;
-        }
-        return XXH32_avalanche(hash);
-    } else {
-         switch(len&15) /* or switch(bEnd - p) */ {
-           case 12:      XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 8:       XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 4:       XXH_PROCESS4;
-                         return XXH32_avalanche(hash);
+#ifndef XXH_SIZE_OPT
+   /* default to 1 for -Os or -Oz */
+#  if (defined(__GNUC__) || defined(__clang__)) && defined(__OPTIMIZE_SIZE__)
+#    define XXH_SIZE_OPT 1
+#  else
+#    define XXH_SIZE_OPT 0
+#  endif
+#endif
 
-           case 13:      XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 9:       XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 5:       XXH_PROCESS4;
-                         XXH_PROCESS1;
-                         return XXH32_avalanche(hash);
+#ifndef XXH_FORCE_ALIGN_CHECK  /* can be defined externally */
+   /* don't check on sizeopt, x86, aarch64, or arm when unaligned access is available */
+#  if XXH_SIZE_OPT >= 1 || \
+      defined(__i386)  || defined(__x86_64__) || defined(__aarch64__) || defined(__ARM_FEATURE_UNALIGNED) \
+   || defined(_M_IX86) || defined(_M_X64)     || defined(_M_ARM64)    || defined(_M_ARM) /* visual */
+#    define XXH_FORCE_ALIGN_CHECK 0
+#  else
+#    define XXH_FORCE_ALIGN_CHECK 1
+#  endif
+#endif
 
-           case 14:      XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 10:      XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 6:       XXH_PROCESS4;
-                         XXH_PROCESS1;
-                         XXH_PROCESS1;
-                         return XXH32_avalanche(hash);
+#ifndef XXH_NO_INLINE_HINTS
+#  if XXH_SIZE_OPT >= 1 || defined(__NO_INLINE__)  /* -O0, -fno-inline */
+#    define XXH_NO_INLINE_HINTS 1
+#  else
+#    define XXH_NO_INLINE_HINTS 0
+#  endif
+#endif
 
-           case 15:      XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 11:      XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 7:       XXH_PROCESS4;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 3:       XXH_PROCESS1;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 2:       XXH_PROCESS1;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 1:       XXH_PROCESS1;
-                         XXH_FALLTHROUGH;  /* fallthrough */
-           case 0:       return XXH32_avalanche(hash);
-        }
-        XXH_ASSERT(0);
-        return hash;   /* reaching this point is deemed impossible */
-    }
-}
+#ifndef XXH3_INLINE_SECRET
+#  if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12) \
+     || !defined(XXH_INLINE_ALL)
+#    define XXH3_INLINE_SECRET 0
+#  else
+#    define XXH3_INLINE_SECRET 1
+#  endif
+#endif
 
-#ifdef XXH_OLD_NAMES
-#  define PROCESS1 XXH_PROCESS1
-#  define PROCESS4 XXH_PROCESS4
-#else
-#  undef XXH_PROCESS1
-#  undef XXH_PROCESS4
+#ifndef XXH32_ENDJMP
+/* generally preferable for performance */
+#  define XXH32_ENDJMP 0
 #endif
 
 /*!
- * @internal
- * @brief The implementation for @ref XXH32().
- *
- * @param input , len , seed Directly passed from @ref XXH32().
- * @param align Whether @p input is aligned.
- * @return The calculated hash.
+ * @defgroup impl Implementation
+ * @{
  */
-XXH_FORCE_INLINE XXH_PUREF xxh_u32
-XXH32_endian_align(const xxh_u8* input, size_t len, xxh_u32 seed, XXH_alignment align)
-{
-    xxh_u32 h32;
-
-    if (input==NULL) XXH_ASSERT(len == 0);
-
-    if (len>=16) {
-        const xxh_u8* const bEnd = input + len;
-        const xxh_u8* const limit = bEnd - 15;
-        xxh_u32 v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
-        xxh_u32 v2 = seed + XXH_PRIME32_2;
-        xxh_u32 v3 = seed + 0;
-        xxh_u32 v4 = seed - XXH_PRIME32_1;
 
-        do {
-            v1 = XXH32_round(v1, XXH_get32bits(input)); input += 4;
-            v2 = XXH32_round(v2, XXH_get32bits(input)); input += 4;
-            v3 = XXH32_round(v3, XXH_get32bits(input)); input += 4;
-            v4 = XXH32_round(v4, XXH_get32bits(input)); input += 4;
-        } while (input < limit);
 
-        h32 = XXH_rotl32(v1, 1)  + XXH_rotl32(v2, 7)
-            + XXH_rotl32(v3, 12) + XXH_rotl32(v4, 18);
-    } else {
-        h32  = seed + XXH_PRIME32_5;
-    }
+/* *************************************
+*  Includes & Memory related functions
+***************************************/
+#if defined(XXH_NO_STREAM)
+/* nothing */
+#elif defined(XXH_NO_STDLIB)
 
-    h32 += (xxh_u32)len;
+/* When requesting to disable any mention of stdlib,
+ * the library loses the ability to invoked malloc / free.
+ * In practice, it means that functions like `XXH*_createState()`
+ * will always fail, and return NULL.
+ * This flag is useful in situations where
+ * xxhash.h is integrated into some kernel, embedded or limited environment
+ * without access to dynamic allocation.
+ */
 
-    return XXH32_finalize(h32, input, len&15, align);
-}
+static XXH_CONSTF void* XXH_defaultMalloc(size_t s) { (void)s; return NULL; }
+static void XXH_defaultFree(void* p) { (void)p; }
 
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH32_hash_t XXH32 (const void* input, size_t len, XXH32_hash_t seed)
-{
-#if !defined(XXH_NO_STREAM) && XXH_SIZE_OPT >= 2
-    /* Simple version, good for code maintenance, but unfortunately slow for small inputs */
-    XXH32_state_t state;
-    XXH32_reset(&state, seed);
-    XXH32_update(&state, (const xxh_u8*)input, len);
-    return XXH32_digest(&state);
 #else
-    if (XXH_FORCE_ALIGN_CHECK) {
-        if ((((size_t)input) & 3) == 0) {   /* Input is 4-bytes aligned, leverage the speed benefit */
-            return XXH32_endian_align((const xxh_u8*)input, len, seed, XXH_aligned);
-    }   }
 
-    return XXH32_endian_align((const xxh_u8*)input, len, seed, XXH_unaligned);
-#endif
-}
+/*
+ * Modify the local functions below should you wish to use
+ * different memory routines for malloc() and free()
+ */
+#include <stdlib.h>
+
+/*!
+ * @internal
+ * @brief Modify this function to use a different routine than malloc().
+ */
+static XXH_MALLOCF void* XXH_defaultMalloc(size_t s) { return malloc(s); }
 
+/*!
+ * @internal
+ * @brief Modify this function to use a different routine than free().
+ */
+static void XXH_defaultFree(void* p) { free(p); }
 
+#endif  /* XXH_NO_STDLIB */
 
-/*******   Hash streaming   *******/
 #ifndef XXH_NO_STREAM
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH32_state_t* XXH32_createState(void)
-{
-    return (XXH32_state_t*)XXH_malloc(sizeof(XXH32_state_t));
-}
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH_errorcode XXH32_freeState(XXH32_state_t* statePtr)
+/*! @internal The allocator set by XXH_setAllocator(). Zero means default. */
+static XXH_customMem XXH_g_customMem = { NULL, NULL, NULL };
+
+static XXH_MALLOCF void* XXH_malloc(size_t s)
 {
-    XXH_free(statePtr);
-    return XXH_OK;
+    if (XXH_g_customMem.customAlloc != NULL)
+        return XXH_g_customMem.customAlloc(XXH_g_customMem.opaque, s);
+    return XXH_defaultMalloc(s);
 }
 
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API void XXH32_copyState(XXH32_state_t* dstState, const XXH32_state_t* srcState)
+static void XXH_free(void* p)
 {
-    XXH_memcpy(dstState, srcState, sizeof(*dstState));
+    if (XXH_g_customMem.customFree != NULL) {
+        /* like free(), XXH_free(NULL) is a no-op, whatever the allocator */
+        if (p != NULL) XXH_g_customMem.customFree(XXH_g_customMem.opaque, p);
+        return;
+    }
+    XXH_defaultFree(p);
 }
 
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH_errorcode XXH32_reset(XXH32_state_t* statePtr, XXH32_hash_t seed)
+/*! @ingroup public */
+XXH_PUBLIC_API XXH_errorcode XXH_setAllocator(XXH_customMem customMem)
 {
-    XXH_ASSERT(statePtr != NULL);
-    memset(statePtr, 0, sizeof(*statePtr));
-    statePtr->v[0] = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
-    statePtr->v[1] = seed + XXH_PRIME32_2;
-    statePtr->v[2] = seed + 0;
-    statePtr->v[3] = seed - XXH_PRIME32_1;
+    if ((customMem.customAlloc == NULL) != (customMem.customFree == NULL)) return XXH_ERROR;
+    XXH_g_customMem = customMem;
     return XXH_OK;
 }
+#endif /* !XXH_NO_STREAM */
 
+#include <string.h>
 
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH32_update(XXH32_state_t* state, const void* input, size_t len)
+/*!
+ * @internal
+ * @brief Modify this function to use a different routine than memcpy().
+ */
+static void* XXH_memcpy(void* dest, const void* src, size_t size)
 {
-    if (input==NULL) {
-        XXH_ASSERT(len == 0);
-        return XXH_OK;
-    }
-
-    {   const xxh_u8* p = (const xxh_u8*)input;
-        const xxh_u8* const bEnd = p + len;
-
-        state->total_len_32 += (XXH32_hash_t)len;
-        state->large_len |= (XXH32_hash_t)((len>=16) | (state->total_len_32>=16));
-
-        if (state->memsize + len < 16)  {   /* fill in tmp buffer */
-            XXH_memcpy((xxh_u8*)(state->mem32) + state->memsize, input, len);
-            state->memsize += (XXH32_hash_t)len;
-            return XXH_OK;
-        }
-
-        if (state->memsize) {   /* some data left from previous update */
-            XXH_memcpy((xxh_u8*)(state->mem32) + state->memsize, input, 16-state->memsize);
-            {   const xxh_u32* p32 = state->mem32;
-                state->v[0] = XXH32_round(state->v[0], XXH_readLE32(p32)); p32++;
-                state->v[1] = XXH32_round(state->v[1], XXH_readLE32(p32)); p32++;
-                state->v[2] = XXH32_round(state->v[2], XXH_readLE32(p32)); p32++;
-                state->v[3] = XXH32_round(state->v[3], XXH_readLE32(p32));
-            }
-            p += 16-state->memsize;
-            state->memsize = 0;
-        }
+    return memcpy(dest,src,size);
+}
 
-        if (p <= bEnd-16) {
-            const xxh_u8* const limit = bEnd - 16;
+#include <limits.h>   /* ULLONG_MAX */
 
-            do {
-                state->v[0] = XXH32_round(state->v[0], XXH_readLE32(p)); p+=4;
-                state->v[1] = XXH32_round(state->v[1], XXH_readLE32(p)); p+=4;
-                state->v[2] = XXH32_round(state->v[2], XXH_readLE32(p)); p+=4;
-                state->v[3] = XXH32_round(state->v[3], XXH_readLE32(p)); p+=4;
-            } while (p<=limit);
 
-        }
+/* *************************************
+*  Compiler Specific Options
+***************************************/
+#ifdef _MSC_VER /* Visual Studio warning fix */
+#  pragma warning(disable : 4127) /* disable: C4127: conditional expression is constant */
+#endif
 
-        if (p < bEnd) {
-            XXH_memcpy(state->mem32, p, (size_t)(bEnd-p));
-            state->memsize = (unsigned)(bEnd-p);
-        }
-    }
+#if XXH_NO_INLINE_HINTS  /* disable inlining hints */
+#  if defined(__GNUC__) || defined(__clang__)
+#    define XXH_FORCE_INLINE static __attribute__((__unused__))
+#  else
+#    define XXH_FORCE_INLINE static
+#  endif
+#  define XXH_NO_INLINE static
+/* enable inlining hints */
+#elif defined(__GNUC__) || defined(__clang__)
+#  define XXH_FORCE_INLINE static __inline__ __attribute__((__always_inline__, __unused__))
+#  define XXH_NO_INLINE static __attribute__((__noinline__))
+#elif defined(_MSC_VER)  /* Visual Studio */
+#  define XXH_FORCE_INLINE static __forceinline
+#  define XXH_NO_INLINE static __declspec(noinline)
+#elif defined (__cplusplus) \
+  || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L))   /* C99 */
+#  define XXH_FORCE_INLINE static inline
+#  define XXH_NO_INLINE static
+#else
+#  define XXH_FORCE_INLINE static
+#  define XXH_NO_INLINE static
+#endif
 
-    return XXH_OK;
-}
+#if XXH3_INLINE_SECRET
+#  define XXH3_WITH_SECRET_INLINE XXH_FORCE_INLINE
+#else
+#  define XXH3_WITH_SECRET_INLINE XXH_NO_INLINE
+#endif
 
 
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH32_hash_t XXH32_digest(const XXH32_state_t* state)
-{
-    xxh_u32 h32;
+/* *************************************
+*  Debug
+***************************************/
+/*!
+ * @ingroup tuning
+ * @def XXH_DEBUGLEVEL
+ * @brief Sets the debugging level.
+ *
+ * XXH_DEBUGLEVEL is expected to be defined externally, typically via the
+ * compiler's command line options. The value must be a number.
+ */
+#ifndef XXH_DEBUGLEVEL
+#  ifdef DEBUGLEVEL /* backwards compat */
+#    define XXH_DEBUGLEVEL DEBUGLEVEL
+#  else
+#    define XXH_DEBUGLEVEL 0
+#  endif
+#endif
 
-    if (state->large_len) {
-        h32 = XXH_rotl32(state->v[0], 1)
-            + XXH_rotl32(state->v[1], 7)
-            + XXH_rotl32(state->v[2], 12)
-            + XXH_rotl32(state->v[3], 18);
-    } else {
-        h32 = state->v[2] /* == seed */ + XXH_PRIME32_5;
-    }
+#if (XXH_DEBUGLEVEL>=1)
+#  include <assert.h>   /* note: can still be disabled with NDEBUG */
+#  define XXH_ASSERT(c)   assert(c)
+#else
+#  if defined(__INTEL_COMPILER)
+#    define XXH_ASSERT(c)   XXH_ASSUME((unsigned char) (c))
+#  else
+#    define XXH_ASSERT(c)   XXH_ASSUME(c)
+#  endif
+#endif
 
-    h32 += state->total_len_32;
+/* note: use after variable declarations */
+#ifndef XXH_STATIC_ASSERT
+#  if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)    /* C11 */
+#    define XXH_STATIC_ASSERT_WITH_MESSAGE(c,m) do { _Static_assert((c),m); } while(0)
+#  elif defined(__cplusplus) && (__cplusplus >= 201103L)            /* C++11 */
+#    define XXH_STATIC_ASSERT_WITH_MESSAGE(c,m) do { static_assert((c),m); } while(0)
+#  else
+#    define XXH_STATIC_ASSERT_WITH_MESSAGE(c,m) do { struct xxh_sa { char x[(c) ? 1 : -1]; }; } while(0)
+#  endif
+#  define XXH_STATIC_ASSERT(c) XXH_STATIC_ASSERT_WITH_MESSAGE((c),#c)
+#endif
 
-    return XXH32_finalize(h32, (const xxh_u8*)state->mem32, state->memsize, XXH_aligned);
-}
-#endif /* !XXH_NO_STREAM */
+/*!
+ * @internal
+ * @def XXH_COMPILER_GUARD(var)
+ * @brief Used to prevent unwanted optimizations for @p var.
+ *
+ * It uses an empty GCC inline assembly statement with a register constraint
+ * which forces @p var into a general purpose register (eg eax, ebx, ecx
+ * on x86) and marks it as modified.
+ *
+ * This is used in a few places to avoid unwanted autovectorization (e.g.
+ * XXH32_round()). All vectorization we want is explicit via intrinsics,
+ * and _usually_ isn't wanted elsewhere.
+ *
+ * We also use it to prevent unwanted constant folding for AArch64 in
+ * XXH3_initCustomSecret_scalar().
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#  define XXH_COMPILER_GUARD(var) __asm__("" : "+r" (var))
+#else
+#  define XXH_COMPILER_GUARD(var) ((void)0)
+#endif
 
-/*******   Canonical representation   *******/
+/* Specifically for NEON vectors which use the "w" constraint, on
+ * Clang. */
+#if defined(__clang__) && defined(__ARM_ARCH) && !defined(__wasm__)
+#  define XXH_COMPILER_GUARD_CLANG_NEON(var) __asm__("" : "+w" (var))
+#else
+#  define XXH_COMPILER_GUARD_CLANG_NEON(var) ((void)0)
+#endif
 
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API void XXH32_canonicalFromHash(XXH32_canonical_t* dst, XXH32_hash_t hash)
-{
-    XXH_STATIC_ASSERT(sizeof(XXH32_canonical_t) == sizeof(XXH32_hash_t));
-    if (XXH_CPU_LITTLE_ENDIAN) hash = XXH_swap32(hash);
-    XXH_memcpy(dst, &hash, sizeof(*dst));
-}
-/*! @ingroup XXH32_family */
-XXH_PUBLIC_API XXH32_hash_t XXH32_hashFromCanonical(const XXH32_canonical_t* src)
-{
-    return XXH_readBE32(src);
-}
+/* *************************************
+*  Basic Types
+***************************************/
+#if !defined (__VMS) \
+ && (defined (__cplusplus) \
+ || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */) )
+#   ifdef _AIX
+#     include <inttypes.h>
+#   else
+#     include <stdint.h>
+#   endif
+    typedef uint8_t xxh_u8;
+#else
+    typedef unsigned char xxh_u8;
+#endif
+typedef XXH32_hash_t xxh_u32;
 
+#ifdef XXH_OLD_NAMES
+#  warning "XXH_OLD_NAMES is planned to be removed starting v0.9. If the program depends on it, consider moving away from it by employing newer type names directly"
+#  define BYTE xxh_u8
+#  define U8   xxh_u8
+#  define U32  xxh_u32
+#endif
 
-#ifndef XXH_NO_LONG_LONG
+/* ***   Memory access   *** */
 
-/* *******************************************************************
-*  64-bit hash functions
-*********************************************************************/
 /*!
- * @}
- * @ingroup impl
- * @{
+ * @internal
+ * @fn xxh_u32 XXH_read32(const void* ptr)
+ * @brief Reads an unaligned 32-bit integer from @p ptr in native endianness.
+ *
+ * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
+ *
+ * @param ptr The pointer to read from.
+ * @return The 32-bit native endian integer from the bytes at @p ptr.
  */
-/*******   Memory access   *******/
 
-typedef XXH64_hash_t xxh_u64;
+/*!
+ * @internal
+ * @fn xxh_u32 XXH_readLE32(const void* ptr)
+ * @brief Reads an unaligned 32-bit little endian integer from @p ptr.
+ *
+ * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
+ *
+ * @param ptr The pointer to read from.
+ * @return The 32-bit little endian integer from the bytes at @p ptr.
+ */
 
-#ifdef XXH_OLD_NAMES
-#  define U64 xxh_u64
-#endif
+/*!
+ * @internal
+ * @fn xxh_u32 XXH_readBE32(const void* ptr)
+ * @brief Reads an unaligned 32-bit big endian integer from @p ptr.
+ *
+ * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
+ *
+ * @param ptr The pointer to read from.
+ * @return The 32-bit big endian integer from the bytes at @p ptr.
+ */
+
+/*!
+ * @internal
+ * @fn xxh_u32 XXH_readLE32_align(const void* ptr, XXH_alignment align)
+ * @brief Like @ref XXH_readLE32(), but has an option for aligned reads.
+ *
+ * Affected by @ref XXH_FORCE_MEMORY_ACCESS.
+ * Note that when @ref XXH_FORCE_ALIGN_CHECK == 0, the @p align parameter is
+ * always @ref XXH_alignment::XXH_unaligned.
+ *
+ * @param ptr The pointer to read from.
+ * @param align Whether @p ptr is aligned.
+ * @pre
+ *   If @p align == @ref XXH_alignment::XXH_aligned, @p ptr must be 4 byte
+ *   aligned.
+ * @return The 32-bit little endian integer from the bytes at @p ptr.
+ */
 
 #if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
 /*
  * Manual byteshift. Best for old compilers which don't inline memcpy.
- * We actually directly use XXH_readLE64 and XXH_readBE64.
+ * We actually directly use XXH_readLE32 and XXH_readBE32.
  */
 #elif (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==2))
 
-/* Force direct memory access. Only works on CPU which support unaligned memory access in hardware */
-static xxh_u64 XXH_read64(const void* memPtr)
-{
-    return *(const xxh_u64*) memPtr;
-}
+/*
+ * Force direct memory access. Only works on CPU which support unaligned memory
+ * access in hardware.
+ */
+static xxh_u32 XXH_read32(const void* memPtr) { return *(const xxh_u32*) memPtr; }
 
 #elif (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==1))
 
@@ -3275,12 +3804,12 @@ static xxh_u64 XXH_read64(const void* memPtr)
  * https://gcc.godbolt.org/z/xYez1j67Y.
  */
 #ifdef XXH_OLD_NAMES
-typedef union { xxh_u32 u32; xxh_u64 u64; } __attribute__((__packed__)) unalign64;
+typedef union { xxh_u32 u32; } __attribute__((__packed__)) unalign;
 #endif
-static xxh_u64 XXH_read64(const void* ptr)
+static xxh_u32 XXH_read32(const void* ptr)
 {
-    typedef __attribute__((__aligned__(1))) xxh_u64 xxh_unalign64;
-    return *((const xxh_unalign64*)ptr);
+    typedef __attribute__((__aligned__(1))) xxh_u32 xxh_unalign32;
+    return *((const xxh_unalign32*)ptr);
 }
 
 #else
@@ -3289,308 +3818,548 @@ static xxh_u64 XXH_read64(const void* ptr)
  * Portable and safe solution. Generally efficient.
  * see: https://fastcompression.blogspot.com/2015/08/accessing-unaligned-memory.html
  */
-static xxh_u64 XXH_read64(const void* memPtr)
+static xxh_u32 XXH_read32(const void* memPtr)
 {
-    xxh_u64 val;
+    xxh_u32 val;
     XXH_memcpy(&val, memPtr, sizeof(val));
     return val;
 }
 
 #endif   /* XXH_FORCE_DIRECT_MEMORY_ACCESS */
 
-#if defined(_MSC_VER)     /* Visual Studio */
-#  define XXH_swap64 _byteswap_uint64
-#elif XXH_GCC_VERSION >= 403
-#  define XXH_swap64 __builtin_bswap64
-#else
-static xxh_u64 XXH_swap64(xxh_u64 x)
-{
-    return  ((x << 56) & 0xff00000000000000ULL) |
-            ((x << 40) & 0x00ff000000000000ULL) |
-            ((x << 24) & 0x0000ff0000000000ULL) |
-            ((x << 8)  & 0x000000ff00000000ULL) |
-            ((x >> 8)  & 0x00000000ff000000ULL) |
-            ((x >> 24) & 0x0000000000ff0000ULL) |
-            ((x >> 40) & 0x000000000000ff00ULL) |
-            ((x >> 56) & 0x00000000000000ffULL);
-}
-#endif
-
 
-/* XXH_FORCE_MEMORY_ACCESS==3 is an endian-independent byteshift load. */
-#if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
+/* ***   Endianness   *** */
 
-XXH_FORCE_INLINE xxh_u64 XXH_readLE64(const void* memPtr)
-{
-    const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
-    return bytePtr[0]
-         | ((xxh_u64)bytePtr[1] << 8)
-         | ((xxh_u64)bytePtr[2] << 16)
-         | ((xxh_u64)bytePtr[3] << 24)
-         | ((xxh_u64)bytePtr[4] << 32)
-         | ((xxh_u64)bytePtr[5] << 40)
-         | ((xxh_u64)bytePtr[6] << 48)
-         | ((xxh_u64)bytePtr[7] << 56);
+/*!
+ * @ingroup tuning
+ * @def XXH_CPU_LITTLE_ENDIAN
+ * @brief Whether the target is little endian.
+ *
+ * Defined to 1 if the target is little endian, or 0 if it is big endian.
+ * It can be defined externally, for example on the compiler command line.
+ *
+ * If it is not defined,
+ * a runtime check (which is usually constant folded) is used instead.
+ *
+ * @note
+ *   This is not necessarily defined to an integer constant.
+ *
+ * @see XXH_isLittleEndian() for the runtime check.
+ */
+#ifndef XXH_CPU_LITTLE_ENDIAN
+/*
+ * Try to detect endianness automatically, to avoid the nonstandard behavior
+ * in `XXH_isLittleEndian()`
+ */
+#  if defined(_WIN32) /* Windows is always little endian */ \
+     || defined(__LITTLE_ENDIAN__) \
+     || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#    define XXH_CPU_LITTLE_ENDIAN 1
+#  elif defined(__BIG_ENDIAN__) \
+     || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#    define XXH_CPU_LITTLE_ENDIAN 0
+#  else
+/*!
+ * @internal
+ * @brief Runtime check for @ref XXH_CPU_LITTLE_ENDIAN.
+ *
+ * Most compilers will constant fold this.
+ */
+static int XXH_isLittleEndian(void)
+{
+    /*
+     * Portable and well-defined behavior.
+     * Don't use static: it is detrimental to performance.
+     */
+    const union { xxh_u32 u; xxh_u8 c[4]; } one = { 1 };
+    return one.c[0];
 }
+#   define XXH_CPU_LITTLE_ENDIAN   XXH_isLittleEndian()
+#  endif
+#endif
 
-XXH_FORCE_INLINE xxh_u64 XXH_readBE64(const void* memPtr)
+
+
+
+/* ****************************************
+*  Compiler-specific Functions and Macros
+******************************************/
+#define XXH_GCC_VERSION (__GNUC__ * 100 + __GNUC_MINOR__)
+
+#ifdef __has_builtin
+#  define XXH_HAS_BUILTIN(x) __has_builtin(x)
+#else
+#  define XXH_HAS_BUILTIN(x) 0
+#endif
+
+
+
+/*
+ * C23 and future versions have standard "unreachable()".
+ * Once it has been implemented reliably we can add it as an
+ * additional case:
+ *
+ * ```
+ * #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= XXH_C23_VN)
+ * #  include <stddef.h>
+ * #  ifdef unreachable
+ * #    define XXH_UNREACHABLE() unreachable()
+ * #  endif
+ * #endif
+ * ```
+ *
+ * Note C++23 also has std::unreachable() which can be detected
+ * as follows:
+ * ```
+ * #if defined(__cpp_lib_unreachable) && (__cpp_lib_unreachable >= 202202L)
+ * #  include <utility>
+ * #  define XXH_UNREACHABLE() std::unreachable()
+ * #endif
+ * ```
+ * NB: `__cpp_lib_unreachable` is defined in the `<version>` header.
+ * We don't use that as including `<utility>` in `extern "C"` blocks
+ * doesn't work on GCC12
+ */
+
+#if XXH_HAS_BUILTIN(__builtin_unreachable)
+#  define XXH_UNREACHABLE() __builtin_unreachable()
+
+#elif defined(_MSC_VER)
+#  define XXH_UNREACHABLE() __assume(0)
+
+#else
+#  define XXH_UNREACHABLE()
+#endif
+
+#if XXH_HAS_BUILTIN(__builtin_assume)
+#  define XXH_ASSUME(c) __builtin_assume(c)
+#else
+#  define XXH_ASSUME(c) if (!(c)) { XXH_UNREACHABLE(); }
+#endif
+
+/*!
+ * @internal
+ * @def XXH_rotl32(x,r)
+ * @brief 32-bit rotate left.
+ *
+ * @param x The 32-bit integer to be rotated.
+ * @param r The number of bits to rotate.
+ * @pre
+ *   @p r > 0 && @p r < 32
+ * @note
+ *   @p x and @p r may be evaluated multiple times.
+ * @return The rotated result.
+ */
+#if !defined(NO_CLANG_BUILTIN) && XXH_HAS_BUILTIN(__builtin_rotateleft32) \
+                               && XXH_HAS_BUILTIN(__builtin_rotateleft64)
+#  define XXH_rotl32 __builtin_rotateleft32
+#  define XXH_rotl64 __builtin_rotateleft64
+/* Note: although _rotl exists for minGW (GCC under windows), performance seems poor */
+#elif defined(_MSC_VER)
+#  define XXH_rotl32(x,r) _rotl(x,r)
+#  define XXH_rotl64(x,r) _rotl64(x,r)
+#else
+#  define XXH_rotl32(x,r) (((x) << (r)) | ((x) >> (32 - (r))))
+#  define XXH_rotl64(x,r) (((x) << (r)) | ((x) >> (64 - (r))))
+#endif
+
+/*!
+ * @internal
+ * @fn xxh_u32 XXH_swap32(xxh_u32 x)
+ * @brief A 32-bit byteswap.
+ *
+ * @param x The 32-bit integer to byteswap.
+ * @return @p x, byteswapped.
+ */
+#if defined(_MSC_VER)     /* Visual Studio */
+#  define XXH_swap32 _byteswap_ulong
+#elif XXH_GCC_VERSION >= 403
+#  define XXH_swap32 __builtin_bswap32
+#else
+static xxh_u32 XXH_swap32 (xxh_u32 x)
+{
+    return  ((x << 24) & 0xff000000 ) |
+            ((x <<  8) & 0x00ff0000 ) |
+            ((x >>  8) & 0x0000ff00 ) |
+            ((x >> 24) & 0x000000ff );
+}
+#endif
+
+
+/* ***************************
+*  Memory reads
+*****************************/
+
+/*!
+ * @internal
+ * @brief Enum to indicate whether a pointer is aligned.
+ */
+typedef enum {
+    XXH_aligned,  /*!< Aligned */
+    XXH_unaligned /*!< Possibly unaligned */
+} XXH_alignment;
+
+/*
+ * XXH_FORCE_MEMORY_ACCESS==3 is an endian-independent byteshift load.
+ *
+ * This is ideal for older compilers which don't inline memcpy.
+ */
+#if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
+
+XXH_FORCE_INLINE xxh_u32 XXH_readLE32(const void* memPtr)
 {
     const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
-    return bytePtr[7]
-         | ((xxh_u64)bytePtr[6] << 8)
-         | ((xxh_u64)bytePtr[5] << 16)
-         | ((xxh_u64)bytePtr[4] << 24)
-         | ((xxh_u64)bytePtr[3] << 32)
-         | ((xxh_u64)bytePtr[2] << 40)
-         | ((xxh_u64)bytePtr[1] << 48)
-         | ((xxh_u64)bytePtr[0] << 56);
+    return bytePtr[0]
+         | ((xxh_u32)bytePtr[1] << 8)
+         | ((xxh_u32)bytePtr[2] << 16)
+         | ((xxh_u32)bytePtr[3] << 24);
+}
+
+XXH_FORCE_INLINE xxh_u32 XXH_readBE32(const void* memPtr)
+{
+    const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
+    return bytePtr[3]
+         | ((xxh_u32)bytePtr[2] << 8)
+         | ((xxh_u32)bytePtr[1] << 16)
+         | ((xxh_u32)bytePtr[0] << 24);
 }
 
 #else
-XXH_FORCE_INLINE xxh_u64 XXH_readLE64(const void* ptr)
+XXH_FORCE_INLINE xxh_u32 XXH_readLE32(const void* ptr)
 {
-    return XXH_CPU_LITTLE_ENDIAN ? XXH_read64(ptr) : XXH_swap64(XXH_read64(ptr));
+    return XXH_CPU_LITTLE_ENDIAN ? XXH_read32(ptr) : XXH_swap32(XXH_read32(ptr));
 }
 
-static xxh_u64 XXH_readBE64(const void* ptr)
+static xxh_u32 XXH_readBE32(const void* ptr)
 {
-    return XXH_CPU_LITTLE_ENDIAN ? XXH_swap64(XXH_read64(ptr)) : XXH_read64(ptr);
+    return XXH_CPU_LITTLE_ENDIAN ? XXH_swap32(XXH_read32(ptr)) : XXH_read32(ptr);
 }
 #endif
 
-XXH_FORCE_INLINE xxh_u64
-XXH_readLE64_align(const void* ptr, XXH_alignment align)
+XXH_FORCE_INLINE xxh_u32
+XXH_readLE32_align(const void* ptr, XXH_alignment align)
 {
-    if (align==XXH_unaligned)
-        return XXH_readLE64(ptr);
-    else
-        return XXH_CPU_LITTLE_ENDIAN ? *(const xxh_u64*)ptr : XXH_swap64(*(const xxh_u64*)ptr);
+    if (align==XXH_unaligned) {
+        return XXH_readLE32(ptr);
+    } else {
+        return XXH_CPU_LITTLE_ENDIAN ? *(const xxh_u32*)ptr : XXH_swap32(*(const xxh_u32*)ptr);
+    }
 }
 
+XXH_FORCE_INLINE void XXH_writeLE32(void* dst, xxh_u32 v32)
+{
+    if (!XXH_CPU_LITTLE_ENDIAN) v32 = XXH_swap32(v32);
+    XXH_memcpy(dst, &v32, sizeof(v32));
+}
 
-/*******   xxh64   *******/
+
+/* *************************************
+*  Misc
+***************************************/
+/*! @ingroup public */
+XXH_PUBLIC_API unsigned XXH_versionNumber (void) { return XXH_VERSION_NUMBER; }
+
+
+/* *******************************************************************
+*  32-bit hash functions
+*********************************************************************/
 /*!
  * @}
- * @defgroup XXH64_impl XXH64 implementation
+ * @defgroup XXH32_impl XXH32 implementation
  * @ingroup impl
  *
- * Details on the XXH64 implementation.
+ * Details on the XXH32 implementation.
  * @{
  */
-/* #define rather that static const, to be used as initializers */
-#define XXH_PRIME64_1  0x9E3779B185EBCA87ULL  /*!< 0b1001111000110111011110011011000110000101111010111100101010000111 */
-#define XXH_PRIME64_2  0xC2B2AE3D27D4EB4FULL  /*!< 0b1100001010110010101011100011110100100111110101001110101101001111 */
-#define XXH_PRIME64_3  0x165667B19E3779F9ULL  /*!< 0b0001011001010110011001111011000110011110001101110111100111111001 */
-#define XXH_PRIME64_4  0x85EBCA77C2B2AE63ULL  /*!< 0b1000010111101011110010100111011111000010101100101010111001100011 */
-#define XXH_PRIME64_5  0x27D4EB2F165667C5ULL  /*!< 0b0010011111010100111010110010111100010110010101100110011111000101 */
+ /* #define instead of static const, to be used as initializers */
+#define XXH_PRIME32_1  0x9E3779B1U  /*!< 0b10011110001101110111100110110001 */
+#define XXH_PRIME32_2  0x85EBCA77U  /*!< 0b10000101111010111100101001110111 */
+#define XXH_PRIME32_3  0xC2B2AE3DU  /*!< 0b11000010101100101010111000111101 */
+#define XXH_PRIME32_4  0x27D4EB2FU  /*!< 0b00100111110101001110101100101111 */
+#define XXH_PRIME32_5  0x165667B1U  /*!< 0b00010110010101100110011110110001 */
 
 #ifdef XXH_OLD_NAMES
-#  define PRIME64_1 XXH_PRIME64_1
-#  define PRIME64_2 XXH_PRIME64_2
-#  define PRIME64_3 XXH_PRIME64_3
-#  define PRIME64_4 XXH_PRIME64_4
-#  define PRIME64_5 XXH_PRIME64_5
+#  define PRIME32_1 XXH_PRIME32_1
+#  define PRIME32_2 XXH_PRIME32_2
+#  define PRIME32_3 XXH_PRIME32_3
+#  define PRIME32_4 XXH_PRIME32_4
+#  define PRIME32_5 XXH_PRIME32_5
 #endif
 
-/*! @copydoc XXH32_round */
-static xxh_u64 XXH64_round(xxh_u64 acc, xxh_u64 input)
+/*!
+ * @internal
+ * @brief Normal stripe processing routine.
+ *
+ * This shuffles the bits so that any bit from @p input impacts several bits in
+ * @p acc.
+ *
+ * @param acc The accumulator lane.
+ * @param input The stripe of input to mix.
+ * @return The mixed accumulator lane.
+ */
+static xxh_u32 XXH32_round(xxh_u32 acc, xxh_u32 input)
 {
-    acc += input * XXH_PRIME64_2;
-    acc  = XXH_rotl64(acc, 31);
-    acc *= XXH_PRIME64_1;
-#if (defined(__AVX512F__)) && !defined(XXH_ENABLE_AUTOVECTORIZE)
+    acc += input * XXH_PRIME32_2;
+    acc  = XXH_rotl32(acc, 13);
+    acc *= XXH_PRIME32_1;
+#if (defined(__SSE4_1__) || defined(__aarch64__) || defined(__wasm_simd128__)) && !defined(XXH_ENABLE_AUTOVECTORIZE)
     /*
-     * DISABLE AUTOVECTORIZATION:
+     * UGLY HACK:
      * A compiler fence is used to prevent GCC and Clang from
-     * autovectorizing the XXH64 loop (pragmas and attributes don't work for some
-     * reason) without globally disabling AVX512.
+     * autovectorizing the XXH32 loop (pragmas and attributes don't work for some
+     * reason) without globally disabling SSE4.1.
      *
-     * Autovectorization of XXH64 tends to be detrimental,
-     * though the exact outcome may change depending on exact cpu and compiler version.
-     * For information, it has been reported as detrimental for Skylake-X,
-     * but possibly beneficial for Zen4.
+     * The reason we want to avoid vectorization is because despite working on
+     * 4 integers at a time, there are multiple factors slowing XXH32 down on
+     * SSE4:
+     * - There's a ridiculous amount of lag from pmulld (10 cycles of latency on
+     *   newer chips!) making it slightly slower to multiply four integers at
+     *   once compared to four integers independently. Even when pmulld was
+     *   fastest, Sandy/Ivy Bridge, it is still not worth it to go into SSE
+     *   just to multiply unless doing a long operation.
      *
-     * The default is to disable auto-vectorization,
-     * but you can select to enable it instead using `XXH_ENABLE_AUTOVECTORIZE` build variable.
+     * - Four instructions are required to rotate,
+     *      movqda tmp,  v // not required with VEX encoding
+     *      pslld  tmp, 13 // tmp <<= 13
+     *      psrld  v,   19 // x >>= 19
+     *      por    v,  tmp // x |= tmp
+     *   compared to one for scalar:
+     *      roll   v, 13    // reliably fast across the board
+     *      shldl  v, v, 13 // Sandy Bridge and later prefer this for some reason
+     *
+     * - Instruction level parallelism is actually more beneficial here because
+     *   the SIMD actually serializes this operation: While v1 is rotating, v2
+     *   can load data, while v3 can multiply. SSE forces them to operate
+     *   together.
+     *
+     * This is also enabled on AArch64, as Clang is *very aggressive* in vectorizing
+     * the loop. NEON is only faster on the A53, and with the newer cores, it is less
+     * than half the speed.
+     *
+     * Additionally, this is used on WASM SIMD128 because it JITs to the same
+     * SIMD instructions and has the same issue.
      */
     XXH_COMPILER_GUARD(acc);
 #endif
     return acc;
 }
 
-static xxh_u64 XXH64_mergeRound(xxh_u64 acc, xxh_u64 val)
-{
-    val  = XXH64_round(0, val);
-    acc ^= val;
-    acc  = acc * XXH_PRIME64_1 + XXH_PRIME64_4;
-    return acc;
-}
-
-/*! @copydoc XXH32_avalanche */
-static xxh_u64 XXH64_avalanche(xxh_u64 hash)
+/*!
+ * @internal
+ * @brief Mixes all bits to finalize the hash.
+ *
+ * The final mix ensures that all input bits have a chance to impact any bit in
+ * the output digest, resulting in an unbiased distribution.
+ *
+ * @param hash The hash to avalanche.
+ * @return The avalanched hash.
+ */
+static xxh_u32 XXH32_avalanche(xxh_u32 hash)
 {
-    hash ^= hash >> 33;
-    hash *= XXH_PRIME64_2;
-    hash ^= hash >> 29;
-    hash *= XXH_PRIME64_3;
-    hash ^= hash >> 32;
+    hash ^= hash >> 15;
+    hash *= XXH_PRIME32_2;
+    hash ^= hash >> 13;
+    hash *= XXH_PRIME32_3;
+    hash ^= hash >> 16;
     return hash;
 }
 
-
-#define XXH_get64bits(p) XXH_readLE64_align(p, align)
+#define XXH_get32bits(p) XXH_readLE32_align(p, align)
 
 /*!
  * @internal
- * @brief Processes the last 0-31 bytes of @p ptr.
+ * @brief Processes the last 0-15 bytes of @p ptr.
  *
- * There may be up to 31 bytes remaining to consume from the input.
+ * There may be up to 15 bytes remaining to consume from the input.
  * This final stage will digest them to ensure that all input bytes are present
  * in the final mix.
  *
  * @param hash The hash to finalize.
  * @param ptr The pointer to the remaining input.
- * @param len The remaining length, modulo 32.
+ * @param len The remaining length, modulo 16.
  * @param align Whether @p ptr is aligned.
- * @return The finalized hash
- * @see XXH32_finalize().
+ * @return The finalized hash.
+ * @see XXH64_finalize().
  */
-static XXH_PUREF xxh_u64
-XXH64_finalize(xxh_u64 hash, const xxh_u8* ptr, size_t len, XXH_alignment align)
+static XXH_PUREF xxh_u32
+XXH32_finalize(xxh_u32 hash, const xxh_u8* ptr, size_t len, XXH_alignment align)
 {
+#define XXH_PROCESS1 do {                             \
+    hash += (*ptr++) * XXH_PRIME32_5;                 \
+    hash = XXH_rotl32(hash, 11) * XXH_PRIME32_1;      \
+} while (0)
+
+#define XXH_PROCESS4 do {                             \
+    hash += XXH_get32bits(ptr) * XXH_PRIME32_3;       \
+    ptr += 4;                                         \
+    hash  = XXH_rotl32(hash, 17) * XXH_PRIME32_4;     \
+} while (0)
+
     if (ptr==NULL) XXH_ASSERT(len == 0);
-    len &= 31;
-    while (len >= 8) {
-        xxh_u64 const k1 = XXH64_round(0, XXH_get64bits(ptr));
-        ptr += 8;
-        hash ^= k1;
-        hash  = XXH_rotl64(hash,27) * XXH_PRIME64_1 + XXH_PRIME64_4;
-        len -= 8;
-    }
-    if (len >= 4) {
-        hash ^= (xxh_u64)(XXH_get32bits(ptr)) * XXH_PRIME64_1;
-        ptr += 4;
-        hash = XXH_rotl64(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
-        len -= 4;
-    }
-    while (len > 0) {
-        hash ^= (*ptr++) * XXH_PRIME64_5;
-        hash = XXH_rotl64(hash, 11) * XXH_PRIME64_1;
-        --len;
+
+    /* Compact rerolled version; generally faster */
+    if (!XXH32_ENDJMP) {
+        len &= 15;
+        while (len >= 4) {
+            XXH_PROCESS4;
+            len -= 4;
+        }
+        while (len > 0) {
+            XXH_PROCESS1;
+            --len;
+        }
+        return XXH32_avalanche(hash);
+    } else {
+         switch(len&15) /* or switch(bEnd - p) */ {
+           case 12:      XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 8:       XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 4:       XXH_PROCESS4;
+                         return XXH32_avalanche(hash);
+
+           case 13:      XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 9:       XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 5:       XXH_PROCESS4;
+                         XXH_PROCESS1;
+                         return XXH32_avalanche(hash);
+
+           case 14:      XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 10:      XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 6:       XXH_PROCESS4;
+                         XXH_PROCESS1;
+                         XXH_PROCESS1;
+                         return XXH32_avalanche(hash);
+
+           case 15:      XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 11:      XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 7:       XXH_PROCESS4;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 3:       XXH_PROCESS1;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 2:       XXH_PROCESS1;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 1:       XXH_PROCESS1;
+                         XXH_FALLTHROUGH;  /* fallthrough */
+           case 0:       return XXH32_avalanche(hash);
+        }
+        XXH_ASSERT(0);
+        return hash;   /* reaching this point is deemed impossible */
     }
-    return  XXH64_avalanche(hash);
 }
 
 #ifdef XXH_OLD_NAMES
-#  define PROCESS1_64 XXH_PROCESS1_64
-#  define PROCESS4_64 XXH_PROCESS4_64
-#  define PROCESS8_64 XXH_PROCESS8_64
+#  define PROCESS1 XXH_PROCESS1
+#  define PROCESS4 XXH_PROCESS4
 #else
-#  undef XXH_PROCESS1_64
-#  undef XXH_PROCESS4_64
-#  undef XXH_PROCESS8_64
+#  undef XXH_PROCESS1
+#  undef XXH_PROCESS4
 #endif
 
 /*!
  * @internal
- * @brief The implementation for @ref XXH64().
+ * @brief The implementation for @ref XXH32().
  *
- * @param input , len , seed Directly passed from @ref XXH64().
+ * @param input , len , seed Directly passed from @ref XXH32().
  * @param align Whether @p input is aligned.
  * @return The calculated hash.
  */
-XXH_FORCE_INLINE XXH_PUREF xxh_u64
-XXH64_endian_align(const xxh_u8* input, size_t len, xxh_u64 seed, XXH_alignment align)
+XXH_FORCE_INLINE XXH_PUREF xxh_u32
+XXH32_endian_align(const xxh_u8* input, size_t len, xxh_u32 seed, XXH_alignment align)
 {
-    xxh_u64 h64;
+    xxh_u32 h32;
+
     if (input==NULL) XXH_ASSERT(len == 0);
 
-    if (len>=32) {
+    if (len>=16) {
         const xxh_u8* const bEnd = input + len;
-        const xxh_u8* const limit = bEnd - 31;
-        xxh_u64 v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
-        xxh_u64 v2 = seed + XXH_PRIME64_2;
-        xxh_u64 v3 = seed + 0;
-        xxh_u64 v4 = seed - XXH_PRIME64_1;
+        const xxh_u8* const limit = bEnd - 15;
+        xxh_u32 v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+        xxh_u32 v2 = seed + XXH_PRIME32_2;
+        xxh_u32 v3 = seed + 0;
+        xxh_u32 v4 = seed - XXH_PRIME32_1;
 
         do {
-            v1 = XXH64_round(v1, XXH_get64bits(input)); input+=8;
-            v2 = XXH64_round(v2, XXH_get64bits(input)); input+=8;
-            v3 = XXH64_round(v3, XXH_get64bits(input)); input+=8;
-            v4 = XXH64_round(v4, XXH_get64bits(input)); input+=8;
-        } while (input<limit);
-
-        h64 = XXH_rotl64(v1, 1) + XXH_rotl64(v2, 7) + XXH_rotl64(v3, 12) + XXH_rotl64(v4, 18);
-        h64 = XXH64_mergeRound(h64, v1);
-        h64 = XXH64_mergeRound(h64, v2);
-        h64 = XXH64_mergeRound(h64, v3);
-        h64 = XXH64_mergeRound(h64, v4);
+            v1 = XXH32_round(v1, XXH_get32bits(input)); input += 4;
+            v2 = XXH32_round(v2, XXH_get32bits(input)); input += 4;
+            v3 = XXH32_round(v3, XXH_get32bits(input)); input += 4;
+            v4 = XXH32_round(v4, XXH_get32bits(input)); input += 4;
+        } while (input < limit);
 
+        h32 = XXH_rotl32(v1, 1)  + XXH_rotl32(v2, 7)
+            + XXH_rotl32(v3, 12) + XXH_rotl32(v4, 18);
     } else {
-        h64  = seed + XXH_PRIME64_5;
+        h32  = seed + XXH_PRIME32_5;
     }
 
-    h64 += (xxh_u64) len;
+    h32 += (xxh_u32)len;
 
-    return XXH64_finalize(h64, input, len, align);
+    return XXH32_finalize(h32, input, len&15, align);
 }
 
-
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API XXH64_hash_t XXH64 (XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH32_hash_t XXH32 (const void* input, size_t len, XXH32_hash_t seed)
 {
 #if !defined(XXH_NO_STREAM) && XXH_SIZE_OPT >= 2
     /* Simple version, good for code maintenance, but unfortunately slow for small inputs */
-    XXH64_state_t state;
-    XXH64_reset(&state, seed);
-    XXH64_update(&state, (const xxh_u8*)input, len);
-    return XXH64_digest(&state);
+    XXH32_state_t state;
+    XXH32_reset(&state, seed);
+    XXH32_update(&state, (const xxh_u8*)input, len);
+    return XXH32_digest(&state);
 #else
     if (XXH_FORCE_ALIGN_CHECK) {
-        if ((((size_t)input) & 7)==0) {  /* Input is aligned, let's leverage the speed advantage */
-            return XXH64_endian_align((const xxh_u8*)input, len, seed, XXH_aligned);
+        if ((((size_t)input) & 3) == 0) {   /* Input is 4-bytes aligned, leverage the speed benefit */
+            return XXH32_endian_align((const xxh_u8*)input, len, seed, XXH_aligned);
     }   }
 
-    return XXH64_endian_align((const xxh_u8*)input, len, seed, XXH_unaligned);
-
+    return XXH32_endian_align((const xxh_u8*)input, len, seed, XXH_unaligned);
 #endif
 }
 
-/*******   Hash Streaming   *******/
+
+
+/*******   Hash streaming   *******/
 #ifndef XXH_NO_STREAM
-/*! @ingroup XXH64_family*/
-XXH_PUBLIC_API XXH64_state_t* XXH64_createState(void)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH32_state_t* XXH32_createState(void)
 {
-    return (XXH64_state_t*)XXH_malloc(sizeof(XXH64_state_t));
+    return (XXH32_state_t*)XXH_malloc(sizeof(XXH32_state_t));
 }
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API XXH_errorcode XXH64_freeState(XXH64_state_t* statePtr)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH_errorcode XXH32_freeState(XXH32_state_t* statePtr)
 {
     XXH_free(statePtr);
     return XXH_OK;
 }
 
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API void XXH64_copyState(XXH_NOESCAPE XXH64_state_t* dstState, const XXH64_state_t* srcState)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API void XXH32_copyState(XXH32_state_t* dstState, const XXH32_state_t* srcState)
 {
     XXH_memcpy(dstState, srcState, sizeof(*dstState));
 }
 
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API XXH_errorcode XXH64_reset(XXH_NOESCAPE XXH64_state_t* statePtr, XXH64_hash_t seed)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH_errorcode XXH32_reset(XXH32_state_t* statePtr, XXH32_hash_t seed)
 {
     XXH_ASSERT(statePtr != NULL);
     memset(statePtr, 0, sizeof(*statePtr));
-    statePtr->v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
-    statePtr->v[1] = seed + XXH_PRIME64_2;
+    statePtr->v[0] = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+    statePtr->v[1] = seed + XXH_PRIME32_2;
     statePtr->v[2] = seed + 0;
-    statePtr->v[3] = seed - XXH_PRIME64_1;
+    statePtr->v[3] = seed - XXH_PRIME32_1;
     return XXH_OK;
 }
 
-/*! @ingroup XXH64_family */
+
+/*! @ingroup XXH32_family */
 XXH_PUBLIC_API XXH_errorcode
-XXH64_update (XXH_NOESCAPE XXH64_state_t* state, XXH_NOESCAPE const void* input, size_t len)
+XXH32_update(XXH32_state_t* state, const void* input, size_t len)
 {
     if (input==NULL) {
         XXH_ASSERT(len == 0);
@@ -3600,38 +4369,41 @@ XXH64_update (XXH_NOESCAPE XXH64_state_t* state, XXH_NOESCAPE const void* input,
     {   const xxh_u8* p = (const xxh_u8*)input;
         const xxh_u8* const bEnd = p + len;
 
-        state->total_len += len;
+        state->total_len_32 += (XXH32_hash_t)len;
+        state->large_len |= (XXH32_hash_t)((len>=16) | (state->total_len_32>=16));
 
-        if (state->memsize + len < 32) {  /* fill in tmp buffer */
-            XXH_memcpy(((xxh_u8*)state->mem64) + state->memsize, input, len);
-            state->memsize += (xxh_u32)len;
+        if (state->memsize + len < 16)  {   /* fill in tmp buffer */
+            XXH_memcpy((xxh_u8*)(state->mem32) + state->memsize, input, len);
+            state->memsize += (XXH32_hash_t)len;
             return XXH_OK;
         }
 
-        if (state->memsize) {   /* tmp buffer is full */
-            XXH_memcpy(((xxh_u8*)state->mem64) + state->memsize, input, 32-state->memsize);
-            state->v[0] = XXH64_round(state->v[0], XXH_readLE64(state->mem64+0));
-            state->v[1] = XXH64_round(state->v[1], XXH_readLE64(state->mem64+1));
-            state->v[2] = XXH64_round(state->v[2], XXH_readLE64(state->mem64+2));
-            state->v[3] = XXH64_round(state->v[3], XXH_readLE64(state->mem64+3));
-            p += 32 - state->memsize;
+        if (state->memsize) {   /* some data left from previous update */
+            XXH_memcpy((xxh_u8*)(state->mem32) + state->memsize, input, 16-state->memsize);
+            {   const xxh_u32* p32 = state->mem32;
+                state->v[0] = XXH32_round(state->v[0], XXH_readLE32(p32)); p32++;
+                state->v[1] = XXH32_round(state->v[1], XXH_readLE32(p32)); p32++;
+                state->v[2] = XXH32_round(state->v[2], XXH_readLE32(p32)); p32++;
+                state->v[3] = XXH32_round(state->v[3], XXH_readLE32(p32));
+            }
+            p += 16-state->memsize;
             state->memsize = 0;
         }
 
-        if (p+32 <= bEnd) {
-            const xxh_u8* const limit = bEnd - 32;
+        if (p <= bEnd-16) {
+            const xxh_u8* const limit = bEnd - 16;
 
             do {
-                state->v[0] = XXH64_round(state->v[0], XXH_readLE64(p)); p+=8;
-                state->v[1] = XXH64_round(state->v[1], XXH_readLE64(p)); p+=8;
-                state->v[2] = XXH64_round(state->v[2], XXH_readLE64(p)); p+=8;
-                state->v[3] = XXH64_round(state->v[3], XXH_readLE64(p)); p+=8;
+                state->v[0] = XXH32_round(state->v[0], XXH_readLE32(p)); p+=4;
+                state->v[1] = XXH32_round(state->v[1], XXH_readLE32(p)); p+=4;
+                state->v[2] = XXH32_round(state->v[2], XXH_readLE32(p)); p+=4;
+                state->v[3] = XXH32_round(state->v[3], XXH_readLE32(p)); p+=4;
             } while (p<=limit);
 
         }
 
         if (p < bEnd) {
-            XXH_memcpy(state->mem64, p, (size_t)(bEnd-p));
+            XXH_memcpy(state->mem32, p, (size_t)(bEnd-p));
             state->memsize = (unsigned)(bEnd-p);
         }
     }
@@ -3640,270 +4412,838 @@ XXH64_update (XXH_NOESCAPE XXH64_state_t* state, XXH_NOESCAPE const void* input,
 }
 
 
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API XXH64_hash_t XXH64_digest(XXH_NOESCAPE const XXH64_state_t* state)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH32_hash_t XXH32_digest(const XXH32_state_t* state)
 {
-    xxh_u64 h64;
+    xxh_u32 h32;
 
-    if (state->total_len >= 32) {
-        h64 = XXH_rotl64(state->v[0], 1) + XXH_rotl64(state->v[1], 7) + XXH_rotl64(state->v[2], 12) + XXH_rotl64(state->v[3], 18);
-        h64 = XXH64_mergeRound(h64, state->v[0]);
-        h64 = XXH64_mergeRound(h64, state->v[1]);
-        h64 = XXH64_mergeRound(h64, state->v[2]);
-        h64 = XXH64_mergeRound(h64, state->v[3]);
+    if (state->large_len) {
+        h32 = XXH_rotl32(state->v[0], 1)
+            + XXH_rotl32(state->v[1], 7)
+            + XXH_rotl32(state->v[2], 12)
+            + XXH_rotl32(state->v[3], 18);
     } else {
-        h64  = state->v[2] /*seed*/ + XXH_PRIME64_5;
+        h32 = state->v[2] /* == seed */ + XXH_PRIME32_5;
     }
 
-    h64 += (xxh_u64) state->total_len;
+    h32 += state->total_len_32;
 
-    return XXH64_finalize(h64, (const xxh_u8*)state->mem64, (size_t)state->total_len, XXH_aligned);
+    return XXH32_finalize(h32, (const xxh_u8*)state->mem32, state->memsize, XXH_aligned);
+}
+
+/*
+ * Saved state identifiers, for the second byte of the header.
+ * See XXH_SAVESTATE_VERSION for the format.
+ */
+#define XXH_SAVESTATE_ID_XXH32 1
+#define XXH_SAVESTATE_ID_XXH64 2
+#define XXH_SAVESTATE_ID_XXH3  3
+
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API size_t XXH32_saveState(const XXH32_state_t* statePtr, void* dst, size_t dstCapacity)
+{
+    xxh_u8* const op = (xxh_u8*)dst;
+    size_t const size = 4 + 4 + sizeof(statePtr->v) + statePtr->memsize;
+    size_t i;
+    XXH_ASSERT(statePtr->memsize < sizeof(statePtr->mem32));
+    if (dst == NULL || dstCapacity < size) return 0;
+    op[0] = XXH_SAVESTATE_VERSION;
+    op[1] = XXH_SAVESTATE_ID_XXH32;
+    op[2] = (xxh_u8)(statePtr->large_len != 0);
+    op[3] = (xxh_u8)statePtr->memsize;
+    XXH_writeLE32(op + 4, statePtr->total_len_32);
+    for (i = 0; i < 4; i++) XXH_writeLE32(op + 8 + 4*i, statePtr->v[i]);
+    XXH_memcpy(op + 24, statePtr->mem32, statePtr->memsize);
+    return size;
+}
+
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH_errorcode XXH32_loadState(XXH32_state_t* statePtr, const void* src, size_t srcSize)
+{
+    const xxh_u8* const ip = (const xxh_u8*)src;
+    size_t i;
+    if (statePtr == NULL || src == NULL || srcSize < 24) return XXH_ERROR;
+    if (ip[0] != XXH_SAVESTATE_VERSION || ip[1] != XXH_SAVESTATE_ID_XXH32) return XXH_ERROR;
+    if (ip[2] > 1 || ip[3] >= sizeof(statePtr->mem32) || srcSize != 24 + (size_t)ip[3]) return XXH_ERROR;
+    memset(statePtr, 0, sizeof(*statePtr));
+    statePtr->large_len = ip[2];
+    statePtr->memsize = ip[3];
+    statePtr->total_len_32 = XXH_readLE32(ip + 4);
+    for (i = 0; i < 4; i++) statePtr->v[i] = XXH_readLE32(ip + 8 + 4*i);
+    XXH_memcpy(statePtr->mem32, ip + 24, statePtr->memsize);
+    return XXH_OK;
 }
 #endif /* !XXH_NO_STREAM */
 
-/******* Canonical representation   *******/
+/*******   Canonical representation   *******/
 
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API void XXH64_canonicalFromHash(XXH_NOESCAPE XXH64_canonical_t* dst, XXH64_hash_t hash)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API void XXH32_canonicalFromHash(XXH32_canonical_t* dst, XXH32_hash_t hash)
 {
-    XXH_STATIC_ASSERT(sizeof(XXH64_canonical_t) == sizeof(XXH64_hash_t));
-    if (XXH_CPU_LITTLE_ENDIAN) hash = XXH_swap64(hash);
+    XXH_STATIC_ASSERT(sizeof(XXH32_canonical_t) == sizeof(XXH32_hash_t));
+    if (XXH_CPU_LITTLE_ENDIAN) hash = XXH_swap32(hash);
     XXH_memcpy(dst, &hash, sizeof(*dst));
 }
-
-/*! @ingroup XXH64_family */
-XXH_PUBLIC_API XXH64_hash_t XXH64_hashFromCanonical(XXH_NOESCAPE const XXH64_canonical_t* src)
+/*! @ingroup XXH32_family */
+XXH_PUBLIC_API XXH32_hash_t XXH32_hashFromCanonical(const XXH32_canonical_t* src)
 {
-    return XXH_readBE64(src);
+    return XXH_readBE32(src);
 }
 
-#ifndef XXH_NO_XXH3
 
-/* *********************************************************************
-*  XXH3
-*  New generation hash designed for speed on small keys and vectorization
-************************************************************************ */
+#ifndef XXH_NO_LONG_LONG
+
+/* *******************************************************************
+*  64-bit hash functions
+*********************************************************************/
 /*!
  * @}
- * @defgroup XXH3_impl XXH3 implementation
  * @ingroup impl
  * @{
  */
+/*******   Memory access   *******/
 
-/* ===   Compiler specifics   === */
+typedef XXH64_hash_t xxh_u64;
 
-#if ((defined(sun) || defined(__sun)) && __cplusplus) /* Solaris includes __STDC_VERSION__ with C++. Tested with GCC 5.5 */
-#  define XXH_RESTRICT   /* disable */
-#elif defined (__STDC_VERSION__) && __STDC_VERSION__ >= 199901L   /* >= C99 */
-#  define XXH_RESTRICT   restrict
-#elif (defined (__GNUC__) && ((__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 1))) \
-   || (defined (__clang__)) \
-   || (defined (_MSC_VER) && (_MSC_VER >= 1400)) \
-   || (defined (__INTEL_COMPILER) && (__INTEL_COMPILER >= 1300))
+#ifdef XXH_OLD_NAMES
+#  define U64 xxh_u64
+#endif
+
+#if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
 /*
- * There are a LOT more compilers that recognize __restrict but this
- * covers the major ones.
+ * Manual byteshift. Best for old compilers which don't inline memcpy.
+ * We actually directly use XXH_readLE64 and XXH_readBE64.
  */
-#  define XXH_RESTRICT   __restrict
-#else
-#  define XXH_RESTRICT   /* disable */
-#endif
+#elif (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==2))
 
-#if (defined(__GNUC__) && (__GNUC__ >= 3))  \
-  || (defined(__INTEL_COMPILER) && (__INTEL_COMPILER >= 800)) \
-  || defined(__clang__)
-#    define XXH_likely(x) __builtin_expect(x, 1)
-#    define XXH_unlikely(x) __builtin_expect(x, 0)
-#else
-#    define XXH_likely(x) (x)
-#    define XXH_unlikely(x) (x)
-#endif
+/* Force direct memory access. Only works on CPU which support unaligned memory access in hardware */
+static xxh_u64 XXH_read64(const void* memPtr)
+{
+    return *(const xxh_u64*) memPtr;
+}
+
+#elif (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==1))
 
-#ifndef XXH_HAS_INCLUDE
-#  ifdef __has_include
 /*
- * Not defined as XXH_HAS_INCLUDE(x) (function-like) because
- * this causes segfaults in Apple Clang 4.2 (on Mac OS X 10.7 Lion)
+ * __attribute__((aligned(1))) is supported by gcc and clang. Originally the
+ * documentation claimed that it only increased the alignment, but actually it
+ * can decrease it on gcc, clang, and icc:
+ * https://gcc.gnu.org/bugzilla/show_bug.cgi?id=69502,
+ * https://gcc.godbolt.org/z/xYez1j67Y.
  */
-#    define XXH_HAS_INCLUDE __has_include
-#  else
-#    define XXH_HAS_INCLUDE(x) 0
-#  endif
-#endif
-
-#if defined(__GNUC__) || defined(__clang__)
-#  if defined(__ARM_FEATURE_SVE)
-#    include <arm_sve.h>
-#  endif
-#  if defined(__ARM_NEON__) || defined(__ARM_NEON) \
-   || (defined(_M_ARM) && _M_ARM >= 7) \
-   || defined(_M_ARM64) || defined(_M_ARM64EC) \
-   || (defined(__wasm_simd128__) && XXH_HAS_INCLUDE(<arm_neon.h>)) /* WASM SIMD128 via SIMDe */
-#    define inline __inline__  /* circumvent a clang bug */
-#    include <arm_neon.h>
-#    undef inline
-#  elif defined(__AVX2__)
-#    include <immintrin.h>
-#  elif defined(__SSE2__)
-#    include <emmintrin.h>
-#  endif
+#ifdef XXH_OLD_NAMES
+typedef union { xxh_u32 u32; xxh_u64 u64; } __attribute__((__packed__)) unalign64;
 #endif
+static xxh_u64 XXH_read64(const void* ptr)
+{
+    typedef __attribute__((__aligned__(1))) xxh_u64 xxh_unalign64;
+    return *((const xxh_unalign64*)ptr);
+}
 
-#if defined(_MSC_VER)
-#  include <intrin.h>
-#endif
+#else
 
 /*
- * One goal of XXH3 is to make it fast on both 32-bit and 64-bit, while
- * remaining a true 64-bit/128-bit hash function.
- *
- * This is done by prioritizing a subset of 64-bit operations that can be
- * emulated without too many steps on the average 32-bit machine.
- *
- * For example, these two lines seem similar, and run equally fast on 64-bit:
- *
- *   xxh_u64 x;
- *   x ^= (x >> 47); // good
- *   x ^= (x >> 13); // bad
- *
- * However, to a 32-bit machine, there is a major difference.
- *
- * x ^= (x >> 47) looks like this:
- *
- *   x.lo ^= (x.hi >> (47 - 32));
- *
- * while x ^= (x >> 13) looks like this:
- *
- *   // note: funnel shifts are not usually cheap.
- *   x.lo ^= (x.lo >> 13) | (x.hi << (32 - 13));
- *   x.hi ^= (x.hi >> 13);
- *
- * The first one is significantly faster than the second, simply because the
- * shift is larger than 32. This means:
- *  - All the bits we need are in the upper 32 bits, so we can ignore the lower
- *    32 bits in the shift.
- *  - The shift result will always fit in the lower 32 bits, and therefore,
- *    we can ignore the upper 32 bits in the xor.
- *
- * Thanks to this optimization, XXH3 only requires these features to be efficient:
- *
- *  - Usable unaligned access
- *  - A 32-bit or 64-bit ALU
- *      - If 32-bit, a decent ADC instruction
- *  - A 32 or 64-bit multiply with a 64-bit result
- *  - For the 128-bit variant, a decent byteswap helps short inputs.
- *
- * The first two are already required by XXH32, and almost all 32-bit and 64-bit
- * platforms which can run XXH32 can run XXH3 efficiently.
- *
- * Thumb-1, the classic 16-bit only subset of ARM's instruction set, is one
- * notable exception.
- *
- * First of all, Thumb-1 lacks support for the UMULL instruction which
- * performs the important long multiply. This means numerous __aeabi_lmul
- * calls.
- *
- * Second of all, the 8 functional registers are just not enough.
- * Setup for __aeabi_lmul, byteshift loads, pointers, and all arithmetic need
- * Lo registers, and this shuffling results in thousands more MOVs than A32.
- *
- * A32 and T32 don't have this limitation. They can access all 14 registers,
- * do a 32->64 multiply with UMULL, and the flexible operand allowing free
- * shifts is helpful, too.
- *
- * Therefore, we do a quick sanity check.
- *
- * If compiling Thumb-1 for a target which supports ARM instructions, we will
- * emit a warning, as it is not a "sane" platform to compile for.
- *
- * Usually, if this happens, it is because of an accident and you probably need
- * to specify -march, as you likely meant to compile for a newer architecture.
- *
- * Credit: large sections of the vectorial and asm source code paths
- *         have been contributed by @easyaspi314
+ * Portable and safe solution. Generally efficient.
+ * see: https://fastcompression.blogspot.com/2015/08/accessing-unaligned-memory.html
  */
-#if defined(__thumb__) && !defined(__thumb2__) && defined(__ARM_ARCH_ISA_ARM)
-#   warning "XXH3 is highly inefficient without ARM or Thumb-2."
+static xxh_u64 XXH_read64(const void* memPtr)
+{
+    xxh_u64 val;
+    XXH_memcpy(&val, memPtr, sizeof(val));
+    return val;
+}
+
+#endif   /* XXH_FORCE_DIRECT_MEMORY_ACCESS */
+
+#if defined(_MSC_VER)     /* Visual Studio */
+#  define XXH_swap64 _byteswap_uint64
+#elif XXH_GCC_VERSION >= 403
+#  define XXH_swap64 __builtin_bswap64
+#else
+static xxh_u64 XXH_swap64(xxh_u64 x)
+{
+    return  ((x << 56) & 0xff00000000000000ULL) |
+            ((x << 40) & 0x00ff000000000000ULL) |
+            ((x << 24) & 0x0000ff0000000000ULL) |
+            ((x << 8)  & 0x000000ff00000000ULL) |
+            ((x >> 8)  & 0x00000000ff000000ULL) |
+            ((x >> 24) & 0x0000000000ff0000ULL) |
+            ((x >> 40) & 0x000000000000ff00ULL) |
+            ((x >> 56) & 0x00000000000000ffULL);
+}
 #endif
 
-/* ==========================================
- * Vectorization detection
- * ========================================== */
 
-#ifdef XXH_DOXYGEN
-/*!
- * @ingroup tuning
- * @brief Overrides the vectorization implementation chosen for XXH3.
- *
- * Can be defined to 0 to disable SIMD or any of the values mentioned in
- * @ref XXH_VECTOR_TYPE.
- *
- * If this is not defined, it uses predefined macros to determine the best
- * implementation.
- */
-#  define XXH_VECTOR XXH_SCALAR
-/*!
- * @ingroup tuning
- * @brief Possible values for @ref XXH_VECTOR.
- *
- * Note that these are actually implemented as macros.
- *
- * If this is not defined, it is detected automatically.
- * internal macro XXH_X86DISPATCH overrides this.
- */
-enum XXH_VECTOR_TYPE /* fake enum */ {
-    XXH_SCALAR = 0,  /*!< Portable scalar version */
-    XXH_SSE2   = 1,  /*!<
-                      * SSE2 for Pentium 4, Opteron, all x86_64.
-                      *
-                      * @note SSE2 is also guaranteed on Windows 10, macOS, and
-                      * Android x86.
-                      */
-    XXH_AVX2   = 2,  /*!< AVX2 for Haswell and Bulldozer */
-    XXH_AVX512 = 3,  /*!< AVX512 for Skylake and Icelake */
-    XXH_NEON   = 4,  /*!<
-                       * NEON for most ARMv7-A, all AArch64, and WASM SIMD128
-                       * via the SIMDeverywhere polyfill provided with the
-                       * Emscripten SDK.
-                       */
-    XXH_VSX    = 5,  /*!< VSX and ZVector for POWER8/z13 (64-bit) */
-    XXH_SVE    = 6,  /*!< SVE for some ARMv8-A and ARMv9-A */
-};
+/* XXH_FORCE_MEMORY_ACCESS==3 is an endian-independent byteshift load. */
+#if (defined(XXH_FORCE_MEMORY_ACCESS) && (XXH_FORCE_MEMORY_ACCESS==3))
+
+XXH_FORCE_INLINE xxh_u64 XXH_readLE64(const void* memPtr)
+{
+    const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
+    return bytePtr[0]
+         | ((xxh_u64)bytePtr[1] << 8)
+         | ((xxh_u64)bytePtr[2] << 16)
+         | ((xxh_u64)bytePtr[3] << 24)
+         | ((xxh_u64)bytePtr[4] << 32)
+         | ((xxh_u64)bytePtr[5] << 40)
+         | ((xxh_u64)bytePtr[6] << 48)
+         | ((xxh_u64)bytePtr[7] << 56);
+}
+
+XXH_FORCE_INLINE xxh_u64 XXH_readBE64(const void* memPtr)
+{
+    const xxh_u8* bytePtr = (const xxh_u8 *)memPtr;
+    return bytePtr[7]
+         | ((xxh_u64)bytePtr[6] << 8)
+         | ((xxh_u64)bytePtr[5] << 16)
+         | ((xxh_u64)bytePtr[4] << 24)
+         | ((xxh_u64)bytePtr[3] << 32)
+         | ((xxh_u64)bytePtr[2] << 40)
+         | ((xxh_u64)bytePtr[1] << 48)
+         | ((xxh_u64)bytePtr[0] << 56);
+}
+
+#else
+XXH_FORCE_INLINE xxh_u64 XXH_readLE64(const void* ptr)
+{
+    return XXH_CPU_LITTLE_ENDIAN ? XXH_read64(ptr) : XXH_swap64(XXH_read64(ptr));
+}
+
+static xxh_u64 XXH_readBE64(const void* ptr)
+{
+    return XXH_CPU_LITTLE_ENDIAN ? XXH_swap64(XXH_read64(ptr)) : XXH_read64(ptr);
+}
+#endif
+
+XXH_FORCE_INLINE xxh_u64
+XXH_readLE64_align(const void* ptr, XXH_alignment align)
+{
+    if (align==XXH_unaligned)
+        return XXH_readLE64(ptr);
+    else
+        return XXH_CPU_LITTLE_ENDIAN ? *(const xxh_u64*)ptr : XXH_swap64(*(const xxh_u64*)ptr);
+}
+
+XXH_FORCE_INLINE void XXH_writeLE64(void* dst, xxh_u64 v64)
+{
+    if (!XXH_CPU_LITTLE_ENDIAN) v64 = XXH_swap64(v64);
+    XXH_memcpy(dst, &v64, sizeof(v64));
+}
+
+
+/*******   xxh64   *******/
 /*!
- * @ingroup tuning
- * @brief Selects the minimum alignment for XXH3's accumulators.
- *
- * When using SIMD, this should match the alignment required for said vector
- * type, so, for example, 32 for AVX2.
+ * @}
+ * @defgroup XXH64_impl XXH64 implementation
+ * @ingroup impl
  *
- * Default: Auto detected.
+ * Details on the XXH64 implementation.
+ * @{
  */
-#  define XXH_ACC_ALIGN 8
+/* #define rather that static const, to be used as initializers */
+#define XXH_PRIME64_1  0x9E3779B185EBCA87ULL  /*!< 0b1001111000110111011110011011000110000101111010111100101010000111 */
+#define XXH_PRIME64_2  0xC2B2AE3D27D4EB4FULL  /*!< 0b1100001010110010101011100011110100100111110101001110101101001111 */
+#define XXH_PRIME64_3  0x165667B19E3779F9ULL  /*!< 0b0001011001010110011001111011000110011110001101110111100111111001 */
+#define XXH_PRIME64_4  0x85EBCA77C2B2AE63ULL  /*!< 0b1000010111101011110010100111011111000010101100101010111001100011 */
+#define XXH_PRIME64_5  0x27D4EB2F165667C5ULL  /*!< 0b0010011111010100111010110010111100010110010101100110011111000101 */
+
+#ifdef XXH_OLD_NAMES
+#  define PRIME64_1 XXH_PRIME64_1
+#  define PRIME64_2 XXH_PRIME64_2
+#  define PRIME64_3 XXH_PRIME64_3
+#  define PRIME64_4 XXH_PRIME64_4
+#  define PRIME64_5 XXH_PRIME64_5
 #endif
 
-/* Actual definition */
-#ifndef XXH_DOXYGEN
-#  define XXH_SCALAR 0
-#  define XXH_SSE2   1
-#  define XXH_AVX2   2
-#  define XXH_AVX512 3
-#  define XXH_NEON   4
-#  define XXH_VSX    5
-#  define XXH_SVE    6
+/*! @copydoc XXH32_round */
+static xxh_u64 XXH64_round(xxh_u64 acc, xxh_u64 input)
+{
+    acc += input * XXH_PRIME64_2;
+    acc  = XXH_rotl64(acc, 31);
+    acc *= XXH_PRIME64_1;
+#if (defined(__AVX512F__)) && !defined(XXH_ENABLE_AUTOVECTORIZE)
+    /*
+     * DISABLE AUTOVECTORIZATION:
+     * A compiler fence is used to prevent GCC and Clang from
+     * autovectorizing the XXH64 loop (pragmas and attributes don't work for some
+     * reason) without globally disabling AVX512.
+     *
+     * Autovectorization of XXH64 tends to be detrimental,
+     * though the exact outcome may change depending on exact cpu and compiler version.
+     * For information, it has been reported as detrimental for Skylake-X,
+     * but possibly beneficial for Zen4.
+     *
+     * The default is to disable auto-vectorization,
+     * but you can select to enable it instead using `XXH_ENABLE_AUTOVECTORIZE` build variable.
+     */
+    XXH_COMPILER_GUARD(acc);
 #endif
+    return acc;
+}
 
-#ifndef XXH_VECTOR    /* can be defined on command line */
-#  if defined(__ARM_FEATURE_SVE)
-#    define XXH_VECTOR XXH_SVE
-#  elif ( \
-        defined(__ARM_NEON__) || defined(__ARM_NEON) /* gcc */ \
-     || defined(_M_ARM) || defined(_M_ARM64) || defined(_M_ARM64EC) /* msvc */ \
-     || (defined(__wasm_simd128__) && XXH_HAS_INCLUDE(<arm_neon.h>)) /* wasm simd128 via SIMDe */ \
-   ) && ( \
-        defined(_WIN32) || defined(__LITTLE_ENDIAN__) /* little endian only */ \
-    || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) \
-   )
-#    define XXH_VECTOR XXH_NEON
+static xxh_u64 XXH64_mergeRound(xxh_u64 acc, xxh_u64 val)
+{
+    val  = XXH64_round(0, val);
+    acc ^= val;
+    acc  = acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+    return acc;
+}
+
+/*! @copydoc XXH32_avalanche */
+static xxh_u64 XXH64_avalanche(xxh_u64 hash)
+{
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+
+#define XXH_get64bits(p) XXH_readLE64_align(p, align)
+
+/*!
+ * @internal
+ * @brief Processes the last 0-31 bytes of @p ptr.
+ *
+ * There may be up to 31 bytes remaining to consume from the input.
+ * This final stage will digest them to ensure that all input bytes are present
+ * in the final mix.
+ *
+ * @param hash The hash to finalize.
+ * @param ptr The pointer to the remaining input.
+ * @param len The remaining length, modulo 32.
+ * @param align Whether @p ptr is aligned.
+ * @return The finalized hash
+ * @see XXH32_finalize().
+ */
+static XXH_PUREF xxh_u64
+XXH64_finalize(xxh_u64 hash, const xxh_u8* ptr, size_t len, XXH_alignment align)
+{
+    if (ptr==NULL) XXH_ASSERT(len == 0);
+    len &= 31;
+    while (len >= 8) {
+        xxh_u64 const k1 = XXH64_round(0, XXH_get64bits(ptr));
+        ptr += 8;
+        hash ^= k1;
+        hash  = XXH_rotl64(hash,27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        len -= 8;
+    }
+    if (len >= 4) {
+        hash ^= (xxh_u64)(XXH_get32bits(ptr)) * XXH_PRIME64_1;
+        ptr += 4;
+        hash = XXH_rotl64(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        len -= 4;
+    }
+    while (len > 0) {
+        hash ^= (*ptr++) * XXH_PRIME64_5;
+        hash = XXH_rotl64(hash, 11) * XXH_PRIME64_1;
+        --len;
+    }
+    return  XXH64_avalanche(hash);
+}
+
+#ifdef XXH_OLD_NAMES
+#  define PROCESS1_64 XXH_PROCESS1_64
+#  define PROCESS4_64 XXH_PROCESS4_64
+#  define PROCESS8_64 XXH_PROCESS8_64
+#else
+#  undef XXH_PROCESS1_64
+#  undef XXH_PROCESS4_64
+#  undef XXH_PROCESS8_64
+#endif
+
+/*!
+ * @internal
+ * @brief The implementation for @ref XXH64().
+ *
+ * @param input , len , seed Directly passed from @ref XXH64().
+ * @param align Whether @p input is aligned.
+ * @return The calculated hash.
+ */
+XXH_FORCE_INLINE XXH_PUREF xxh_u64
+XXH64_endian_align(const xxh_u8* input, size_t len, xxh_u64 seed, XXH_alignment align)
+{
+    xxh_u64 h64;
+    if (input==NULL) XXH_ASSERT(len == 0);
+
+    if (len>=32) {
+        const xxh_u8* const bEnd = input + len;
+        const xxh_u8* const limit = bEnd - 31;
+        xxh_u64 v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        xxh_u64 v2 = seed + XXH_PRIME64_2;
+        xxh_u64 v3 = seed + 0;
+        xxh_u64 v4 = seed - XXH_PRIME64_1;
+
+        do {
+            v1 = XXH64_round(v1, XXH_get64bits(input)); input+=8;
+            v2 = XXH64_round(v2, XXH_get64bits(input)); input+=8;
+            v3 = XXH64_round(v3, XXH_get64bits(input)); input+=8;
+            v4 = XXH64_round(v4, XXH_get64bits(input)); input+=8;
+        } while (input<limit);
+
+        h64 = XXH_rotl64(v1, 1) + XXH_rotl64(v2, 7) + XXH_rotl64(v3, 12) + XXH_rotl64(v4, 18);
+        h64 = XXH64_mergeRound(h64, v1);
+        h64 = XXH64_mergeRound(h64, v2);
+        h64 = XXH64_mergeRound(h64, v3);
+        h64 = XXH64_mergeRound(h64, v4);
+
+    } else {
+        h64  = seed + XXH_PRIME64_5;
+    }
+
+    h64 += (xxh_u64) len;
+
+    return XXH64_finalize(h64, input, len, align);
+}
+
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH64_hash_t XXH64 (XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+{
+#if !defined(XXH_NO_STREAM) && XXH_SIZE_OPT >= 2
+    /* Simple version, good for code maintenance, but unfortunately slow for small inputs */
+    XXH64_state_t state;
+    XXH64_reset(&state, seed);
+    XXH64_update(&state, (const xxh_u8*)input, len);
+    return XXH64_digest(&state);
+#else
+    if (XXH_FORCE_ALIGN_CHECK) {
+        if ((((size_t)input) & 7)==0) {  /* Input is aligned, let's leverage the speed advantage */
+            return XXH64_endian_align((const xxh_u8*)input, len, seed, XXH_aligned);
+    }   }
+
+    return XXH64_endian_align((const xxh_u8*)input, len, seed, XXH_unaligned);
+
+#endif
+}
+
+/*******   Hash Streaming   *******/
+#ifndef XXH_NO_STREAM
+/*! @ingroup XXH64_family*/
+XXH_PUBLIC_API XXH64_state_t* XXH64_createState(void)
+{
+    return (XXH64_state_t*)XXH_malloc(sizeof(XXH64_state_t));
+}
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH_errorcode XXH64_freeState(XXH64_state_t* statePtr)
+{
+    XXH_free(statePtr);
+    return XXH_OK;
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API void XXH64_copyState(XXH_NOESCAPE XXH64_state_t* dstState, const XXH64_state_t* srcState)
+{
+    XXH_memcpy(dstState, srcState, sizeof(*dstState));
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH_errorcode XXH64_reset(XXH_NOESCAPE XXH64_state_t* statePtr, XXH64_hash_t seed)
+{
+    XXH_ASSERT(statePtr != NULL);
+    memset(statePtr, 0, sizeof(*statePtr));
+    statePtr->v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+    statePtr->v[1] = seed + XXH_PRIME64_2;
+    statePtr->v[2] = seed + 0;
+    statePtr->v[3] = seed - XXH_PRIME64_1;
+    return XXH_OK;
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH64_update (XXH_NOESCAPE XXH64_state_t* state, XXH_NOESCAPE const void* input, size_t len)
+{
+    if (input==NULL) {
+        XXH_ASSERT(len == 0);
+        return XXH_OK;
+    }
+
+    {   const xxh_u8* p = (const xxh_u8*)input;
+        const xxh_u8* const bEnd = p + len;
+
+        state->total_len += len;
+
+        if (state->memsize + len < 32) {  /* fill in tmp buffer */
+            XXH_memcpy(((xxh_u8*)state->mem64) + state->memsize, input, len);
+            state->memsize += (xxh_u32)len;
+            return XXH_OK;
+        }
+
+        if (state->memsize) {   /* tmp buffer is full */
+            XXH_memcpy(((xxh_u8*)state->mem64) + state->memsize, input, 32-state->memsize);
+            state->v[0] = XXH64_round(state->v[0], XXH_readLE64(state->mem64+0));
+            state->v[1] = XXH64_round(state->v[1], XXH_readLE64(state->mem64+1));
+            state->v[2] = XXH64_round(state->v[2], XXH_readLE64(state->mem64+2));
+            state->v[3] = XXH64_round(state->v[3], XXH_readLE64(state->mem64+3));
+            p += 32 - state->memsize;
+            state->memsize = 0;
+        }
+
+        if (p+32 <= bEnd) {
+            const xxh_u8* const limit = bEnd - 32;
+
+            do {
+                state->v[0] = XXH64_round(state->v[0], XXH_readLE64(p)); p+=8;
+                state->v[1] = XXH64_round(state->v[1], XXH_readLE64(p)); p+=8;
+                state->v[2] = XXH64_round(state->v[2], XXH_readLE64(p)); p+=8;
+                state->v[3] = XXH64_round(state->v[3], XXH_readLE64(p)); p+=8;
+            } while (p<=limit);
+
+        }
+
+        if (p < bEnd) {
+            XXH_memcpy(state->mem64, p, (size_t)(bEnd-p));
+            state->memsize = (unsigned)(bEnd-p);
+        }
+    }
+
+    return XXH_OK;
+}
+
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH64_hash_t XXH64_digest(XXH_NOESCAPE const XXH64_state_t* state)
+{
+    xxh_u64 h64;
+
+    if (state->total_len >= 32) {
+        h64 = XXH_rotl64(state->v[0], 1) + XXH_rotl64(state->v[1], 7) + XXH_rotl64(state->v[2], 12) + XXH_rotl64(state->v[3], 18);
+        h64 = XXH64_mergeRound(h64, state->v[0]);
+        h64 = XXH64_mergeRound(h64, state->v[1]);
+        h64 = XXH64_mergeRound(h64, state->v[2]);
+        h64 = XXH64_mergeRound(h64, state->v[3]);
+    } else {
+        h64  = state->v[2] /*seed*/ + XXH_PRIME64_5;
+    }
+
+    h64 += (xxh_u64) state->total_len;
+
+    return XXH64_finalize(h64, (const xxh_u8*)state->mem64, (size_t)state->total_len, XXH_aligned);
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API size_t XXH64_saveState(XXH_NOESCAPE const XXH64_state_t* statePtr, XXH_NOESCAPE void* dst, size_t dstCapacity)
+{
+    xxh_u8* const op = (xxh_u8*)dst;
+    size_t const size = 4 + 8 + sizeof(statePtr->v) + statePtr->memsize;
+    size_t i;
+    XXH_ASSERT(statePtr->memsize < sizeof(statePtr->mem64));
+    if (dst == NULL || dstCapacity < size) return 0;
+    op[0] = XXH_SAVESTATE_VERSION;
+    op[1] = XXH_SAVESTATE_ID_XXH64;
+    op[2] = 0;
+    op[3] = (xxh_u8)statePtr->memsize;
+    XXH_writeLE64(op + 4, statePtr->total_len);
+    for (i = 0; i < 4; i++) XXH_writeLE64(op + 12 + 8*i, statePtr->v[i]);
+    XXH_memcpy(op + 44, statePtr->mem64, statePtr->memsize);
+    return size;
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH_errorcode XXH64_loadState(XXH_NOESCAPE XXH64_state_t* statePtr, XXH_NOESCAPE const void* src, size_t srcSize)
+{
+    const xxh_u8* const ip = (const xxh_u8*)src;
+    size_t i;
+    if (statePtr == NULL || src == NULL || srcSize < 44) return XXH_ERROR;
+    if (ip[0] != XXH_SAVESTATE_VERSION || ip[1] != XXH_SAVESTATE_ID_XXH64) return XXH_ERROR;
+    if (ip[2] != 0 || ip[3] >= sizeof(statePtr->mem64) || srcSize != 44 + (size_t)ip[3]) return XXH_ERROR;
+    memset(statePtr, 0, sizeof(*statePtr));
+    statePtr->memsize = ip[3];
+    statePtr->total_len = XXH_readLE64(ip + 4);
+    for (i = 0; i < 4; i++) statePtr->v[i] = XXH_readLE64(ip + 12 + 8*i);
+    XXH_memcpy(statePtr->mem64, ip + 44, statePtr->memsize);
+    return XXH_OK;
+}
+
+/*
+ * Same as XXH64_update(), for an append of @len <= 8 bytes:
+ * it can at most complete the internal buffer once.
+ */
+XXH_FORCE_INLINE XXH_errorcode
+XXH64_update_small(XXH64_state_t* state, const xxh_u8* bytes, size_t len)
+{
+    XXH_ASSERT(state != NULL);
+    XXH_ASSERT(len <= 8 && state->memsize < 32);
+    state->total_len += len;
+    if (state->memsize + len < 32) {
+        XXH_memcpy((xxh_u8*)state->mem64 + state->memsize, bytes, len);
+        state->memsize += (xxh_u32)len;
+        return XXH_OK;
+    }
+    {   size_t const fill = 32 - state->memsize;
+        XXH_memcpy((xxh_u8*)state->mem64 + state->memsize, bytes, fill);
+        state->v[0] = XXH64_round(state->v[0], XXH_readLE64(state->mem64+0));
+        state->v[1] = XXH64_round(state->v[1], XXH_readLE64(state->mem64+1));
+        state->v[2] = XXH64_round(state->v[2], XXH_readLE64(state->mem64+2));
+        state->v[3] = XXH64_round(state->v[3], XXH_readLE64(state->mem64+3));
+        XXH_memcpy(state->mem64, bytes + fill, len - fill);
+        state->memsize = (xxh_u32)(len - fill);
+    }
+    return XXH_OK;
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH_errorcode XXH64_update_u32(XXH_NOESCAPE XXH64_state_t* statePtr, XXH32_hash_t value)
+{
+    xxh_u8 bytes[4];
+    XXH_writeLE32(bytes, value);
+    return XXH64_update_small(statePtr, bytes, sizeof(bytes));
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH_errorcode XXH64_update_u64(XXH_NOESCAPE XXH64_state_t* statePtr, XXH64_hash_t value)
+{
+    xxh_u8 bytes[8];
+    XXH_writeLE64(bytes, value);
+    return XXH64_update_small(statePtr, bytes, sizeof(bytes));
+}
+#endif /* !XXH_NO_STREAM */
+
+/******* Canonical representation   *******/
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API void XXH64_canonicalFromHash(XXH_NOESCAPE XXH64_canonical_t* dst, XXH64_hash_t hash)
+{
+    XXH_STATIC_ASSERT(sizeof(XXH64_canonical_t) == sizeof(XXH64_hash_t));
+    if (XXH_CPU_LITTLE_ENDIAN) hash = XXH_swap64(hash);
+    XXH_memcpy(dst, &hash, sizeof(*dst));
+}
+
+/*! @ingroup XXH64_family */
+XXH_PUBLIC_API XXH64_hash_t XXH64_hashFromCanonical(XXH_NOESCAPE const XXH64_canonical_t* src)
+{
+    return XXH_readBE64(src);
+}
+
+#ifndef XXH_NO_XXH3
+
+/* *********************************************************************
+*  XXH3
+*  New generation hash designed for speed on small keys and vectorization
+************************************************************************ */
+/*!
+ * @}
+ * @defgroup XXH3_impl XXH3 implementation
+ * @ingroup impl
+ * @{
+ */
+
+/* ===   Compiler specifics   === */
+
+#if ((defined(sun) || defined(__sun)) && __cplusplus) /* Solaris includes __STDC_VERSION__ with C++. Tested with GCC 5.5 */
+#  define XXH_RESTRICT   /* disable */
+#elif defined (__STDC_VERSION__) && __STDC_VERSION__ >= 199901L   /* >= C99 */
+#  define XXH_RESTRICT   restrict
+#elif (defined (__GNUC__) && ((__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 1))) \
+   || (defined (__clang__)) \
+   || (defined (_MSC_VER) && (_MSC_VER >= 1400)) \
+   || (defined (__INTEL_COMPILER) && (__INTEL_COMPILER >= 1300))
+/*
+ * There are a LOT more compilers that recognize __restrict but this
+ * covers the major ones.
+ */
+#  define XXH_RESTRICT   __restrict
+#else
+#  define XXH_RESTRICT   /* disable */
+#endif
+
+#if (defined(__GNUC__) && (__GNUC__ >= 3))  \
+  || (defined(__INTEL_COMPILER) && (__INTEL_COMPILER >= 800)) \
+  || defined(__clang__)
+#    define XXH_likely(x) __builtin_expect(x, 1)
+#    define XXH_unlikely(x) __builtin_expect(x, 0)
+#else
+#    define XXH_likely(x) (x)
+#    define XXH_unlikely(x) (x)
+#endif
+
+#ifndef XXH_HAS_INCLUDE
+#  ifdef __has_include
+/*
+ * Not defined as XXH_HAS_INCLUDE(x) (function-like) because
+ * this causes segfaults in Apple Clang 4.2 (on Mac OS X 10.7 Lion)
+ */
+#    define XXH_HAS_INCLUDE __has_include
+#  else
+#    define XXH_HAS_INCLUDE(x) 0
+#  endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#  if defined(__ARM_FEATURE_SVE)
+#    include <arm_sve.h>
+#  endif
+#  if defined(__ARM_NEON__) || defined(__ARM_NEON) \
+   || (defined(_M_ARM) && _M_ARM >= 7) \
+   || defined(_M_ARM64) || defined(_M_ARM64EC) \
+   || (defined(__wasm_simd128__) && XXH_HAS_INCLUDE(<arm_neon.h>)) /* WASM SIMD128 via SIMDe */
+#    define inline __inline__  /* circumvent a clang bug */
+#    include <arm_neon.h>
+#    undef inline
+#  elif defined(__AVX2__)
+#    include <immintrin.h>
+#  elif defined(__SSE2__)
+#    include <emmintrin.h>
+#  endif
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+/*
+ * One goal of XXH3 is to make it fast on both 32-bit and 64-bit, while
+ * remaining a true 64-bit/128-bit hash function.
+ *
+ * This is done by prioritizing a subset of 64-bit operations that can be
+ * emulated without too many steps on the average 32-bit machine.
+ *
+ * For example, these two lines seem similar, and run equally fast on 64-bit:
+ *
+ *   xxh_u64 x;
+ *   x ^= (x >> 47); // good
+ *   x ^= (x >> 13); // bad
+ *
+ * However, to a 32-bit machine, there is a major difference.
+ *
+ * x ^= (x >> 47) looks like this:
+ *
+ *   x.lo ^= (x.hi >> (47 - 32));
+ *
+ * while x ^= (x >> 13) looks like this:
+ *
+ *   // note: funnel shifts are not usually cheap.
+ *   x.lo ^= (x.lo >> 13) | (x.hi << (32 - 13));
+ *   x.hi ^= (x.hi >> 13);
+ *
+ * The first one is significantly faster than the second, simply because the
+ * shift is larger than 32. This means:
+ *  - All the bits we need are in the upper 32 bits, so we can ignore the lower
+ *    32 bits in the shift.
+ *  - The shift result will always fit in the lower 32 bits, and therefore,
+ *    we can ignore the upper 32 bits in the xor.
+ *
+ * Thanks to this optimization, XXH3 only requires these features to be efficient:
+ *
+ *  - Usable unaligned access
+ *  - A 32-bit or 64-bit ALU
+ *      - If 32-bit, a decent ADC instruction
+ *  - A 32 or 64-bit multiply with a 64-bit result
+ *  - For the 128-bit variant, a decent byteswap helps short inputs.
+ *
+ * The first two are already required by XXH32, and almost all 32-bit and 64-bit
+ * platforms which can run XXH32 can run XXH3 efficiently.
+ *
+ * Thumb-1, the classic 16-bit only subset of ARM's instruction set, is one
+ * notable exception.
+ *
+ * First of all, Thumb-1 lacks support for the UMULL instruction which
+ * performs the important long multiply. This means numerous __aeabi_lmul
+ * calls.
+ *
+ * Second of all, the 8 functional registers are just not enough.
+ * Setup for __aeabi_lmul, byteshift loads, pointers, and all arithmetic need
+ * Lo registers, and this shuffling results in thousands more MOVs than A32.
+ *
+ * A32 and T32 don't have this limitation. They can access all 14 registers,
+ * do a 32->64 multiply with UMULL, and the flexible operand allowing free
+ * shifts is helpful, too.
+ *
+ * Therefore, we do a quick sanity check.
+ *
+ * If compiling Thumb-1 for a target which supports ARM instructions, we will
+ * emit a warning, as it is not a "sane" platform to compile for.
+ *
+ * Usually, if this happens, it is because of an accident and you probably need
+ * to specify -march, as you likely meant to compile for a newer architecture.
+ *
+ * Credit: large sections of the vectorial and asm source code paths
+ *         have been contributed by @easyaspi314
+ */
+#if defined(__thumb__) && !defined(__thumb2__) && defined(__ARM_ARCH_ISA_ARM)
+#   warning "XXH3 is highly inefficient without ARM or Thumb-2."
+#endif
+
+/* ==========================================
+ * Vectorization detection
+ * ========================================== */
+
+#ifdef XXH_DOXYGEN
+/*!
+ * @ingroup tuning
+ * @brief Overrides the vectorization implementation chosen for XXH3.
+ *
+ * Can be defined to 0 to disable SIMD or any of the values mentioned in
+ * @ref XXH_VECTOR_TYPE.
+ *
+ * If this is not defined, it uses predefined macros to determine the best
+ * implementation.
+ */
+#  define XXH_VECTOR XXH_SCALAR
+/*!
+ * @ingroup tuning
+ * @brief Possible values for @ref XXH_VECTOR.
+ *
+ * Note that these are actually implemented as macros.
+ *
+ * If this is not defined, it is detected automatically.
+ * internal macro XXH_X86DISPATCH overrides this.
+ */
+enum XXH_VECTOR_TYPE /* fake enum */ {
+    XXH_SCALAR = 0,  /*!< Portable scalar version */
+    XXH_SSE2   = 1,  /*!<
+                      * SSE2 for Pentium 4, Opteron, all x86_64.
+                      *
+                      * @note SSE2 is also guaranteed on Windows 10, macOS, and
+                      * Android x86.
+                      */
+    XXH_AVX2   = 2,  /*!< AVX2 for Haswell and Bulldozer */
+    XXH_AVX512 = 3,  /*!< AVX512 for Skylake and Icelake */
+    XXH_NEON   = 4,  /*!<
+                       * NEON for most ARMv7-A, all AArch64, and WASM SIMD128
+                       * via the SIMDeverywhere polyfill provided with the
+                       * Emscripten SDK.
+                       */
+    XXH_VSX    = 5,  /*!< VSX and ZVector for POWER8/z13 (64-bit) */
+    XXH_SVE    = 6,  /*!< SVE for some ARMv8-A and ARMv9-A */
+};
+/*!
+ * @ingroup tuning
+ * @brief Selects the minimum alignment for XXH3's accumulators.
+ *
+ * When using SIMD, this should match the alignment required for said vector
+ * type, so, for example, 32 for AVX2.
+ *
+ * Default: Auto detected.
+ */
+#  define XXH_ACC_ALIGN 8
+#endif
+
+/* Actual definition */
+#ifndef XXH_DOXYGEN
+#  define XXH_SCALAR 0
+#  define XXH_SSE2   1
+#  define XXH_AVX2   2
+#  define XXH_AVX512 3
+#  define XXH_NEON   4
+#  define XXH_VSX    5
+#  define XXH_SVE    6
+#endif
+
+#ifndef XXH_VECTOR    /* can be defined on command line */
+#  if defined(__ARM_FEATURE_SVE)
+#    define XXH_VECTOR XXH_SVE
+#  elif ( \
+        defined(__ARM_NEON__) || defined(__ARM_NEON) /* gcc */ \
+     || defined(_M_ARM) || defined(_M_ARM64) || defined(_M_ARM64EC) /* msvc */ \
+     || (defined(__wasm_simd128__) && XXH_HAS_INCLUDE(<arm_neon.h>)) /* wasm simd128 via SIMDe */ \
+   ) && ( \
+        defined(_WIN32) || defined(__LITTLE_ENDIAN__) /* little endian only */ \
+    || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) \
+   )
+#    define XXH_VECTOR XXH_NEON
 #  elif defined(__AVX512F__)
 #    define XXH_VECTOR XXH_AVX512
 #  elif defined(__AVX2__)
@@ -3915,2390 +5255,4362 @@ enum XXH_VECTOR_TYPE /* fake enum */ {
      && defined(__GNUC__) /* TODO: IBM XL */
 #    define XXH_VECTOR XXH_VSX
 #  else
-#    define XXH_VECTOR XXH_SCALAR
-#  endif
+#    define XXH_VECTOR XXH_SCALAR
+#  endif
+#endif
+
+/* __ARM_FEATURE_SVE is only supported by GCC & Clang. */
+#if (XXH_VECTOR == XXH_SVE) && !defined(__ARM_FEATURE_SVE)
+#  ifdef _MSC_VER
+#    pragma warning(once : 4606)
+#  else
+#    warning "__ARM_FEATURE_SVE isn't supported. Use SCALAR instead."
+#  endif
+#  undef XXH_VECTOR
+#  define XXH_VECTOR XXH_SCALAR
+#endif
+
+/*
+ * Controls the alignment of the accumulator,
+ * for compatibility with aligned vector loads, which are usually faster.
+ */
+#ifndef XXH_ACC_ALIGN
+#  if defined(XXH_X86DISPATCH)
+#     define XXH_ACC_ALIGN 64  /* for compatibility with avx512 */
+#  elif XXH_VECTOR == XXH_SCALAR  /* scalar */
+#     define XXH_ACC_ALIGN 8
+#  elif XXH_VECTOR == XXH_SSE2  /* sse2 */
+#     define XXH_ACC_ALIGN 16
+#  elif XXH_VECTOR == XXH_AVX2  /* avx2 */
+#     define XXH_ACC_ALIGN 32
+#  elif XXH_VECTOR == XXH_NEON  /* neon */
+#     define XXH_ACC_ALIGN 16
+#  elif XXH_VECTOR == XXH_VSX   /* vsx */
+#     define XXH_ACC_ALIGN 16
+#  elif XXH_VECTOR == XXH_AVX512  /* avx512 */
+#     define XXH_ACC_ALIGN 64
+#  elif XXH_VECTOR == XXH_SVE   /* sve */
+#     define XXH_ACC_ALIGN 64
+#  endif
+#endif
+
+#if defined(XXH_X86DISPATCH) || XXH_VECTOR == XXH_SSE2 \
+    || XXH_VECTOR == XXH_AVX2 || XXH_VECTOR == XXH_AVX512
+#  define XXH_SEC_ALIGN XXH_ACC_ALIGN
+#elif XXH_VECTOR == XXH_SVE
+#  define XXH_SEC_ALIGN XXH_ACC_ALIGN
+#else
+#  define XXH_SEC_ALIGN 8
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define XXH_ALIASING __attribute__((__may_alias__))
+#else
+#  define XXH_ALIASING /* nothing */
+#endif
+
+/*
+ * UGLY HACK:
+ * GCC usually generates the best code with -O3 for xxHash.
+ *
+ * However, when targeting AVX2, it is overzealous in its unrolling resulting
+ * in code roughly 3/4 the speed of Clang.
+ *
+ * There are other issues, such as GCC splitting _mm256_loadu_si256 into
+ * _mm_loadu_si128 + _mm256_inserti128_si256. This is an optimization which
+ * only applies to Sandy and Ivy Bridge... which don't even support AVX2.
+ *
+ * That is why when compiling the AVX2 version, it is recommended to use either
+ *   -O2 -mavx2 -march=haswell
+ * or
+ *   -O2 -mavx2 -mno-avx256-split-unaligned-load
+ * for decent performance, or to use Clang instead.
+ *
+ * Fortunately, we can control the first one with a pragma that forces GCC into
+ * -O2, but the other one we can't control without "failed to inline always
+ * inline function due to target mismatch" warnings.
+ */
+#if XXH_VECTOR == XXH_AVX2 /* AVX2 */ \
+  && defined(__GNUC__) && !defined(__clang__) /* GCC, not Clang */ \
+  && defined(__OPTIMIZE__) && XXH_SIZE_OPT <= 0 /* respect -O0 and -Os */
+#  pragma GCC push_options
+#  pragma GCC optimize("-O2")
+#endif
+
+#if XXH_VECTOR == XXH_NEON
+
+/*
+ * UGLY HACK: While AArch64 GCC on Linux does not seem to care, on macOS, GCC -O3
+ * optimizes out the entire hashLong loop because of the aliasing violation.
+ *
+ * However, GCC is also inefficient at load-store optimization with vld1q/vst1q,
+ * so the only option is to mark it as aliasing.
+ */
+typedef uint64x2_t xxh_aliasing_uint64x2_t XXH_ALIASING;
+
+/*!
+ * @internal
+ * @brief `vld1q_u64` but faster and alignment-safe.
+ *
+ * On AArch64, unaligned access is always safe, but on ARMv7-a, it is only
+ * *conditionally* safe (`vld1` has an alignment bit like `movdq[ua]` in x86).
+ *
+ * GCC for AArch64 sees `vld1q_u8` as an intrinsic instead of a load, so it
+ * prohibits load-store optimizations. Therefore, a direct dereference is used.
+ *
+ * Otherwise, `vld1q_u8` is used with `vreinterpretq_u8_u64` to do a safe
+ * unaligned load.
+ */
+#if defined(__aarch64__) && defined(__GNUC__) && !defined(__clang__)
+XXH_FORCE_INLINE uint64x2_t XXH_vld1q_u64(void const* ptr) /* silence -Wcast-align */
+{
+    return *(xxh_aliasing_uint64x2_t const *)ptr;
+}
+#else
+XXH_FORCE_INLINE uint64x2_t XXH_vld1q_u64(void const* ptr)
+{
+    return vreinterpretq_u64_u8(vld1q_u8((uint8_t const*)ptr));
+}
+#endif
+
+/*!
+ * @internal
+ * @brief `vmlal_u32` on low and high halves of a vector.
+ *
+ * This is a workaround for AArch64 GCC < 11 which implemented arm_neon.h with
+ * inline assembly and were therefore incapable of merging the `vget_{low, high}_u32`
+ * with `vmlal_u32`.
+ */
+#if defined(__aarch64__) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 11
+XXH_FORCE_INLINE uint64x2_t
+XXH_vmlal_low_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
+{
+    /* Inline assembly is the only way */
+    __asm__("umlal   %0.2d, %1.2s, %2.2s" : "+w" (acc) : "w" (lhs), "w" (rhs));
+    return acc;
+}
+XXH_FORCE_INLINE uint64x2_t
+XXH_vmlal_high_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
+{
+    /* This intrinsic works as expected */
+    return vmlal_high_u32(acc, lhs, rhs);
+}
+#else
+/* Portable intrinsic versions */
+XXH_FORCE_INLINE uint64x2_t
+XXH_vmlal_low_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
+{
+    return vmlal_u32(acc, vget_low_u32(lhs), vget_low_u32(rhs));
+}
+/*! @copydoc XXH_vmlal_low_u32
+ * Assume the compiler converts this to vmlal_high_u32 on aarch64 */
+XXH_FORCE_INLINE uint64x2_t
+XXH_vmlal_high_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
+{
+    return vmlal_u32(acc, vget_high_u32(lhs), vget_high_u32(rhs));
+}
+#endif
+
+/*!
+ * @ingroup tuning
+ * @brief Controls the NEON to scalar ratio for XXH3
+ *
+ * This can be set to 2, 4, 6, or 8.
+ *
+ * ARM Cortex CPUs are _very_ sensitive to how their pipelines are used.
+ *
+ * For example, the Cortex-A73 can dispatch 3 micro-ops per cycle, but only 2 of those
+ * can be NEON. If you are only using NEON instructions, you are only using 2/3 of the CPU
+ * bandwidth.
+ *
+ * This is even more noticeable on the more advanced cores like the Cortex-A76 which
+ * can dispatch 8 micro-ops per cycle, but still only 2 NEON micro-ops at once.
+ *
+ * Therefore, to make the most out of the pipeline, it is beneficial to run 6 NEON lanes
+ * and 2 scalar lanes, which is chosen by default.
+ *
+ * This does not apply to Apple processors or 32-bit processors, which run better with
+ * full NEON. These will default to 8. Additionally, size-optimized builds run 8 lanes.
+ *
+ * This change benefits CPUs with large micro-op buffers without negatively affecting
+ * most other CPUs:
+ *
+ *  | Chipset               | Dispatch type       | NEON only | 6:2 hybrid | Diff. |
+ *  |:----------------------|:--------------------|----------:|-----------:|------:|
+ *  | Snapdragon 730 (A76)  | 2 NEON/8 micro-ops  |  8.8 GB/s |  10.1 GB/s |  ~16% |
+ *  | Snapdragon 835 (A73)  | 2 NEON/3 micro-ops  |  5.1 GB/s |   5.3 GB/s |   ~5% |
+ *  | Marvell PXA1928 (A53) | In-order dual-issue |  1.9 GB/s |   1.9 GB/s |    0% |
+ *  | Apple M1              | 4 NEON/8 micro-ops  | 37.3 GB/s |  36.1 GB/s |  ~-3% |
+ *
+ * It also seems to fix some bad codegen on GCC, making it almost as fast as clang.
+ *
+ * When using WASM SIMD128, if this is 2 or 6, SIMDe will scalarize 2 of the lanes meaning
+ * it effectively becomes worse 4.
+ *
+ * @see XXH3_accumulate_512_neon()
+ */
+# ifndef XXH3_NEON_LANES
+#  if (defined(__aarch64__) || defined(__arm64__) || defined(_M_ARM64) || defined(_M_ARM64EC)) \
+   && !defined(__APPLE__) && XXH_SIZE_OPT <= 0
+#   define XXH3_NEON_LANES 6
+#  else
+#   define XXH3_NEON_LANES XXH_ACC_NB
+#  endif
+# endif
+#endif  /* XXH_VECTOR == XXH_NEON */
+
+/*
+ * VSX and Z Vector helpers.
+ *
+ * This is very messy, and any pull requests to clean this up are welcome.
+ *
+ * There are a lot of problems with supporting VSX and s390x, due to
+ * inconsistent intrinsics, spotty coverage, and multiple endiannesses.
+ */
+#if XXH_VECTOR == XXH_VSX
+/* Annoyingly, these headers _may_ define three macros: `bool`, `vector`,
+ * and `pixel`. This is a problem for obvious reasons.
+ *
+ * These keywords are unnecessary; the spec literally says they are
+ * equivalent to `__bool`, `__vector`, and `__pixel` and may be undef'd
+ * after including the header.
+ *
+ * We use pragma push_macro/pop_macro to keep the namespace clean. */
+#  pragma push_macro("bool")
+#  pragma push_macro("vector")
+#  pragma push_macro("pixel")
+/* silence potential macro redefined warnings */
+#  undef bool
+#  undef vector
+#  undef pixel
+
+#  if defined(__s390x__)
+#    include <s390intrin.h>
+#  else
+#    include <altivec.h>
+#  endif
+
+/* Restore the original macro values, if applicable. */
+#  pragma pop_macro("pixel")
+#  pragma pop_macro("vector")
+#  pragma pop_macro("bool")
+
+typedef __vector unsigned long long xxh_u64x2;
+typedef __vector unsigned char xxh_u8x16;
+typedef __vector unsigned xxh_u32x4;
+
+/*
+ * UGLY HACK: Similar to aarch64 macOS GCC, s390x GCC has the same aliasing issue.
+ */
+typedef xxh_u64x2 xxh_aliasing_u64x2 XXH_ALIASING;
+
+# ifndef XXH_VSX_BE
+#  if defined(__BIG_ENDIAN__) \
+  || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#    define XXH_VSX_BE 1
+#  elif defined(__VEC_ELEMENT_REG_ORDER__) && __VEC_ELEMENT_REG_ORDER__ == __ORDER_BIG_ENDIAN__
+#    warning "-maltivec=be is not recommended. Please use native endianness."
+#    define XXH_VSX_BE 1
+#  else
+#    define XXH_VSX_BE 0
+#  endif
+# endif /* !defined(XXH_VSX_BE) */
+
+# if XXH_VSX_BE
+#  if defined(__POWER9_VECTOR__) || (defined(__clang__) && defined(__s390x__))
+#    define XXH_vec_revb vec_revb
+#  else
+/*!
+ * A polyfill for POWER9's vec_revb().
+ */
+XXH_FORCE_INLINE xxh_u64x2 XXH_vec_revb(xxh_u64x2 val)
+{
+    xxh_u8x16 const vByteSwap = { 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00,
+                                  0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08 };
+    return vec_perm(val, val, vByteSwap);
+}
+#  endif
+# endif /* XXH_VSX_BE */
+
+/*!
+ * Performs an unaligned vector load and byte swaps it on big endian.
+ */
+XXH_FORCE_INLINE xxh_u64x2 XXH_vec_loadu(const void *ptr)
+{
+    xxh_u64x2 ret;
+    XXH_memcpy(&ret, ptr, sizeof(xxh_u64x2));
+# if XXH_VSX_BE
+    ret = XXH_vec_revb(ret);
+# endif
+    return ret;
+}
+
+/*
+ * vec_mulo and vec_mule are very problematic intrinsics on PowerPC
+ *
+ * These intrinsics weren't added until GCC 8, despite existing for a while,
+ * and they are endian dependent. Also, their meaning swap depending on version.
+ * */
+# if defined(__s390x__)
+ /* s390x is always big endian, no issue on this platform */
+#  define XXH_vec_mulo vec_mulo
+#  define XXH_vec_mule vec_mule
+# elif defined(__clang__) && XXH_HAS_BUILTIN(__builtin_altivec_vmuleuw) && !defined(__ibmxl__)
+/* Clang has a better way to control this, we can just use the builtin which doesn't swap. */
+ /* The IBM XL Compiler (which defined __clang__) only implements the vec_* operations */
+#  define XXH_vec_mulo __builtin_altivec_vmulouw
+#  define XXH_vec_mule __builtin_altivec_vmuleuw
+# else
+/* gcc needs inline assembly */
+/* Adapted from https://github.com/google/highwayhash/blob/master/highwayhash/hh_vsx.h. */
+XXH_FORCE_INLINE xxh_u64x2 XXH_vec_mulo(xxh_u32x4 a, xxh_u32x4 b)
+{
+    xxh_u64x2 result;
+    __asm__("vmulouw %0, %1, %2" : "=v" (result) : "v" (a), "v" (b));
+    return result;
+}
+XXH_FORCE_INLINE xxh_u64x2 XXH_vec_mule(xxh_u32x4 a, xxh_u32x4 b)
+{
+    xxh_u64x2 result;
+    __asm__("vmuleuw %0, %1, %2" : "=v" (result) : "v" (a), "v" (b));
+    return result;
+}
+# endif /* XXH_vec_mulo, XXH_vec_mule */
+#endif /* XXH_VECTOR == XXH_VSX */
+
+#if XXH_VECTOR == XXH_SVE
+#define ACCRND(acc, offset) \
+do { \
+    svuint64_t input_vec = svld1_u64(mask, xinput + offset);         \
+    svuint64_t secret_vec = svld1_u64(mask, xsecret + offset);       \
+    svuint64_t mixed = sveor_u64_x(mask, secret_vec, input_vec);     \
+    svuint64_t swapped = svtbl_u64(input_vec, kSwap);                \
+    svuint64_t mixed_lo = svextw_u64_x(mask, mixed);                 \
+    svuint64_t mixed_hi = svlsr_n_u64_x(mask, mixed, 32);            \
+    svuint64_t mul = svmad_u64_x(mask, mixed_lo, mixed_hi, swapped); \
+    acc = svadd_u64_x(mask, acc, mul);                               \
+} while (0)
+#endif /* XXH_VECTOR == XXH_SVE */
+
+/* prefetch
+ * can be disabled, by declaring XXH_NO_PREFETCH build macro.
+ * XXH_PREFETCH_INPUT() is only used for the input of the long loops:
+ * it becomes non-temporal with XXH_PREFETCH_NTA=1, while XXH_PREFETCH() is unchanged */
+#ifndef XXH_PREFETCH_NTA
+#  define XXH_PREFETCH_NTA 0
+#endif
+#if defined(XXH_NO_PREFETCH)
+#  define XXH_PREFETCH(ptr)  (void)(ptr)  /* disabled */
+#  define XXH_PREFETCH_INPUT(ptr)  (void)(ptr)
+#else
+#  if XXH_SIZE_OPT >= 1
+#    define XXH_PREFETCH(ptr) (void)(ptr)
+#    define XXH_PREFETCH_INPUT(ptr) (void)(ptr)
+#  elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))  /* _mm_prefetch() not defined outside of x86/x64 */
+#    include <mmintrin.h>   /* https://msdn.microsoft.com/fr-fr/library/84szxsww(v=vs.90).aspx */
+#    define XXH_PREFETCH(ptr)  _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#    if XXH_PREFETCH_NTA
+#      define XXH_PREFETCH_INPUT(ptr)  _mm_prefetch((const char*)(ptr), _MM_HINT_NTA)
+#    endif
+#  elif defined(__GNUC__) && ( (__GNUC__ >= 4) || ( (__GNUC__ == 3) && (__GNUC_MINOR__ >= 1) ) )
+#    define XXH_PREFETCH(ptr)  __builtin_prefetch((ptr), 0 /* rw==read */, 3 /* locality */)
+#    if XXH_PREFETCH_NTA
+#      define XXH_PREFETCH_INPUT(ptr)  __builtin_prefetch((ptr), 0 /* rw==read */, 0 /* no temporal locality */)
+#    endif
+#  else
+#    define XXH_PREFETCH(ptr) (void)(ptr)  /* disabled */
+#    define XXH_PREFETCH_INPUT(ptr) (void)(ptr)
+#  endif
+#  ifndef XXH_PREFETCH_INPUT
+#    define XXH_PREFETCH_INPUT(ptr) XXH_PREFETCH(ptr)
+#  endif
+#endif  /* XXH_NO_PREFETCH */
+
+
+/* ==========================================
+ * XXH3 default settings
+ * ========================================== */
+
+#define XXH_SECRET_DEFAULT_SIZE 192   /* minimum XXH3_SECRET_SIZE_MIN */
+
+#if (XXH_SECRET_DEFAULT_SIZE < XXH3_SECRET_SIZE_MIN)
+#  error "default keyset is not large enough"
+#endif
+
+/*! Pseudorandom secret taken directly from FARSH. */
+XXH_ALIGN(64) static const xxh_u8 XXH3_kSecret[XXH_SECRET_DEFAULT_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static const xxh_u64 PRIME_MX1 = 0x165667919E3779F9ULL;  /*!< 0b0001011001010110011001111001000110011110001101110111100111111001 */
+static const xxh_u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;  /*!< 0b1001111110110010000111000110010100011110100110001101111100100101 */
+
+#ifdef XXH_OLD_NAMES
+#  define kSecret XXH3_kSecret
+#endif
+
+#ifdef XXH_DOXYGEN
+/*!
+ * @brief Calculates a 32-bit to 64-bit long multiply.
+ *
+ * Implemented as a macro.
+ *
+ * Wraps `__emulu` on MSVC x86 because it tends to call `__allmul` when it doesn't
+ * need to (but it shouldn't need to anyways, it is about 7 instructions to do
+ * a 64x64 multiply...). Since we know that this will _always_ emit `MULL`, we
+ * use that instead of the normal method.
+ *
+ * If you are compiling for platforms like Thumb-1 and don't have a better option,
+ * you may also want to write your own long multiply routine here.
+ *
+ * @param x, y Numbers to be multiplied
+ * @return 64-bit product of the low 32 bits of @p x and @p y.
+ */
+XXH_FORCE_INLINE xxh_u64
+XXH_mult32to64(xxh_u64 x, xxh_u64 y)
+{
+   return (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF);
+}
+#elif defined(_MSC_VER) && defined(_M_IX86)
+#    define XXH_mult32to64(x, y) __emulu((unsigned)(x), (unsigned)(y))
+#else
+/*
+ * Downcast + upcast is usually better than masking on older compilers like
+ * GCC 4.2 (especially 32-bit ones), all without affecting newer compilers.
+ *
+ * The other method, (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF), will AND both operands
+ * and perform a full 64x64 multiply -- entirely redundant on 32-bit.
+ */
+#    define XXH_mult32to64(x, y) ((xxh_u64)(xxh_u32)(x) * (xxh_u64)(xxh_u32)(y))
+#endif
+
+/*!
+ * @brief Calculates a 64->128-bit long multiply.
+ *
+ * Uses `__uint128_t` and `_umul128` if available, otherwise uses a scalar
+ * version.
+ *
+ * @param lhs , rhs The 64-bit integers to be multiplied
+ * @return The 128-bit result represented in an @ref XXH128_hash_t.
+ */
+static XXH128_hash_t
+XXH_mult64to128(xxh_u64 lhs, xxh_u64 rhs)
+{
+    /*
+     * GCC/Clang __uint128_t method.
+     *
+     * On most 64-bit targets, GCC and Clang define a __uint128_t type.
+     * This is usually the best way as it usually uses a native long 64-bit
+     * multiply, such as MULQ on x86_64 or MUL + UMULH on aarch64.
+     *
+     * Usually.
+     *
+     * Despite being a 32-bit platform, Clang (and emscripten) define this type
+     * despite not having the arithmetic for it. This results in a laggy
+     * compiler builtin call which calculates a full 128-bit multiply.
+     * In that case it is best to use the portable one.
+     * https://github.com/Cyan4973/xxHash/issues/211#issuecomment-515575677
+     */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__wasm__) \
+    && defined(__SIZEOF_INT128__) \
+    || (defined(_INTEGRAL_MAX_BITS) && _INTEGRAL_MAX_BITS >= 128)
+
+    __uint128_t const product = (__uint128_t)lhs * (__uint128_t)rhs;
+    XXH128_hash_t r128;
+    r128.low64  = (xxh_u64)(product);
+    r128.high64 = (xxh_u64)(product >> 64);
+    return r128;
+
+    /*
+     * MSVC for x64's _umul128 method.
+     *
+     * xxh_u64 _umul128(xxh_u64 Multiplier, xxh_u64 Multiplicand, xxh_u64 *HighProduct);
+     *
+     * This compiles to single operand MUL on x64.
+     */
+#elif (defined(_M_X64) || defined(_M_IA64)) && !defined(_M_ARM64EC)
+
+#ifndef _MSC_VER
+#   pragma intrinsic(_umul128)
+#endif
+    xxh_u64 product_high;
+    xxh_u64 const product_low = _umul128(lhs, rhs, &product_high);
+    XXH128_hash_t r128;
+    r128.low64  = product_low;
+    r128.high64 = product_high;
+    return r128;
+
+    /*
+     * MSVC for ARM64's __umulh method.
+     *
+     * This compiles to the same MUL + UMULH as GCC/Clang's __uint128_t method.
+     */
+#elif defined(_M_ARM64) || defined(_M_ARM64EC)
+
+#ifndef _MSC_VER
+#   pragma intrinsic(__umulh)
+#endif
+    XXH128_hash_t r128;
+    r128.low64  = lhs * rhs;
+    r128.high64 = __umulh(lhs, rhs);
+    return r128;
+
+#else
+    /*
+     * Portable scalar method. Optimized for 32-bit and 64-bit ALUs.
+     *
+     * This is a fast and simple grade school multiply, which is shown below
+     * with base 10 arithmetic instead of base 0x100000000.
+     *
+     *           9 3 // D2 lhs = 93
+     *         x 7 5 // D2 rhs = 75
+     *     ----------
+     *           1 5 // D2 lo_lo = (93 % 10) * (75 % 10) = 15
+     *         4 5 | // D2 hi_lo = (93 / 10) * (75 % 10) = 45
+     *         2 1 | // D2 lo_hi = (93 % 10) * (75 / 10) = 21
+     *     + 6 3 | | // D2 hi_hi = (93 / 10) * (75 / 10) = 63
+     *     ---------
+     *         2 7 | // D2 cross = (15 / 10) + (45 % 10) + 21 = 27
+     *     + 6 7 | | // D2 upper = (27 / 10) + (45 / 10) + 63 = 67
+     *     ---------
+     *       6 9 7 5 // D4 res = (27 * 10) + (15 % 10) + (67 * 100) = 6975
+     *
+     * The reasons for adding the products like this are:
+     *  1. It avoids manual carry tracking. Just like how
+     *     (9 * 9) + 9 + 9 = 99, the same applies with this for UINT64_MAX.
+     *     This avoids a lot of complexity.
+     *
+     *  2. It hints for, and on Clang, compiles to, the powerful UMAAL
+     *     instruction available in ARM's Digital Signal Processing extension
+     *     in 32-bit ARMv6 and later, which is shown below:
+     *
+     *         void UMAAL(xxh_u32 *RdLo, xxh_u32 *RdHi, xxh_u32 Rn, xxh_u32 Rm)
+     *         {
+     *             xxh_u64 product = (xxh_u64)*RdLo * (xxh_u64)*RdHi + Rn + Rm;
+     *             *RdLo = (xxh_u32)(product & 0xFFFFFFFF);
+     *             *RdHi = (xxh_u32)(product >> 32);
+     *         }
+     *
+     *     This instruction was designed for efficient long multiplication, and
+     *     allows this to be calculated in only 4 instructions at speeds
+     *     comparable to some 64-bit ALUs.
+     *
+     *  3. It isn't terrible on other platforms. Usually this will be a couple
+     *     of 32-bit ADD/ADCs.
+     */
+
+    /* First calculate all of the cross products. */
+    xxh_u64 const lo_lo = XXH_mult32to64(lhs & 0xFFFFFFFF, rhs & 0xFFFFFFFF);
+    xxh_u64 const hi_lo = XXH_mult32to64(lhs >> 32,        rhs & 0xFFFFFFFF);
+    xxh_u64 const lo_hi = XXH_mult32to64(lhs & 0xFFFFFFFF, rhs >> 32);
+    xxh_u64 const hi_hi = XXH_mult32to64(lhs >> 32,        rhs >> 32);
+
+    /* Now add the products together. These will never overflow. */
+    xxh_u64 const cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    xxh_u64 const upper = (hi_lo >> 32) + (cross >> 32)        + hi_hi;
+    xxh_u64 const lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+
+    XXH128_hash_t r128;
+    r128.low64  = lower;
+    r128.high64 = upper;
+    return r128;
+#endif
+}
+
+/*!
+ * @brief Calculates a 64-bit to 128-bit multiply, then XOR folds it.
+ *
+ * The reason for the separate function is to prevent passing too many structs
+ * around by value. This will hopefully inline the multiply, but we don't force it.
+ *
+ * @param lhs , rhs The 64-bit integers to multiply
+ * @return The low 64 bits of the product XOR'd by the high 64 bits.
+ * @see XXH_mult64to128()
+ */
+static xxh_u64
+XXH3_mul128_fold64(xxh_u64 lhs, xxh_u64 rhs)
+{
+    XXH128_hash_t product = XXH_mult64to128(lhs, rhs);
+    return product.low64 ^ product.high64;
+}
+
+/*! Seems to produce slightly better code on GCC for some reason. */
+XXH_FORCE_INLINE XXH_CONSTF xxh_u64 XXH_xorshift64(xxh_u64 v64, int shift)
+{
+    XXH_ASSERT(0 <= shift && shift < 64);
+    return v64 ^ (v64 >> shift);
+}
+
+/*
+ * This is a fast avalanche stage,
+ * suitable when input bits are already partially mixed
+ */
+static XXH64_hash_t XXH3_avalanche(xxh_u64 h64)
+{
+    h64 = XXH_xorshift64(h64, 37);
+    h64 *= PRIME_MX1;
+    h64 = XXH_xorshift64(h64, 32);
+    return h64;
+}
+
+/*
+ * This is a stronger avalanche,
+ * inspired by Pelle Evensen's rrmxmx
+ * preferable when input has not been previously mixed
+ */
+static XXH64_hash_t XXH3_rrmxmx(xxh_u64 h64, xxh_u64 len)
+{
+    /* this mix is inspired by Pelle Evensen's rrmxmx */
+    h64 ^= XXH_rotl64(h64, 49) ^ XXH_rotl64(h64, 24);
+    h64 *= PRIME_MX2;
+    h64 ^= (h64 >> 35) + len ;
+    h64 *= PRIME_MX2;
+    return XXH_xorshift64(h64, 28);
+}
+
+
+/*!
+ * @internal
+ * @brief Enum to indicate how short and mid-size inputs are loaded.
+ *
+ * It is always a compile time constant, so the unused case is optimized out.
+ */
+typedef enum {
+    XXH3_asIs,      /*!< Bytes are hashed as is */
+    XXH3_foldAscii  /*!< 'A'-'Z' are hashed as 'a'-'z', see XXH3_64bits_asciiFold() */
+} XXH3_fold;
+
+/*
+ * Folds 'A'-'Z' to lowercase in each byte of @w, if requested.
+ * No addition can carry into the next byte, so byte order does not matter.
+ */
+XXH_FORCE_INLINE xxh_u64 XXH3_fold64(xxh_u64 w, XXH3_fold fold)
+{
+    if (fold == XXH3_foldAscii) {
+        xxh_u64 const highBits = 0x8080808080808080ULL;
+        xxh_u64 const low7  = w & ~highBits;
+        xxh_u64 const geA   = low7 + 0x3F3F3F3F3F3F3F3FULL;  /* high bit set if >= 'A' */
+        xxh_u64 const gtZ   = low7 + 0x2525252525252525ULL;  /* high bit set if >  'Z' */
+        xxh_u64 const upper = geA & ~gtZ & ~w & highBits;    /* excludes bytes >= 0x80 */
+        return w | (upper >> 2);                             /* 0x80 >> 2 == 'a' - 'A' */
+    }
+    return w;
+}
+
+XXH_FORCE_INLINE xxh_u32 XXH3_readLE32_fold(const void* ptr, XXH3_fold fold)
+{
+    return (xxh_u32)XXH3_fold64(XXH_readLE32(ptr), fold);
+}
+
+XXH_FORCE_INLINE xxh_u64 XXH3_readLE64_fold(const void* ptr, XXH3_fold fold)
+{
+    return XXH3_fold64(XXH_readLE64(ptr), fold);
+}
+
+#if (XXH_VECTOR == XXH_SSE2) || (XXH_VECTOR == XXH_AVX2) || (XXH_VECTOR == XXH_AVX512)
+/*
+ * 16 bytes at a time:
+ * 'A'-'Z' are moved to the bottom of the signed range, then selected by a single compare.
+ */
+#  define XXH3_FOLD_STEP 16
+XXH_FORCE_INLINE void XXH3_asciiFoldStep(xxh_u8* dst, const xxh_u8* src)
+{
+    __m128i const v     = _mm_loadu_si128((const __m128i*)(const void*)src);
+    __m128i const moved = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i const upper = _mm_cmplt_epi8(moved, _mm_set1_epi8((char)(-128 + 26)));
+    __m128i const lower = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    _mm_storeu_si128((__m128i*)(void*)dst, lower);
+}
+#else
+#  define XXH3_FOLD_STEP 8
+XXH_FORCE_INLINE void XXH3_asciiFoldStep(xxh_u8* dst, const xxh_u8* src)
+{
+    xxh_u64 const w = XXH3_fold64(XXH_read64(src), XXH3_foldAscii);
+    XXH_memcpy(dst, &w, sizeof(w));
+}
+#endif
+
+/*
+ * Loads 16 bytes as two 64-bit words.
+ * When folding 16 bytes at a time, both words are read back from the same store,
+ * which can be forwarded.
+ */
+XXH_FORCE_INLINE void
+XXH3_readLE128_fold(const xxh_u8* ptr, xxh_u64* lo, xxh_u64* hi, XXH3_fold fold)
+{
+#if XXH3_FOLD_STEP == 16
+    if (fold == XXH3_foldAscii) {
+        XXH_ALIGN(16) xxh_u8 folded[16];
+        XXH3_asciiFoldStep(folded, ptr);
+        *lo = XXH_readLE64(folded);
+        *hi = XXH_readLE64(folded + 8);
+        return;
+    }
+#endif
+    *lo = XXH3_readLE64_fold(ptr, fold);
+    *hi = XXH3_readLE64_fold(ptr + 8, fold);
+}
+
+/* ==========================================
+ * Short keys
+ * ==========================================
+ * One of the shortcomings of XXH32 and XXH64 was that their performance was
+ * sub-optimal on short lengths. It used an iterative algorithm which strongly
+ * favored lengths that were a multiple of 4 or 8.
+ *
+ * Instead of iterating over individual inputs, we use a set of single shot
+ * functions which piece together a range of lengths and operate in constant time.
+ *
+ * Additionally, the number of multiplies has been significantly reduced. This
+ * reduces latency, especially when emulating 64-bit multiplies on 32-bit.
+ *
+ * Depending on the platform, this may or may not be faster than XXH32, but it
+ * is almost guaranteed to be faster than XXH64.
+ */
+
+/*
+ * At very short lengths, there isn't enough input to fully hide secrets, or use
+ * the entire secret.
+ *
+ * There is also only a limited amount of mixing we can do before significantly
+ * impacting performance.
+ *
+ * Therefore, we use different sections of the secret and always mix two secret
+ * samples with an XOR. This should have no effect on performance on the
+ * seedless or withSeed variants because everything _should_ be constant folded
+ * by modern compilers.
+ *
+ * The XOR mixing hides individual parts of the secret and increases entropy.
+ *
+ * This adds an extra layer of strength for custom secrets.
+ */
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_1to3_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                  XXH3_fold fold)
+{
+    XXH_ASSERT(input != NULL);
+    XXH_ASSERT(1 <= len && len <= 3);
+    XXH_ASSERT(secret != NULL);
+    /*
+     * len = 1: combined = { input[0], 0x01, input[0], input[0] }
+     * len = 2: combined = { input[1], 0x02, input[0], input[1] }
+     * len = 3: combined = { input[2], 0x03, input[0], input[1] }
+     */
+    {   xxh_u8  const c1 = input[0];
+        xxh_u8  const c2 = input[len >> 1];
+        xxh_u8  const c3 = input[len - 1];
+        /* len is not a letter, so it can be folded along */
+        xxh_u32 const combined = (xxh_u32)XXH3_fold64(
+                                   ((xxh_u32)c1 << 16) | ((xxh_u32)c2  << 24)
+                                 | ((xxh_u32)c3 <<  0) | ((xxh_u32)len << 8), fold);
+        xxh_u64 const bitflip = (XXH_readLE32(secret) ^ XXH_readLE32(secret+4)) + seed;
+        xxh_u64 const keyed = (xxh_u64)combined ^ bitflip;
+        return XXH64_avalanche(keyed);
+    }
+}
+
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_4to8_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                  XXH3_fold fold)
+{
+    XXH_ASSERT(input != NULL);
+    XXH_ASSERT(secret != NULL);
+    XXH_ASSERT(4 <= len && len <= 8);
+    seed ^= (xxh_u64)XXH_swap32((xxh_u32)seed) << 32;
+    {   xxh_u32 const input1 = XXH3_readLE32_fold(input, fold);
+        xxh_u32 const input2 = XXH3_readLE32_fold(input + len - 4, fold);
+        xxh_u64 const bitflip = (XXH_readLE64(secret+8) ^ XXH_readLE64(secret+16)) - seed;
+        xxh_u64 const input64 = input2 + (((xxh_u64)input1) << 32);
+        xxh_u64 const keyed = input64 ^ bitflip;
+        return XXH3_rrmxmx(keyed, len);
+    }
+}
+
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_9to16_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                   XXH3_fold fold)
+{
+    XXH_ASSERT(input != NULL);
+    XXH_ASSERT(secret != NULL);
+    XXH_ASSERT(9 <= len && len <= 16);
+    {   xxh_u64 const bitflip1 = (XXH_readLE64(secret+24) ^ XXH_readLE64(secret+32)) + seed;
+        xxh_u64 const bitflip2 = (XXH_readLE64(secret+40) ^ XXH_readLE64(secret+48)) - seed;
+        xxh_u64 const input_lo = XXH3_readLE64_fold(input, fold)           ^ bitflip1;
+        xxh_u64 const input_hi = XXH3_readLE64_fold(input + len - 8, fold) ^ bitflip2;
+        xxh_u64 const acc = len
+                          + XXH_swap64(input_lo) + input_hi
+                          + XXH3_mul128_fold64(input_lo, input_hi);
+        return XXH3_avalanche(acc);
+    }
+}
+
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_0to16_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                   XXH3_fold fold)
+{
+    XXH_ASSERT(len <= 16);
+    {   if (XXH_likely(len >  8)) return XXH3_len_9to16_64b(input, len, secret, seed, fold);
+        if (XXH_likely(len >= 4)) return XXH3_len_4to8_64b(input, len, secret, seed, fold);
+        if (len) return XXH3_len_1to3_64b(input, len, secret, seed, fold);
+        return XXH64_avalanche(seed ^ (XXH_readLE64(secret+56) ^ XXH_readLE64(secret+64)));
+    }
+}
+
+/*
+ * DISCLAIMER: There are known *seed-dependent* multicollisions here due to
+ * multiplication by zero, affecting hashes of lengths 17 to 240.
+ *
+ * However, they are very unlikely.
+ *
+ * Keep this in mind when using the unseeded XXH3_64bits() variant: As with all
+ * unseeded non-cryptographic hashes, it does not attempt to defend itself
+ * against specially crafted inputs, only random inputs.
+ *
+ * Compared to classic UMAC where a 1 in 2^31 chance of 4 consecutive bytes
+ * cancelling out the secret is taken an arbitrary number of times (addressed
+ * in XXH3_accumulate_512), this collision is very unlikely with random inputs
+ * and/or proper seeding:
+ *
+ * This only has a 1 in 2^63 chance of 8 consecutive bytes cancelling out, in a
+ * function that is only called up to 16 times per hash with up to 240 bytes of
+ * input.
+ *
+ * This is not too bad for a non-cryptographic hash function, especially with
+ * only 64 bit outputs.
+ *
+ * The 128-bit variant (which trades some speed for strength) is NOT affected
+ * by this, although it is always a good idea to use a proper seed if you care
+ * about strength.
+ */
+XXH_FORCE_INLINE xxh_u64 XXH3_mix16B(const xxh_u8* XXH_RESTRICT input,
+                                     const xxh_u8* XXH_RESTRICT secret, xxh_u64 seed64,
+                                     XXH3_fold fold)
+{
+#if defined(__GNUC__) && !defined(__clang__) /* GCC, not Clang */ \
+  && defined(__i386__) && defined(__SSE2__)  /* x86 + SSE2 */ \
+  && !defined(XXH_ENABLE_AUTOVECTORIZE)      /* Define to disable like XXH32 hack */
+    /*
+     * UGLY HACK:
+     * GCC for x86 tends to autovectorize the 128-bit multiply, resulting in
+     * slower code.
+     *
+     * By forcing seed64 into a register, we disrupt the cost model and
+     * cause it to scalarize. See `XXH32_round()`
+     *
+     * FIXME: Clang's output is still _much_ faster -- On an AMD Ryzen 3600,
+     * XXH3_64bits @ len=240 runs at 4.6 GB/s with Clang 9, but 3.3 GB/s on
+     * GCC 9.2, despite both emitting scalar code.
+     *
+     * GCC generates much better scalar code than Clang for the rest of XXH3,
+     * which is why finding a more optimal codepath is an interest.
+     */
+    XXH_COMPILER_GUARD(seed64);
+#endif
+    {   xxh_u64 input_lo, input_hi;
+        XXH3_readLE128_fold(input, &input_lo, &input_hi, fold);
+        return XXH3_mul128_fold64(
+            input_lo ^ (XXH_readLE64(secret)   + seed64),
+            input_hi ^ (XXH_readLE64(secret+8) - seed64)
+        );
+    }
+}
+
+/*
+ * For mid range keys, XXH3 uses a Mum-hash variant.
+ *
+ * These paths are scalar for every XXH_VECTOR, and are not dispatched.
+ * XXH3_mix16B() is built around a full 64x64->128 multiply, which SSE2, AVX2
+ * and AVX512 lack: emulating it takes four 32x32 multiplies per lane, plus
+ * carries. An exact AVX2 version of XXH3_len_129to240_64b(), 4 lanes wide,
+ * was measured ~40% slower in latency and ~15% slower in throughput than
+ * this code, which issues one MUL per 16 bytes.
+ */
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_17to128_64b(const xxh_u8* XXH_RESTRICT input, size_t len,
+                     const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                     XXH64_hash_t seed, XXH3_fold fold)
+{
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
+    XXH_ASSERT(16 < len && len <= 128);
+
+    {   xxh_u64 acc = len * XXH_PRIME64_1;
+#if XXH_SIZE_OPT >= 1
+        /* Smaller and cleaner, but slightly slower. */
+        unsigned int i = (unsigned int)(len - 1) / 32;
+        do {
+            acc += XXH3_mix16B(input+16 * i, secret+32*i, seed, fold);
+            acc += XXH3_mix16B(input+len-16*(i+1), secret+32*i+16, seed, fold);
+        } while (i-- != 0);
+#else
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += XXH3_mix16B(input+48, secret+96, seed, fold);
+                    acc += XXH3_mix16B(input+len-64, secret+112, seed, fold);
+                }
+                acc += XXH3_mix16B(input+32, secret+64, seed, fold);
+                acc += XXH3_mix16B(input+len-48, secret+80, seed, fold);
+            }
+            acc += XXH3_mix16B(input+16, secret+32, seed, fold);
+            acc += XXH3_mix16B(input+len-32, secret+48, seed, fold);
+        }
+        acc += XXH3_mix16B(input+0, secret+0, seed, fold);
+        acc += XXH3_mix16B(input+len-16, secret+16, seed, fold);
+#endif
+        return XXH3_avalanche(acc);
+    }
+}
+
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_129to240_64b_internal(const xxh_u8* XXH_RESTRICT input, size_t len,
+                               const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                               XXH64_hash_t seed, XXH3_fold fold)
+{
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
+    XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
+
+    #define XXH3_MIDSIZE_STARTOFFSET 3
+    #define XXH3_MIDSIZE_LASTOFFSET  17
+
+    {   xxh_u64 acc = len * XXH_PRIME64_1;
+        xxh_u64 acc_end;
+        unsigned int const nbRounds = (unsigned int)len / 16;
+        unsigned int i;
+        XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
+        for (i=0; i<8; i++) {
+            acc += XXH3_mix16B(input+(16*i), secret+(16*i), seed, fold);
+        }
+        /* last bytes */
+        acc_end = XXH3_mix16B(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed, fold);
+        XXH_ASSERT(nbRounds >= 8);
+        acc = XXH3_avalanche(acc);
+#if defined(__clang__)                                /* Clang */ \
+    && (defined(__ARM_NEON) || defined(__ARM_NEON__)) /* NEON */ \
+    && !defined(XXH_ENABLE_AUTOVECTORIZE)             /* Define to disable */
+        /*
+         * UGLY HACK:
+         * Clang for ARMv7-A tries to vectorize this loop, similar to GCC x86.
+         * In everywhere else, it uses scalar code.
+         *
+         * For 64->128-bit multiplies, even if the NEON was 100% optimal, it
+         * would still be slower than UMAAL (see XXH_mult64to128).
+         *
+         * Unfortunately, Clang doesn't handle the long multiplies properly and
+         * converts them to the nonexistent "vmulq_u64" intrinsic, which is then
+         * scalarized into an ugly mess of VMOV.32 instructions.
+         *
+         * This mess is difficult to avoid without turning autovectorization
+         * off completely, but they are usually relatively minor and/or not
+         * worth it to fix.
+         *
+         * This loop is the easiest to fix, as unlike XXH32, this pragma
+         * _actually works_ because it is a loop vectorization instead of an
+         * SLP vectorization.
+         */
+        #pragma clang loop vectorize(disable)
+#endif
+        for (i=8 ; i < nbRounds; i++) {
+            /*
+             * Prevents clang for unrolling the acc loop and interleaving with this one.
+             */
+            XXH_COMPILER_GUARD(acc);
+            acc_end += XXH3_mix16B(input+(16*i), secret+(16*(i-8)) + XXH3_MIDSIZE_STARTOFFSET, seed, fold);
+        }
+        return XXH3_avalanche(acc + acc_end);
+    }
+}
+
+XXH_NO_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_129to240_64b(const xxh_u8* XXH_RESTRICT input, size_t len,
+                      const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                      XXH64_hash_t seed)
+{
+    return XXH3_len_129to240_64b_internal(input, len, secret, secretSize, seed, XXH3_asIs);
+}
+
+
+/* =======     Long Keys     ======= */
+
+#define XXH_STRIPE_LEN 64
+#define XXH_SECRET_CONSUME_RATE 8   /* nb of secret bytes consumed at each accumulation */
+#define XXH_ACC_NB (XXH_STRIPE_LEN / sizeof(xxh_u64))
+#define XXH_MIN(x, y) (((x) > (y)) ? (y) : (x))
+
+#ifdef XXH_OLD_NAMES
+#  define STRIPE_LEN XXH_STRIPE_LEN
+#  define ACC_NB XXH_ACC_NB
+#endif
+
+#ifndef XXH_PREFETCH_DIST
+#  ifdef __clang__
+#    define XXH_PREFETCH_DIST 320
+#  else
+#    if (XXH_VECTOR == XXH_AVX512)
+#      define XXH_PREFETCH_DIST 512
+#    else
+#      define XXH_PREFETCH_DIST 384
+#    endif
+#  endif  /* __clang__ */
+#endif  /* XXH_PREFETCH_DIST */
+
+/*
+ * These macros are to generate an XXH3_accumulate() function.
+ * The two arguments select the name suffix and target attribute.
+ *
+ * The name of this symbol is XXH3_accumulate_<name>() and it calls
+ * XXH3_accumulate_512_<name>().
+ * It prefetches @prefetchDist bytes ahead of the current stripe,
+ * usually XXH_PREFETCH_DIST.
+ *
+ * It may be useful to hand implement this function if the compiler fails to
+ * optimize the inline function.
+ */
+#define XXH3_ACCUMULATE_TEMPLATE(name)                      \
+void                                                        \
+XXH3_accumulate_##name(xxh_u64* XXH_RESTRICT acc,           \
+                       const xxh_u8* XXH_RESTRICT input,    \
+                       const xxh_u8* XXH_RESTRICT secret,   \
+                       size_t nbStripes,                    \
+                       size_t prefetchDist)                 \
+{                                                           \
+    size_t n;                                               \
+    for (n = 0; n < nbStripes; n++ ) {                      \
+        const xxh_u8* const in = input + n*XXH_STRIPE_LEN;  \
+        XXH_PREFETCH_INPUT(in + prefetchDist);              \
+        XXH3_accumulate_512_##name(                         \
+                 acc,                                       \
+                 in,                                        \
+                 secret + n*XXH_SECRET_CONSUME_RATE);       \
+    }                                                       \
+}
+
+
+/* Several intrinsic functions below are supposed to accept __int64 as argument,
+ * as documented in https://software.intel.com/sites/landingpage/IntrinsicsGuide/ .
+ * However, several environments do not define __int64 type,
+ * requiring a workaround.
+ */
+#if !defined (__VMS) \
+  && (defined (__cplusplus) \
+  || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */) )
+    typedef int64_t xxh_i64;
+#else
+    /* the following type must have a width of 64-bit */
+    typedef long long xxh_i64;
+#endif
+
+
+/*
+ * XXH3_accumulate_512 is the tightest loop for long inputs, and it is the most optimized.
+ *
+ * It is a hardened version of UMAC, based off of FARSH's implementation.
+ *
+ * This was chosen because it adapts quite well to 32-bit, 64-bit, and SIMD
+ * implementations, and it is ridiculously fast.
+ *
+ * We harden it by mixing the original input to the accumulators as well as the product.
+ *
+ * This means that in the (relatively likely) case of a multiply by zero, the
+ * original input is preserved.
+ *
+ * On 128-bit inputs, we swap 64-bit pairs when we add the input to improve
+ * cross-pollination, as otherwise the upper and lower halves would be
+ * essentially independent.
+ *
+ * This doesn't matter on 64-bit hashes since they all get merged together in
+ * the end, so we skip the extra step.
+ *
+ * Both XXH3_64bits and XXH3_128bits use this subroutine.
+ */
+
+#if (XXH_VECTOR == XXH_AVX512) \
+     || (defined(XXH_DISPATCH_AVX512) && XXH_DISPATCH_AVX512 != 0)
+
+#ifndef XXH_TARGET_AVX512
+# define XXH_TARGET_AVX512  /* disable attribute target */
+#endif
+
+XXH_FORCE_INLINE XXH_TARGET_AVX512 void
+XXH3_accumulate_512_avx512(void* XXH_RESTRICT acc,
+                     const void* XXH_RESTRICT input,
+                     const void* XXH_RESTRICT secret)
+{
+    __m512i* const xacc = (__m512i *) acc;
+    XXH_ASSERT((((size_t)acc) & 63) == 0);
+    XXH_STATIC_ASSERT(XXH_STRIPE_LEN == sizeof(__m512i));
+
+    {
+        /* data_vec    = input[0]; */
+        __m512i const data_vec    = _mm512_loadu_si512   (input);
+        /* key_vec     = secret[0]; */
+        __m512i const key_vec     = _mm512_loadu_si512   (secret);
+        /* data_key    = data_vec ^ key_vec; */
+        __m512i const data_key    = _mm512_xor_si512     (data_vec, key_vec);
+        /* data_key_lo = data_key >> 32; */
+        __m512i const data_key_lo = _mm512_srli_epi64 (data_key, 32);
+        /* product     = (data_key & 0xffffffff) * (data_key_lo & 0xffffffff); */
+        __m512i const product     = _mm512_mul_epu32     (data_key, data_key_lo);
+        /* xacc[0] += swap(data_vec); */
+        __m512i const data_swap = _mm512_shuffle_epi32(data_vec, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
+        __m512i const sum       = _mm512_add_epi64(*xacc, data_swap);
+        /* xacc[0] += product; */
+        *xacc = _mm512_add_epi64(product, sum);
+    }
+}
+XXH_FORCE_INLINE XXH_TARGET_AVX512 XXH3_ACCUMULATE_TEMPLATE(avx512)
+
+/*
+ * XXH3_scrambleAcc: Scrambles the accumulators to improve mixing.
+ *
+ * Multiplication isn't perfect, as explained by Google in HighwayHash:
+ *
+ *  // Multiplication mixes/scrambles bytes 0-7 of the 64-bit result to
+ *  // varying degrees. In descending order of goodness, bytes
+ *  // 3 4 2 5 1 6 0 7 have quality 228 224 164 160 100 96 36 32.
+ *  // As expected, the upper and lower bytes are much worse.
+ *
+ * Source: https://github.com/google/highwayhash/blob/0aaf66b/highwayhash/hh_avx2.h#L291
+ *
+ * Since our algorithm uses a pseudorandom secret to add some variance into the
+ * mix, we don't need to (or want to) mix as often or as much as HighwayHash does.
+ *
+ * This isn't as tight as XXH3_accumulate, but still written in SIMD to avoid
+ * extraction.
+ *
+ * Both XXH3_64bits and XXH3_128bits use this subroutine.
+ */
+
+XXH_FORCE_INLINE XXH_TARGET_AVX512 void
+XXH3_scrambleAcc_avx512(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 63) == 0);
+    XXH_STATIC_ASSERT(XXH_STRIPE_LEN == sizeof(__m512i));
+    {   __m512i* const xacc = (__m512i*) acc;
+        const __m512i prime32 = _mm512_set1_epi32((int)XXH_PRIME32_1);
+
+        /* xacc[0] ^= (xacc[0] >> 47) */
+        __m512i const acc_vec     = *xacc;
+        __m512i const shifted     = _mm512_srli_epi64    (acc_vec, 47);
+        /* xacc[0] ^= secret; */
+        __m512i const key_vec     = _mm512_loadu_si512   (secret);
+        __m512i const data_key    = _mm512_ternarylogic_epi32(key_vec, acc_vec, shifted, 0x96 /* key_vec ^ acc_vec ^ shifted */);
+
+        /* xacc[0] *= XXH_PRIME32_1; */
+        __m512i const data_key_hi = _mm512_srli_epi64 (data_key, 32);
+        __m512i const prod_lo     = _mm512_mul_epu32     (data_key, prime32);
+        __m512i const prod_hi     = _mm512_mul_epu32     (data_key_hi, prime32);
+        *xacc = _mm512_add_epi64(prod_lo, _mm512_slli_epi64(prod_hi, 32));
+    }
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX512 void
+XXH3_initCustomSecret_avx512(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+{
+    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 63) == 0);
+    XXH_STATIC_ASSERT(XXH_SEC_ALIGN == 64);
+    XXH_ASSERT(((size_t)customSecret & 63) == 0);
+    (void)(&XXH_writeLE64);
+    {   int const nbRounds = XXH_SECRET_DEFAULT_SIZE / sizeof(__m512i);
+        __m512i const seed_pos = _mm512_set1_epi64((xxh_i64)seed64);
+        __m512i const seed     = _mm512_mask_sub_epi64(seed_pos, 0xAA, _mm512_set1_epi8(0), seed_pos);
+
+        const __m512i* const src  = (const __m512i*) ((const void*) XXH3_kSecret);
+              __m512i* const dest = (      __m512i*) customSecret;
+        int i;
+        XXH_ASSERT(((size_t)src & 63) == 0); /* control alignment */
+        XXH_ASSERT(((size_t)dest & 63) == 0);
+        for (i=0; i < nbRounds; ++i) {
+            dest[i] = _mm512_add_epi64(_mm512_load_si512(src + i), seed);
+    }   }
+}
+
+/*
+ * Integer keys: vectorized XXH3_len_4to8_64b() for 4 and 8 byte inputs.
+ *
+ * The 64-bit multiplications by PRIME_MX2 are emulated with _mm512_mul_epu32,
+ * since _mm512_mullo_epi64 requires AVX512DQ.
+ */
+XXH_FORCE_INLINE XXH_TARGET_AVX512 __m512i
+XXH3_mulMX2_avx512(__m512i x)
+{
+    __m512i const mx2_lo = _mm512_set1_epi64((xxh_i64)(PRIME_MX2 & 0xFFFFFFFF));
+    __m512i const mx2_hi = _mm512_set1_epi64((xxh_i64)(PRIME_MX2 >> 32));
+    __m512i const lo_lo  = _mm512_mul_epu32(x, mx2_lo);
+    __m512i const hi_lo  = _mm512_mul_epu32(_mm512_srli_epi64(x, 32), mx2_lo);
+    __m512i const lo_hi  = _mm512_mul_epu32(x, mx2_hi);
+    return _mm512_add_epi64(lo_lo, _mm512_slli_epi64(_mm512_add_epi64(hi_lo, lo_hi), 32));
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX512 __m512i
+XXH3_rrmxmx_avx512(__m512i h64, __m512i len)
+{
+    /* h64 ^= XXH_rotl64(h64, 49) ^ XXH_rotl64(h64, 24); */
+    h64 = _mm512_ternarylogic_epi64(h64, _mm512_rol_epi64(h64, 49), _mm512_rol_epi64(h64, 24), 0x96);
+    h64 = XXH3_mulMX2_avx512(h64);
+    h64 = _mm512_xor_si512(h64, _mm512_add_epi64(_mm512_srli_epi64(h64, 35), len));
+    h64 = XXH3_mulMX2_avx512(h64);
+    return _mm512_xor_si512(h64, _mm512_srli_epi64(h64, 28));
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX512 void
+XXH3_hashU32Array_avx512(const xxh_u32* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
+{
+    __m512i const bitflip = _mm512_set1_epi64((xxh_i64)(XXH_readLE64(XXH3_kSecret+8) ^ XXH_readLE64(XXH3_kSecret+16)));
+    __m512i const len = _mm512_set1_epi64(4);
+    size_t n = 0;
+    for (; n + 8 <= nbKeys; n += 8) {
+        /* input64 = key + (key << 32) */
+        __m512i const key     = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(const void*)(keys + n)));
+        __m512i const input64 = _mm512_or_si512(key, _mm512_slli_epi64(key, 32));
+        _mm512_storeu_si512(out + n, XXH3_rrmxmx_avx512(_mm512_xor_si512(input64, bitflip), len));
+    }
+    for (; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX512 void
+XXH3_hashU64Array_avx512(const xxh_u64* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
+{
+    __m512i const bitflip = _mm512_set1_epi64((xxh_i64)(XXH_readLE64(XXH3_kSecret+8) ^ XXH_readLE64(XXH3_kSecret+16)));
+    __m512i const len = _mm512_set1_epi64(8);
+    size_t n = 0;
+    for (; n + 8 <= nbKeys; n += 8) {
+        /* input64 = XXH_rotl64(key, 32) */
+        __m512i const input64 = _mm512_rol_epi64(_mm512_loadu_si512(keys + n), 32);
+        _mm512_storeu_si512(out + n, XXH3_rrmxmx_avx512(_mm512_xor_si512(input64, bitflip), len));
+    }
+    for (; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
+}
+
+#endif
+
+#if (XXH_VECTOR == XXH_AVX2) \
+    || (defined(XXH_DISPATCH_AVX2) && XXH_DISPATCH_AVX2 != 0)
+
+#ifndef XXH_TARGET_AVX2
+# define XXH_TARGET_AVX2  /* disable attribute target */
+#endif
+
+XXH_FORCE_INLINE XXH_TARGET_AVX2 void
+XXH3_accumulate_512_avx2( void* XXH_RESTRICT acc,
+                    const void* XXH_RESTRICT input,
+                    const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 31) == 0);
+    {   __m256i* const xacc    =       (__m256i *) acc;
+        /* Unaligned. This is mainly for pointer arithmetic, and because
+         * _mm256_loadu_si256 requires  a const __m256i * pointer for some reason. */
+        const         __m256i* const xinput  = (const __m256i *) input;
+        /* Unaligned. This is mainly for pointer arithmetic, and because
+         * _mm256_loadu_si256 requires a const __m256i * pointer for some reason. */
+        const         __m256i* const xsecret = (const __m256i *) secret;
+
+        size_t i;
+        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m256i); i++) {
+            /* data_vec    = xinput[i]; */
+            __m256i const data_vec    = _mm256_loadu_si256    (xinput+i);
+            /* key_vec     = xsecret[i]; */
+            __m256i const key_vec     = _mm256_loadu_si256   (xsecret+i);
+            /* data_key    = data_vec ^ key_vec; */
+            __m256i const data_key    = _mm256_xor_si256     (data_vec, key_vec);
+            /* data_key_lo = data_key >> 32; */
+            __m256i const data_key_lo = _mm256_srli_epi64 (data_key, 32);
+            /* product     = (data_key & 0xffffffff) * (data_key_lo & 0xffffffff); */
+            __m256i const product     = _mm256_mul_epu32     (data_key, data_key_lo);
+            /* xacc[i] += swap(data_vec); */
+            __m256i const data_swap = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+            __m256i const sum       = _mm256_add_epi64(xacc[i], data_swap);
+            /* xacc[i] += product; */
+            xacc[i] = _mm256_add_epi64(product, sum);
+    }   }
+}
+XXH_FORCE_INLINE XXH_TARGET_AVX2 XXH3_ACCUMULATE_TEMPLATE(avx2)
+
+XXH_FORCE_INLINE XXH_TARGET_AVX2 void
+XXH3_scrambleAcc_avx2(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 31) == 0);
+    {   __m256i* const xacc = (__m256i*) acc;
+        /* Unaligned. This is mainly for pointer arithmetic, and because
+         * _mm256_loadu_si256 requires a const __m256i * pointer for some reason. */
+        const         __m256i* const xsecret = (const __m256i *) secret;
+        const __m256i prime32 = _mm256_set1_epi32((int)XXH_PRIME32_1);
+
+        size_t i;
+        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m256i); i++) {
+            /* xacc[i] ^= (xacc[i] >> 47) */
+            __m256i const acc_vec     = xacc[i];
+            __m256i const shifted     = _mm256_srli_epi64    (acc_vec, 47);
+            __m256i const data_vec    = _mm256_xor_si256     (acc_vec, shifted);
+            /* xacc[i] ^= xsecret; */
+            __m256i const key_vec     = _mm256_loadu_si256   (xsecret+i);
+            __m256i const data_key    = _mm256_xor_si256     (data_vec, key_vec);
+
+            /* xacc[i] *= XXH_PRIME32_1; */
+            __m256i const data_key_hi = _mm256_srli_epi64 (data_key, 32);
+            __m256i const prod_lo     = _mm256_mul_epu32     (data_key, prime32);
+            __m256i const prod_hi     = _mm256_mul_epu32     (data_key_hi, prime32);
+            xacc[i] = _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32));
+        }
+    }
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX2 void XXH3_initCustomSecret_avx2(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+{
+    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 31) == 0);
+    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE / sizeof(__m256i)) == 6);
+    XXH_STATIC_ASSERT(XXH_SEC_ALIGN <= 64);
+    (void)(&XXH_writeLE64);
+    XXH_PREFETCH(customSecret);
+    {   __m256i const seed = _mm256_set_epi64x((xxh_i64)(0U - seed64), (xxh_i64)seed64, (xxh_i64)(0U - seed64), (xxh_i64)seed64);
+
+        const __m256i* const src  = (const __m256i*) ((const void*) XXH3_kSecret);
+              __m256i*       dest = (      __m256i*) customSecret;
+
+#       if defined(__GNUC__) || defined(__clang__)
+        /*
+         * On GCC & Clang, marking 'dest' as modified will cause the compiler:
+         *   - do not extract the secret from sse registers in the internal loop
+         *   - use less common registers, and avoid pushing these reg into stack
+         */
+        XXH_COMPILER_GUARD(dest);
+#       endif
+        XXH_ASSERT(((size_t)src & 31) == 0); /* control alignment */
+        XXH_ASSERT(((size_t)dest & 31) == 0);
+
+        /* GCC -O2 need unroll loop manually */
+        dest[0] = _mm256_add_epi64(_mm256_load_si256(src+0), seed);
+        dest[1] = _mm256_add_epi64(_mm256_load_si256(src+1), seed);
+        dest[2] = _mm256_add_epi64(_mm256_load_si256(src+2), seed);
+        dest[3] = _mm256_add_epi64(_mm256_load_si256(src+3), seed);
+        dest[4] = _mm256_add_epi64(_mm256_load_si256(src+4), seed);
+        dest[5] = _mm256_add_epi64(_mm256_load_si256(src+5), seed);
+    }
+}
+
+/*
+ * Integer keys: vectorized XXH3_len_4to8_64b() for 4 and 8 byte inputs.
+ *
+ * AVX2 has no 64-bit multiplication, nor 64-bit rotation:
+ * both are emulated with 32-bit multiplications and shifts.
+ */
+XXH_FORCE_INLINE XXH_TARGET_AVX2 __m256i
+XXH3_mulMX2_avx2(__m256i x)
+{
+    __m256i const mx2_lo = _mm256_set1_epi64x((xxh_i64)(PRIME_MX2 & 0xFFFFFFFF));
+    __m256i const mx2_hi = _mm256_set1_epi64x((xxh_i64)(PRIME_MX2 >> 32));
+    __m256i const lo_lo  = _mm256_mul_epu32(x, mx2_lo);
+    __m256i const hi_lo  = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), mx2_lo);
+    __m256i const lo_hi  = _mm256_mul_epu32(x, mx2_hi);
+    return _mm256_add_epi64(lo_lo, _mm256_slli_epi64(_mm256_add_epi64(hi_lo, lo_hi), 32));
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX2 __m256i
+XXH3_rrmxmx_avx2(__m256i h64, __m256i len)
+{
+    /* h64 ^= XXH_rotl64(h64, 49) ^ XXH_rotl64(h64, 24); */
+    __m256i const rot49 = _mm256_or_si256(_mm256_slli_epi64(h64, 49), _mm256_srli_epi64(h64, 15));
+    __m256i const rot24 = _mm256_or_si256(_mm256_slli_epi64(h64, 24), _mm256_srli_epi64(h64, 40));
+    h64 = _mm256_xor_si256(h64, _mm256_xor_si256(rot49, rot24));
+    h64 = XXH3_mulMX2_avx2(h64);
+    h64 = _mm256_xor_si256(h64, _mm256_add_epi64(_mm256_srli_epi64(h64, 35), len));
+    h64 = XXH3_mulMX2_avx2(h64);
+    return _mm256_xor_si256(h64, _mm256_srli_epi64(h64, 28));
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX2 void
+XXH3_hashU32Array_avx2(const xxh_u32* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
+{
+    __m256i const bitflip = _mm256_set1_epi64x((xxh_i64)(XXH_readLE64(XXH3_kSecret+8) ^ XXH_readLE64(XXH3_kSecret+16)));
+    __m256i const len = _mm256_set1_epi64x(4);
+    size_t n = 0;
+    for (; n + 4 <= nbKeys; n += 4) {
+        /* input64 = key + (key << 32) */
+        __m256i const key     = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(const void*)(keys + n)));
+        __m256i const input64 = _mm256_or_si256(key, _mm256_slli_epi64(key, 32));
+        _mm256_storeu_si256((__m256i*)(void*)(out + n), XXH3_rrmxmx_avx2(_mm256_xor_si256(input64, bitflip), len));
+    }
+    for (; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
+}
+
+XXH_FORCE_INLINE XXH_TARGET_AVX2 void
+XXH3_hashU64Array_avx2(const xxh_u64* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
+{
+    __m256i const bitflip = _mm256_set1_epi64x((xxh_i64)(XXH_readLE64(XXH3_kSecret+8) ^ XXH_readLE64(XXH3_kSecret+16)));
+    __m256i const len = _mm256_set1_epi64x(8);
+    size_t n = 0;
+    for (; n + 4 <= nbKeys; n += 4) {
+        /* input64 = XXH_rotl64(key, 32) */
+        __m256i const input64 = _mm256_shuffle_epi32(_mm256_loadu_si256((const __m256i*)(const void*)(keys + n)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm256_storeu_si256((__m256i*)(void*)(out + n), XXH3_rrmxmx_avx2(_mm256_xor_si256(input64, bitflip), len));
+    }
+    for (; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
+}
+
+#endif
+
+/* x86dispatch always generates SSE2 */
+#if (XXH_VECTOR == XXH_SSE2) || defined(XXH_X86DISPATCH)
+
+#ifndef XXH_TARGET_SSE2
+# define XXH_TARGET_SSE2  /* disable attribute target */
+#endif
+
+XXH_FORCE_INLINE XXH_TARGET_SSE2 void
+XXH3_accumulate_512_sse2( void* XXH_RESTRICT acc,
+                    const void* XXH_RESTRICT input,
+                    const void* XXH_RESTRICT secret)
+{
+    /* SSE2 is just a half-scale version of the AVX2 version. */
+    XXH_ASSERT((((size_t)acc) & 15) == 0);
+    {   __m128i* const xacc    =       (__m128i *) acc;
+        /* Unaligned. This is mainly for pointer arithmetic, and because
+         * _mm_loadu_si128 requires a const __m128i * pointer for some reason. */
+        const         __m128i* const xinput  = (const __m128i *) input;
+        /* Unaligned. This is mainly for pointer arithmetic, and because
+         * _mm_loadu_si128 requires a const __m128i * pointer for some reason. */
+        const         __m128i* const xsecret = (const __m128i *) secret;
+
+        size_t i;
+        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m128i); i++) {
+            /* data_vec    = xinput[i]; */
+            __m128i const data_vec    = _mm_loadu_si128   (xinput+i);
+            /* key_vec     = xsecret[i]; */
+            __m128i const key_vec     = _mm_loadu_si128   (xsecret+i);
+            /* data_key    = data_vec ^ key_vec; */
+            __m128i const data_key    = _mm_xor_si128     (data_vec, key_vec);
+            /* data_key_lo = data_key >> 32; */
+            __m128i const data_key_lo = _mm_shuffle_epi32 (data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            /* product     = (data_key & 0xffffffff) * (data_key_lo & 0xffffffff); */
+            __m128i const product     = _mm_mul_epu32     (data_key, data_key_lo);
+            /* xacc[i] += swap(data_vec); */
+            __m128i const data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1,0,3,2));
+            __m128i const sum       = _mm_add_epi64(xacc[i], data_swap);
+            /* xacc[i] += product; */
+            xacc[i] = _mm_add_epi64(product, sum);
+    }   }
+}
+XXH_FORCE_INLINE XXH_TARGET_SSE2 XXH3_ACCUMULATE_TEMPLATE(sse2)
+
+XXH_FORCE_INLINE XXH_TARGET_SSE2 void
+XXH3_scrambleAcc_sse2(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 15) == 0);
+    {   __m128i* const xacc = (__m128i*) acc;
+        /* Unaligned. This is mainly for pointer arithmetic, and because
+         * _mm_loadu_si128 requires a const __m128i * pointer for some reason. */
+        const         __m128i* const xsecret = (const __m128i *) secret;
+        const __m128i prime32 = _mm_set1_epi32((int)XXH_PRIME32_1);
+
+        size_t i;
+        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m128i); i++) {
+            /* xacc[i] ^= (xacc[i] >> 47) */
+            __m128i const acc_vec     = xacc[i];
+            __m128i const shifted     = _mm_srli_epi64    (acc_vec, 47);
+            __m128i const data_vec    = _mm_xor_si128     (acc_vec, shifted);
+            /* xacc[i] ^= xsecret[i]; */
+            __m128i const key_vec     = _mm_loadu_si128   (xsecret+i);
+            __m128i const data_key    = _mm_xor_si128     (data_vec, key_vec);
+
+            /* xacc[i] *= XXH_PRIME32_1; */
+            __m128i const data_key_hi = _mm_shuffle_epi32 (data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i const prod_lo     = _mm_mul_epu32     (data_key, prime32);
+            __m128i const prod_hi     = _mm_mul_epu32     (data_key_hi, prime32);
+            xacc[i] = _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32));
+        }
+    }
+}
+
+XXH_FORCE_INLINE XXH_TARGET_SSE2 void XXH3_initCustomSecret_sse2(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+{
+    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 15) == 0);
+    (void)(&XXH_writeLE64);
+    {   int const nbRounds = XXH_SECRET_DEFAULT_SIZE / sizeof(__m128i);
+
+#       if defined(_MSC_VER) && defined(_M_IX86) && _MSC_VER < 1900
+        /* MSVC 32bit mode does not support _mm_set_epi64x before 2015 */
+        XXH_ALIGN(16) const xxh_i64 seed64x2[2] = { (xxh_i64)seed64, (xxh_i64)(0U - seed64) };
+        __m128i const seed = _mm_load_si128((__m128i const*)seed64x2);
+#       else
+        __m128i const seed = _mm_set_epi64x((xxh_i64)(0U - seed64), (xxh_i64)seed64);
+#       endif
+        int i;
+
+        const void* const src16 = XXH3_kSecret;
+        __m128i* dst16 = (__m128i*) customSecret;
+#       if defined(__GNUC__) || defined(__clang__)
+        /*
+         * On GCC & Clang, marking 'dest' as modified will cause the compiler:
+         *   - do not extract the secret from sse registers in the internal loop
+         *   - use less common registers, and avoid pushing these reg into stack
+         */
+        XXH_COMPILER_GUARD(dst16);
+#       endif
+        XXH_ASSERT(((size_t)src16 & 15) == 0); /* control alignment */
+        XXH_ASSERT(((size_t)dst16 & 15) == 0);
+
+        for (i=0; i < nbRounds; ++i) {
+            dst16[i] = _mm_add_epi64(_mm_load_si128((const __m128i *)src16+i), seed);
+    }   }
+}
+
+/*
+ * Integer keys: vectorized XXH3_len_4to8_64b() for 8 byte inputs.
+ * See XXH3_hashU64Array_avx2() for details.
+ * There is no SSE2 variant for 4 byte inputs:
+ * with only 2 lanes, it is slower than the scalar code.
+ */
+XXH_FORCE_INLINE XXH_TARGET_SSE2 __m128i
+XXH3_mulMX2_sse2(__m128i x)
+{
+    __m128i const mx2_lo = _mm_set_epi32(0, (int)(PRIME_MX2 & 0xFFFFFFFF), 0, (int)(PRIME_MX2 & 0xFFFFFFFF));
+    __m128i const mx2_hi = _mm_set_epi32(0, (int)(PRIME_MX2 >> 32), 0, (int)(PRIME_MX2 >> 32));
+    __m128i const lo_lo  = _mm_mul_epu32(x, mx2_lo);
+    __m128i const hi_lo  = _mm_mul_epu32(_mm_srli_epi64(x, 32), mx2_lo);
+    __m128i const lo_hi  = _mm_mul_epu32(x, mx2_hi);
+    return _mm_add_epi64(lo_lo, _mm_slli_epi64(_mm_add_epi64(hi_lo, lo_hi), 32));
+}
+
+XXH_FORCE_INLINE XXH_TARGET_SSE2 __m128i
+XXH3_rrmxmx_sse2(__m128i h64, __m128i len)
+{
+    /* h64 ^= XXH_rotl64(h64, 49) ^ XXH_rotl64(h64, 24); */
+    __m128i const rot49 = _mm_or_si128(_mm_slli_epi64(h64, 49), _mm_srli_epi64(h64, 15));
+    __m128i const rot24 = _mm_or_si128(_mm_slli_epi64(h64, 24), _mm_srli_epi64(h64, 40));
+    h64 = _mm_xor_si128(h64, _mm_xor_si128(rot49, rot24));
+    h64 = XXH3_mulMX2_sse2(h64);
+    h64 = _mm_xor_si128(h64, _mm_add_epi64(_mm_srli_epi64(h64, 35), len));
+    h64 = XXH3_mulMX2_sse2(h64);
+    return _mm_xor_si128(h64, _mm_srli_epi64(h64, 28));
+}
+
+XXH_FORCE_INLINE XXH_TARGET_SSE2 void
+XXH3_hashU64Array_sse2(const xxh_u64* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
+{
+    xxh_u64 const bitflip64 = XXH_readLE64(XXH3_kSecret+8) ^ XXH_readLE64(XXH3_kSecret+16);
+    __m128i const bitflip = _mm_set_epi32((int)(bitflip64 >> 32), (int)bitflip64, (int)(bitflip64 >> 32), (int)bitflip64);
+    __m128i const len = _mm_set_epi32(0, 8, 0, 8);
+    size_t n = 0;
+    for (; n + 2 <= nbKeys; n += 2) {
+        /* input64 = XXH_rotl64(key, 32) */
+        __m128i const input64 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(const void*)(keys + n)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i*)(void*)(out + n), XXH3_rrmxmx_sse2(_mm_xor_si128(input64, bitflip), len));
+    }
+    for (; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
+}
+
+#endif
+
+#if (XXH_VECTOR == XXH_NEON)
+
+/* forward declarations for the scalar routines */
+XXH_FORCE_INLINE void
+XXH3_scalarRound(void* XXH_RESTRICT acc, void const* XXH_RESTRICT input,
+                 void const* XXH_RESTRICT secret, size_t lane);
+
+XXH_FORCE_INLINE void
+XXH3_scalarScrambleRound(void* XXH_RESTRICT acc,
+                         void const* XXH_RESTRICT secret, size_t lane);
+
+/*!
+ * @internal
+ * @brief The bulk processing loop for NEON and WASM SIMD128.
+ *
+ * The NEON code path is actually partially scalar when running on AArch64. This
+ * is to optimize the pipelining and can have up to 15% speedup depending on the
+ * CPU, and it also mitigates some GCC codegen issues.
+ *
+ * @see XXH3_NEON_LANES for configuring this and details about this optimization.
+ *
+ * NEON's 32-bit to 64-bit long multiply takes a half vector of 32-bit
+ * integers instead of the other platforms which mask full 64-bit vectors,
+ * so the setup is more complicated than just shifting right.
+ *
+ * Additionally, there is an optimization for 4 lanes at once noted below.
+ *
+ * Since, as stated, the most optimal amount of lanes for Cortexes is 6,
+ * there needs to be *three* versions of the accumulate operation used
+ * for the remaining 2 lanes.
+ *
+ * WASM's SIMD128 uses SIMDe's arm_neon.h polyfill because the intrinsics overlap
+ * nearly perfectly.
+ */
+
+XXH_FORCE_INLINE void
+XXH3_accumulate_512_neon( void* XXH_RESTRICT acc,
+                    const void* XXH_RESTRICT input,
+                    const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 15) == 0);
+    XXH_STATIC_ASSERT(XXH3_NEON_LANES > 0 && XXH3_NEON_LANES <= XXH_ACC_NB && XXH3_NEON_LANES % 2 == 0);
+    {   /* GCC for darwin arm64 does not like aliasing here */
+        xxh_aliasing_uint64x2_t* const xacc = (xxh_aliasing_uint64x2_t*) acc;
+        /* We don't use a uint32x4_t pointer because it causes bus errors on ARMv7. */
+        uint8_t const* xinput = (const uint8_t *) input;
+        uint8_t const* xsecret  = (const uint8_t *) secret;
+
+        size_t i;
+#ifdef __wasm_simd128__
+        /*
+         * On WASM SIMD128, Clang emits direct address loads when XXH3_kSecret
+         * is constant propagated, which results in it converting it to this
+         * inside the loop:
+         *
+         *    a = v128.load(XXH3_kSecret +  0 + $secret_offset, offset = 0)
+         *    b = v128.load(XXH3_kSecret + 16 + $secret_offset, offset = 0)
+         *    ...
+         *
+         * This requires a full 32-bit address immediate (and therefore a 6 byte
+         * instruction) as well as an add for each offset.
+         *
+         * Putting an asm guard prevents it from folding (at the cost of losing
+         * the alignment hint), and uses the free offset in `v128.load` instead
+         * of adding secret_offset each time which overall reduces code size by
+         * about a kilobyte and improves performance.
+         */
+        XXH_COMPILER_GUARD(xsecret);
+#endif
+        /* Scalar lanes use the normal scalarRound routine */
+        for (i = XXH3_NEON_LANES; i < XXH_ACC_NB; i++) {
+            XXH3_scalarRound(acc, input, secret, i);
+        }
+        i = 0;
+        /* 4 NEON lanes at a time. */
+        for (; i+1 < XXH3_NEON_LANES / 2; i+=2) {
+            /* data_vec = xinput[i]; */
+            uint64x2_t data_vec_1 = XXH_vld1q_u64(xinput  + (i * 16));
+            uint64x2_t data_vec_2 = XXH_vld1q_u64(xinput  + ((i+1) * 16));
+            /* key_vec  = xsecret[i];  */
+            uint64x2_t key_vec_1  = XXH_vld1q_u64(xsecret + (i * 16));
+            uint64x2_t key_vec_2  = XXH_vld1q_u64(xsecret + ((i+1) * 16));
+            /* data_swap = swap(data_vec) */
+            uint64x2_t data_swap_1 = vextq_u64(data_vec_1, data_vec_1, 1);
+            uint64x2_t data_swap_2 = vextq_u64(data_vec_2, data_vec_2, 1);
+            /* data_key = data_vec ^ key_vec; */
+            uint64x2_t data_key_1 = veorq_u64(data_vec_1, key_vec_1);
+            uint64x2_t data_key_2 = veorq_u64(data_vec_2, key_vec_2);
+
+            /*
+             * If we reinterpret the 64x2 vectors as 32x4 vectors, we can use a
+             * de-interleave operation for 4 lanes in 1 step with `vuzpq_u32` to
+             * get one vector with the low 32 bits of each lane, and one vector
+             * with the high 32 bits of each lane.
+             *
+             * The intrinsic returns a double vector because the original ARMv7-a
+             * instruction modified both arguments in place. AArch64 and SIMD128 emit
+             * two instructions from this intrinsic.
+             *
+             *  [ dk11L | dk11H | dk12L | dk12H ] -> [ dk11L | dk12L | dk21L | dk22L ]
+             *  [ dk21L | dk21H | dk22L | dk22H ] -> [ dk11H | dk12H | dk21H | dk22H ]
+             */
+            uint32x4x2_t unzipped = vuzpq_u32(
+                vreinterpretq_u32_u64(data_key_1),
+                vreinterpretq_u32_u64(data_key_2)
+            );
+            /* data_key_lo = data_key & 0xFFFFFFFF */
+            uint32x4_t data_key_lo = unzipped.val[0];
+            /* data_key_hi = data_key >> 32 */
+            uint32x4_t data_key_hi = unzipped.val[1];
+            /*
+             * Then, we can split the vectors horizontally and multiply which, as for most
+             * widening intrinsics, have a variant that works on both high half vectors
+             * for free on AArch64. A similar instruction is available on SIMD128.
+             *
+             * sum = data_swap + (u64x2) data_key_lo * (u64x2) data_key_hi
+             */
+            uint64x2_t sum_1 = XXH_vmlal_low_u32(data_swap_1, data_key_lo, data_key_hi);
+            uint64x2_t sum_2 = XXH_vmlal_high_u32(data_swap_2, data_key_lo, data_key_hi);
+            /*
+             * Clang reorders
+             *    a += b * c;     // umlal   swap.2d, dkl.2s, dkh.2s
+             *    c += a;         // add     acc.2d, acc.2d, swap.2d
+             * to
+             *    c += a;         // add     acc.2d, acc.2d, swap.2d
+             *    c += b * c;     // umlal   acc.2d, dkl.2s, dkh.2s
+             *
+             * While it would make sense in theory since the addition is faster,
+             * for reasons likely related to umlal being limited to certain NEON
+             * pipelines, this is worse. A compiler guard fixes this.
+             */
+            XXH_COMPILER_GUARD_CLANG_NEON(sum_1);
+            XXH_COMPILER_GUARD_CLANG_NEON(sum_2);
+            /* xacc[i] = acc_vec + sum; */
+            xacc[i]   = vaddq_u64(xacc[i], sum_1);
+            xacc[i+1] = vaddq_u64(xacc[i+1], sum_2);
+        }
+        /* Operate on the remaining NEON lanes 2 at a time. */
+        for (; i < XXH3_NEON_LANES / 2; i++) {
+            /* data_vec = xinput[i]; */
+            uint64x2_t data_vec = XXH_vld1q_u64(xinput  + (i * 16));
+            /* key_vec  = xsecret[i];  */
+            uint64x2_t key_vec  = XXH_vld1q_u64(xsecret + (i * 16));
+            /* acc_vec_2 = swap(data_vec) */
+            uint64x2_t data_swap = vextq_u64(data_vec, data_vec, 1);
+            /* data_key = data_vec ^ key_vec; */
+            uint64x2_t data_key = veorq_u64(data_vec, key_vec);
+            /* For two lanes, just use VMOVN and VSHRN. */
+            /* data_key_lo = data_key & 0xFFFFFFFF; */
+            uint32x2_t data_key_lo = vmovn_u64(data_key);
+            /* data_key_hi = data_key >> 32; */
+            uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
+            /* sum = data_swap + (u64x2) data_key_lo * (u64x2) data_key_hi; */
+            uint64x2_t sum = vmlal_u32(data_swap, data_key_lo, data_key_hi);
+            /* Same Clang workaround as before */
+            XXH_COMPILER_GUARD_CLANG_NEON(sum);
+            /* xacc[i] = acc_vec + sum; */
+            xacc[i] = vaddq_u64 (xacc[i], sum);
+        }
+    }
+}
+XXH_FORCE_INLINE XXH3_ACCUMULATE_TEMPLATE(neon)
+
+XXH_FORCE_INLINE void
+XXH3_scrambleAcc_neon(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 15) == 0);
+
+    {   xxh_aliasing_uint64x2_t* xacc       = (xxh_aliasing_uint64x2_t*) acc;
+        uint8_t const* xsecret = (uint8_t const*) secret;
+
+        size_t i;
+        /* WASM uses operator overloads and doesn't need these. */
+#ifndef __wasm_simd128__
+        /* { prime32_1, prime32_1 } */
+        uint32x2_t const kPrimeLo = vdup_n_u32(XXH_PRIME32_1);
+        /* { 0, prime32_1, 0, prime32_1 } */
+        uint32x4_t const kPrimeHi = vreinterpretq_u32_u64(vdupq_n_u64((xxh_u64)XXH_PRIME32_1 << 32));
 #endif
 
-/* __ARM_FEATURE_SVE is only supported by GCC & Clang. */
-#if (XXH_VECTOR == XXH_SVE) && !defined(__ARM_FEATURE_SVE)
-#  ifdef _MSC_VER
-#    pragma warning(once : 4606)
-#  else
-#    warning "__ARM_FEATURE_SVE isn't supported. Use SCALAR instead."
-#  endif
-#  undef XXH_VECTOR
-#  define XXH_VECTOR XXH_SCALAR
+        /* AArch64 uses both scalar and neon at the same time */
+        for (i = XXH3_NEON_LANES; i < XXH_ACC_NB; i++) {
+            XXH3_scalarScrambleRound(acc, secret, i);
+        }
+        for (i=0; i < XXH3_NEON_LANES / 2; i++) {
+            /* xacc[i] ^= (xacc[i] >> 47); */
+            uint64x2_t acc_vec  = xacc[i];
+            uint64x2_t shifted  = vshrq_n_u64(acc_vec, 47);
+            uint64x2_t data_vec = veorq_u64(acc_vec, shifted);
+
+            /* xacc[i] ^= xsecret[i]; */
+            uint64x2_t key_vec  = XXH_vld1q_u64(xsecret + (i * 16));
+            uint64x2_t data_key = veorq_u64(data_vec, key_vec);
+            /* xacc[i] *= XXH_PRIME32_1 */
+#ifdef __wasm_simd128__
+            /* SIMD128 has multiply by u64x2, use it instead of expanding and scalarizing */
+            xacc[i] = data_key * XXH_PRIME32_1;
+#else
+            /*
+             * Expanded version with portable NEON intrinsics
+             *
+             *    lo(x) * lo(y) + (hi(x) * lo(y) << 32)
+             *
+             * prod_hi = hi(data_key) * lo(prime) << 32
+             *
+             * Since we only need 32 bits of this multiply a trick can be used, reinterpreting the vector
+             * as a uint32x4_t and multiplying by { 0, prime, 0, prime } to cancel out the unwanted bits
+             * and avoid the shift.
+             */
+            uint32x4_t prod_hi = vmulq_u32 (vreinterpretq_u32_u64(data_key), kPrimeHi);
+            /* Extract low bits for vmlal_u32  */
+            uint32x2_t data_key_lo = vmovn_u64(data_key);
+            /* xacc[i] = prod_hi + lo(data_key) * XXH_PRIME32_1; */
+            xacc[i] = vmlal_u32(vreinterpretq_u64_u32(prod_hi), data_key_lo, kPrimeLo);
+#endif
+        }
+    }
+}
 #endif
 
-/*
- * Controls the alignment of the accumulator,
- * for compatibility with aligned vector loads, which are usually faster.
- */
-#ifndef XXH_ACC_ALIGN
-#  if defined(XXH_X86DISPATCH)
-#     define XXH_ACC_ALIGN 64  /* for compatibility with avx512 */
-#  elif XXH_VECTOR == XXH_SCALAR  /* scalar */
-#     define XXH_ACC_ALIGN 8
-#  elif XXH_VECTOR == XXH_SSE2  /* sse2 */
-#     define XXH_ACC_ALIGN 16
-#  elif XXH_VECTOR == XXH_AVX2  /* avx2 */
-#     define XXH_ACC_ALIGN 32
-#  elif XXH_VECTOR == XXH_NEON  /* neon */
-#     define XXH_ACC_ALIGN 16
-#  elif XXH_VECTOR == XXH_VSX   /* vsx */
-#     define XXH_ACC_ALIGN 16
-#  elif XXH_VECTOR == XXH_AVX512  /* avx512 */
-#     define XXH_ACC_ALIGN 64
-#  elif XXH_VECTOR == XXH_SVE   /* sve */
-#     define XXH_ACC_ALIGN 64
-#  endif
+#if (XXH_VECTOR == XXH_VSX)
+
+XXH_FORCE_INLINE void
+XXH3_accumulate_512_vsx(  void* XXH_RESTRICT acc,
+                    const void* XXH_RESTRICT input,
+                    const void* XXH_RESTRICT secret)
+{
+    /* presumed aligned */
+    xxh_aliasing_u64x2* const xacc = (xxh_aliasing_u64x2*) acc;
+    xxh_u8 const* const xinput   = (xxh_u8 const*) input;   /* no alignment restriction */
+    xxh_u8 const* const xsecret  = (xxh_u8 const*) secret;    /* no alignment restriction */
+    xxh_u64x2 const v32 = { 32, 32 };
+    size_t i;
+    for (i = 0; i < XXH_STRIPE_LEN / sizeof(xxh_u64x2); i++) {
+        /* data_vec = xinput[i]; */
+        xxh_u64x2 const data_vec = XXH_vec_loadu(xinput + 16*i);
+        /* key_vec = xsecret[i]; */
+        xxh_u64x2 const key_vec  = XXH_vec_loadu(xsecret + 16*i);
+        xxh_u64x2 const data_key = data_vec ^ key_vec;
+        /* shuffled = (data_key << 32) | (data_key >> 32); */
+        xxh_u32x4 const shuffled = (xxh_u32x4)vec_rl(data_key, v32);
+        /* product = ((xxh_u64x2)data_key & 0xFFFFFFFF) * ((xxh_u64x2)shuffled & 0xFFFFFFFF); */
+        xxh_u64x2 const product  = XXH_vec_mulo((xxh_u32x4)data_key, shuffled);
+        /* acc_vec = xacc[i]; */
+        xxh_u64x2 acc_vec        = xacc[i];
+        acc_vec += product;
+
+        /* swap high and low halves */
+#ifdef __s390x__
+        acc_vec += vec_permi(data_vec, data_vec, 2);
+#else
+        acc_vec += vec_xxpermdi(data_vec, data_vec, 2);
+#endif
+        xacc[i] = acc_vec;
+    }
+}
+XXH_FORCE_INLINE XXH3_ACCUMULATE_TEMPLATE(vsx)
+
+XXH_FORCE_INLINE void
+XXH3_scrambleAcc_vsx(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+{
+    XXH_ASSERT((((size_t)acc) & 15) == 0);
+
+    {   xxh_aliasing_u64x2* const xacc = (xxh_aliasing_u64x2*) acc;
+        const xxh_u8* const xsecret = (const xxh_u8*) secret;
+        /* constants */
+        xxh_u64x2 const v32  = { 32, 32 };
+        xxh_u64x2 const v47 = { 47, 47 };
+        xxh_u32x4 const prime = { XXH_PRIME32_1, XXH_PRIME32_1, XXH_PRIME32_1, XXH_PRIME32_1 };
+        size_t i;
+        for (i = 0; i < XXH_STRIPE_LEN / sizeof(xxh_u64x2); i++) {
+            /* xacc[i] ^= (xacc[i] >> 47); */
+            xxh_u64x2 const acc_vec  = xacc[i];
+            xxh_u64x2 const data_vec = acc_vec ^ (acc_vec >> v47);
+
+            /* xacc[i] ^= xsecret[i]; */
+            xxh_u64x2 const key_vec  = XXH_vec_loadu(xsecret + 16*i);
+            xxh_u64x2 const data_key = data_vec ^ key_vec;
+
+            /* xacc[i] *= XXH_PRIME32_1 */
+            /* prod_lo = ((xxh_u64x2)data_key & 0xFFFFFFFF) * ((xxh_u64x2)prime & 0xFFFFFFFF);  */
+            xxh_u64x2 const prod_even  = XXH_vec_mule((xxh_u32x4)data_key, prime);
+            /* prod_hi = ((xxh_u64x2)data_key >> 32) * ((xxh_u64x2)prime >> 32);  */
+            xxh_u64x2 const prod_odd  = XXH_vec_mulo((xxh_u32x4)data_key, prime);
+            xacc[i] = prod_odd + (prod_even << v32);
+    }   }
+}
+
 #endif
 
-#if defined(XXH_X86DISPATCH) || XXH_VECTOR == XXH_SSE2 \
-    || XXH_VECTOR == XXH_AVX2 || XXH_VECTOR == XXH_AVX512
-#  define XXH_SEC_ALIGN XXH_ACC_ALIGN
-#elif XXH_VECTOR == XXH_SVE
-#  define XXH_SEC_ALIGN XXH_ACC_ALIGN
-#else
-#  define XXH_SEC_ALIGN 8
-#endif
+#if (XXH_VECTOR == XXH_SVE)
+
+XXH_FORCE_INLINE void
+XXH3_accumulate_512_sve( void* XXH_RESTRICT acc,
+                   const void* XXH_RESTRICT input,
+                   const void* XXH_RESTRICT secret)
+{
+    uint64_t *xacc = (uint64_t *)acc;
+    const uint64_t *xinput = (const uint64_t *)(const void *)input;
+    const uint64_t *xsecret = (const uint64_t *)(const void *)secret;
+    svuint64_t kSwap = sveor_n_u64_z(svptrue_b64(), svindex_u64(0, 1), 1);
+    uint64_t element_count = svcntd();
+    if (element_count >= 8) {
+        svbool_t mask = svptrue_pat_b64(SV_VL8);
+        svuint64_t vacc = svld1_u64(mask, xacc);
+        ACCRND(vacc, 0);
+        svst1_u64(mask, xacc, vacc);
+    } else if (element_count == 2) {   /* sve128 */
+        svbool_t mask = svptrue_pat_b64(SV_VL2);
+        svuint64_t acc0 = svld1_u64(mask, xacc + 0);
+        svuint64_t acc1 = svld1_u64(mask, xacc + 2);
+        svuint64_t acc2 = svld1_u64(mask, xacc + 4);
+        svuint64_t acc3 = svld1_u64(mask, xacc + 6);
+        ACCRND(acc0, 0);
+        ACCRND(acc1, 2);
+        ACCRND(acc2, 4);
+        ACCRND(acc3, 6);
+        svst1_u64(mask, xacc + 0, acc0);
+        svst1_u64(mask, xacc + 2, acc1);
+        svst1_u64(mask, xacc + 4, acc2);
+        svst1_u64(mask, xacc + 6, acc3);
+    } else {
+        svbool_t mask = svptrue_pat_b64(SV_VL4);
+        svuint64_t acc0 = svld1_u64(mask, xacc + 0);
+        svuint64_t acc1 = svld1_u64(mask, xacc + 4);
+        ACCRND(acc0, 0);
+        ACCRND(acc1, 4);
+        svst1_u64(mask, xacc + 0, acc0);
+        svst1_u64(mask, xacc + 4, acc1);
+    }
+}
+
+XXH_FORCE_INLINE void
+XXH3_accumulate_sve(xxh_u64* XXH_RESTRICT acc,
+               const xxh_u8* XXH_RESTRICT input,
+               const xxh_u8* XXH_RESTRICT secret,
+               size_t nbStripes,
+               size_t prefetchDist)
+{
+    (void)prefetchDist;  /* prefetches a fixed 1 KB ahead */
+    if (nbStripes != 0) {
+        uint64_t *xacc = (uint64_t *)acc;
+        const uint64_t *xinput = (const uint64_t *)(const void *)input;
+        const uint64_t *xsecret = (const uint64_t *)(const void *)secret;
+        svuint64_t kSwap = sveor_n_u64_z(svptrue_b64(), svindex_u64(0, 1), 1);
+        uint64_t element_count = svcntd();
+        if (element_count >= 8) {
+            svbool_t mask = svptrue_pat_b64(SV_VL8);
+            svuint64_t vacc = svld1_u64(mask, xacc + 0);
+            do {
+                /* svprfd(svbool_t, void *, enum svfprop); */
+                svprfd(mask, xinput + 128, SV_PLDL1STRM);
+                ACCRND(vacc, 0);
+                xinput += 8;
+                xsecret += 1;
+                nbStripes--;
+           } while (nbStripes != 0);
+
+           svst1_u64(mask, xacc + 0, vacc);
+        } else if (element_count == 2) { /* sve128 */
+            svbool_t mask = svptrue_pat_b64(SV_VL2);
+            svuint64_t acc0 = svld1_u64(mask, xacc + 0);
+            svuint64_t acc1 = svld1_u64(mask, xacc + 2);
+            svuint64_t acc2 = svld1_u64(mask, xacc + 4);
+            svuint64_t acc3 = svld1_u64(mask, xacc + 6);
+            do {
+                svprfd(mask, xinput + 128, SV_PLDL1STRM);
+                ACCRND(acc0, 0);
+                ACCRND(acc1, 2);
+                ACCRND(acc2, 4);
+                ACCRND(acc3, 6);
+                xinput += 8;
+                xsecret += 1;
+                nbStripes--;
+           } while (nbStripes != 0);
 
-#if defined(__GNUC__) || defined(__clang__)
-#  define XXH_ALIASING __attribute__((__may_alias__))
-#else
-#  define XXH_ALIASING /* nothing */
-#endif
+           svst1_u64(mask, xacc + 0, acc0);
+           svst1_u64(mask, xacc + 2, acc1);
+           svst1_u64(mask, xacc + 4, acc2);
+           svst1_u64(mask, xacc + 6, acc3);
+        } else {
+            svbool_t mask = svptrue_pat_b64(SV_VL4);
+            svuint64_t acc0 = svld1_u64(mask, xacc + 0);
+            svuint64_t acc1 = svld1_u64(mask, xacc + 4);
+            do {
+                svprfd(mask, xinput + 128, SV_PLDL1STRM);
+                ACCRND(acc0, 0);
+                ACCRND(acc1, 4);
+                xinput += 8;
+                xsecret += 1;
+                nbStripes--;
+           } while (nbStripes != 0);
+
+           svst1_u64(mask, xacc + 0, acc0);
+           svst1_u64(mask, xacc + 4, acc1);
+       }
+    }
+}
 
-/*
- * UGLY HACK:
- * GCC usually generates the best code with -O3 for xxHash.
- *
- * However, when targeting AVX2, it is overzealous in its unrolling resulting
- * in code roughly 3/4 the speed of Clang.
- *
- * There are other issues, such as GCC splitting _mm256_loadu_si256 into
- * _mm_loadu_si128 + _mm256_inserti128_si256. This is an optimization which
- * only applies to Sandy and Ivy Bridge... which don't even support AVX2.
- *
- * That is why when compiling the AVX2 version, it is recommended to use either
- *   -O2 -mavx2 -march=haswell
- * or
- *   -O2 -mavx2 -mno-avx256-split-unaligned-load
- * for decent performance, or to use Clang instead.
- *
- * Fortunately, we can control the first one with a pragma that forces GCC into
- * -O2, but the other one we can't control without "failed to inline always
- * inline function due to target mismatch" warnings.
- */
-#if XXH_VECTOR == XXH_AVX2 /* AVX2 */ \
-  && defined(__GNUC__) && !defined(__clang__) /* GCC, not Clang */ \
-  && defined(__OPTIMIZE__) && XXH_SIZE_OPT <= 0 /* respect -O0 and -Os */
-#  pragma GCC push_options
-#  pragma GCC optimize("-O2")
 #endif
 
-#if XXH_VECTOR == XXH_NEON
+/* scalar variants - universal */
 
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
 /*
- * UGLY HACK: While AArch64 GCC on Linux does not seem to care, on macOS, GCC -O3
- * optimizes out the entire hashLong loop because of the aliasing violation.
- *
- * However, GCC is also inefficient at load-store optimization with vld1q/vst1q,
- * so the only option is to mark it as aliasing.
- */
-typedef uint64x2_t xxh_aliasing_uint64x2_t XXH_ALIASING;
-
-/*!
- * @internal
- * @brief `vld1q_u64` but faster and alignment-safe.
- *
- * On AArch64, unaligned access is always safe, but on ARMv7-a, it is only
- * *conditionally* safe (`vld1` has an alignment bit like `movdq[ua]` in x86).
+ * In XXH3_scalarRound(), GCC and Clang have a similar codegen issue, where they
+ * emit an excess mask and a full 64-bit multiply-add (MADD X-form).
  *
- * GCC for AArch64 sees `vld1q_u8` as an intrinsic instead of a load, so it
- * prohibits load-store optimizations. Therefore, a direct dereference is used.
+ * While this might not seem like much, as AArch64 is a 64-bit architecture, only
+ * big Cortex designs have a full 64-bit multiplier.
  *
- * Otherwise, `vld1q_u8` is used with `vreinterpretq_u8_u64` to do a safe
- * unaligned load.
- */
-#if defined(__aarch64__) && defined(__GNUC__) && !defined(__clang__)
-XXH_FORCE_INLINE uint64x2_t XXH_vld1q_u64(void const* ptr) /* silence -Wcast-align */
-{
-    return *(xxh_aliasing_uint64x2_t const *)ptr;
-}
-#else
-XXH_FORCE_INLINE uint64x2_t XXH_vld1q_u64(void const* ptr)
-{
-    return vreinterpretq_u64_u8(vld1q_u8((uint8_t const*)ptr));
-}
-#endif
-
-/*!
- * @internal
- * @brief `vmlal_u32` on low and high halves of a vector.
+ * On the little cores, the smaller 32-bit multiplier is used, and full 64-bit
+ * multiplies expand to 2-3 multiplies in microcode. This has a major penalty
+ * of up to 4 latency cycles and 2 stall cycles in the multiply pipeline.
  *
- * This is a workaround for AArch64 GCC < 11 which implemented arm_neon.h with
- * inline assembly and were therefore incapable of merging the `vget_{low, high}_u32`
- * with `vmlal_u32`.
+ * Thankfully, AArch64 still provides the 32-bit long multiply-add (UMADDL) which does
+ * not have this penalty and does the mask automatically.
  */
-#if defined(__aarch64__) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 11
-XXH_FORCE_INLINE uint64x2_t
-XXH_vmlal_low_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
-{
-    /* Inline assembly is the only way */
-    __asm__("umlal   %0.2d, %1.2s, %2.2s" : "+w" (acc) : "w" (lhs), "w" (rhs));
-    return acc;
-}
-XXH_FORCE_INLINE uint64x2_t
-XXH_vmlal_high_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
+XXH_FORCE_INLINE xxh_u64
+XXH_mult32to64_add64(xxh_u64 lhs, xxh_u64 rhs, xxh_u64 acc)
 {
-    /* This intrinsic works as expected */
-    return vmlal_high_u32(acc, lhs, rhs);
+    xxh_u64 ret;
+    /* note: %x = 64-bit register, %w = 32-bit register */
+    __asm__("umaddl %x0, %w1, %w2, %x3" : "=r" (ret) : "r" (lhs), "r" (rhs), "r" (acc));
+    return ret;
 }
 #else
-/* Portable intrinsic versions */
-XXH_FORCE_INLINE uint64x2_t
-XXH_vmlal_low_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
-{
-    return vmlal_u32(acc, vget_low_u32(lhs), vget_low_u32(rhs));
-}
-/*! @copydoc XXH_vmlal_low_u32
- * Assume the compiler converts this to vmlal_high_u32 on aarch64 */
-XXH_FORCE_INLINE uint64x2_t
-XXH_vmlal_high_u32(uint64x2_t acc, uint32x4_t lhs, uint32x4_t rhs)
+XXH_FORCE_INLINE xxh_u64
+XXH_mult32to64_add64(xxh_u64 lhs, xxh_u64 rhs, xxh_u64 acc)
 {
-    return vmlal_u32(acc, vget_high_u32(lhs), vget_high_u32(rhs));
+    return XXH_mult32to64((xxh_u32)lhs, (xxh_u32)rhs) + acc;
 }
 #endif
 
-/*!
- * @ingroup tuning
- * @brief Controls the NEON to scalar ratio for XXH3
- *
- * This can be set to 2, 4, 6, or 8.
- *
- * ARM Cortex CPUs are _very_ sensitive to how their pipelines are used.
- *
- * For example, the Cortex-A73 can dispatch 3 micro-ops per cycle, but only 2 of those
- * can be NEON. If you are only using NEON instructions, you are only using 2/3 of the CPU
- * bandwidth.
- *
- * This is even more noticeable on the more advanced cores like the Cortex-A76 which
- * can dispatch 8 micro-ops per cycle, but still only 2 NEON micro-ops at once.
- *
- * Therefore, to make the most out of the pipeline, it is beneficial to run 6 NEON lanes
- * and 2 scalar lanes, which is chosen by default.
- *
- * This does not apply to Apple processors or 32-bit processors, which run better with
- * full NEON. These will default to 8. Additionally, size-optimized builds run 8 lanes.
- *
- * This change benefits CPUs with large micro-op buffers without negatively affecting
- * most other CPUs:
- *
- *  | Chipset               | Dispatch type       | NEON only | 6:2 hybrid | Diff. |
- *  |:----------------------|:--------------------|----------:|-----------:|------:|
- *  | Snapdragon 730 (A76)  | 2 NEON/8 micro-ops  |  8.8 GB/s |  10.1 GB/s |  ~16% |
- *  | Snapdragon 835 (A73)  | 2 NEON/3 micro-ops  |  5.1 GB/s |   5.3 GB/s |   ~5% |
- *  | Marvell PXA1928 (A53) | In-order dual-issue |  1.9 GB/s |   1.9 GB/s |    0% |
- *  | Apple M1              | 4 NEON/8 micro-ops  | 37.3 GB/s |  36.1 GB/s |  ~-3% |
- *
- * It also seems to fix some bad codegen on GCC, making it almost as fast as clang.
- *
- * When using WASM SIMD128, if this is 2 or 6, SIMDe will scalarize 2 of the lanes meaning
- * it effectively becomes worse 4.
- *
- * @see XXH3_accumulate_512_neon()
- */
-# ifndef XXH3_NEON_LANES
-#  if (defined(__aarch64__) || defined(__arm64__) || defined(_M_ARM64) || defined(_M_ARM64EC)) \
-   && !defined(__APPLE__) && XXH_SIZE_OPT <= 0
-#   define XXH3_NEON_LANES 6
-#  else
-#   define XXH3_NEON_LANES XXH_ACC_NB
-#  endif
-# endif
-#endif  /* XXH_VECTOR == XXH_NEON */
-
-/*
- * VSX and Z Vector helpers.
- *
- * This is very messy, and any pull requests to clean this up are welcome.
- *
- * There are a lot of problems with supporting VSX and s390x, due to
- * inconsistent intrinsics, spotty coverage, and multiple endiannesses.
- */
-#if XXH_VECTOR == XXH_VSX
-/* Annoyingly, these headers _may_ define three macros: `bool`, `vector`,
- * and `pixel`. This is a problem for obvious reasons.
- *
- * These keywords are unnecessary; the spec literally says they are
- * equivalent to `__bool`, `__vector`, and `__pixel` and may be undef'd
- * after including the header.
- *
- * We use pragma push_macro/pop_macro to keep the namespace clean. */
-#  pragma push_macro("bool")
-#  pragma push_macro("vector")
-#  pragma push_macro("pixel")
-/* silence potential macro redefined warnings */
-#  undef bool
-#  undef vector
-#  undef pixel
-
-#  if defined(__s390x__)
-#    include <s390intrin.h>
-#  else
-#    include <altivec.h>
-#  endif
-
-/* Restore the original macro values, if applicable. */
-#  pragma pop_macro("pixel")
-#  pragma pop_macro("vector")
-#  pragma pop_macro("bool")
-
-typedef __vector unsigned long long xxh_u64x2;
-typedef __vector unsigned char xxh_u8x16;
-typedef __vector unsigned xxh_u32x4;
-
-/*
- * UGLY HACK: Similar to aarch64 macOS GCC, s390x GCC has the same aliasing issue.
+/*!
+ * @internal
+ * @brief Scalar round for @ref XXH3_accumulate_512_scalar().
+ *
+ * This is extracted to its own function because the NEON path uses a combination
+ * of NEON and scalar.
  */
-typedef xxh_u64x2 xxh_aliasing_u64x2 XXH_ALIASING;
+XXH_FORCE_INLINE void
+XXH3_scalarRound(void* XXH_RESTRICT acc,
+                 void const* XXH_RESTRICT input,
+                 void const* XXH_RESTRICT secret,
+                 size_t lane)
+{
+    xxh_u64* xacc = (xxh_u64*) acc;
+    xxh_u8 const* xinput  = (xxh_u8 const*) input;
+    xxh_u8 const* xsecret = (xxh_u8 const*) secret;
+    XXH_ASSERT(lane < XXH_ACC_NB);
+    XXH_ASSERT(((size_t)acc & (XXH_ACC_ALIGN-1)) == 0);
+    {
+        xxh_u64 const data_val = XXH_readLE64(xinput + lane * 8);
+        xxh_u64 const data_key = data_val ^ XXH_readLE64(xsecret + lane * 8);
+        xacc[lane ^ 1] += data_val; /* swap adjacent lanes */
+        xacc[lane] = XXH_mult32to64_add64(data_key /* & 0xFFFFFFFF */, data_key >> 32, xacc[lane]);
+    }
+}
 
-# ifndef XXH_VSX_BE
-#  if defined(__BIG_ENDIAN__) \
-  || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
-#    define XXH_VSX_BE 1
-#  elif defined(__VEC_ELEMENT_REG_ORDER__) && __VEC_ELEMENT_REG_ORDER__ == __ORDER_BIG_ENDIAN__
-#    warning "-maltivec=be is not recommended. Please use native endianness."
-#    define XXH_VSX_BE 1
-#  else
-#    define XXH_VSX_BE 0
-#  endif
-# endif /* !defined(XXH_VSX_BE) */
+/*!
+ * @internal
+ * @brief Processes a 64 byte block of data using the scalar path.
+ */
+XXH_FORCE_INLINE void
+XXH3_accumulate_512_scalar(void* XXH_RESTRICT acc,
+                     const void* XXH_RESTRICT input,
+                     const void* XXH_RESTRICT secret)
+{
+    size_t i;
+    /* ARM GCC refuses to unroll this loop, resulting in a 24% slowdown on ARMv6. */
+#if defined(__GNUC__) && !defined(__clang__) \
+  && (defined(__arm__) || defined(__thumb2__)) \
+  && defined(__ARM_FEATURE_UNALIGNED) /* no unaligned access just wastes bytes */ \
+  && XXH_SIZE_OPT <= 0
+#  pragma GCC unroll 8
+#endif
+    for (i=0; i < XXH_ACC_NB; i++) {
+        XXH3_scalarRound(acc, input, secret, i);
+    }
+}
+XXH_FORCE_INLINE XXH3_ACCUMULATE_TEMPLATE(scalar)
 
-# if XXH_VSX_BE
-#  if defined(__POWER9_VECTOR__) || (defined(__clang__) && defined(__s390x__))
-#    define XXH_vec_revb vec_revb
-#  else
 /*!
- * A polyfill for POWER9's vec_revb().
+ * @internal
+ * @brief Scalar scramble step for @ref XXH3_scrambleAcc_scalar().
+ *
+ * This is extracted to its own function because the NEON path uses a combination
+ * of NEON and scalar.
  */
-XXH_FORCE_INLINE xxh_u64x2 XXH_vec_revb(xxh_u64x2 val)
+XXH_FORCE_INLINE void
+XXH3_scalarScrambleRound(void* XXH_RESTRICT acc,
+                         void const* XXH_RESTRICT secret,
+                         size_t lane)
 {
-    xxh_u8x16 const vByteSwap = { 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00,
-                                  0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08 };
-    return vec_perm(val, val, vByteSwap);
+    xxh_u64* const xacc = (xxh_u64*) acc;   /* presumed aligned */
+    const xxh_u8* const xsecret = (const xxh_u8*) secret;   /* no alignment restriction */
+    XXH_ASSERT((((size_t)acc) & (XXH_ACC_ALIGN-1)) == 0);
+    XXH_ASSERT(lane < XXH_ACC_NB);
+    {
+        xxh_u64 const key64 = XXH_readLE64(xsecret + lane * 8);
+        xxh_u64 acc64 = xacc[lane];
+        acc64 = XXH_xorshift64(acc64, 47);
+        acc64 ^= key64;
+        acc64 *= XXH_PRIME32_1;
+        xacc[lane] = acc64;
+    }
 }
-#  endif
-# endif /* XXH_VSX_BE */
 
 /*!
- * Performs an unaligned vector load and byte swaps it on big endian.
+ * @internal
+ * @brief Scrambles the accumulators after a large chunk has been read
  */
-XXH_FORCE_INLINE xxh_u64x2 XXH_vec_loadu(const void *ptr)
+XXH_FORCE_INLINE void
+XXH3_scrambleAcc_scalar(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
 {
-    xxh_u64x2 ret;
-    XXH_memcpy(&ret, ptr, sizeof(xxh_u64x2));
-# if XXH_VSX_BE
-    ret = XXH_vec_revb(ret);
-# endif
-    return ret;
+    size_t i;
+    for (i=0; i < XXH_ACC_NB; i++) {
+        XXH3_scalarScrambleRound(acc, secret, i);
+    }
+}
+
+XXH_FORCE_INLINE void
+XXH3_initCustomSecret_scalar(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+{
+    /*
+     * We need a separate pointer for the hack below,
+     * which requires a non-const pointer.
+     * Any decent compiler will optimize this out otherwise.
+     */
+    const xxh_u8* kSecretPtr = XXH3_kSecret;
+    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 15) == 0);
+
+#if defined(__GNUC__) && defined(__aarch64__)
+    /*
+     * UGLY HACK:
+     * GCC and Clang generate a bunch of MOV/MOVK pairs for aarch64, and they are
+     * placed sequentially, in order, at the top of the unrolled loop.
+     *
+     * While MOVK is great for generating constants (2 cycles for a 64-bit
+     * constant compared to 4 cycles for LDR), it fights for bandwidth with
+     * the arithmetic instructions.
+     *
+     *   I   L   S
+     * MOVK
+     * MOVK
+     * MOVK
+     * MOVK
+     * ADD
+     * SUB      STR
+     *          STR
+     * By forcing loads from memory (as the asm line causes the compiler to assume
+     * that XXH3_kSecretPtr has been changed), the pipelines are used more
+     * efficiently:
+     *   I   L   S
+     *      LDR
+     *  ADD LDR
+     *  SUB     STR
+     *          STR
+     *
+     * See XXH3_NEON_LANES for details on the pipsline.
+     *
+     * XXH3_64bits_withSeed, len == 256, Snapdragon 835
+     *   without hack: 2654.4 MB/s
+     *   with hack:    3202.9 MB/s
+     */
+    XXH_COMPILER_GUARD(kSecretPtr);
+#endif
+    {   int const nbRounds = XXH_SECRET_DEFAULT_SIZE / 16;
+        int i;
+        for (i=0; i < nbRounds; i++) {
+            /*
+             * The asm hack causes the compiler to assume that kSecretPtr aliases with
+             * customSecret, and on aarch64, this prevented LDP from merging two
+             * loads together for free. Putting the loads together before the stores
+             * properly generates LDP.
+             */
+            xxh_u64 lo = XXH_readLE64(kSecretPtr + 16*i)     + seed64;
+            xxh_u64 hi = XXH_readLE64(kSecretPtr + 16*i + 8) - seed64;
+            XXH_writeLE64((xxh_u8*)customSecret + 16*i,     lo);
+            XXH_writeLE64((xxh_u8*)customSecret + 16*i + 8, hi);
+    }   }
 }
 
 /*
- * vec_mulo and vec_mule are very problematic intrinsics on PowerPC
- *
- * These intrinsics weren't added until GCC 8, despite existing for a while,
- * and they are endian dependent. Also, their meaning swap depending on version.
- * */
-# if defined(__s390x__)
- /* s390x is always big endian, no issue on this platform */
-#  define XXH_vec_mulo vec_mulo
-#  define XXH_vec_mule vec_mule
-# elif defined(__clang__) && XXH_HAS_BUILTIN(__builtin_altivec_vmuleuw) && !defined(__ibmxl__)
-/* Clang has a better way to control this, we can just use the builtin which doesn't swap. */
- /* The IBM XL Compiler (which defined __clang__) only implements the vec_* operations */
-#  define XXH_vec_mulo __builtin_altivec_vmulouw
-#  define XXH_vec_mule __builtin_altivec_vmuleuw
-# else
-/* gcc needs inline assembly */
-/* Adapted from https://github.com/google/highwayhash/blob/master/highwayhash/hh_vsx.h. */
-XXH_FORCE_INLINE xxh_u64x2 XXH_vec_mulo(xxh_u32x4 a, xxh_u32x4 b)
+ * Integer keys: each key is hashed as its in-memory representation,
+ * using the short input routines with a constant length,
+ * which the compiler can fully specialize.
+ */
+XXH_FORCE_INLINE void
+XXH3_hashU32Array_scalar(const xxh_u32* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
 {
-    xxh_u64x2 result;
-    __asm__("vmulouw %0, %1, %2" : "=v" (result) : "v" (a), "v" (b));
-    return result;
+    size_t n;
+    for (n = 0; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
 }
-XXH_FORCE_INLINE xxh_u64x2 XXH_vec_mule(xxh_u32x4 a, xxh_u32x4 b)
+
+XXH_FORCE_INLINE void
+XXH3_hashU64Array_scalar(const xxh_u64* XXH_RESTRICT keys, size_t nbKeys, xxh_u64* XXH_RESTRICT out)
 {
-    xxh_u64x2 result;
-    __asm__("vmuleuw %0, %1, %2" : "=v" (result) : "v" (a), "v" (b));
-    return result;
+    size_t n;
+    for (n = 0; n < nbKeys; n++) {
+        out[n] = XXH3_len_4to8_64b((const xxh_u8*)(keys + n), sizeof(keys[n]), XXH3_kSecret, 0, XXH3_asIs);
+    }
 }
-# endif /* XXH_vec_mulo, XXH_vec_mule */
-#endif /* XXH_VECTOR == XXH_VSX */
 
-#if XXH_VECTOR == XXH_SVE
-#define ACCRND(acc, offset) \
-do { \
-    svuint64_t input_vec = svld1_u64(mask, xinput + offset);         \
-    svuint64_t secret_vec = svld1_u64(mask, xsecret + offset);       \
-    svuint64_t mixed = sveor_u64_x(mask, secret_vec, input_vec);     \
-    svuint64_t swapped = svtbl_u64(input_vec, kSwap);                \
-    svuint64_t mixed_lo = svextw_u64_x(mask, mixed);                 \
-    svuint64_t mixed_hi = svlsr_n_u64_x(mask, mixed, 32);            \
-    svuint64_t mul = svmad_u64_x(mask, mixed_lo, mixed_hi, swapped); \
-    acc = svadd_u64_x(mask, acc, mul);                               \
-} while (0)
-#endif /* XXH_VECTOR == XXH_SVE */
 
-/* prefetch
- * can be disabled, by declaring XXH_NO_PREFETCH build macro */
-#if defined(XXH_NO_PREFETCH)
-#  define XXH_PREFETCH(ptr)  (void)(ptr)  /* disabled */
-#else
-#  if XXH_SIZE_OPT >= 1
-#    define XXH_PREFETCH(ptr) (void)(ptr)
-#  elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))  /* _mm_prefetch() not defined outside of x86/x64 */
-#    include <mmintrin.h>   /* https://msdn.microsoft.com/fr-fr/library/84szxsww(v=vs.90).aspx */
-#    define XXH_PREFETCH(ptr)  _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
-#  elif defined(__GNUC__) && ( (__GNUC__ >= 4) || ( (__GNUC__ == 3) && (__GNUC_MINOR__ >= 1) ) )
-#    define XXH_PREFETCH(ptr)  __builtin_prefetch((ptr), 0 /* rw==read */, 3 /* locality */)
-#  else
-#    define XXH_PREFETCH(ptr) (void)(ptr)  /* disabled */
-#  endif
-#endif  /* XXH_NO_PREFETCH */
+typedef void (*XXH3_f_accumulate)(xxh_u64* XXH_RESTRICT, const xxh_u8* XXH_RESTRICT, const xxh_u8* XXH_RESTRICT, size_t, size_t);
+typedef void (*XXH3_f_scrambleAcc)(void* XXH_RESTRICT, const void*);
+typedef void (*XXH3_f_initCustomSecret)(void* XXH_RESTRICT, xxh_u64);
+
+
+#if (XXH_VECTOR == XXH_AVX512)
+
+#define XXH3_accumulate_512 XXH3_accumulate_512_avx512
+#define XXH3_accumulate     XXH3_accumulate_avx512
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_avx512
+#define XXH3_initCustomSecret XXH3_initCustomSecret_avx512
+#define XXH3_hashU32Array   XXH3_hashU32Array_avx512
+#define XXH3_hashU64Array   XXH3_hashU64Array_avx512
+
+#elif (XXH_VECTOR == XXH_AVX2)
+
+#define XXH3_accumulate_512 XXH3_accumulate_512_avx2
+#define XXH3_accumulate     XXH3_accumulate_avx2
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_avx2
+#define XXH3_initCustomSecret XXH3_initCustomSecret_avx2
+#define XXH3_hashU32Array   XXH3_hashU32Array_avx2
+#define XXH3_hashU64Array   XXH3_hashU64Array_avx2
+
+#elif (XXH_VECTOR == XXH_SSE2)
+
+#define XXH3_accumulate_512 XXH3_accumulate_512_sse2
+#define XXH3_accumulate     XXH3_accumulate_sse2
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_sse2
+#define XXH3_initCustomSecret XXH3_initCustomSecret_sse2
+#define XXH3_hashU32Array   XXH3_hashU32Array_scalar
+#define XXH3_hashU64Array   XXH3_hashU64Array_sse2
+
+#elif (XXH_VECTOR == XXH_NEON)
 
+#define XXH3_accumulate_512 XXH3_accumulate_512_neon
+#define XXH3_accumulate     XXH3_accumulate_neon
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_neon
+#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+#define XXH3_hashU32Array   XXH3_hashU32Array_scalar
+#define XXH3_hashU64Array   XXH3_hashU64Array_scalar
 
-/* ==========================================
- * XXH3 default settings
- * ========================================== */
+#elif (XXH_VECTOR == XXH_VSX)
 
-#define XXH_SECRET_DEFAULT_SIZE 192   /* minimum XXH3_SECRET_SIZE_MIN */
+#define XXH3_accumulate_512 XXH3_accumulate_512_vsx
+#define XXH3_accumulate     XXH3_accumulate_vsx
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_vsx
+#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+#define XXH3_hashU32Array   XXH3_hashU32Array_scalar
+#define XXH3_hashU64Array   XXH3_hashU64Array_scalar
 
-#if (XXH_SECRET_DEFAULT_SIZE < XXH3_SECRET_SIZE_MIN)
-#  error "default keyset is not large enough"
-#endif
+#elif (XXH_VECTOR == XXH_SVE)
+#define XXH3_accumulate_512 XXH3_accumulate_512_sve
+#define XXH3_accumulate     XXH3_accumulate_sve
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_scalar
+#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+#define XXH3_hashU32Array   XXH3_hashU32Array_scalar
+#define XXH3_hashU64Array   XXH3_hashU64Array_scalar
 
-/*! Pseudorandom secret taken directly from FARSH. */
-XXH_ALIGN(64) static const xxh_u8 XXH3_kSecret[XXH_SECRET_DEFAULT_SIZE] = {
-    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
-    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
-    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
-    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
-    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
-    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
-    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
-    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
-    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
-    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
-    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
-    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
-};
+#else /* scalar */
 
-static const xxh_u64 PRIME_MX1 = 0x165667919E3779F9ULL;  /*!< 0b0001011001010110011001111001000110011110001101110111100111111001 */
-static const xxh_u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;  /*!< 0b1001111110110010000111000110010100011110100110001101111100100101 */
+#define XXH3_accumulate_512 XXH3_accumulate_512_scalar
+#define XXH3_accumulate     XXH3_accumulate_scalar
+#define XXH3_scrambleAcc    XXH3_scrambleAcc_scalar
+#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+#define XXH3_hashU32Array   XXH3_hashU32Array_scalar
+#define XXH3_hashU64Array   XXH3_hashU64Array_scalar
 
-#ifdef XXH_OLD_NAMES
-#  define kSecret XXH3_kSecret
 #endif
 
-#ifdef XXH_DOXYGEN
-/*!
- * @brief Calculates a 32-bit to 64-bit long multiply.
- *
- * Implemented as a macro.
- *
- * Wraps `__emulu` on MSVC x86 because it tends to call `__allmul` when it doesn't
- * need to (but it shouldn't need to anyways, it is about 7 instructions to do
- * a 64x64 multiply...). Since we know that this will _always_ emit `MULL`, we
- * use that instead of the normal method.
- *
- * If you are compiling for platforms like Thumb-1 and don't have a better option,
- * you may also want to write your own long multiply routine here.
- *
- * @param x, y Numbers to be multiplied
- * @return 64-bit product of the low 32 bits of @p x and @p y.
- */
-XXH_FORCE_INLINE xxh_u64
-XXH_mult32to64(xxh_u64 x, xxh_u64 y)
-{
-   return (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF);
-}
-#elif defined(_MSC_VER) && defined(_M_IX86)
-#    define XXH_mult32to64(x, y) __emulu((unsigned)(x), (unsigned)(y))
-#else
-/*
- * Downcast + upcast is usually better than masking on older compilers like
- * GCC 4.2 (especially 32-bit ones), all without affecting newer compilers.
- *
- * The other method, (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF), will AND both operands
- * and perform a full 64x64 multiply -- entirely redundant on 32-bit.
- */
-#    define XXH_mult32to64(x, y) ((xxh_u64)(xxh_u32)(x) * (xxh_u64)(xxh_u32)(y))
+#if XXH_SIZE_OPT >= 1 /* don't do SIMD for initialization */
+#  undef XXH3_initCustomSecret
+#  define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
 #endif
 
-/*!
- * @brief Calculates a 64->128-bit long multiply.
- *
- * Uses `__uint128_t` and `_umul128` if available, otherwise uses a scalar
- * version.
- *
- * @param lhs , rhs The 64-bit integers to be multiplied
- * @return The 128-bit result represented in an @ref XXH128_hash_t.
+/*
+ * Block geometry of a secret: a block consumes the whole secret,
+ * one stripe every XXH_SECRET_CONSUME_RATE bytes.
  */
-static XXH128_hash_t
-XXH_mult64to128(xxh_u64 lhs, xxh_u64 rhs)
+#define XXH3_NB_STRIPES_PER_BLOCK(secretSize) (((secretSize) - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE)
+
+XXH_FORCE_INLINE void
+XXH3_hashLong_internal_loop_geometry(xxh_u64* XXH_RESTRICT acc,
+                               const xxh_u8* XXH_RESTRICT input, size_t len,
+                               const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                                     size_t nbStripesPerBlock, size_t block_len,
+                                     size_t prefetchDist,
+                                     XXH3_f_accumulate f_acc,
+                                     XXH3_f_scrambleAcc f_scramble)
 {
-    /*
-     * GCC/Clang __uint128_t method.
-     *
-     * On most 64-bit targets, GCC and Clang define a __uint128_t type.
-     * This is usually the best way as it usually uses a native long 64-bit
-     * multiply, such as MULQ on x86_64 or MUL + UMULH on aarch64.
-     *
-     * Usually.
-     *
-     * Despite being a 32-bit platform, Clang (and emscripten) define this type
-     * despite not having the arithmetic for it. This results in a laggy
-     * compiler builtin call which calculates a full 128-bit multiply.
-     * In that case it is best to use the portable one.
-     * https://github.com/Cyan4973/xxHash/issues/211#issuecomment-515575677
-     */
-#if (defined(__GNUC__) || defined(__clang__)) && !defined(__wasm__) \
-    && defined(__SIZEOF_INT128__) \
-    || (defined(_INTEGRAL_MAX_BITS) && _INTEGRAL_MAX_BITS >= 128)
+    size_t const nb_blocks = (len - 1) / block_len;
 
-    __uint128_t const product = (__uint128_t)lhs * (__uint128_t)rhs;
-    XXH128_hash_t r128;
-    r128.low64  = (xxh_u64)(product);
-    r128.high64 = (xxh_u64)(product >> 64);
-    return r128;
+    size_t n;
 
-    /*
-     * MSVC for x64's _umul128 method.
-     *
-     * xxh_u64 _umul128(xxh_u64 Multiplier, xxh_u64 Multiplicand, xxh_u64 *HighProduct);
-     *
-     * This compiles to single operand MUL on x64.
-     */
-#elif (defined(_M_X64) || defined(_M_IA64)) && !defined(_M_ARM64EC)
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN);
+    XXH_ASSERT(nbStripesPerBlock == XXH3_NB_STRIPES_PER_BLOCK(secretSize));
+    XXH_ASSERT(block_len == XXH_STRIPE_LEN * nbStripesPerBlock);
 
-#ifndef _MSC_VER
-#   pragma intrinsic(_umul128)
-#endif
-    xxh_u64 product_high;
-    xxh_u64 const product_low = _umul128(lhs, rhs, &product_high);
-    XXH128_hash_t r128;
-    r128.low64  = product_low;
-    r128.high64 = product_high;
-    return r128;
+    for (n = 0; n < nb_blocks; n++) {
+        f_acc(acc, input + n*block_len, secret, nbStripesPerBlock, prefetchDist);
+        f_scramble(acc, secret + secretSize - XXH_STRIPE_LEN);
+    }
 
-    /*
-     * MSVC for ARM64's __umulh method.
-     *
-     * This compiles to the same MUL + UMULH as GCC/Clang's __uint128_t method.
-     */
-#elif defined(_M_ARM64) || defined(_M_ARM64EC)
+    /* last partial block */
+    XXH_ASSERT(len > XXH_STRIPE_LEN);
+    {   size_t const nbStripes = ((len - 1) - (block_len * nb_blocks)) / XXH_STRIPE_LEN;
+        XXH_ASSERT(nbStripes <= (secretSize / XXH_SECRET_CONSUME_RATE));
+        f_acc(acc, input + nb_blocks*block_len, secret, nbStripes, prefetchDist);
 
-#ifndef _MSC_VER
-#   pragma intrinsic(__umulh)
-#endif
-    XXH128_hash_t r128;
-    r128.low64  = lhs * rhs;
-    r128.high64 = __umulh(lhs, rhs);
-    return r128;
+        /* last stripe */
+        {   const xxh_u8* const p = input + len - XXH_STRIPE_LEN;
+#define XXH_SECRET_LASTACC_START 7  /* not aligned on 8, last secret is different from acc & scrambler */
+            f_acc(acc, p, secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START, 1, prefetchDist);
+    }   }
+}
 
-#else
-    /*
-     * Portable scalar method. Optimized for 32-bit and 64-bit ALUs.
-     *
-     * This is a fast and simple grade school multiply, which is shown below
-     * with base 10 arithmetic instead of base 0x100000000.
-     *
-     *           9 3 // D2 lhs = 93
-     *         x 7 5 // D2 rhs = 75
-     *     ----------
-     *           1 5 // D2 lo_lo = (93 % 10) * (75 % 10) = 15
-     *         4 5 | // D2 hi_lo = (93 / 10) * (75 % 10) = 45
-     *         2 1 | // D2 lo_hi = (93 % 10) * (75 / 10) = 21
-     *     + 6 3 | | // D2 hi_hi = (93 / 10) * (75 / 10) = 63
-     *     ---------
-     *         2 7 | // D2 cross = (15 / 10) + (45 % 10) + 21 = 27
-     *     + 6 7 | | // D2 upper = (27 / 10) + (45 / 10) + 63 = 67
-     *     ---------
-     *       6 9 7 5 // D4 res = (27 * 10) + (15 % 10) + (67 * 100) = 6975
-     *
-     * The reasons for adding the products like this are:
-     *  1. It avoids manual carry tracking. Just like how
-     *     (9 * 9) + 9 + 9 = 99, the same applies with this for UINT64_MAX.
-     *     This avoids a lot of complexity.
-     *
-     *  2. It hints for, and on Clang, compiles to, the powerful UMAAL
-     *     instruction available in ARM's Digital Signal Processing extension
-     *     in 32-bit ARMv6 and later, which is shown below:
-     *
-     *         void UMAAL(xxh_u32 *RdLo, xxh_u32 *RdHi, xxh_u32 Rn, xxh_u32 Rm)
-     *         {
-     *             xxh_u64 product = (xxh_u64)*RdLo * (xxh_u64)*RdHi + Rn + Rm;
-     *             *RdLo = (xxh_u32)(product & 0xFFFFFFFF);
-     *             *RdHi = (xxh_u32)(product >> 32);
-     *         }
-     *
-     *     This instruction was designed for efficient long multiplication, and
-     *     allows this to be calculated in only 4 instructions at speeds
-     *     comparable to some 64-bit ALUs.
-     *
-     *  3. It isn't terrible on other platforms. Usually this will be a couple
-     *     of 32-bit ADD/ADCs.
-     */
+XXH_FORCE_INLINE void
+XXH3_hashLong_internal_loop(xxh_u64* XXH_RESTRICT acc,
+                      const xxh_u8* XXH_RESTRICT input, size_t len,
+                      const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                            size_t prefetchDist,
+                            XXH3_f_accumulate f_acc,
+                            XXH3_f_scrambleAcc f_scramble)
+{
+    size_t const nbStripesPerBlock = XXH3_NB_STRIPES_PER_BLOCK(secretSize);
+    XXH3_hashLong_internal_loop_geometry(acc, input, len, secret, secretSize,
+                                         nbStripesPerBlock, XXH_STRIPE_LEN * nbStripesPerBlock,
+                                         prefetchDist, f_acc, f_scramble);
+}
 
-    /* First calculate all of the cross products. */
-    xxh_u64 const lo_lo = XXH_mult32to64(lhs & 0xFFFFFFFF, rhs & 0xFFFFFFFF);
-    xxh_u64 const hi_lo = XXH_mult32to64(lhs >> 32,        rhs & 0xFFFFFFFF);
-    xxh_u64 const lo_hi = XXH_mult32to64(lhs & 0xFFFFFFFF, rhs >> 32);
-    xxh_u64 const hi_hi = XXH_mult32to64(lhs >> 32,        rhs >> 32);
+XXH_FORCE_INLINE xxh_u64
+XXH3_mix2Accs(const xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT secret)
+{
+    return XXH3_mul128_fold64(
+               acc[0] ^ XXH_readLE64(secret),
+               acc[1] ^ XXH_readLE64(secret+8) );
+}
 
-    /* Now add the products together. These will never overflow. */
-    xxh_u64 const cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
-    xxh_u64 const upper = (hi_lo >> 32) + (cross >> 32)        + hi_hi;
-    xxh_u64 const lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+static XXH64_hash_t
+XXH3_mergeAccs(const xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT secret, xxh_u64 start)
+{
+    xxh_u64 result64 = start;
+    size_t i = 0;
 
-    XXH128_hash_t r128;
-    r128.low64  = lower;
-    r128.high64 = upper;
-    return r128;
+    for (i = 0; i < 4; i++) {
+        result64 += XXH3_mix2Accs(acc+2*i, secret + 16*i);
+#if defined(__clang__)                                /* Clang */ \
+    && (defined(__arm__) || defined(__thumb__))       /* ARMv7 */ \
+    && (defined(__ARM_NEON) || defined(__ARM_NEON__)) /* NEON */  \
+    && !defined(XXH_ENABLE_AUTOVECTORIZE)             /* Define to disable */
+        /*
+         * UGLY HACK:
+         * Prevent autovectorization on Clang ARMv7-a. Exact same problem as
+         * the one in XXH3_len_129to240_64b. Speeds up shorter keys > 240b.
+         * XXH3_64bits, len == 256, Snapdragon 835:
+         *   without hack: 2063.7 MB/s
+         *   with hack:    2560.7 MB/s
+         */
+        XXH_COMPILER_GUARD(result64);
 #endif
-}
+    }
 
-/*!
- * @brief Calculates a 64-bit to 128-bit multiply, then XOR folds it.
- *
- * The reason for the separate function is to prevent passing too many structs
- * around by value. This will hopefully inline the multiply, but we don't force it.
- *
- * @param lhs , rhs The 64-bit integers to multiply
- * @return The low 64 bits of the product XOR'd by the high 64 bits.
- * @see XXH_mult64to128()
- */
-static xxh_u64
-XXH3_mul128_fold64(xxh_u64 lhs, xxh_u64 rhs)
-{
-    XXH128_hash_t product = XXH_mult64to128(lhs, rhs);
-    return product.low64 ^ product.high64;
+    return XXH3_avalanche(result64);
 }
 
-/*! Seems to produce slightly better code on GCC for some reason. */
-XXH_FORCE_INLINE XXH_CONSTF xxh_u64 XXH_xorshift64(xxh_u64 v64, int shift)
+#define XXH3_INIT_ACC { XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3, \
+                        XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1 }
+
+XXH_FORCE_INLINE XXH64_hash_t
+XXH3_hashLong_64b_internal(const void* XXH_RESTRICT input, size_t len,
+                           const void* XXH_RESTRICT secret, size_t secretSize,
+                           size_t prefetchDist,
+                           XXH3_f_accumulate f_acc,
+                           XXH3_f_scrambleAcc f_scramble)
 {
-    XXH_ASSERT(0 <= shift && shift < 64);
-    return v64 ^ (v64 >> shift);
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+
+    XXH3_hashLong_internal_loop(acc, (const xxh_u8*)input, len, (const xxh_u8*)secret, secretSize, prefetchDist, f_acc, f_scramble);
+
+    /* converge into final hash */
+    XXH_STATIC_ASSERT(sizeof(acc) == 64);
+    /* do not align on 8, so that the secret is different from the accumulator */
+#define XXH_SECRET_MERGEACCS_START 11
+    XXH_ASSERT(secretSize >= sizeof(acc) + XXH_SECRET_MERGEACCS_START);
+    return XXH3_mergeAccs(acc, (const xxh_u8*)secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
 }
 
 /*
- * This is a fast avalanche stage,
- * suitable when input bits are already partially mixed
+ * It's important for performance to transmit secret's size (when it's static)
+ * so that the compiler can properly optimize the vectorized loop.
+ * This makes a big performance difference for "medium" keys (<1 KB) when using AVX instruction set.
+ * When the secret size is unknown, or on GCC 12 where the mix of NO_INLINE and FORCE_INLINE
+ * breaks -Og, this is XXH_NO_INLINE.
  */
-static XXH64_hash_t XXH3_avalanche(xxh_u64 h64)
+XXH3_WITH_SECRET_INLINE XXH64_hash_t
+XXH3_hashLong_64b_withSecret(const void* XXH_RESTRICT input, size_t len,
+                             XXH64_hash_t seed64, const xxh_u8* XXH_RESTRICT secret, size_t secretLen)
 {
-    h64 = XXH_xorshift64(h64, 37);
-    h64 *= PRIME_MX1;
-    h64 = XXH_xorshift64(h64, 32);
-    return h64;
+    (void)seed64;
+    return XXH3_hashLong_64b_internal(input, len, secret, secretLen, XXH_PREFETCH_DIST, XXH3_accumulate, XXH3_scrambleAcc);
 }
 
 /*
- * This is a stronger avalanche,
- * inspired by Pelle Evensen's rrmxmx
- * preferable when input has not been previously mixed
+ * It's preferable for performance that XXH3_hashLong is not inlined,
+ * as it results in a smaller function for small data, easier to the instruction cache.
+ * Note that inside this no_inline function, we do inline the internal loop,
+ * and provide a statically defined secret size to allow optimization of vector loop.
  */
-static XXH64_hash_t XXH3_rrmxmx(xxh_u64 h64, xxh_u64 len)
+XXH_NO_INLINE XXH_PUREF XXH64_hash_t
+XXH3_hashLong_64b_default(const void* XXH_RESTRICT input, size_t len,
+                          XXH64_hash_t seed64, const xxh_u8* XXH_RESTRICT secret, size_t secretLen)
 {
-    /* this mix is inspired by Pelle Evensen's rrmxmx */
-    h64 ^= XXH_rotl64(h64, 49) ^ XXH_rotl64(h64, 24);
-    h64 *= PRIME_MX2;
-    h64 ^= (h64 >> 35) + len ;
-    h64 *= PRIME_MX2;
-    return XXH_xorshift64(h64, 28);
+    (void)seed64; (void)secret; (void)secretLen;
+    return XXH3_hashLong_64b_internal(input, len, XXH3_kSecret, sizeof(XXH3_kSecret), XXH_PREFETCH_DIST, XXH3_accumulate, XXH3_scrambleAcc);
 }
 
-
-/* ==========================================
- * Short keys
- * ==========================================
- * One of the shortcomings of XXH32 and XXH64 was that their performance was
- * sub-optimal on short lengths. It used an iterative algorithm which strongly
- * favored lengths that were a multiple of 4 or 8.
- *
- * Instead of iterating over individual inputs, we use a set of single shot
- * functions which piece together a range of lengths and operate in constant time.
- *
- * Additionally, the number of multiplies has been significantly reduced. This
- * reduces latency, especially when emulating 64-bit multiplies on 32-bit.
- *
- * Depending on the platform, this may or may not be faster than XXH32, but it
- * is almost guaranteed to be faster than XXH64.
- */
-
 /*
- * At very short lengths, there isn't enough input to fully hide secrets, or use
- * the entire secret.
- *
- * There is also only a limited amount of mixing we can do before significantly
- * impacting performance.
- *
- * Therefore, we use different sections of the secret and always mix two secret
- * samples with an XOR. This should have no effect on performance on the
- * seedless or withSeed variants because everything _should_ be constant folded
- * by modern compilers.
+ * XXH3_hashLong_64b_withSeed():
+ * Generate a custom key based on alteration of default XXH3_kSecret with the seed,
+ * and then use this key for long mode hashing.
  *
- * The XOR mixing hides individual parts of the secret and increases entropy.
+ * This operation is decently fast but nonetheless costs a little bit of time.
+ * Try to avoid it whenever possible (typically when seed==0).
  *
- * This adds an extra layer of strength for custom secrets.
+ * It's important for performance that XXH3_hashLong is not inlined. Not sure
+ * why (uop cache maybe?), but the difference is large and easily measurable.
  */
-XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
-XXH3_len_1to3_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+XXH_FORCE_INLINE XXH64_hash_t
+XXH3_hashLong_64b_withSeed_internal(const void* input, size_t len,
+                                    XXH64_hash_t seed,
+                                    XXH3_f_accumulate f_acc,
+                                    XXH3_f_scrambleAcc f_scramble,
+                                    XXH3_f_initCustomSecret f_initSec)
 {
-    XXH_ASSERT(input != NULL);
-    XXH_ASSERT(1 <= len && len <= 3);
-    XXH_ASSERT(secret != NULL);
-    /*
-     * len = 1: combined = { input[0], 0x01, input[0], input[0] }
-     * len = 2: combined = { input[1], 0x02, input[0], input[1] }
-     * len = 3: combined = { input[2], 0x03, input[0], input[1] }
-     */
-    {   xxh_u8  const c1 = input[0];
-        xxh_u8  const c2 = input[len >> 1];
-        xxh_u8  const c3 = input[len - 1];
-        xxh_u32 const combined = ((xxh_u32)c1 << 16) | ((xxh_u32)c2  << 24)
-                               | ((xxh_u32)c3 <<  0) | ((xxh_u32)len << 8);
-        xxh_u64 const bitflip = (XXH_readLE32(secret) ^ XXH_readLE32(secret+4)) + seed;
-        xxh_u64 const keyed = (xxh_u64)combined ^ bitflip;
-        return XXH64_avalanche(keyed);
+#if XXH_SIZE_OPT <= 0
+    if (seed == 0)
+        return XXH3_hashLong_64b_internal(input, len,
+                                          XXH3_kSecret, sizeof(XXH3_kSecret), XXH_PREFETCH_DIST,
+                                          f_acc, f_scramble);
+#endif
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
+        f_initSec(secret, seed);
+        return XXH3_hashLong_64b_internal(input, len, secret, sizeof(secret), XXH_PREFETCH_DIST,
+                                          f_acc, f_scramble);
     }
 }
 
-XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
-XXH3_len_4to8_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+/*
+ * It's important for performance that XXH3_hashLong is not inlined.
+ */
+XXH_NO_INLINE XXH64_hash_t
+XXH3_hashLong_64b_withSeed(const void* XXH_RESTRICT input, size_t len,
+                           XXH64_hash_t seed, const xxh_u8* XXH_RESTRICT secret, size_t secretLen)
 {
-    XXH_ASSERT(input != NULL);
-    XXH_ASSERT(secret != NULL);
-    XXH_ASSERT(4 <= len && len <= 8);
-    seed ^= (xxh_u64)XXH_swap32((xxh_u32)seed) << 32;
-    {   xxh_u32 const input1 = XXH_readLE32(input);
-        xxh_u32 const input2 = XXH_readLE32(input + len - 4);
-        xxh_u64 const bitflip = (XXH_readLE64(secret+8) ^ XXH_readLE64(secret+16)) - seed;
-        xxh_u64 const input64 = input2 + (((xxh_u64)input1) << 32);
-        xxh_u64 const keyed = input64 ^ bitflip;
-        return XXH3_rrmxmx(keyed, len);
-    }
+    (void)secret; (void)secretLen;
+    return XXH3_hashLong_64b_withSeed_internal(input, len, seed,
+                XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
 }
 
-XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
-XXH3_len_9to16_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
-{
-    XXH_ASSERT(input != NULL);
-    XXH_ASSERT(secret != NULL);
-    XXH_ASSERT(9 <= len && len <= 16);
-    {   xxh_u64 const bitflip1 = (XXH_readLE64(secret+24) ^ XXH_readLE64(secret+32)) + seed;
-        xxh_u64 const bitflip2 = (XXH_readLE64(secret+40) ^ XXH_readLE64(secret+48)) - seed;
-        xxh_u64 const input_lo = XXH_readLE64(input)           ^ bitflip1;
-        xxh_u64 const input_hi = XXH_readLE64(input + len - 8) ^ bitflip2;
-        xxh_u64 const acc = len
-                          + XXH_swap64(input_lo) + input_hi
-                          + XXH3_mul128_fold64(input_lo, input_hi);
-        return XXH3_avalanche(acc);
-    }
-}
 
-XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
-XXH3_len_0to16_64b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+typedef XXH64_hash_t (*XXH3_hashLong64_f)(const void* XXH_RESTRICT, size_t,
+                                          XXH64_hash_t, const xxh_u8* XXH_RESTRICT, size_t);
+
+XXH_FORCE_INLINE XXH64_hash_t
+XXH3_64bits_internal(const void* XXH_RESTRICT input, size_t len,
+                     XXH64_hash_t seed64, const void* XXH_RESTRICT secret, size_t secretLen,
+                     XXH3_hashLong64_f f_hashLong)
 {
-    XXH_ASSERT(len <= 16);
-    {   if (XXH_likely(len >  8)) return XXH3_len_9to16_64b(input, len, secret, seed);
-        if (XXH_likely(len >= 4)) return XXH3_len_4to8_64b(input, len, secret, seed);
-        if (len) return XXH3_len_1to3_64b(input, len, secret, seed);
-        return XXH64_avalanche(seed ^ (XXH_readLE64(secret+56) ^ XXH_readLE64(secret+64)));
-    }
+    XXH_ASSERT(secretLen >= XXH3_SECRET_SIZE_MIN);
+    /*
+     * If an action is to be taken if `secretLen` condition is not respected,
+     * it should be done here.
+     * For now, it's a contract pre-condition.
+     * Adding a check and a branch here would cost performance at every hash.
+     * Also, note that function signature doesn't offer room to return an error.
+     */
+    if (len <= 16)
+        return XXH3_len_0to16_64b((const xxh_u8*)input, len, (const xxh_u8*)secret, seed64, XXH3_asIs);
+    if (len <= 128)
+        return XXH3_len_17to128_64b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64, XXH3_asIs);
+    if (len <= XXH3_MIDSIZE_MAX)
+        return XXH3_len_129to240_64b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64);
+    return f_hashLong(input, len, seed64, (const xxh_u8*)secret, secretLen);
 }
 
+
+/* ===   Public entry point   === */
+
 /*
- * DISCLAIMER: There are known *seed-dependent* multicollisions here due to
- * multiplication by zero, affecting hashes of lengths 17 to 240.
- *
- * However, they are very unlikely.
- *
- * Keep this in mind when using the unseeded XXH3_64bits() variant: As with all
- * unseeded non-cryptographic hashes, it does not attempt to defend itself
- * against specially crafted inputs, only random inputs.
- *
- * Compared to classic UMAC where a 1 in 2^31 chance of 4 consecutive bytes
- * cancelling out the secret is taken an arbitrary number of times (addressed
- * in XXH3_accumulate_512), this collision is very unlikely with random inputs
- * and/or proper seeding:
- *
- * This only has a 1 in 2^63 chance of 8 consecutive bytes cancelling out, in a
- * function that is only called up to 16 times per hash with up to 240 bytes of
- * input.
- *
- * This is not too bad for a non-cryptographic hash function, especially with
- * only 64 bit outputs.
- *
- * The 128-bit variant (which trades some speed for strength) is NOT affected
- * by this, although it is always a good idea to use a proper seed if you care
- * about strength.
+ * NUL-terminated strings are hashed with XXH3_64bits(str, strlen(str)).
+ * Searching for the terminator while hashing can't read past it, so it
+ * relies on memchr() and ends up slower than strlen() followed by XXH3,
+ * except for strings larger than the cache.
  */
-XXH_FORCE_INLINE xxh_u64 XXH3_mix16B(const xxh_u8* XXH_RESTRICT input,
-                                     const xxh_u8* XXH_RESTRICT secret, xxh_u64 seed64)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t XXH3_64bits(XXH_NOESCAPE const void* input, size_t length)
 {
-#if defined(__GNUC__) && !defined(__clang__) /* GCC, not Clang */ \
-  && defined(__i386__) && defined(__SSE2__)  /* x86 + SSE2 */ \
-  && !defined(XXH_ENABLE_AUTOVECTORIZE)      /* Define to disable like XXH32 hack */
-    /*
-     * UGLY HACK:
-     * GCC for x86 tends to autovectorize the 128-bit multiply, resulting in
-     * slower code.
-     *
-     * By forcing seed64 into a register, we disrupt the cost model and
-     * cause it to scalarize. See `XXH32_round()`
-     *
-     * FIXME: Clang's output is still _much_ faster -- On an AMD Ryzen 3600,
-     * XXH3_64bits @ len=240 runs at 4.6 GB/s with Clang 9, but 3.3 GB/s on
-     * GCC 9.2, despite both emitting scalar code.
-     *
-     * GCC generates much better scalar code than Clang for the rest of XXH3,
-     * which is why finding a more optimal codepath is an interest.
-     */
-    XXH_COMPILER_GUARD(seed64);
-#endif
-    {   xxh_u64 const input_lo = XXH_readLE64(input);
-        xxh_u64 const input_hi = XXH_readLE64(input+8);
-        return XXH3_mul128_fold64(
-            input_lo ^ (XXH_readLE64(secret)   + seed64),
-            input_hi ^ (XXH_readLE64(secret+8) - seed64)
-        );
-    }
+    return XXH3_64bits_internal(input, length, 0, XXH3_kSecret, sizeof(XXH3_kSecret), XXH3_hashLong_64b_default);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_withSecret(XXH_NOESCAPE const void* input, size_t length, XXH_NOESCAPE const void* secret, size_t secretSize)
+{
+    return XXH3_64bits_internal(input, length, 0, secret, secretSize, XXH3_hashLong_64b_withSecret);
 }
 
-/* For mid range keys, XXH3 uses a Mum-hash variant. */
-XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
-XXH3_len_17to128_64b(const xxh_u8* XXH_RESTRICT input, size_t len,
-                     const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
-                     XXH64_hash_t seed)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed)
 {
-    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
-    XXH_ASSERT(16 < len && len <= 128);
-
-    {   xxh_u64 acc = len * XXH_PRIME64_1;
-#if XXH_SIZE_OPT >= 1
-        /* Smaller and cleaner, but slightly slower. */
-        unsigned int i = (unsigned int)(len - 1) / 32;
-        do {
-            acc += XXH3_mix16B(input+16 * i, secret+32*i, seed);
-            acc += XXH3_mix16B(input+len-16*(i+1), secret+32*i+16, seed);
-        } while (i-- != 0);
-#else
-        if (len > 32) {
-            if (len > 64) {
-                if (len > 96) {
-                    acc += XXH3_mix16B(input+48, secret+96, seed);
-                    acc += XXH3_mix16B(input+len-64, secret+112, seed);
-                }
-                acc += XXH3_mix16B(input+32, secret+64, seed);
-                acc += XXH3_mix16B(input+len-48, secret+80, seed);
-            }
-            acc += XXH3_mix16B(input+16, secret+32, seed);
-            acc += XXH3_mix16B(input+len-32, secret+48, seed);
-        }
-        acc += XXH3_mix16B(input+0, secret+0, seed);
-        acc += XXH3_mix16B(input+len-16, secret+16, seed);
-#endif
-        return XXH3_avalanche(acc);
-    }
+    return XXH3_64bits_internal(input, length, seed, XXH3_kSecret, sizeof(XXH3_kSecret), XXH3_hashLong_64b_withSeed);
 }
 
-XXH_NO_INLINE XXH_PUREF XXH64_hash_t
-XXH3_len_129to240_64b(const xxh_u8* XXH_RESTRICT input, size_t len,
-                      const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
-                      XXH64_hash_t seed)
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_withSecretandSeed(XXH_NOESCAPE const void* input, size_t length, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed)
 {
-    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
-    XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
+    if (length <= XXH3_MIDSIZE_MAX)
+        return XXH3_64bits_internal(input, length, seed, XXH3_kSecret, sizeof(XXH3_kSecret), NULL);
+    return XXH3_hashLong_64b_withSecret(input, length, seed, (const xxh_u8*)secret, secretSize);
+}
 
-    #define XXH3_MIDSIZE_STARTOFFSET 3
-    #define XXH3_MIDSIZE_LASTOFFSET  17
 
-    {   xxh_u64 acc = len * XXH_PRIME64_1;
-        xxh_u64 acc_end;
-        unsigned int const nbRounds = (unsigned int)len / 16;
-        unsigned int i;
-        XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
-        for (i=0; i<8; i++) {
-            acc += XXH3_mix16B(input+(16*i), secret+(16*i), seed);
-        }
-        /* last bytes */
-        acc_end = XXH3_mix16B(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed);
-        XXH_ASSERT(nbRounds >= 8);
-        acc = XXH3_avalanche(acc);
-#if defined(__clang__)                                /* Clang */ \
-    && (defined(__ARM_NEON) || defined(__ARM_NEON__)) /* NEON */ \
-    && !defined(XXH_ENABLE_AUTOVECTORIZE)             /* Define to disable */
-        /*
-         * UGLY HACK:
-         * Clang for ARMv7-A tries to vectorize this loop, similar to GCC x86.
-         * In everywhere else, it uses scalar code.
-         *
-         * For 64->128-bit multiplies, even if the NEON was 100% optimal, it
-         * would still be slower than UMAAL (see XXH_mult64to128).
-         *
-         * Unfortunately, Clang doesn't handle the long multiplies properly and
-         * converts them to the nonexistent "vmulq_u64" intrinsic, which is then
-         * scalarized into an ugly mess of VMOV.32 instructions.
-         *
-         * This mess is difficult to avoid without turning autovectorization
-         * off completely, but they are usually relatively minor and/or not
-         * worth it to fix.
-         *
-         * This loop is the easiest to fix, as unlike XXH32, this pragma
-         * _actually works_ because it is a loop vectorization instead of an
-         * SLP vectorization.
-         */
-        #pragma clang loop vectorize(disable)
+/* ===   Batch of keys   === */
+
+/*!
+ * @brief Distance, in number of keys, at which XXH3_64bits_batch() prefetches.
+ */
+#ifndef XXH3_BATCH_PREFETCH_DIST
+#  define XXH3_BATCH_PREFETCH_DIST 8
 #endif
-        for (i=8 ; i < nbRounds; i++) {
-            /*
-             * Prevents clang for unrolling the acc loop and interleaving with this one.
-             */
-            XXH_COMPILER_GUARD(acc);
-            acc_end += XXH3_mix16B(input+(16*i), secret+(16*(i-8)) + XXH3_MIDSIZE_STARTOFFSET, seed);
+
+XXH_FORCE_INLINE XXH64_hash_t
+XXH3_64bits_batchKey(const void* XXH_RESTRICT input, size_t len)
+{
+    return XXH3_64bits_internal(input, len, 0, XXH3_kSecret, sizeof(XXH3_kSecret), XXH3_hashLong_64b_default);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_64bits_batch(XXH_NOESCAPE const void* const* ptrs, XXH_NOESCAPE const size_t* lens,
+                  size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    size_t n;
+    XXH_ASSERT(nbKeys == 0 || (ptrs != NULL && lens != NULL && out != NULL));
+    /*
+     * Keys are typically scattered in memory: while a key is hashed,
+     * the one further down the list is prefetched, including its last byte
+     * when it crosses a cache line.
+     */
+    for (n = 0; n < nbKeys; n++) {
+        if (n + XXH3_BATCH_PREFETCH_DIST < nbKeys) {
+            const xxh_u8* const next = (const xxh_u8*)ptrs[n + XXH3_BATCH_PREFETCH_DIST];
+            size_t const nextLen = lens[n + XXH3_BATCH_PREFETCH_DIST];
+            XXH_PREFETCH(next);
+            XXH_PREFETCH(next + (nextLen ? nextLen - 1 : 0));
         }
-        return XXH3_avalanche(acc + acc_end);
+        out[n] = XXH3_64bits_batchKey(ptrs[n], lens[n]);
     }
 }
 
+/* ===   Arrays of integer keys   === */
 
-/* =======     Long Keys     ======= */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_64bits_u32_array(XXH_NOESCAPE const XXH32_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    XXH_ASSERT(nbKeys == 0 || (keys != NULL && out != NULL));
+    XXH3_hashU32Array(keys, nbKeys, out);
+}
 
-#define XXH_STRIPE_LEN 64
-#define XXH_SECRET_CONSUME_RATE 8   /* nb of secret bytes consumed at each accumulation */
-#define XXH_ACC_NB (XXH_STRIPE_LEN / sizeof(xxh_u64))
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_64bits_u64_array(XXH_NOESCAPE const XXH64_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    XXH_ASSERT(nbKeys == 0 || (keys != NULL && out != NULL));
+    XXH3_hashU64Array(keys, nbKeys, out);
+}
 
-#ifdef XXH_OLD_NAMES
-#  define STRIPE_LEN XXH_STRIPE_LEN
-#  define ACC_NB XXH_ACC_NB
-#endif
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_64bits_u128_array(XXH_NOESCAPE const XXH128_hash_t* keys, size_t nbKeys, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    size_t n = 0;
+    XXH_ASSERT(nbKeys == 0 || (keys != NULL && out != NULL));
+    XXH_STATIC_ASSERT(sizeof(keys[0]) == 16);
+    for (; n + 2 <= nbKeys; n += 2) {
+        XXH64_hash_t const h0 = XXH3_len_9to16_64b((const xxh_u8*)(keys + n + 0), sizeof(keys[0]), XXH3_kSecret, 0, XXH3_asIs);
+        XXH64_hash_t const h1 = XXH3_len_9to16_64b((const xxh_u8*)(keys + n + 1), sizeof(keys[0]), XXH3_kSecret, 0, XXH3_asIs);
+        out[n+0] = h0;
+        out[n+1] = h1;
+    }
+    for (; n < nbKeys; n++) {
+        out[n] = XXH3_len_9to16_64b((const xxh_u8*)(keys + n), sizeof(keys[0]), XXH3_kSecret, 0, XXH3_asIs);
+    }
+}
 
-#ifndef XXH_PREFETCH_DIST
-#  ifdef __clang__
-#    define XXH_PREFETCH_DIST 320
-#  else
-#    if (XXH_VECTOR == XXH_AVX512)
-#      define XXH_PREFETCH_DIST 512
-#    else
-#      define XXH_PREFETCH_DIST 384
-#    endif
-#  endif  /* __clang__ */
-#endif  /* XXH_PREFETCH_DIST */
 
-/*
- * These macros are to generate an XXH3_accumulate() function.
- * The two arguments select the name suffix and target attribute.
+/*!
+ * @internal
+ * @brief Processes a large input for XXH3_update(), XXH3_digest_long()
+ *        and scatter-gather hashing.
  *
- * The name of this symbol is XXH3_accumulate_<name>() and it calls
- * XXH3_accumulate_512_<name>().
+ * Unlike XXH3_hashLong_internal_loop(), this can process data that overlaps a block.
  *
- * It may be useful to hand implement this function if the compiler fails to
- * optimize the inline function.
+ * @param acc                Pointer to the 8 accumulator lanes
+ * @param nbStripesSoFarPtr  In/out pointer to the number of leftover stripes in the block*
+ * @param nbStripesPerBlock  Number of stripes in a block
+ * @param input              Input pointer
+ * @param nbStripes          Number of stripes to process
+ * @param secret             Secret pointer
+ * @param secretLimit        Offset of the last block in @p secret
+ * @param f_acc              Pointer to an XXH3_accumulate implementation
+ * @param f_scramble         Pointer to an XXH3_scrambleAcc implementation
+ * @return                   Pointer past the end of @p input after processing
  */
-#define XXH3_ACCUMULATE_TEMPLATE(name)                      \
-void                                                        \
-XXH3_accumulate_##name(xxh_u64* XXH_RESTRICT acc,           \
-                       const xxh_u8* XXH_RESTRICT input,    \
-                       const xxh_u8* XXH_RESTRICT secret,   \
-                       size_t nbStripes)                    \
-{                                                           \
-    size_t n;                                               \
-    for (n = 0; n < nbStripes; n++ ) {                      \
-        const xxh_u8* const in = input + n*XXH_STRIPE_LEN;  \
-        XXH_PREFETCH(in + XXH_PREFETCH_DIST);               \
-        XXH3_accumulate_512_##name(                         \
-                 acc,                                       \
-                 in,                                        \
-                 secret + n*XXH_SECRET_CONSUME_RATE);       \
-    }                                                       \
-}
-
-
-XXH_FORCE_INLINE void XXH_writeLE64(void* dst, xxh_u64 v64)
+XXH_FORCE_INLINE const xxh_u8 *
+XXH3_consumeStripes(xxh_u64* XXH_RESTRICT acc,
+                    size_t* XXH_RESTRICT nbStripesSoFarPtr, size_t nbStripesPerBlock,
+                    const xxh_u8* XXH_RESTRICT input, size_t nbStripes,
+                    const xxh_u8* XXH_RESTRICT secret, size_t secretLimit,
+                    XXH3_f_accumulate f_acc,
+                    XXH3_f_scrambleAcc f_scramble)
 {
-    if (!XXH_CPU_LITTLE_ENDIAN) v64 = XXH_swap64(v64);
-    XXH_memcpy(dst, &v64, sizeof(v64));
+    const xxh_u8* initialSecret = secret + *nbStripesSoFarPtr * XXH_SECRET_CONSUME_RATE;
+    /* Process full blocks */
+    if (nbStripes >= (nbStripesPerBlock - *nbStripesSoFarPtr)) {
+        /* Process the initial partial block... */
+        size_t nbStripesThisIter = nbStripesPerBlock - *nbStripesSoFarPtr;
+
+        do {
+            /* Accumulate and scramble */
+            f_acc(acc, input, initialSecret, nbStripesThisIter, XXH_PREFETCH_DIST);
+            f_scramble(acc, secret + secretLimit);
+            input += nbStripesThisIter * XXH_STRIPE_LEN;
+            nbStripes -= nbStripesThisIter;
+            /* Then continue the loop with the full block size */
+            nbStripesThisIter = nbStripesPerBlock;
+            initialSecret = secret;
+        } while (nbStripes >= nbStripesPerBlock);
+        *nbStripesSoFarPtr = 0;
+    }
+    /* Process a partial block */
+    if (nbStripes > 0) {
+        f_acc(acc, input, initialSecret, nbStripes, XXH_PREFETCH_DIST);
+        input += nbStripes * XXH_STRIPE_LEN;
+        *nbStripesSoFarPtr += nbStripes;
+    }
+    /* Return end pointer */
+    return input;
 }
 
-/* Several intrinsic functions below are supposed to accept __int64 as argument,
- * as documented in https://software.intel.com/sites/landingpage/IntrinsicsGuide/ .
- * However, several environments do not define __int64 type,
- * requiring a workaround.
+
+/* ===   XXH3 streaming   === */
+#ifndef XXH_NO_STREAM
+/*
+ * Malloc's a pointer that is always aligned to @align.
+ *
+ * This must be freed with `XXH_alignedFree()`.
+ *
+ * malloc typically guarantees 16 byte alignment on 64-bit systems and 8 byte
+ * alignment on 32-bit. This isn't enough for the 32 byte aligned loads in AVX2
+ * or on 32-bit, the 16 byte aligned loads in SSE2 and NEON.
+ *
+ * This underalignment previously caused a rather obvious crash which went
+ * completely unnoticed due to XXH3_createState() not actually being tested.
+ * Credit to RedSpah for noticing this bug.
+ *
+ * The alignment is done manually: Functions like posix_memalign or _mm_malloc
+ * are avoided: To maintain portability, we would have to write a fallback
+ * like this anyways, and besides, testing for the existence of library
+ * functions without relying on external build tools is impossible.
+ *
+ * The method is simple: Overallocate, manually align, and store the offset
+ * to the original behind the returned pointer.
+ *
+ * Align must be a power of 2 and 8 <= align <= 128.
  */
-#if !defined (__VMS) \
-  && (defined (__cplusplus) \
-  || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */) )
-    typedef int64_t xxh_i64;
-#else
-    /* the following type must have a width of 64-bit */
-    typedef long long xxh_i64;
-#endif
+static XXH_MALLOCF void* XXH_alignedMalloc(size_t s, size_t align)
+{
+    XXH_ASSERT(align <= 128 && align >= 8); /* range check */
+    XXH_ASSERT((align & (align-1)) == 0);   /* power of 2 */
+    XXH_ASSERT(s != 0 && s < (s + align));  /* empty/overflow */
+    {   /* Overallocate to make room for manual realignment and an offset byte */
+        xxh_u8* base = (xxh_u8*)XXH_malloc(s + align);
+        if (base != NULL) {
+            /*
+             * Get the offset needed to align this pointer.
+             *
+             * Even if the returned pointer is aligned, there will always be
+             * at least one byte to store the offset to the original pointer.
+             */
+            size_t offset = align - ((size_t)base & (align - 1)); /* base % align */
+            /* Add the offset for the now-aligned pointer */
+            xxh_u8* ptr = base + offset;
 
+            XXH_ASSERT((size_t)ptr % align == 0);
 
+            /* Store the offset immediately before the returned pointer. */
+            ptr[-1] = (xxh_u8)offset;
+            return ptr;
+        }
+        return NULL;
+    }
+}
 /*
- * XXH3_accumulate_512 is the tightest loop for long inputs, and it is the most optimized.
- *
- * It is a hardened version of UMAC, based off of FARSH's implementation.
- *
- * This was chosen because it adapts quite well to 32-bit, 64-bit, and SIMD
- * implementations, and it is ridiculously fast.
- *
- * We harden it by mixing the original input to the accumulators as well as the product.
- *
- * This means that in the (relatively likely) case of a multiply by zero, the
- * original input is preserved.
+ * Frees an aligned pointer allocated by XXH_alignedMalloc(). Don't pass
+ * normal malloc'd pointers, XXH_alignedMalloc has a specific data layout.
+ */
+static void XXH_alignedFree(void* p)
+{
+    if (p != NULL) {
+        xxh_u8* ptr = (xxh_u8*)p;
+        /* Get the offset byte we added in XXH_malloc. */
+        xxh_u8 offset = ptr[-1];
+        /* Free the original malloc'd pointer */
+        xxh_u8* base = ptr - offset;
+        XXH_free(base);
+    }
+}
+/*! @ingroup XXH3_family */
+/*!
+ * @brief Allocate an @ref XXH3_state_t.
  *
- * On 128-bit inputs, we swap 64-bit pairs when we add the input to improve
- * cross-pollination, as otherwise the upper and lower halves would be
- * essentially independent.
+ * @return An allocated pointer of @ref XXH3_state_t on success.
+ * @return `NULL` on failure.
  *
- * This doesn't matter on 64-bit hashes since they all get merged together in
- * the end, so we skip the extra step.
+ * @note Must be freed with XXH3_freeState().
  *
- * Both XXH3_64bits and XXH3_128bits use this subroutine.
+ * @see @ref streaming_example "Streaming Example"
  */
-
-#if (XXH_VECTOR == XXH_AVX512) \
-     || (defined(XXH_DISPATCH_AVX512) && XXH_DISPATCH_AVX512 != 0)
-
-#ifndef XXH_TARGET_AVX512
-# define XXH_TARGET_AVX512  /* disable attribute target */
-#endif
-
-XXH_FORCE_INLINE XXH_TARGET_AVX512 void
-XXH3_accumulate_512_avx512(void* XXH_RESTRICT acc,
-                     const void* XXH_RESTRICT input,
-                     const void* XXH_RESTRICT secret)
+XXH_PUBLIC_API XXH3_state_t* XXH3_createState(void)
 {
-    __m512i* const xacc = (__m512i *) acc;
-    XXH_ASSERT((((size_t)acc) & 63) == 0);
-    XXH_STATIC_ASSERT(XXH_STRIPE_LEN == sizeof(__m512i));
-
-    {
-        /* data_vec    = input[0]; */
-        __m512i const data_vec    = _mm512_loadu_si512   (input);
-        /* key_vec     = secret[0]; */
-        __m512i const key_vec     = _mm512_loadu_si512   (secret);
-        /* data_key    = data_vec ^ key_vec; */
-        __m512i const data_key    = _mm512_xor_si512     (data_vec, key_vec);
-        /* data_key_lo = data_key >> 32; */
-        __m512i const data_key_lo = _mm512_srli_epi64 (data_key, 32);
-        /* product     = (data_key & 0xffffffff) * (data_key_lo & 0xffffffff); */
-        __m512i const product     = _mm512_mul_epu32     (data_key, data_key_lo);
-        /* xacc[0] += swap(data_vec); */
-        __m512i const data_swap = _mm512_shuffle_epi32(data_vec, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
-        __m512i const sum       = _mm512_add_epi64(*xacc, data_swap);
-        /* xacc[0] += product; */
-        *xacc = _mm512_add_epi64(product, sum);
-    }
+    XXH3_state_t* const state = (XXH3_state_t*)XXH_alignedMalloc(sizeof(XXH3_state_t), 64);
+    if (state==NULL) return NULL;
+    XXH3_INITSTATE(state);
+    return state;
 }
-XXH_FORCE_INLINE XXH_TARGET_AVX512 XXH3_ACCUMULATE_TEMPLATE(avx512)
 
-/*
- * XXH3_scrambleAcc: Scrambles the accumulators to improve mixing.
- *
- * Multiplication isn't perfect, as explained by Google in HighwayHash:
- *
- *  // Multiplication mixes/scrambles bytes 0-7 of the 64-bit result to
- *  // varying degrees. In descending order of goodness, bytes
- *  // 3 4 2 5 1 6 0 7 have quality 228 224 164 160 100 96 36 32.
- *  // As expected, the upper and lower bytes are much worse.
+/*! @ingroup XXH3_family */
+/*!
+ * @brief Frees an @ref XXH3_state_t.
  *
- * Source: https://github.com/google/highwayhash/blob/0aaf66b/highwayhash/hh_avx2.h#L291
+ * @param statePtr A pointer to an @ref XXH3_state_t allocated with @ref XXH3_createState().
  *
- * Since our algorithm uses a pseudorandom secret to add some variance into the
- * mix, we don't need to (or want to) mix as often or as much as HighwayHash does.
+ * @return @ref XXH_OK.
  *
- * This isn't as tight as XXH3_accumulate, but still written in SIMD to avoid
- * extraction.
+ * @note Must be allocated with XXH3_createState().
  *
- * Both XXH3_64bits and XXH3_128bits use this subroutine.
+ * @see @ref streaming_example "Streaming Example"
  */
-
-XXH_FORCE_INLINE XXH_TARGET_AVX512 void
-XXH3_scrambleAcc_avx512(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+XXH_PUBLIC_API XXH_errorcode XXH3_freeState(XXH3_state_t* statePtr)
 {
-    XXH_ASSERT((((size_t)acc) & 63) == 0);
-    XXH_STATIC_ASSERT(XXH_STRIPE_LEN == sizeof(__m512i));
-    {   __m512i* const xacc = (__m512i*) acc;
-        const __m512i prime32 = _mm512_set1_epi32((int)XXH_PRIME32_1);
+    XXH_alignedFree(statePtr);
+    return XXH_OK;
+}
 
-        /* xacc[0] ^= (xacc[0] >> 47) */
-        __m512i const acc_vec     = *xacc;
-        __m512i const shifted     = _mm512_srli_epi64    (acc_vec, 47);
-        /* xacc[0] ^= secret; */
-        __m512i const key_vec     = _mm512_loadu_si512   (secret);
-        __m512i const data_key    = _mm512_ternarylogic_epi32(key_vec, acc_vec, shifted, 0x96 /* key_vec ^ acc_vec ^ shifted */);
+/*
+ * A pool is a single aligned allocation: this header, padded to 64 bytes,
+ * followed by the states. Released states are chained through their first bytes.
+ * States are spaced by a multiple of 64 bytes, so that each of them stays aligned
+ * even where XXH_ALIGN_MEMBER() can't pad XXH3_state_t.
+ */
+struct XXH3_statePool_s {
+    xxh_u8* states;
+    size_t nbStates;
+    XXH3_state_t* freeList;
+};
 
-        /* xacc[0] *= XXH_PRIME32_1; */
-        __m512i const data_key_hi = _mm512_srli_epi64 (data_key, 32);
-        __m512i const prod_lo     = _mm512_mul_epu32     (data_key, prime32);
-        __m512i const prod_hi     = _mm512_mul_epu32     (data_key_hi, prime32);
-        *xacc = _mm512_add_epi64(prod_lo, _mm512_slli_epi64(prod_hi, 32));
+#define XXH3_STATEPOOL_HEADER 64
+#define XXH3_STATEPOOL_STRIDE ((sizeof(XXH3_state_t) + 63) & ~(size_t)63)
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH3_statePool_t* XXH3_createStatePool(size_t nbStates)
+{
+    XXH_STATIC_ASSERT(sizeof(XXH3_statePool_t) <= XXH3_STATEPOOL_HEADER);
+    if (nbStates == 0) return NULL;
+    if (nbStates > ((size_t)-1 - XXH3_STATEPOOL_HEADER - 64) / XXH3_STATEPOOL_STRIDE) return NULL;
+    {   xxh_u8* const base = (xxh_u8*)XXH_alignedMalloc(XXH3_STATEPOOL_HEADER + nbStates * XXH3_STATEPOOL_STRIDE, 64);
+        XXH3_statePool_t* const pool = (XXH3_statePool_t*)(void*)base;
+        size_t n;
+        if (base == NULL) return NULL;
+        pool->states = base + XXH3_STATEPOOL_HEADER;
+        pool->nbStates = nbStates;
+        pool->freeList = NULL;
+        for (n = nbStates; n > 0; n--) {
+            XXH3_state_t* const state = (XXH3_state_t*)(void*)(pool->states + (n-1) * XXH3_STATEPOOL_STRIDE);
+            XXH_memcpy(state, &pool->freeList, sizeof(pool->freeList));
+            pool->freeList = state;
+        }
+        return pool;
     }
 }
 
-XXH_FORCE_INLINE XXH_TARGET_AVX512 void
-XXH3_initCustomSecret_avx512(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode XXH3_freeStatePool(XXH3_statePool_t* pool)
 {
-    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 63) == 0);
-    XXH_STATIC_ASSERT(XXH_SEC_ALIGN == 64);
-    XXH_ASSERT(((size_t)customSecret & 63) == 0);
-    (void)(&XXH_writeLE64);
-    {   int const nbRounds = XXH_SECRET_DEFAULT_SIZE / sizeof(__m512i);
-        __m512i const seed_pos = _mm512_set1_epi64((xxh_i64)seed64);
-        __m512i const seed     = _mm512_mask_sub_epi64(seed_pos, 0xAA, _mm512_set1_epi8(0), seed_pos);
+    XXH_alignedFree(pool);
+    return XXH_OK;
+}
 
-        const __m512i* const src  = (const __m512i*) ((const void*) XXH3_kSecret);
-              __m512i* const dest = (      __m512i*) customSecret;
-        int i;
-        XXH_ASSERT(((size_t)src & 63) == 0); /* control alignment */
-        XXH_ASSERT(((size_t)dest & 63) == 0);
-        for (i=0; i < nbRounds; ++i) {
-            dest[i] = _mm512_add_epi64(_mm512_load_si512(src + i), seed);
-    }   }
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH3_state_t* XXH3_acquireState(XXH_NOESCAPE XXH3_statePool_t* pool)
+{
+    XXH3_state_t* const state = pool->freeList;
+    if (state == NULL) return NULL;
+    XXH_memcpy(&pool->freeList, state, sizeof(pool->freeList));
+    XXH3_INITSTATE(state);
+    return state;
 }
 
+#if (XXH_DEBUGLEVEL >= 1)
+/* Returns 1 if @statePtr is already on the free list of @pool */
+static int XXH3_statePool_isFree(const XXH3_statePool_t* pool, const XXH3_state_t* statePtr)
+{
+    XXH3_state_t* state = pool->freeList;
+    while (state != NULL) {
+        if (state == statePtr) return 1;
+        XXH_memcpy(&state, state, sizeof(state));
+    }
+    return 0;
+}
 #endif
 
-#if (XXH_VECTOR == XXH_AVX2) \
-    || (defined(XXH_DISPATCH_AVX2) && XXH_DISPATCH_AVX2 != 0)
-
-#ifndef XXH_TARGET_AVX2
-# define XXH_TARGET_AVX2  /* disable attribute target */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode XXH3_releaseState(XXH_NOESCAPE XXH3_statePool_t* pool, XXH3_state_t* statePtr)
+{
+    if (statePtr == NULL) return XXH_ERROR;
+    /* compare addresses as integers, since statePtr may point outside of the pool */
+    {   size_t const first = (size_t)pool->states;
+        size_t const addr = (size_t)statePtr;
+        if (addr < first || addr >= first + pool->nbStates * XXH3_STATEPOOL_STRIDE) return XXH_ERROR;
+        if ((addr - first) % XXH3_STATEPOOL_STRIDE != 0) return XXH_ERROR;
+    }
+#if (XXH_DEBUGLEVEL >= 1)
+    /* releasing a state twice would corrupt the free list */
+    XXH_ASSERT(!XXH3_statePool_isFree(pool, statePtr));
 #endif
+    XXH_memcpy(statePtr, &pool->freeList, sizeof(pool->freeList));
+    pool->freeList = statePtr;
+    return XXH_OK;
+}
 
-XXH_FORCE_INLINE XXH_TARGET_AVX2 void
-XXH3_accumulate_512_avx2( void* XXH_RESTRICT acc,
-                    const void* XXH_RESTRICT input,
-                    const void* XXH_RESTRICT secret)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_copyState(XXH_NOESCAPE XXH3_state_t* dst_state, XXH_NOESCAPE const XXH3_state_t* src_state)
 {
-    XXH_ASSERT((((size_t)acc) & 31) == 0);
-    {   __m256i* const xacc    =       (__m256i *) acc;
-        /* Unaligned. This is mainly for pointer arithmetic, and because
-         * _mm256_loadu_si256 requires  a const __m256i * pointer for some reason. */
-        const         __m256i* const xinput  = (const __m256i *) input;
-        /* Unaligned. This is mainly for pointer arithmetic, and because
-         * _mm256_loadu_si256 requires a const __m256i * pointer for some reason. */
-        const         __m256i* const xsecret = (const __m256i *) secret;
-
-        size_t i;
-        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m256i); i++) {
-            /* data_vec    = xinput[i]; */
-            __m256i const data_vec    = _mm256_loadu_si256    (xinput+i);
-            /* key_vec     = xsecret[i]; */
-            __m256i const key_vec     = _mm256_loadu_si256   (xsecret+i);
-            /* data_key    = data_vec ^ key_vec; */
-            __m256i const data_key    = _mm256_xor_si256     (data_vec, key_vec);
-            /* data_key_lo = data_key >> 32; */
-            __m256i const data_key_lo = _mm256_srli_epi64 (data_key, 32);
-            /* product     = (data_key & 0xffffffff) * (data_key_lo & 0xffffffff); */
-            __m256i const product     = _mm256_mul_epu32     (data_key, data_key_lo);
-            /* xacc[i] += swap(data_vec); */
-            __m256i const data_swap = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
-            __m256i const sum       = _mm256_add_epi64(xacc[i], data_swap);
-            /* xacc[i] += product; */
-            xacc[i] = _mm256_add_epi64(product, sum);
-    }   }
+    XXH_memcpy(dst_state, src_state, sizeof(*dst_state));
 }
-XXH_FORCE_INLINE XXH_TARGET_AVX2 XXH3_ACCUMULATE_TEMPLATE(avx2)
 
-XXH_FORCE_INLINE XXH_TARGET_AVX2 void
-XXH3_scrambleAcc_avx2(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+static void
+XXH3_reset_internal(XXH3_state_t* statePtr,
+                    XXH64_hash_t seed,
+                    const void* secret, size_t secretSize)
 {
-    XXH_ASSERT((((size_t)acc) & 31) == 0);
-    {   __m256i* const xacc = (__m256i*) acc;
-        /* Unaligned. This is mainly for pointer arithmetic, and because
-         * _mm256_loadu_si256 requires a const __m256i * pointer for some reason. */
-        const         __m256i* const xsecret = (const __m256i *) secret;
-        const __m256i prime32 = _mm256_set1_epi32((int)XXH_PRIME32_1);
-
-        size_t i;
-        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m256i); i++) {
-            /* xacc[i] ^= (xacc[i] >> 47) */
-            __m256i const acc_vec     = xacc[i];
-            __m256i const shifted     = _mm256_srli_epi64    (acc_vec, 47);
-            __m256i const data_vec    = _mm256_xor_si256     (acc_vec, shifted);
-            /* xacc[i] ^= xsecret; */
-            __m256i const key_vec     = _mm256_loadu_si256   (xsecret+i);
-            __m256i const data_key    = _mm256_xor_si256     (data_vec, key_vec);
-
-            /* xacc[i] *= XXH_PRIME32_1; */
-            __m256i const data_key_hi = _mm256_srli_epi64 (data_key, 32);
-            __m256i const prod_lo     = _mm256_mul_epu32     (data_key, prime32);
-            __m256i const prod_hi     = _mm256_mul_epu32     (data_key_hi, prime32);
-            xacc[i] = _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32));
-        }
-    }
+    size_t const initStart = offsetof(XXH3_state_t, bufferedSize);
+    size_t const initLength = offsetof(XXH3_state_t, nbStripesPerBlock) - initStart;
+    XXH_ASSERT(offsetof(XXH3_state_t, nbStripesPerBlock) > initStart);
+    XXH_ASSERT(statePtr != NULL);
+    /* set members from bufferedSize to nbStripesPerBlock (excluded) to 0 */
+    memset((char*)statePtr + initStart, 0, initLength);
+    statePtr->acc[0] = XXH_PRIME32_3;
+    statePtr->acc[1] = XXH_PRIME64_1;
+    statePtr->acc[2] = XXH_PRIME64_2;
+    statePtr->acc[3] = XXH_PRIME64_3;
+    statePtr->acc[4] = XXH_PRIME64_4;
+    statePtr->acc[5] = XXH_PRIME32_2;
+    statePtr->acc[6] = XXH_PRIME64_5;
+    statePtr->acc[7] = XXH_PRIME32_1;
+    statePtr->seed = seed;
+    statePtr->useSeed = (seed != 0);
+    statePtr->extSecret = (const unsigned char*)secret;
+    if (secret != NULL) statePtr->secretPending = 0;
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN);
+    statePtr->secretLimit = secretSize - XXH_STRIPE_LEN;
+    statePtr->nbStripesPerBlock = statePtr->secretLimit / XXH_SECRET_CONSUME_RATE;
 }
 
-XXH_FORCE_INLINE XXH_TARGET_AVX2 void XXH3_initCustomSecret_avx2(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_reset(XXH_NOESCAPE XXH3_state_t* statePtr)
 {
-    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 31) == 0);
-    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE / sizeof(__m256i)) == 6);
-    XXH_STATIC_ASSERT(XXH_SEC_ALIGN <= 64);
-    (void)(&XXH_writeLE64);
-    XXH_PREFETCH(customSecret);
-    {   __m256i const seed = _mm256_set_epi64x((xxh_i64)(0U - seed64), (xxh_i64)seed64, (xxh_i64)(0U - seed64), (xxh_i64)seed64);
+    if (statePtr == NULL) return XXH_ERROR;
+    XXH3_reset_internal(statePtr, 0, XXH3_kSecret, XXH_SECRET_DEFAULT_SIZE);
+    return XXH_OK;
+}
 
-        const __m256i* const src  = (const __m256i*) ((const void*) XXH3_kSecret);
-              __m256i*       dest = (      __m256i*) customSecret;
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_reset_withSecret(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize)
+{
+    if (statePtr == NULL) return XXH_ERROR;
+    XXH3_reset_internal(statePtr, 0, secret, secretSize);
+    if (secret == NULL) return XXH_ERROR;
+    if (secretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
+    return XXH_OK;
+}
 
-#       if defined(__GNUC__) || defined(__clang__)
-        /*
-         * On GCC & Clang, marking 'dest' as modified will cause the compiler:
-         *   - do not extract the secret from sse registers in the internal loop
-         *   - use less common registers, and avoid pushing these reg into stack
-         */
-        XXH_COMPILER_GUARD(dest);
-#       endif
-        XXH_ASSERT(((size_t)src & 31) == 0); /* control alignment */
-        XXH_ASSERT(((size_t)dest & 31) == 0);
+/*
+ * The secret derived from the seed is only needed once the input exceeds
+ * the internal buffer, which most seeded streams never do:
+ * its derivation is deferred to XXH3_update() or to the digest.
+ * @ref XXH3_state_s::customSecret remains valid when the seed doesn't change.
+ */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_reset_withSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH64_hash_t seed)
+{
+    if (statePtr == NULL) return XXH_ERROR;
+    if (seed==0) return XXH3_64bits_reset(statePtr);
+    if ((seed != statePtr->seed) || (statePtr->extSecret != NULL))
+        statePtr->secretPending = 1;
+    XXH3_reset_internal(statePtr, seed, NULL, XXH_SECRET_DEFAULT_SIZE);
+    return XXH_OK;
+}
 
-        /* GCC -O2 need unroll loop manually */
-        dest[0] = _mm256_add_epi64(_mm256_load_si256(src+0), seed);
-        dest[1] = _mm256_add_epi64(_mm256_load_si256(src+1), seed);
-        dest[2] = _mm256_add_epi64(_mm256_load_si256(src+2), seed);
-        dest[3] = _mm256_add_epi64(_mm256_load_si256(src+3), seed);
-        dest[4] = _mm256_add_epi64(_mm256_load_si256(src+4), seed);
-        dest[5] = _mm256_add_epi64(_mm256_load_si256(src+5), seed);
-    }
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_reset_withSecretandSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed64)
+{
+    if (statePtr == NULL) return XXH_ERROR;
+    if (secret == NULL) return XXH_ERROR;
+    if (secretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
+    XXH3_reset_internal(statePtr, seed64, secret, secretSize);
+    statePtr->useSeed = 1; /* always, even if seed64==0 */
+    return XXH_OK;
 }
 
+#ifndef XXH3_STREAM_USE_STACK
+# if XXH_SIZE_OPT <= 0 && !defined(__clang__) /* clang doesn't need additional stack space */
+#   define XXH3_STREAM_USE_STACK 1
+# endif
 #endif
 
-/* x86dispatch always generates SSE2 */
-#if (XXH_VECTOR == XXH_SSE2) || defined(XXH_X86DISPATCH)
-
-#ifndef XXH_TARGET_SSE2
-# define XXH_TARGET_SSE2  /* disable attribute target */
-#endif
+#define XXH3_INTERNALBUFFER_STRIPES (XXH3_INTERNALBUFFER_SIZE / XXH_STRIPE_LEN)
 
-XXH_FORCE_INLINE XXH_TARGET_SSE2 void
-XXH3_accumulate_512_sse2( void* XXH_RESTRICT acc,
-                    const void* XXH_RESTRICT input,
-                    const void* XXH_RESTRICT secret)
-{
-    /* SSE2 is just a half-scale version of the AVX2 version. */
-    XXH_ASSERT((((size_t)acc) & 15) == 0);
-    {   __m128i* const xacc    =       (__m128i *) acc;
-        /* Unaligned. This is mainly for pointer arithmetic, and because
-         * _mm_loadu_si128 requires a const __m128i * pointer for some reason. */
-        const         __m128i* const xinput  = (const __m128i *) input;
-        /* Unaligned. This is mainly for pointer arithmetic, and because
-         * _mm_loadu_si128 requires a const __m128i * pointer for some reason. */
-        const         __m128i* const xsecret = (const __m128i *) secret;
+/*
+ * Ingests @p input, which doesn't fit in the internal buffer anymore:
+ * the buffer is completed and consumed, then the input, except its tail,
+ * which is buffered (always, even when it is a full stripe).
+ * The fields of the state are passed individually,
+ * so that it serves both XXH3_state_t and XXH3_compactState_t.
+ * @p buffer is XXH3_INTERNALBUFFER_SIZE bytes.
+ */
+XXH_FORCE_INLINE void
+XXH3_update_long_internal(xxh_u64* XXH_RESTRICT acc,
+                          size_t* XXH_RESTRICT nbStripesSoFarPtr, size_t nbStripesPerBlock,
+                          unsigned char* XXH_RESTRICT buffer, XXH32_hash_t* XXH_RESTRICT bufferedSizePtr,
+                          const xxh_u8* XXH_RESTRICT input, size_t len,
+                          const unsigned char* XXH_RESTRICT secret, size_t secretLimit,
+                          XXH3_f_accumulate f_acc,
+                          XXH3_f_scrambleAcc f_scramble)
+{
+    const xxh_u8* const bEnd = input + len;
+    XXH_STATIC_ASSERT(XXH3_INTERNALBUFFER_SIZE % XXH_STRIPE_LEN == 0);   /* clean multiple */
+    XXH_ASSERT(len > XXH3_INTERNALBUFFER_SIZE - *bufferedSizePtr);
 
-        size_t i;
-        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m128i); i++) {
-            /* data_vec    = xinput[i]; */
-            __m128i const data_vec    = _mm_loadu_si128   (xinput+i);
-            /* key_vec     = xsecret[i]; */
-            __m128i const key_vec     = _mm_loadu_si128   (xsecret+i);
-            /* data_key    = data_vec ^ key_vec; */
-            __m128i const data_key    = _mm_xor_si128     (data_vec, key_vec);
-            /* data_key_lo = data_key >> 32; */
-            __m128i const data_key_lo = _mm_shuffle_epi32 (data_key, _MM_SHUFFLE(0, 3, 0, 1));
-            /* product     = (data_key & 0xffffffff) * (data_key_lo & 0xffffffff); */
-            __m128i const product     = _mm_mul_epu32     (data_key, data_key_lo);
-            /* xacc[i] += swap(data_vec); */
-            __m128i const data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1,0,3,2));
-            __m128i const sum       = _mm_add_epi64(xacc[i], data_swap);
-            /* xacc[i] += product; */
-            xacc[i] = _mm_add_epi64(product, sum);
-    }   }
+    /*
+     * Internal buffer is partially filled (always, except at beginning)
+     * Complete it, then consume it.
+     */
+    if (*bufferedSizePtr) {
+        size_t const loadSize = XXH3_INTERNALBUFFER_SIZE - *bufferedSizePtr;
+        XXH_memcpy(buffer + *bufferedSizePtr, input, loadSize);
+        input += loadSize;
+        XXH3_consumeStripes(acc,
+                            nbStripesSoFarPtr, nbStripesPerBlock,
+                            buffer, XXH3_INTERNALBUFFER_STRIPES,
+                            secret, secretLimit,
+                            f_acc, f_scramble);
+        *bufferedSizePtr = 0;
+    }
+    XXH_ASSERT(input < bEnd);
+    if (bEnd - input > XXH3_INTERNALBUFFER_SIZE) {
+        size_t const nbStripes = (size_t)(bEnd - 1 - input) / XXH_STRIPE_LEN;
+        input = XXH3_consumeStripes(acc,
+                                    nbStripesSoFarPtr, nbStripesPerBlock,
+                                    input, nbStripes,
+                                    secret, secretLimit,
+                                    f_acc, f_scramble);
+        XXH_memcpy(buffer + XXH3_INTERNALBUFFER_SIZE - XXH_STRIPE_LEN, input - XXH_STRIPE_LEN, XXH_STRIPE_LEN);
+    }
+    /* Some remaining input (always) : buffer it */
+    XXH_ASSERT(input < bEnd);
+    XXH_ASSERT(bEnd - input <= XXH3_INTERNALBUFFER_SIZE);
+    XXH_ASSERT(*bufferedSizePtr == 0);
+    XXH_memcpy(buffer, input, (size_t)(bEnd-input));
+    *bufferedSizePtr = (XXH32_hash_t)(bEnd-input);
 }
-XXH_FORCE_INLINE XXH_TARGET_SSE2 XXH3_ACCUMULATE_TEMPLATE(sse2)
 
-XXH_FORCE_INLINE XXH_TARGET_SSE2 void
-XXH3_scrambleAcc_sse2(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+/*
+ * Both XXH3_64bits_update and XXH3_128bits_update use this routine.
+ */
+XXH_FORCE_INLINE XXH_errorcode
+XXH3_update(XXH3_state_t* XXH_RESTRICT const state,
+            const xxh_u8* XXH_RESTRICT input, size_t len,
+            XXH3_f_accumulate f_acc,
+            XXH3_f_scrambleAcc f_scramble,
+            XXH3_f_initCustomSecret f_initSec)
 {
-    XXH_ASSERT((((size_t)acc) & 15) == 0);
-    {   __m128i* const xacc = (__m128i*) acc;
-        /* Unaligned. This is mainly for pointer arithmetic, and because
-         * _mm_loadu_si128 requires a const __m128i * pointer for some reason. */
-        const         __m128i* const xsecret = (const __m128i *) secret;
-        const __m128i prime32 = _mm_set1_epi32((int)XXH_PRIME32_1);
+    if (input==NULL) {
+        XXH_ASSERT(len == 0);
+        return XXH_OK;
+    }
 
-        size_t i;
-        for (i=0; i < XXH_STRIPE_LEN/sizeof(__m128i); i++) {
-            /* xacc[i] ^= (xacc[i] >> 47) */
-            __m128i const acc_vec     = xacc[i];
-            __m128i const shifted     = _mm_srli_epi64    (acc_vec, 47);
-            __m128i const data_vec    = _mm_xor_si128     (acc_vec, shifted);
-            /* xacc[i] ^= xsecret[i]; */
-            __m128i const key_vec     = _mm_loadu_si128   (xsecret+i);
-            __m128i const data_key    = _mm_xor_si128     (data_vec, key_vec);
+    XXH_ASSERT(state != NULL);
+    {   const unsigned char* const secret = (state->extSecret == NULL) ? state->customSecret : state->extSecret;
+#if defined(XXH3_STREAM_USE_STACK) && XXH3_STREAM_USE_STACK >= 1
+        /* For some reason, gcc and MSVC seem to suffer greatly
+         * when operating accumulators directly into state.
+         * Operating into stack space seems to enable proper optimization.
+         * clang, on the other hand, doesn't seem to need this trick */
+        XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[8];
+        XXH_memcpy(acc, state->acc, sizeof(acc));
+#else
+        xxh_u64* XXH_RESTRICT const acc = state->acc;
+#endif
+        state->totalLen += len;
+        XXH_ASSERT(state->bufferedSize <= XXH3_INTERNALBUFFER_SIZE);
 
-            /* xacc[i] *= XXH_PRIME32_1; */
-            __m128i const data_key_hi = _mm_shuffle_epi32 (data_key, _MM_SHUFFLE(0, 3, 0, 1));
-            __m128i const prod_lo     = _mm_mul_epu32     (data_key, prime32);
-            __m128i const prod_hi     = _mm_mul_epu32     (data_key_hi, prime32);
-            xacc[i] = _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32));
+        /* small input : just fill in tmp buffer */
+        if (len <= XXH3_INTERNALBUFFER_SIZE - state->bufferedSize) {
+            XXH_memcpy(state->buffer + state->bufferedSize, input, len);
+            state->bufferedSize += (XXH32_hash_t)len;
+            return XXH_OK;
+        }
+
+        /* stripes are about to be consumed: the secret is needed now */
+        if (state->secretPending) {
+            XXH_ASSERT(state->extSecret == NULL);
+            f_initSec(state->customSecret, state->seed);
+            state->secretPending = 0;
         }
+
+        /* total input is now > XXH3_INTERNALBUFFER_SIZE */
+        XXH3_update_long_internal(acc,
+                                 &state->nbStripesSoFar, state->nbStripesPerBlock,
+                                  state->buffer, &state->bufferedSize,
+                                  input, len,
+                                  secret, state->secretLimit,
+                                  f_acc, f_scramble);
+#if defined(XXH3_STREAM_USE_STACK) && XXH3_STREAM_USE_STACK >= 1
+        /* save stack accumulators into state */
+        XXH_memcpy(state->acc, acc, sizeof(acc));
+#endif
     }
+
+    return XXH_OK;
 }
 
-XXH_FORCE_INLINE XXH_TARGET_SSE2 void XXH3_initCustomSecret_sse2(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_update(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
 {
-    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 15) == 0);
-    (void)(&XXH_writeLE64);
-    {   int const nbRounds = XXH_SECRET_DEFAULT_SIZE / sizeof(__m128i);
+    return XXH3_update(state, (const xxh_u8*)input, len,
+                       XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
+}
 
-#       if defined(_MSC_VER) && defined(_M_IX86) && _MSC_VER < 1900
-        /* MSVC 32bit mode does not support _mm_set_epi64x before 2015 */
-        XXH_ALIGN(16) const xxh_i64 seed64x2[2] = { (xxh_i64)seed64, (xxh_i64)(0U - seed64) };
-        __m128i const seed = _mm_load_si128((__m128i const*)seed64x2);
-#       else
-        __m128i const seed = _mm_set_epi64x((xxh_i64)(0U - seed64), (xxh_i64)seed64);
-#       endif
-        int i;
 
-        const void* const src16 = XXH3_kSecret;
-        __m128i* dst16 = (__m128i*) customSecret;
-#       if defined(__GNUC__) || defined(__clang__)
-        /*
-         * On GCC & Clang, marking 'dest' as modified will cause the compiler:
-         *   - do not extract the secret from sse registers in the internal loop
-         *   - use less common registers, and avoid pushing these reg into stack
-         */
-        XXH_COMPILER_GUARD(dst16);
-#       endif
-        XXH_ASSERT(((size_t)src16 & 15) == 0); /* control alignment */
-        XXH_ASSERT(((size_t)dst16 & 15) == 0);
+/*
+ * Completes the stripes of a streaming state into @p acc.
+ * The fields of the state are passed individually,
+ * so that it serves both XXH3_state_t and XXH3_compactState_t.
+ * @p buffer is XXH3_INTERNALBUFFER_SIZE bytes.
+ */
+XXH_FORCE_INLINE void
+XXH3_digest_long_internal(XXH64_hash_t* acc,
+                          const XXH64_hash_t* stateAcc,
+                          const unsigned char* buffer, size_t bufferedSize,
+                          size_t nbStripesSoFar, size_t nbStripesPerBlock,
+                          const unsigned char* secret, size_t secretLimit,
+                          XXH3_f_accumulate f_acc,
+                          XXH3_f_scrambleAcc f_scramble)
+{
+    xxh_u8 lastStripe[XXH_STRIPE_LEN];
+    const xxh_u8* lastStripePtr;
 
-        for (i=0; i < nbRounds; ++i) {
-            dst16[i] = _mm_add_epi64(_mm_load_si128((const __m128i *)src16+i), seed);
-    }   }
+    /*
+     * Digest on a local copy. This way, the state remains unaltered, and it can
+     * continue ingesting more input afterwards.
+     */
+    XXH_memcpy(acc, stateAcc, XXH_ACC_NB * sizeof(*acc));
+    if (bufferedSize >= XXH_STRIPE_LEN) {
+        /* Consume remaining stripes then point to remaining data in buffer */
+        size_t const nbStripes = (bufferedSize - 1) / XXH_STRIPE_LEN;
+        XXH3_consumeStripes(acc,
+                           &nbStripesSoFar, nbStripesPerBlock,
+                            buffer, nbStripes,
+                            secret, secretLimit,
+                            f_acc, f_scramble);
+        lastStripePtr = buffer + bufferedSize - XXH_STRIPE_LEN;
+    } else {  /* bufferedSize < XXH_STRIPE_LEN */
+        /* Copy to temp buffer */
+        size_t const catchupSize = XXH_STRIPE_LEN - bufferedSize;
+        XXH_ASSERT(bufferedSize > 0);  /* there is always some input buffered */
+        XXH_memcpy(lastStripe, buffer + XXH3_INTERNALBUFFER_SIZE - catchupSize, catchupSize);
+        XXH_memcpy(lastStripe + catchupSize, buffer, bufferedSize);
+        lastStripePtr = lastStripe;
+    }
+    /* Last stripe */
+    f_acc(acc,
+          lastStripePtr,
+          secret + secretLimit - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
 }
 
-#endif
+XXH_FORCE_INLINE void
+XXH3_digest_long (XXH64_hash_t* acc,
+                  const XXH3_state_t* state,
+                  const unsigned char* secret,
+                  XXH3_f_accumulate f_acc,
+                  XXH3_f_scrambleAcc f_scramble)
+{
+    XXH3_digest_long_internal(acc, state->acc,
+                              state->buffer, state->bufferedSize,
+                              state->nbStripesSoFar, state->nbStripesPerBlock,
+                              secret, state->secretLimit,
+                              f_acc, f_scramble);
+}
 
-#if (XXH_VECTOR == XXH_NEON)
+/*
+ * Returns the secret of @p state.
+ * If it is not derived from the seed yet, it is derived into @p secretBuffer,
+ * since digests leave the state unaltered.
+ */
+XXH_FORCE_INLINE const unsigned char*
+XXH3_digestSecret(const XXH3_state_t* state, unsigned char* secretBuffer,
+                  XXH3_f_initCustomSecret f_initSec)
+{
+    if (state->extSecret != NULL) return state->extSecret;
+    if (!state->secretPending) return state->customSecret;
+    f_initSec(secretBuffer, state->seed);
+    return secretBuffer;
+}
 
-/* forward declarations for the scalar routines */
-XXH_FORCE_INLINE void
-XXH3_scalarRound(void* XXH_RESTRICT acc, void const* XXH_RESTRICT input,
-                 void const* XXH_RESTRICT secret, size_t lane);
+XXH_FORCE_INLINE XXH64_hash_t
+XXH3_64bits_digest_internal(const XXH3_state_t* state,
+                            XXH3_f_accumulate f_acc,
+                            XXH3_f_scrambleAcc f_scramble,
+                            XXH3_f_initCustomSecret f_initSec)
+{
+    XXH_ALIGN(XXH_SEC_ALIGN) unsigned char secretBuffer[XXH_SECRET_DEFAULT_SIZE];
+    if (state->totalLen > XXH3_MIDSIZE_MAX) {
+        const unsigned char* const secret = XXH3_digestSecret(state, secretBuffer, f_initSec);
+        XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
+        XXH3_digest_long(acc, state, secret, f_acc, f_scramble);
+        return XXH3_mergeAccs(acc,
+                              secret + XXH_SECRET_MERGEACCS_START,
+                              (xxh_u64)state->totalLen * XXH_PRIME64_1);
+    }
+    /* totalLen <= XXH3_MIDSIZE_MAX: digesting a short input */
+    if (state->useSeed)
+        return XXH3_64bits_withSeed(state->buffer, (size_t)state->totalLen, state->seed);
+    return XXH3_64bits_withSecret(state->buffer, (size_t)(state->totalLen),
+                                  XXH3_digestSecret(state, secretBuffer, f_initSec),
+                                  state->secretLimit + XXH_STRIPE_LEN);
+}
 
-XXH_FORCE_INLINE void
-XXH3_scalarScrambleRound(void* XXH_RESTRICT acc,
-                         void const* XXH_RESTRICT secret, size_t lane);
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t XXH3_64bits_digest (XXH_NOESCAPE const XXH3_state_t* state)
+{
+    return XXH3_64bits_digest_internal(state, XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
+}
+#endif /* !XXH_NO_STREAM */
 
-/*!
- * @internal
- * @brief The bulk processing loop for NEON and WASM SIMD128.
- *
- * The NEON code path is actually partially scalar when running on AArch64. This
- * is to optimize the pipelining and can have up to 15% speedup depending on the
- * CPU, and it also mitigates some GCC codegen issues.
- *
- * @see XXH3_NEON_LANES for configuring this and details about this optimization.
- *
- * NEON's 32-bit to 64-bit long multiply takes a half vector of 32-bit
- * integers instead of the other platforms which mask full 64-bit vectors,
- * so the setup is more complicated than just shifting right.
+
+/* ==========================================
+ * XXH3 128 bits (a.k.a XXH128)
+ * ==========================================
+ * XXH3's 128-bit variant has better mixing and strength than the 64-bit variant,
+ * even without counting the significantly larger output size.
  *
- * Additionally, there is an optimization for 4 lanes at once noted below.
+ * For example, extra steps are taken to avoid the seed-dependent collisions
+ * in 17-240 byte inputs (See XXH3_mix16B and XXH128_mix32B).
  *
- * Since, as stated, the most optimal amount of lanes for Cortexes is 6,
- * there needs to be *three* versions of the accumulate operation used
- * for the remaining 2 lanes.
+ * This strength naturally comes at the cost of some speed, especially on short
+ * lengths. Note that longer hashes are about as fast as the 64-bit version
+ * due to it using only a slight modification of the 64-bit loop.
  *
- * WASM's SIMD128 uses SIMDe's arm_neon.h polyfill because the intrinsics overlap
- * nearly perfectly.
+ * XXH128 is also more oriented towards 64-bit machines. It is still extremely
+ * fast for a _128-bit_ hash on 32-bit (it usually clears XXH64).
  */
 
-XXH_FORCE_INLINE void
-XXH3_accumulate_512_neon( void* XXH_RESTRICT acc,
-                    const void* XXH_RESTRICT input,
-                    const void* XXH_RESTRICT secret)
+XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_1to3_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                   XXH3_fold fold)
 {
-    XXH_ASSERT((((size_t)acc) & 15) == 0);
-    XXH_STATIC_ASSERT(XXH3_NEON_LANES > 0 && XXH3_NEON_LANES <= XXH_ACC_NB && XXH3_NEON_LANES % 2 == 0);
-    {   /* GCC for darwin arm64 does not like aliasing here */
-        xxh_aliasing_uint64x2_t* const xacc = (xxh_aliasing_uint64x2_t*) acc;
-        /* We don't use a uint32x4_t pointer because it causes bus errors on ARMv7. */
-        uint8_t const* xinput = (const uint8_t *) input;
-        uint8_t const* xsecret  = (const uint8_t *) secret;
-
-        size_t i;
-#ifdef __wasm_simd128__
-        /*
-         * On WASM SIMD128, Clang emits direct address loads when XXH3_kSecret
-         * is constant propagated, which results in it converting it to this
-         * inside the loop:
-         *
-         *    a = v128.load(XXH3_kSecret +  0 + $secret_offset, offset = 0)
-         *    b = v128.load(XXH3_kSecret + 16 + $secret_offset, offset = 0)
-         *    ...
-         *
-         * This requires a full 32-bit address immediate (and therefore a 6 byte
-         * instruction) as well as an add for each offset.
-         *
-         * Putting an asm guard prevents it from folding (at the cost of losing
-         * the alignment hint), and uses the free offset in `v128.load` instead
-         * of adding secret_offset each time which overall reduces code size by
-         * about a kilobyte and improves performance.
-         */
-        XXH_COMPILER_GUARD(xsecret);
-#endif
-        /* Scalar lanes use the normal scalarRound routine */
-        for (i = XXH3_NEON_LANES; i < XXH_ACC_NB; i++) {
-            XXH3_scalarRound(acc, input, secret, i);
-        }
-        i = 0;
-        /* 4 NEON lanes at a time. */
-        for (; i+1 < XXH3_NEON_LANES / 2; i+=2) {
-            /* data_vec = xinput[i]; */
-            uint64x2_t data_vec_1 = XXH_vld1q_u64(xinput  + (i * 16));
-            uint64x2_t data_vec_2 = XXH_vld1q_u64(xinput  + ((i+1) * 16));
-            /* key_vec  = xsecret[i];  */
-            uint64x2_t key_vec_1  = XXH_vld1q_u64(xsecret + (i * 16));
-            uint64x2_t key_vec_2  = XXH_vld1q_u64(xsecret + ((i+1) * 16));
-            /* data_swap = swap(data_vec) */
-            uint64x2_t data_swap_1 = vextq_u64(data_vec_1, data_vec_1, 1);
-            uint64x2_t data_swap_2 = vextq_u64(data_vec_2, data_vec_2, 1);
-            /* data_key = data_vec ^ key_vec; */
-            uint64x2_t data_key_1 = veorq_u64(data_vec_1, key_vec_1);
-            uint64x2_t data_key_2 = veorq_u64(data_vec_2, key_vec_2);
-
-            /*
-             * If we reinterpret the 64x2 vectors as 32x4 vectors, we can use a
-             * de-interleave operation for 4 lanes in 1 step with `vuzpq_u32` to
-             * get one vector with the low 32 bits of each lane, and one vector
-             * with the high 32 bits of each lane.
-             *
-             * The intrinsic returns a double vector because the original ARMv7-a
-             * instruction modified both arguments in place. AArch64 and SIMD128 emit
-             * two instructions from this intrinsic.
-             *
-             *  [ dk11L | dk11H | dk12L | dk12H ] -> [ dk11L | dk12L | dk21L | dk22L ]
-             *  [ dk21L | dk21H | dk22L | dk22H ] -> [ dk11H | dk12H | dk21H | dk22H ]
-             */
-            uint32x4x2_t unzipped = vuzpq_u32(
-                vreinterpretq_u32_u64(data_key_1),
-                vreinterpretq_u32_u64(data_key_2)
-            );
-            /* data_key_lo = data_key & 0xFFFFFFFF */
-            uint32x4_t data_key_lo = unzipped.val[0];
-            /* data_key_hi = data_key >> 32 */
-            uint32x4_t data_key_hi = unzipped.val[1];
-            /*
-             * Then, we can split the vectors horizontally and multiply which, as for most
-             * widening intrinsics, have a variant that works on both high half vectors
-             * for free on AArch64. A similar instruction is available on SIMD128.
-             *
-             * sum = data_swap + (u64x2) data_key_lo * (u64x2) data_key_hi
-             */
-            uint64x2_t sum_1 = XXH_vmlal_low_u32(data_swap_1, data_key_lo, data_key_hi);
-            uint64x2_t sum_2 = XXH_vmlal_high_u32(data_swap_2, data_key_lo, data_key_hi);
-            /*
-             * Clang reorders
-             *    a += b * c;     // umlal   swap.2d, dkl.2s, dkh.2s
-             *    c += a;         // add     acc.2d, acc.2d, swap.2d
-             * to
-             *    c += a;         // add     acc.2d, acc.2d, swap.2d
-             *    c += b * c;     // umlal   acc.2d, dkl.2s, dkh.2s
-             *
-             * While it would make sense in theory since the addition is faster,
-             * for reasons likely related to umlal being limited to certain NEON
-             * pipelines, this is worse. A compiler guard fixes this.
-             */
-            XXH_COMPILER_GUARD_CLANG_NEON(sum_1);
-            XXH_COMPILER_GUARD_CLANG_NEON(sum_2);
-            /* xacc[i] = acc_vec + sum; */
-            xacc[i]   = vaddq_u64(xacc[i], sum_1);
-            xacc[i+1] = vaddq_u64(xacc[i+1], sum_2);
-        }
-        /* Operate on the remaining NEON lanes 2 at a time. */
-        for (; i < XXH3_NEON_LANES / 2; i++) {
-            /* data_vec = xinput[i]; */
-            uint64x2_t data_vec = XXH_vld1q_u64(xinput  + (i * 16));
-            /* key_vec  = xsecret[i];  */
-            uint64x2_t key_vec  = XXH_vld1q_u64(xsecret + (i * 16));
-            /* acc_vec_2 = swap(data_vec) */
-            uint64x2_t data_swap = vextq_u64(data_vec, data_vec, 1);
-            /* data_key = data_vec ^ key_vec; */
-            uint64x2_t data_key = veorq_u64(data_vec, key_vec);
-            /* For two lanes, just use VMOVN and VSHRN. */
-            /* data_key_lo = data_key & 0xFFFFFFFF; */
-            uint32x2_t data_key_lo = vmovn_u64(data_key);
-            /* data_key_hi = data_key >> 32; */
-            uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
-            /* sum = data_swap + (u64x2) data_key_lo * (u64x2) data_key_hi; */
-            uint64x2_t sum = vmlal_u32(data_swap, data_key_lo, data_key_hi);
-            /* Same Clang workaround as before */
-            XXH_COMPILER_GUARD_CLANG_NEON(sum);
-            /* xacc[i] = acc_vec + sum; */
-            xacc[i] = vaddq_u64 (xacc[i], sum);
-        }
+    /* A doubled version of 1to3_64b with different constants. */
+    XXH_ASSERT(input != NULL);
+    XXH_ASSERT(1 <= len && len <= 3);
+    XXH_ASSERT(secret != NULL);
+    /*
+     * len = 1: combinedl = { input[0], 0x01, input[0], input[0] }
+     * len = 2: combinedl = { input[1], 0x02, input[0], input[1] }
+     * len = 3: combinedl = { input[2], 0x03, input[0], input[1] }
+     */
+    {   xxh_u8 const c1 = input[0];
+        xxh_u8 const c2 = input[len >> 1];
+        xxh_u8 const c3 = input[len - 1];
+        /* len is not a letter, so it can be folded along */
+        xxh_u32 const combinedl = (xxh_u32)XXH3_fold64(
+                                    ((xxh_u32)c1 <<16) | ((xxh_u32)c2 << 24)
+                                  | ((xxh_u32)c3 << 0) | ((xxh_u32)len << 8), fold);
+        xxh_u32 const combinedh = XXH_rotl32(XXH_swap32(combinedl), 13);
+        xxh_u64 const bitflipl = (XXH_readLE32(secret) ^ XXH_readLE32(secret+4)) + seed;
+        xxh_u64 const bitfliph = (XXH_readLE32(secret+8) ^ XXH_readLE32(secret+12)) - seed;
+        xxh_u64 const keyed_lo = (xxh_u64)combinedl ^ bitflipl;
+        xxh_u64 const keyed_hi = (xxh_u64)combinedh ^ bitfliph;
+        XXH128_hash_t h128;
+        h128.low64  = XXH64_avalanche(keyed_lo);
+        h128.high64 = XXH64_avalanche(keyed_hi);
+        return h128;
     }
 }
-XXH_FORCE_INLINE XXH3_ACCUMULATE_TEMPLATE(neon)
 
-XXH_FORCE_INLINE void
-XXH3_scrambleAcc_neon(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_4to8_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                   XXH3_fold fold)
 {
-    XXH_ASSERT((((size_t)acc) & 15) == 0);
+    XXH_ASSERT(input != NULL);
+    XXH_ASSERT(secret != NULL);
+    XXH_ASSERT(4 <= len && len <= 8);
+    seed ^= (xxh_u64)XXH_swap32((xxh_u32)seed) << 32;
+    {   xxh_u32 const input_lo = XXH3_readLE32_fold(input, fold);
+        xxh_u32 const input_hi = XXH3_readLE32_fold(input + len - 4, fold);
+        xxh_u64 const input_64 = input_lo + ((xxh_u64)input_hi << 32);
+        xxh_u64 const bitflip = (XXH_readLE64(secret+16) ^ XXH_readLE64(secret+24)) + seed;
+        xxh_u64 const keyed = input_64 ^ bitflip;
 
-    {   xxh_aliasing_uint64x2_t* xacc       = (xxh_aliasing_uint64x2_t*) acc;
-        uint8_t const* xsecret = (uint8_t const*) secret;
+        /* Shift len to the left to ensure it is even, this avoids even multiplies. */
+        XXH128_hash_t m128 = XXH_mult64to128(keyed, XXH_PRIME64_1 + (len << 2));
 
-        size_t i;
-        /* WASM uses operator overloads and doesn't need these. */
-#ifndef __wasm_simd128__
-        /* { prime32_1, prime32_1 } */
-        uint32x2_t const kPrimeLo = vdup_n_u32(XXH_PRIME32_1);
-        /* { 0, prime32_1, 0, prime32_1 } */
-        uint32x4_t const kPrimeHi = vreinterpretq_u32_u64(vdupq_n_u64((xxh_u64)XXH_PRIME32_1 << 32));
-#endif
+        m128.high64 += (m128.low64 << 1);
+        m128.low64  ^= (m128.high64 >> 3);
 
-        /* AArch64 uses both scalar and neon at the same time */
-        for (i = XXH3_NEON_LANES; i < XXH_ACC_NB; i++) {
-            XXH3_scalarScrambleRound(acc, secret, i);
-        }
-        for (i=0; i < XXH3_NEON_LANES / 2; i++) {
-            /* xacc[i] ^= (xacc[i] >> 47); */
-            uint64x2_t acc_vec  = xacc[i];
-            uint64x2_t shifted  = vshrq_n_u64(acc_vec, 47);
-            uint64x2_t data_vec = veorq_u64(acc_vec, shifted);
+        m128.low64   = XXH_xorshift64(m128.low64, 35);
+        m128.low64  *= PRIME_MX2;
+        m128.low64   = XXH_xorshift64(m128.low64, 28);
+        m128.high64  = XXH3_avalanche(m128.high64);
+        return m128;
+    }
+}
 
-            /* xacc[i] ^= xsecret[i]; */
-            uint64x2_t key_vec  = XXH_vld1q_u64(xsecret + (i * 16));
-            uint64x2_t data_key = veorq_u64(data_vec, key_vec);
-            /* xacc[i] *= XXH_PRIME32_1 */
-#ifdef __wasm_simd128__
-            /* SIMD128 has multiply by u64x2, use it instead of expanding and scalarizing */
-            xacc[i] = data_key * XXH_PRIME32_1;
-#else
+XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_9to16_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                    XXH3_fold fold)
+{
+    XXH_ASSERT(input != NULL);
+    XXH_ASSERT(secret != NULL);
+    XXH_ASSERT(9 <= len && len <= 16);
+    {   xxh_u64 const bitflipl = (XXH_readLE64(secret+32) ^ XXH_readLE64(secret+40)) - seed;
+        xxh_u64 const bitfliph = (XXH_readLE64(secret+48) ^ XXH_readLE64(secret+56)) + seed;
+        xxh_u64 const input_lo = XXH3_readLE64_fold(input, fold);
+        xxh_u64       input_hi = XXH3_readLE64_fold(input + len - 8, fold);
+        XXH128_hash_t m128 = XXH_mult64to128(input_lo ^ input_hi ^ bitflipl, XXH_PRIME64_1);
+        /*
+         * Put len in the middle of m128 to ensure that the length gets mixed to
+         * both the low and high bits in the 128x64 multiply below.
+         */
+        m128.low64 += (xxh_u64)(len - 1) << 54;
+        input_hi   ^= bitfliph;
+        /*
+         * Add the high 32 bits of input_hi to the high 32 bits of m128, then
+         * add the long product of the low 32 bits of input_hi and XXH_PRIME32_2 to
+         * the high 64 bits of m128.
+         *
+         * The best approach to this operation is different on 32-bit and 64-bit.
+         */
+        if (sizeof(void *) < sizeof(xxh_u64)) { /* 32-bit */
             /*
-             * Expanded version with portable NEON intrinsics
+             * 32-bit optimized version, which is more readable.
              *
-             *    lo(x) * lo(y) + (hi(x) * lo(y) << 32)
+             * On 32-bit, it removes an ADC and delays a dependency between the two
+             * halves of m128.high64, but it generates an extra mask on 64-bit.
+             */
+            m128.high64 += (input_hi & 0xFFFFFFFF00000000ULL) + XXH_mult32to64((xxh_u32)input_hi, XXH_PRIME32_2);
+        } else {
+            /*
+             * 64-bit optimized (albeit more confusing) version.
              *
-             * prod_hi = hi(data_key) * lo(prime) << 32
+             * Uses some properties of addition and multiplication to remove the mask:
              *
-             * Since we only need 32 bits of this multiply a trick can be used, reinterpreting the vector
-             * as a uint32x4_t and multiplying by { 0, prime, 0, prime } to cancel out the unwanted bits
-             * and avoid the shift.
+             * Let:
+             *    a = input_hi.lo = (input_hi & 0x00000000FFFFFFFF)
+             *    b = input_hi.hi = (input_hi & 0xFFFFFFFF00000000)
+             *    c = XXH_PRIME32_2
+             *
+             *    a + (b * c)
+             * Inverse Property: x + y - x == y
+             *    a + (b * (1 + c - 1))
+             * Distributive Property: x * (y + z) == (x * y) + (x * z)
+             *    a + (b * 1) + (b * (c - 1))
+             * Identity Property: x * 1 == x
+             *    a + b + (b * (c - 1))
+             *
+             * Substitute a, b, and c:
+             *    input_hi.hi + input_hi.lo + ((xxh_u64)input_hi.lo * (XXH_PRIME32_2 - 1))
+             *
+             * Since input_hi.hi + input_hi.lo == input_hi, we get this:
+             *    input_hi + ((xxh_u64)input_hi.lo * (XXH_PRIME32_2 - 1))
              */
-            uint32x4_t prod_hi = vmulq_u32 (vreinterpretq_u32_u64(data_key), kPrimeHi);
-            /* Extract low bits for vmlal_u32  */
-            uint32x2_t data_key_lo = vmovn_u64(data_key);
-            /* xacc[i] = prod_hi + lo(data_key) * XXH_PRIME32_1; */
-            xacc[i] = vmlal_u32(vreinterpretq_u64_u32(prod_hi), data_key_lo, kPrimeLo);
-#endif
+            m128.high64 += input_hi + XXH_mult32to64((xxh_u32)input_hi, XXH_PRIME32_2 - 1);
         }
-    }
+        /* m128 ^= XXH_swap64(m128 >> 64); */
+        m128.low64  ^= XXH_swap64(m128.high64);
+
+        {   /* 128x64 multiply: h128 = m128 * XXH_PRIME64_2; */
+            XXH128_hash_t h128 = XXH_mult64to128(m128.low64, XXH_PRIME64_2);
+            h128.high64 += m128.high64 * XXH_PRIME64_2;
+
+            h128.low64   = XXH3_avalanche(h128.low64);
+            h128.high64  = XXH3_avalanche(h128.high64);
+            return h128;
+    }   }
 }
-#endif
 
-#if (XXH_VECTOR == XXH_VSX)
+/*
+ * Assumption: `secret` size is >= XXH3_SECRET_SIZE_MIN
+ */
+XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_0to16_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed,
+                    XXH3_fold fold)
+{
+    XXH_ASSERT(len <= 16);
+    {   if (len > 8) return XXH3_len_9to16_128b(input, len, secret, seed, fold);
+        if (len >= 4) return XXH3_len_4to8_128b(input, len, secret, seed, fold);
+        if (len) return XXH3_len_1to3_128b(input, len, secret, seed, fold);
+        {   XXH128_hash_t h128;
+            xxh_u64 const bitflipl = XXH_readLE64(secret+64) ^ XXH_readLE64(secret+72);
+            xxh_u64 const bitfliph = XXH_readLE64(secret+80) ^ XXH_readLE64(secret+88);
+            h128.low64 = XXH64_avalanche(seed ^ bitflipl);
+            h128.high64 = XXH64_avalanche( seed ^ bitfliph);
+            return h128;
+    }   }
+}
 
-XXH_FORCE_INLINE void
-XXH3_accumulate_512_vsx(  void* XXH_RESTRICT acc,
-                    const void* XXH_RESTRICT input,
-                    const void* XXH_RESTRICT secret)
+/*
+ * A bit slower than XXH3_mix16B, but handles multiply by zero better.
+ */
+XXH_FORCE_INLINE XXH128_hash_t
+XXH128_mix32B(XXH128_hash_t acc, const xxh_u8* input_1, const xxh_u8* input_2,
+              const xxh_u8* secret, XXH64_hash_t seed, XXH3_fold fold)
+{
+    xxh_u64 input1_lo, input1_hi, input2_lo, input2_hi;
+    XXH3_readLE128_fold(input_1, &input1_lo, &input1_hi, fold);
+    XXH3_readLE128_fold(input_2, &input2_lo, &input2_hi, fold);
+    acc.low64  += XXH3_mix16B (input_1, secret+0, seed, fold);
+    acc.low64  ^= input2_lo + input2_hi;
+    acc.high64 += XXH3_mix16B (input_2, secret+16, seed, fold);
+    acc.high64 ^= input1_lo + input1_hi;
+    return acc;
+}
+
+
+XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_17to128_128b(const xxh_u8* XXH_RESTRICT input, size_t len,
+                      const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                      XXH64_hash_t seed, XXH3_fold fold)
 {
-    /* presumed aligned */
-    xxh_aliasing_u64x2* const xacc = (xxh_aliasing_u64x2*) acc;
-    xxh_u8 const* const xinput   = (xxh_u8 const*) input;   /* no alignment restriction */
-    xxh_u8 const* const xsecret  = (xxh_u8 const*) secret;    /* no alignment restriction */
-    xxh_u64x2 const v32 = { 32, 32 };
-    size_t i;
-    for (i = 0; i < XXH_STRIPE_LEN / sizeof(xxh_u64x2); i++) {
-        /* data_vec = xinput[i]; */
-        xxh_u64x2 const data_vec = XXH_vec_loadu(xinput + 16*i);
-        /* key_vec = xsecret[i]; */
-        xxh_u64x2 const key_vec  = XXH_vec_loadu(xsecret + 16*i);
-        xxh_u64x2 const data_key = data_vec ^ key_vec;
-        /* shuffled = (data_key << 32) | (data_key >> 32); */
-        xxh_u32x4 const shuffled = (xxh_u32x4)vec_rl(data_key, v32);
-        /* product = ((xxh_u64x2)data_key & 0xFFFFFFFF) * ((xxh_u64x2)shuffled & 0xFFFFFFFF); */
-        xxh_u64x2 const product  = XXH_vec_mulo((xxh_u32x4)data_key, shuffled);
-        /* acc_vec = xacc[i]; */
-        xxh_u64x2 acc_vec        = xacc[i];
-        acc_vec += product;
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
+    XXH_ASSERT(16 < len && len <= 128);
 
-        /* swap high and low halves */
-#ifdef __s390x__
-        acc_vec += vec_permi(data_vec, data_vec, 2);
+    {   XXH128_hash_t acc;
+        acc.low64 = len * XXH_PRIME64_1;
+        acc.high64 = 0;
+
+#if XXH_SIZE_OPT >= 1
+        {
+            /* Smaller, but slightly slower. */
+            unsigned int i = (unsigned int)(len - 1) / 32;
+            do {
+                acc = XXH128_mix32B(acc, input+16*i, input+len-16*(i+1), secret+32*i, seed, fold);
+            } while (i-- != 0);
+        }
 #else
-        acc_vec += vec_xxpermdi(data_vec, data_vec, 2);
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc = XXH128_mix32B(acc, input+48, input+len-64, secret+96, seed, fold);
+                }
+                acc = XXH128_mix32B(acc, input+32, input+len-48, secret+64, seed, fold);
+            }
+            acc = XXH128_mix32B(acc, input+16, input+len-32, secret+32, seed, fold);
+        }
+        acc = XXH128_mix32B(acc, input, input+len-16, secret, seed, fold);
 #endif
-        xacc[i] = acc_vec;
+        {   XXH128_hash_t h128;
+            h128.low64  = acc.low64 + acc.high64;
+            h128.high64 = (acc.low64    * XXH_PRIME64_1)
+                        + (acc.high64   * XXH_PRIME64_4)
+                        + ((len - seed) * XXH_PRIME64_2);
+            h128.low64  = XXH3_avalanche(h128.low64);
+            h128.high64 = (XXH64_hash_t)0 - XXH3_avalanche(h128.high64);
+            return h128;
+        }
     }
 }
-XXH_FORCE_INLINE XXH3_ACCUMULATE_TEMPLATE(vsx)
 
-XXH_FORCE_INLINE void
-XXH3_scrambleAcc_vsx(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_129to240_128b_internal(const xxh_u8* XXH_RESTRICT input, size_t len,
+                                const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                                XXH64_hash_t seed, XXH3_fold fold)
 {
-    XXH_ASSERT((((size_t)acc) & 15) == 0);
-
-    {   xxh_aliasing_u64x2* const xacc = (xxh_aliasing_u64x2*) acc;
-        const xxh_u8* const xsecret = (const xxh_u8*) secret;
-        /* constants */
-        xxh_u64x2 const v32  = { 32, 32 };
-        xxh_u64x2 const v47 = { 47, 47 };
-        xxh_u32x4 const prime = { XXH_PRIME32_1, XXH_PRIME32_1, XXH_PRIME32_1, XXH_PRIME32_1 };
-        size_t i;
-        for (i = 0; i < XXH_STRIPE_LEN / sizeof(xxh_u64x2); i++) {
-            /* xacc[i] ^= (xacc[i] >> 47); */
-            xxh_u64x2 const acc_vec  = xacc[i];
-            xxh_u64x2 const data_vec = acc_vec ^ (acc_vec >> v47);
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
+    XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
 
-            /* xacc[i] ^= xsecret[i]; */
-            xxh_u64x2 const key_vec  = XXH_vec_loadu(xsecret + 16*i);
-            xxh_u64x2 const data_key = data_vec ^ key_vec;
+    {   XXH128_hash_t acc;
+        unsigned i;
+        acc.low64 = len * XXH_PRIME64_1;
+        acc.high64 = 0;
+        /*
+         *  We set as `i` as offset + 32. We do this so that unchanged
+         * `len` can be used as upper bound. This reaches a sweet spot
+         * where both x86 and aarch64 get simple agen and good codegen
+         * for the loop.
+         */
+        for (i = 32; i < 160; i += 32) {
+            acc = XXH128_mix32B(acc,
+                                input  + i - 32,
+                                input  + i - 16,
+                                secret + i - 32,
+                                seed, fold);
+        }
+        acc.low64 = XXH3_avalanche(acc.low64);
+        acc.high64 = XXH3_avalanche(acc.high64);
+        /*
+         * NB: `i <= len` will duplicate the last 32-bytes if
+         * len % 32 was zero. This is an unfortunate necessity to keep
+         * the hash result stable.
+         */
+        for (i=160; i <= len; i += 32) {
+            acc = XXH128_mix32B(acc,
+                                input + i - 32,
+                                input + i - 16,
+                                secret + XXH3_MIDSIZE_STARTOFFSET + i - 160,
+                                seed, fold);
+        }
+        /* last bytes */
+        acc = XXH128_mix32B(acc,
+                            input + len - 16,
+                            input + len - 32,
+                            secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET - 16,
+                            (XXH64_hash_t)0 - seed, fold);
 
-            /* xacc[i] *= XXH_PRIME32_1 */
-            /* prod_lo = ((xxh_u64x2)data_key & 0xFFFFFFFF) * ((xxh_u64x2)prime & 0xFFFFFFFF);  */
-            xxh_u64x2 const prod_even  = XXH_vec_mule((xxh_u32x4)data_key, prime);
-            /* prod_hi = ((xxh_u64x2)data_key >> 32) * ((xxh_u64x2)prime >> 32);  */
-            xxh_u64x2 const prod_odd  = XXH_vec_mulo((xxh_u32x4)data_key, prime);
-            xacc[i] = prod_odd + (prod_even << v32);
-    }   }
+        {   XXH128_hash_t h128;
+            h128.low64  = acc.low64 + acc.high64;
+            h128.high64 = (acc.low64    * XXH_PRIME64_1)
+                        + (acc.high64   * XXH_PRIME64_4)
+                        + ((len - seed) * XXH_PRIME64_2);
+            h128.low64  = XXH3_avalanche(h128.low64);
+            h128.high64 = (XXH64_hash_t)0 - XXH3_avalanche(h128.high64);
+            return h128;
+        }
+    }
 }
 
-#endif
-
-#if (XXH_VECTOR == XXH_SVE)
-
-XXH_FORCE_INLINE void
-XXH3_accumulate_512_sve( void* XXH_RESTRICT acc,
-                   const void* XXH_RESTRICT input,
-                   const void* XXH_RESTRICT secret)
+XXH_NO_INLINE XXH_PUREF XXH128_hash_t
+XXH3_len_129to240_128b(const xxh_u8* XXH_RESTRICT input, size_t len,
+                       const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                       XXH64_hash_t seed)
 {
-    uint64_t *xacc = (uint64_t *)acc;
-    const uint64_t *xinput = (const uint64_t *)(const void *)input;
-    const uint64_t *xsecret = (const uint64_t *)(const void *)secret;
-    svuint64_t kSwap = sveor_n_u64_z(svptrue_b64(), svindex_u64(0, 1), 1);
-    uint64_t element_count = svcntd();
-    if (element_count >= 8) {
-        svbool_t mask = svptrue_pat_b64(SV_VL8);
-        svuint64_t vacc = svld1_u64(mask, xacc);
-        ACCRND(vacc, 0);
-        svst1_u64(mask, xacc, vacc);
-    } else if (element_count == 2) {   /* sve128 */
-        svbool_t mask = svptrue_pat_b64(SV_VL2);
-        svuint64_t acc0 = svld1_u64(mask, xacc + 0);
-        svuint64_t acc1 = svld1_u64(mask, xacc + 2);
-        svuint64_t acc2 = svld1_u64(mask, xacc + 4);
-        svuint64_t acc3 = svld1_u64(mask, xacc + 6);
-        ACCRND(acc0, 0);
-        ACCRND(acc1, 2);
-        ACCRND(acc2, 4);
-        ACCRND(acc3, 6);
-        svst1_u64(mask, xacc + 0, acc0);
-        svst1_u64(mask, xacc + 2, acc1);
-        svst1_u64(mask, xacc + 4, acc2);
-        svst1_u64(mask, xacc + 6, acc3);
-    } else {
-        svbool_t mask = svptrue_pat_b64(SV_VL4);
-        svuint64_t acc0 = svld1_u64(mask, xacc + 0);
-        svuint64_t acc1 = svld1_u64(mask, xacc + 4);
-        ACCRND(acc0, 0);
-        ACCRND(acc1, 4);
-        svst1_u64(mask, xacc + 0, acc0);
-        svst1_u64(mask, xacc + 4, acc1);
-    }
+    return XXH3_len_129to240_128b_internal(input, len, secret, secretSize, seed, XXH3_asIs);
 }
 
-XXH_FORCE_INLINE void
-XXH3_accumulate_sve(xxh_u64* XXH_RESTRICT acc,
-               const xxh_u8* XXH_RESTRICT input,
-               const xxh_u8* XXH_RESTRICT secret,
-               size_t nbStripes)
+XXH_FORCE_INLINE XXH128_hash_t
+XXH3_hashLong_128b_internal(const void* XXH_RESTRICT input, size_t len,
+                            const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                            size_t prefetchDist,
+                            XXH3_f_accumulate f_acc,
+                            XXH3_f_scrambleAcc f_scramble)
 {
-    if (nbStripes != 0) {
-        uint64_t *xacc = (uint64_t *)acc;
-        const uint64_t *xinput = (const uint64_t *)(const void *)input;
-        const uint64_t *xsecret = (const uint64_t *)(const void *)secret;
-        svuint64_t kSwap = sveor_n_u64_z(svptrue_b64(), svindex_u64(0, 1), 1);
-        uint64_t element_count = svcntd();
-        if (element_count >= 8) {
-            svbool_t mask = svptrue_pat_b64(SV_VL8);
-            svuint64_t vacc = svld1_u64(mask, xacc + 0);
-            do {
-                /* svprfd(svbool_t, void *, enum svfprop); */
-                svprfd(mask, xinput + 128, SV_PLDL1STRM);
-                ACCRND(vacc, 0);
-                xinput += 8;
-                xsecret += 1;
-                nbStripes--;
-           } while (nbStripes != 0);
-
-           svst1_u64(mask, xacc + 0, vacc);
-        } else if (element_count == 2) { /* sve128 */
-            svbool_t mask = svptrue_pat_b64(SV_VL2);
-            svuint64_t acc0 = svld1_u64(mask, xacc + 0);
-            svuint64_t acc1 = svld1_u64(mask, xacc + 2);
-            svuint64_t acc2 = svld1_u64(mask, xacc + 4);
-            svuint64_t acc3 = svld1_u64(mask, xacc + 6);
-            do {
-                svprfd(mask, xinput + 128, SV_PLDL1STRM);
-                ACCRND(acc0, 0);
-                ACCRND(acc1, 2);
-                ACCRND(acc2, 4);
-                ACCRND(acc3, 6);
-                xinput += 8;
-                xsecret += 1;
-                nbStripes--;
-           } while (nbStripes != 0);
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
 
-           svst1_u64(mask, xacc + 0, acc0);
-           svst1_u64(mask, xacc + 2, acc1);
-           svst1_u64(mask, xacc + 4, acc2);
-           svst1_u64(mask, xacc + 6, acc3);
-        } else {
-            svbool_t mask = svptrue_pat_b64(SV_VL4);
-            svuint64_t acc0 = svld1_u64(mask, xacc + 0);
-            svuint64_t acc1 = svld1_u64(mask, xacc + 4);
-            do {
-                svprfd(mask, xinput + 128, SV_PLDL1STRM);
-                ACCRND(acc0, 0);
-                ACCRND(acc1, 4);
-                xinput += 8;
-                xsecret += 1;
-                nbStripes--;
-           } while (nbStripes != 0);
+    XXH3_hashLong_internal_loop(acc, (const xxh_u8*)input, len, secret, secretSize, prefetchDist, f_acc, f_scramble);
 
-           svst1_u64(mask, xacc + 0, acc0);
-           svst1_u64(mask, xacc + 4, acc1);
-       }
+    /* converge into final hash */
+    XXH_STATIC_ASSERT(sizeof(acc) == 64);
+    XXH_ASSERT(secretSize >= sizeof(acc) + XXH_SECRET_MERGEACCS_START);
+    {   XXH128_hash_t h128;
+        h128.low64  = XXH3_mergeAccs(acc,
+                                     secret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)len * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc,
+                                     secret + secretSize
+                                            - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)len * XXH_PRIME64_2));
+        return h128;
     }
 }
 
-#endif
-
-/* scalar variants - universal */
+/*
+ * It's important for performance that XXH3_hashLong() is not inlined.
+ */
+XXH_NO_INLINE XXH_PUREF XXH128_hash_t
+XXH3_hashLong_128b_default(const void* XXH_RESTRICT input, size_t len,
+                           XXH64_hash_t seed64,
+                           const void* XXH_RESTRICT secret, size_t secretLen)
+{
+    (void)seed64; (void)secret; (void)secretLen;
+    return XXH3_hashLong_128b_internal(input, len, XXH3_kSecret, sizeof(XXH3_kSecret), XXH_PREFETCH_DIST,
+                                       XXH3_accumulate, XXH3_scrambleAcc);
+}
 
-#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
 /*
- * In XXH3_scalarRound(), GCC and Clang have a similar codegen issue, where they
- * emit an excess mask and a full 64-bit multiply-add (MADD X-form).
- *
- * While this might not seem like much, as AArch64 is a 64-bit architecture, only
- * big Cortex designs have a full 64-bit multiplier.
- *
- * On the little cores, the smaller 32-bit multiplier is used, and full 64-bit
- * multiplies expand to 2-3 multiplies in microcode. This has a major penalty
- * of up to 4 latency cycles and 2 stall cycles in the multiply pipeline.
+ * It's important for performance to pass @p secretLen (when it's static)
+ * to the compiler, so that it can properly optimize the vectorized loop.
  *
- * Thankfully, AArch64 still provides the 32-bit long multiply-add (UMADDL) which does
- * not have this penalty and does the mask automatically.
+ * When the secret size is unknown, or on GCC 12 where the mix of NO_INLINE and FORCE_INLINE
+ * breaks -Og, this is XXH_NO_INLINE.
  */
-XXH_FORCE_INLINE xxh_u64
-XXH_mult32to64_add64(xxh_u64 lhs, xxh_u64 rhs, xxh_u64 acc)
+XXH3_WITH_SECRET_INLINE XXH128_hash_t
+XXH3_hashLong_128b_withSecret(const void* XXH_RESTRICT input, size_t len,
+                              XXH64_hash_t seed64,
+                              const void* XXH_RESTRICT secret, size_t secretLen)
 {
-    xxh_u64 ret;
-    /* note: %x = 64-bit register, %w = 32-bit register */
-    __asm__("umaddl %x0, %w1, %w2, %x3" : "=r" (ret) : "r" (lhs), "r" (rhs), "r" (acc));
-    return ret;
+    (void)seed64;
+    return XXH3_hashLong_128b_internal(input, len, (const xxh_u8*)secret, secretLen, XXH_PREFETCH_DIST,
+                                       XXH3_accumulate, XXH3_scrambleAcc);
 }
-#else
-XXH_FORCE_INLINE xxh_u64
-XXH_mult32to64_add64(xxh_u64 lhs, xxh_u64 rhs, xxh_u64 acc)
+
+XXH_FORCE_INLINE XXH128_hash_t
+XXH3_hashLong_128b_withSeed_internal(const void* XXH_RESTRICT input, size_t len,
+                                XXH64_hash_t seed64,
+                                XXH3_f_accumulate f_acc,
+                                XXH3_f_scrambleAcc f_scramble,
+                                XXH3_f_initCustomSecret f_initSec)
 {
-    return XXH_mult32to64((xxh_u32)lhs, (xxh_u32)rhs) + acc;
+    if (seed64 == 0)
+        return XXH3_hashLong_128b_internal(input, len,
+                                           XXH3_kSecret, sizeof(XXH3_kSecret), XXH_PREFETCH_DIST,
+                                           f_acc, f_scramble);
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
+        f_initSec(secret, seed64);
+        return XXH3_hashLong_128b_internal(input, len, (const xxh_u8*)secret, sizeof(secret), XXH_PREFETCH_DIST,
+                                           f_acc, f_scramble);
+    }
 }
-#endif
 
-/*!
- * @internal
- * @brief Scalar round for @ref XXH3_accumulate_512_scalar().
- *
- * This is extracted to its own function because the NEON path uses a combination
- * of NEON and scalar.
+/*
+ * It's important for performance that XXH3_hashLong is not inlined.
  */
-XXH_FORCE_INLINE void
-XXH3_scalarRound(void* XXH_RESTRICT acc,
-                 void const* XXH_RESTRICT input,
-                 void const* XXH_RESTRICT secret,
-                 size_t lane)
+XXH_NO_INLINE XXH128_hash_t
+XXH3_hashLong_128b_withSeed(const void* input, size_t len,
+                            XXH64_hash_t seed64, const void* XXH_RESTRICT secret, size_t secretLen)
 {
-    xxh_u64* xacc = (xxh_u64*) acc;
-    xxh_u8 const* xinput  = (xxh_u8 const*) input;
-    xxh_u8 const* xsecret = (xxh_u8 const*) secret;
-    XXH_ASSERT(lane < XXH_ACC_NB);
-    XXH_ASSERT(((size_t)acc & (XXH_ACC_ALIGN-1)) == 0);
-    {
-        xxh_u64 const data_val = XXH_readLE64(xinput + lane * 8);
-        xxh_u64 const data_key = data_val ^ XXH_readLE64(xsecret + lane * 8);
-        xacc[lane ^ 1] += data_val; /* swap adjacent lanes */
-        xacc[lane] = XXH_mult32to64_add64(data_key /* & 0xFFFFFFFF */, data_key >> 32, xacc[lane]);
-    }
+    (void)secret; (void)secretLen;
+    return XXH3_hashLong_128b_withSeed_internal(input, len, seed64,
+                XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
 }
 
-/*!
- * @internal
- * @brief Processes a 64 byte block of data using the scalar path.
- */
-XXH_FORCE_INLINE void
-XXH3_accumulate_512_scalar(void* XXH_RESTRICT acc,
-                     const void* XXH_RESTRICT input,
-                     const void* XXH_RESTRICT secret)
+typedef XXH128_hash_t (*XXH3_hashLong128_f)(const void* XXH_RESTRICT, size_t,
+                                            XXH64_hash_t, const void* XXH_RESTRICT, size_t);
+
+XXH_FORCE_INLINE XXH128_hash_t
+XXH3_128bits_internal(const void* input, size_t len,
+                      XXH64_hash_t seed64, const void* XXH_RESTRICT secret, size_t secretLen,
+                      XXH3_hashLong128_f f_hl128)
 {
-    size_t i;
-    /* ARM GCC refuses to unroll this loop, resulting in a 24% slowdown on ARMv6. */
-#if defined(__GNUC__) && !defined(__clang__) \
-  && (defined(__arm__) || defined(__thumb2__)) \
-  && defined(__ARM_FEATURE_UNALIGNED) /* no unaligned access just wastes bytes */ \
-  && XXH_SIZE_OPT <= 0
-#  pragma GCC unroll 8
-#endif
-    for (i=0; i < XXH_ACC_NB; i++) {
-        XXH3_scalarRound(acc, input, secret, i);
-    }
+    XXH_ASSERT(secretLen >= XXH3_SECRET_SIZE_MIN);
+    /*
+     * If an action is to be taken if `secret` conditions are not respected,
+     * it should be done here.
+     * For now, it's a contract pre-condition.
+     * Adding a check and a branch here would cost performance at every hash.
+     */
+    if (len <= 16)
+        return XXH3_len_0to16_128b((const xxh_u8*)input, len, (const xxh_u8*)secret, seed64, XXH3_asIs);
+    if (len <= 128)
+        return XXH3_len_17to128_128b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64, XXH3_asIs);
+    if (len <= XXH3_MIDSIZE_MAX)
+        return XXH3_len_129to240_128b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64);
+    return f_hl128(input, len, seed64, secret, secretLen);
 }
-XXH_FORCE_INLINE XXH3_ACCUMULATE_TEMPLATE(scalar)
+
+
+/* ===   Public XXH128 API   === */
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t XXH3_128bits(XXH_NOESCAPE const void* input, size_t len)
+{
+    return XXH3_128bits_internal(input, len, 0,
+                                 XXH3_kSecret, sizeof(XXH3_kSecret),
+                                 XXH3_hashLong_128b_default);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_withSecret(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretSize)
+{
+    return XXH3_128bits_internal(input, len, 0,
+                                 (const xxh_u8*)secret, secretSize,
+                                 XXH3_hashLong_128b_withSecret);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_withSeed(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+{
+    return XXH3_128bits_internal(input, len, seed,
+                                 XXH3_kSecret, sizeof(XXH3_kSecret),
+                                 XXH3_hashLong_128b_withSeed);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_withSecretandSeed(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed)
+{
+    if (len <= XXH3_MIDSIZE_MAX)
+        return XXH3_128bits_internal(input, len, seed, XXH3_kSecret, sizeof(XXH3_kSecret), NULL);
+    return XXH3_hashLong_128b_withSecret(input, len, seed, secret, secretSize);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH128(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+{
+    return XXH3_128bits_withSeed(input, len, seed);
+}
+
+
+/* ===   Multiple independent inputs   === */
+
+/*!
+ * @internal
+ * @brief Maximum number of inputs advanced in lock-step by XXH3_hashLong_multi().
+ */
+#define XXH3_MULTI_MAX 4
 
 /*!
- * @internal
- * @brief Scalar scramble step for @ref XXH3_scrambleAcc_scalar().
+ * @def XXH3_MULTI_LOCKSTEP
+ * @brief Whether XXH3_64bits_multi() interleaves the stripes of its inputs,
+ *        and XXH3_64bits_multiSeed() the accumulations of its seeds.
  *
- * This is extracted to its own function because the NEON path uses a combination
- * of NEON and scalar.
+ * Interleaving only pays off when the accumulation loop of a single input
+ * can't keep the CPU busy, which is the case of SSE2
+ * (+5% to +30% on a Skylake-class core, 4 KB to 1 MB inputs).
+ * The scalar path is bound by multiplier throughput,
+ * and the AVX2 and AVX512 loops keep their accumulators in registers,
+ * which interleaving breaks: both lose 5-10%.
+ * Other targets have not been measured, and default to no interleaving.
+ */
+#ifndef XXH3_MULTI_LOCKSTEP
+#  if (XXH_VECTOR == XXH_SSE2)
+#    define XXH3_MULTI_LOCKSTEP 1
+#  else
+#    define XXH3_MULTI_LOCKSTEP 0
+#  endif
+#endif
+
+/*
+ * Consumes stripes [first, last) of a long input, scrambling at block ends,
+ * as XXH3_hashLong_internal_loop() does.
+ * Stripe positions, hence secret offsets, only depend on the stripe index.
  */
 XXH_FORCE_INLINE void
-XXH3_scalarScrambleRound(void* XXH_RESTRICT acc,
-                         void const* XXH_RESTRICT secret,
-                         size_t lane)
-{
-    xxh_u64* const xacc = (xxh_u64*) acc;   /* presumed aligned */
-    const xxh_u8* const xsecret = (const xxh_u8*) secret;   /* no alignment restriction */
-    XXH_ASSERT((((size_t)acc) & (XXH_ACC_ALIGN-1)) == 0);
-    XXH_ASSERT(lane < XXH_ACC_NB);
-    {
-        xxh_u64 const key64 = XXH_readLE64(xsecret + lane * 8);
-        xxh_u64 acc64 = xacc[lane];
-        acc64 = XXH_xorshift64(acc64, 47);
-        acc64 ^= key64;
-        acc64 *= XXH_PRIME32_1;
-        xacc[lane] = acc64;
+XXH3_consumeStripesRange(xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT input,
+                         size_t first, size_t last, size_t nbStripesPerBlock,
+                         const xxh_u8* XXH_RESTRICT secret, size_t secretSize)
+{
+    while (first < last) {
+        size_t const blockEnd = (first / nbStripesPerBlock + 1) * nbStripesPerBlock;
+        size_t const end = XXH_MIN(blockEnd, last);
+        XXH3_accumulate(acc, input + first * XXH_STRIPE_LEN,
+                        secret + (first % nbStripesPerBlock) * XXH_SECRET_CONSUME_RATE,
+                        end - first, XXH_PREFETCH_DIST);
+        if (end == blockEnd)
+            XXH3_scrambleAcc(acc, secret + secretSize - XXH_STRIPE_LEN);
+        first = end;
     }
 }
 
-/*!
- * @internal
- * @brief Scrambles the accumulators after a large chunk has been read
+/*
+ * Lock-step variant of XXH3_hashLong_internal_loop(), using the default secret.
+ * Each accumulator ends up exactly as if its input was processed alone.
+ *
+ * All inputs consume the secret at the same offsets for the same stripe index,
+ * so their common stripes are interleaved one stripe at a time.
+ * The remaining stripes of longer inputs are then processed individually.
+ * @p nbInputs is a compile-time constant after inlining,
+ * so that the inner loop is fully unrolled.
  */
 XXH_FORCE_INLINE void
-XXH3_scrambleAcc_scalar(void* XXH_RESTRICT acc, const void* XXH_RESTRICT secret)
+XXH3_hashLong_multi(xxh_u64 (*XXH_RESTRICT accs)[XXH_ACC_NB],
+                    const xxh_u8* const* inputs, const size_t* lens, size_t nbInputs)
 {
-    size_t i;
-    for (i=0; i < XXH_ACC_NB; i++) {
-        XXH3_scalarScrambleRound(acc, secret, i);
+    const xxh_u8* const secret = XXH3_kSecret;
+    size_t const secretSize = sizeof(XXH3_kSecret);
+    size_t const nbStripesPerBlock = (secretSize - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
+    size_t nbCommonStripes = (size_t)-1;
+    size_t s, n;
+
+    XXH_ASSERT(nbInputs <= XXH3_MULTI_MAX);
+    for (s = 0; s < nbInputs; s++) {
+        /* all stripes except the last one, which may overlap */
+        size_t const nbStripes = (lens[s] - 1) / XXH_STRIPE_LEN;
+        XXH_ASSERT(lens[s] > XXH3_MIDSIZE_MAX);
+        nbCommonStripes = XXH_MIN(nbCommonStripes, nbStripes);
+    }
+    if (!XXH3_MULTI_LOCKSTEP) nbCommonStripes = 0;
+
+    for (n = 0; n < nbCommonStripes; n++) {
+        const xxh_u8* const stripeSecret = secret + (n % nbStripesPerBlock) * XXH_SECRET_CONSUME_RATE;
+        for (s = 0; s < nbInputs; s++) {
+            const xxh_u8* const in = inputs[s] + n * XXH_STRIPE_LEN;
+            XXH_PREFETCH_INPUT(in + XXH_PREFETCH_DIST);
+            XXH3_accumulate_512(accs[s], in, stripeSecret);
+        }
+        if ((n + 1) % nbStripesPerBlock == 0) {
+            for (s = 0; s < nbInputs; s++)
+                XXH3_scrambleAcc(accs[s], secret + secretSize - XXH_STRIPE_LEN);
+        }
+    }
+
+    for (s = 0; s < nbInputs; s++) {
+        XXH3_consumeStripesRange(accs[s], inputs[s],
+                                 nbCommonStripes, (lens[s] - 1) / XXH_STRIPE_LEN,
+                                 nbStripesPerBlock, secret, secretSize);
+        /* last stripe */
+        XXH3_accumulate_512(accs[s], inputs[s] + lens[s] - XXH_STRIPE_LEN,
+                            secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START);
     }
 }
 
-XXH_FORCE_INLINE void
-XXH3_initCustomSecret_scalar(void* XXH_RESTRICT customSecret, xxh_u64 seed64)
+/*
+ * Hashes a group of up to XXH3_MULTI_MAX long inputs.
+ * Each group size gets its own instance, so that XXH3_hashLong_multi() is unrolled.
+ */
+XXH_NO_INLINE void
+XXH3_hashLong_multiGroup(xxh_u64 (*XXH_RESTRICT accs)[XXH_ACC_NB],
+                         const xxh_u8* const* inputs, const size_t* lens, size_t nbInputs)
 {
-    /*
-     * We need a separate pointer for the hack below,
-     * which requires a non-const pointer.
-     * Any decent compiler will optimize this out otherwise.
-     */
-    const xxh_u8* kSecretPtr = XXH3_kSecret;
-    XXH_STATIC_ASSERT((XXH_SECRET_DEFAULT_SIZE & 15) == 0);
+    size_t s;
+    for (s = 0; s < nbInputs; s++) {
+        static const xxh_u64 initAcc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        XXH_memcpy(accs[s], initAcc, sizeof(initAcc));
+    }
+    switch (nbInputs) {
+    case 4: XXH3_hashLong_multi(accs, inputs, lens, 4); break;
+    case 3: XXH3_hashLong_multi(accs, inputs, lens, 3); break;
+    case 2: XXH3_hashLong_multi(accs, inputs, lens, 2); break;
+    default: XXH3_hashLong_multi(accs, inputs, lens, 1); break;
+    }
+}
 
-#if defined(__GNUC__) && defined(__aarch64__)
-    /*
-     * UGLY HACK:
-     * GCC and Clang generate a bunch of MOV/MOVK pairs for aarch64, and they are
-     * placed sequentially, in order, at the top of the unrolled loop.
-     *
-     * While MOVK is great for generating constants (2 cycles for a 64-bit
-     * constant compared to 4 cycles for LDR), it fights for bandwidth with
-     * the arithmetic instructions.
-     *
-     *   I   L   S
-     * MOVK
-     * MOVK
-     * MOVK
-     * MOVK
-     * ADD
-     * SUB      STR
-     *          STR
-     * By forcing loads from memory (as the asm line causes the compiler to assume
-     * that XXH3_kSecretPtr has been changed), the pipelines are used more
-     * efficiently:
-     *   I   L   S
-     *      LDR
-     *  ADD LDR
-     *  SUB     STR
-     *          STR
-     *
-     * See XXH3_NEON_LANES for details on the pipsline.
-     *
-     * XXH3_64bits_withSeed, len == 256, Snapdragon 835
-     *   without hack: 2654.4 MB/s
-     *   with hack:    3202.9 MB/s
-     */
-    XXH_COMPILER_GUARD(kSecretPtr);
-#endif
-    {   int const nbRounds = XXH_SECRET_DEFAULT_SIZE / 16;
-        int i;
-        for (i=0; i < nbRounds; i++) {
-            /*
-             * The asm hack causes the compiler to assume that kSecretPtr aliases with
-             * customSecret, and on aarch64, this prevented LDP from merging two
-             * loads together for free. Putting the loads together before the stores
-             * properly generates LDP.
-             */
-            xxh_u64 lo = XXH_readLE64(kSecretPtr + 16*i)     + seed64;
-            xxh_u64 hi = XXH_readLE64(kSecretPtr + 16*i + 8) - seed64;
-            XXH_writeLE64((xxh_u8*)customSecret + 16*i,     lo);
-            XXH_writeLE64((xxh_u8*)customSecret + 16*i + 8, hi);
+/*
+ * Hashes a group of long inputs in lock-step,
+ * then converges each of them into its final hash,
+ * as XXH3_hashLong_64b_internal() and XXH3_hashLong_128b_internal() do.
+ * @p out64 or @p out128 selects the hash width.
+ */
+static void
+XXH3_multi_flush(const xxh_u8* const* inputs, const size_t* lens, const size_t* indexes,
+                 size_t nbInputs, XXH64_hash_t* out64, XXH128_hash_t* out128)
+{
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 accs[XXH3_MULTI_MAX][XXH_ACC_NB];
+    size_t s;
+
+    XXH3_hashLong_multiGroup(accs, inputs, lens, nbInputs);
+    XXH_ASSERT(sizeof(XXH3_kSecret) >= sizeof(accs[0]) + XXH_SECRET_MERGEACCS_START);
+    for (s = 0; s < nbInputs; s++) {
+        xxh_u64 const len = (xxh_u64)lens[s];
+        xxh_u64 const low64 = XXH3_mergeAccs(accs[s], XXH3_kSecret + XXH_SECRET_MERGEACCS_START,
+                                             len * XXH_PRIME64_1);
+        if (out64 != NULL) {
+            out64[indexes[s]] = low64;
+        } else {
+            XXH128_hash_t h128;
+            h128.low64  = low64;
+            h128.high64 = XXH3_mergeAccs(accs[s], XXH3_kSecret + sizeof(XXH3_kSecret)
+                                                       - sizeof(accs[s]) - XXH_SECRET_MERGEACCS_START,
+                                         ~(len * XXH_PRIME64_2));
+            out128[indexes[s]] = h128;
     }   }
 }
 
+/*
+ * Hashes short inputs immediately,
+ * and gathers long inputs into groups of XXH3_MULTI_MAX, hashed in lock-step.
+ */
+XXH_FORCE_INLINE void
+XXH3_multi_internal(const void* const* inputs, const size_t* lens, size_t nbInputs,
+                    XXH64_hash_t* out64, XXH128_hash_t* out128)
+{
+    const xxh_u8* groupInputs[XXH3_MULTI_MAX];
+    size_t groupLens[XXH3_MULTI_MAX];
+    size_t groupIndexes[XXH3_MULTI_MAX];
+    size_t nbGrouped = 0;
+    size_t n;
 
-typedef void (*XXH3_f_accumulate)(xxh_u64* XXH_RESTRICT, const xxh_u8* XXH_RESTRICT, const xxh_u8* XXH_RESTRICT, size_t);
-typedef void (*XXH3_f_scrambleAcc)(void* XXH_RESTRICT, const void*);
-typedef void (*XXH3_f_initCustomSecret)(void* XXH_RESTRICT, xxh_u64);
-
-
-#if (XXH_VECTOR == XXH_AVX512)
-
-#define XXH3_accumulate_512 XXH3_accumulate_512_avx512
-#define XXH3_accumulate     XXH3_accumulate_avx512
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_avx512
-#define XXH3_initCustomSecret XXH3_initCustomSecret_avx512
-
-#elif (XXH_VECTOR == XXH_AVX2)
-
-#define XXH3_accumulate_512 XXH3_accumulate_512_avx2
-#define XXH3_accumulate     XXH3_accumulate_avx2
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_avx2
-#define XXH3_initCustomSecret XXH3_initCustomSecret_avx2
-
-#elif (XXH_VECTOR == XXH_SSE2)
-
-#define XXH3_accumulate_512 XXH3_accumulate_512_sse2
-#define XXH3_accumulate     XXH3_accumulate_sse2
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_sse2
-#define XXH3_initCustomSecret XXH3_initCustomSecret_sse2
-
-#elif (XXH_VECTOR == XXH_NEON)
-
-#define XXH3_accumulate_512 XXH3_accumulate_512_neon
-#define XXH3_accumulate     XXH3_accumulate_neon
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_neon
-#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
-
-#elif (XXH_VECTOR == XXH_VSX)
-
-#define XXH3_accumulate_512 XXH3_accumulate_512_vsx
-#define XXH3_accumulate     XXH3_accumulate_vsx
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_vsx
-#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+    XXH_ASSERT(nbInputs == 0 || (inputs != NULL && lens != NULL));
+    for (n = 0; n < nbInputs; n++) {
+        if (lens[n] <= XXH3_MIDSIZE_MAX) {
+            if (out64 != NULL) out64[n] = XXH3_64bits(inputs[n], lens[n]);
+            else out128[n] = XXH3_128bits(inputs[n], lens[n]);
+            continue;
+        }
+        groupInputs[nbGrouped] = (const xxh_u8*)inputs[n];
+        groupLens[nbGrouped] = lens[n];
+        groupIndexes[nbGrouped] = n;
+        if (++nbGrouped == XXH3_MULTI_MAX) {
+            XXH3_multi_flush(groupInputs, groupLens, groupIndexes, nbGrouped, out64, out128);
+            nbGrouped = 0;
+        }
+    }
+    if (nbGrouped)
+        XXH3_multi_flush(groupInputs, groupLens, groupIndexes, nbGrouped, out64, out128);
+}
 
-#elif (XXH_VECTOR == XXH_SVE)
-#define XXH3_accumulate_512 XXH3_accumulate_512_sve
-#define XXH3_accumulate     XXH3_accumulate_sve
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_scalar
-#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_64bits_multi(XXH_NOESCAPE const void* const* inputs, XXH_NOESCAPE const size_t* lens,
+                  size_t nbInputs, XXH_NOESCAPE XXH64_hash_t* out)
+{
+    XXH_ASSERT(nbInputs == 0 || out != NULL);
+    XXH3_multi_internal(inputs, lens, nbInputs, out, NULL);
+}
 
-#else /* scalar */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_128bits_multi(XXH_NOESCAPE const void* const* inputs, XXH_NOESCAPE const size_t* lens,
+                   size_t nbInputs, XXH_NOESCAPE XXH128_hash_t* out)
+{
+    XXH_ASSERT(nbInputs == 0 || out != NULL);
+    XXH3_multi_internal(inputs, lens, nbInputs, NULL, out);
+}
 
-#define XXH3_accumulate_512 XXH3_accumulate_512_scalar
-#define XXH3_accumulate     XXH3_accumulate_scalar
-#define XXH3_scrambleAcc    XXH3_scrambleAcc_scalar
-#define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
+/* ===   XXH3 128-bit streaming   === */
+#ifndef XXH_NO_STREAM
+/*
+ * All initialization and update functions are identical to 64-bit streaming variant.
+ * The only difference is the finalization routine.
+ */
 
-#endif
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_reset(XXH_NOESCAPE XXH3_state_t* statePtr)
+{
+    return XXH3_64bits_reset(statePtr);
+}
 
-#if XXH_SIZE_OPT >= 1 /* don't do SIMD for initialization */
-#  undef XXH3_initCustomSecret
-#  define XXH3_initCustomSecret XXH3_initCustomSecret_scalar
-#endif
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_reset_withSecret(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize)
+{
+    return XXH3_64bits_reset_withSecret(statePtr, secret, secretSize);
+}
 
-XXH_FORCE_INLINE void
-XXH3_hashLong_internal_loop(xxh_u64* XXH_RESTRICT acc,
-                      const xxh_u8* XXH_RESTRICT input, size_t len,
-                      const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
-                            XXH3_f_accumulate f_acc,
-                            XXH3_f_scrambleAcc f_scramble)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_reset_withSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH64_hash_t seed)
 {
-    size_t const nbStripesPerBlock = (secretSize - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
-    size_t const block_len = XXH_STRIPE_LEN * nbStripesPerBlock;
-    size_t const nb_blocks = (len - 1) / block_len;
+    return XXH3_64bits_reset_withSeed(statePtr, seed);
+}
 
-    size_t n;
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_reset_withSecretandSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed)
+{
+    return XXH3_64bits_reset_withSecretandSeed(statePtr, secret, secretSize, seed);
+}
 
-    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN);
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_update(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
+{
+    return XXH3_64bits_update(state, input, len);
+}
 
-    for (n = 0; n < nb_blocks; n++) {
-        f_acc(acc, input + n*block_len, secret, nbStripesPerBlock);
-        f_scramble(acc, secret + secretSize - XXH_STRIPE_LEN);
+XXH_FORCE_INLINE XXH128_hash_t
+XXH3_128bits_digest_internal(const XXH3_state_t* state,
+                             XXH3_f_accumulate f_acc,
+                             XXH3_f_scrambleAcc f_scramble,
+                             XXH3_f_initCustomSecret f_initSec)
+{
+    XXH_ALIGN(XXH_SEC_ALIGN) unsigned char secretBuffer[XXH_SECRET_DEFAULT_SIZE];
+    if (state->totalLen > XXH3_MIDSIZE_MAX) {
+        const unsigned char* const secret = XXH3_digestSecret(state, secretBuffer, f_initSec);
+        XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
+        XXH3_digest_long(acc, state, secret, f_acc, f_scramble);
+        XXH_ASSERT(state->secretLimit + XXH_STRIPE_LEN >= sizeof(acc) + XXH_SECRET_MERGEACCS_START);
+        {   XXH128_hash_t h128;
+            h128.low64  = XXH3_mergeAccs(acc,
+                                         secret + XXH_SECRET_MERGEACCS_START,
+                                         (xxh_u64)state->totalLen * XXH_PRIME64_1);
+            h128.high64 = XXH3_mergeAccs(acc,
+                                         secret + state->secretLimit + XXH_STRIPE_LEN
+                                                - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                         ~((xxh_u64)state->totalLen * XXH_PRIME64_2));
+            return h128;
+        }
     }
+    /* len <= XXH3_MIDSIZE_MAX : short code */
+    if (state->useSeed)
+        return XXH3_128bits_withSeed(state->buffer, (size_t)state->totalLen, state->seed);
+    return XXH3_128bits_withSecret(state->buffer, (size_t)(state->totalLen),
+                                   XXH3_digestSecret(state, secretBuffer, f_initSec),
+                                   state->secretLimit + XXH_STRIPE_LEN);
+}
 
-    /* last partial block */
-    XXH_ASSERT(len > XXH_STRIPE_LEN);
-    {   size_t const nbStripes = ((len - 1) - (block_len * nb_blocks)) / XXH_STRIPE_LEN;
-        XXH_ASSERT(nbStripes <= (secretSize / XXH_SECRET_CONSUME_RATE));
-        f_acc(acc, input + nb_blocks*block_len, secret, nbStripes);
-
-        /* last stripe */
-        {   const xxh_u8* const p = input + len - XXH_STRIPE_LEN;
-#define XXH_SECRET_LASTACC_START 7  /* not aligned on 8, last secret is different from acc & scrambler */
-            XXH3_accumulate_512(acc, p, secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START);
-    }   }
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_digest (XXH_NOESCAPE const XXH3_state_t* state)
+{
+    return XXH3_128bits_digest_internal(state, XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
 }
 
-XXH_FORCE_INLINE xxh_u64
-XXH3_mix2Accs(const xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT secret)
+/* ===   XXH3 state serialization   === */
+
+/* flags of a saved XXH3 state, 3rd byte of the header */
+#define XXH3_SAVESTATE_USESEED    1  /* short inputs are hashed with the seed */
+#define XXH3_SAVESTATE_SEEDSECRET 2  /* the secret is derived from the seed */
+#define XXH3_SAVESTATE_EXTSECRET  4  /* the secret was provided by the user */
+#define XXH3_SAVESTATE_HEADERSIZE 104
+
+/*
+ * Number of bytes at the end of the internal buffer
+ * which XXH3_digest_long() uses to complete the last stripe.
+ */
+static size_t XXH3_catchupSize(const XXH3_state_t* statePtr)
 {
-    return XXH3_mul128_fold64(
-               acc[0] ^ XXH_readLE64(secret),
-               acc[1] ^ XXH_readLE64(secret+8) );
+    if (statePtr->totalLen > XXH3_MIDSIZE_MAX && statePtr->bufferedSize < XXH_STRIPE_LEN)
+        return XXH_STRIPE_LEN - statePtr->bufferedSize;
+    return 0;
 }
 
-static XXH64_hash_t
-XXH3_mergeAccs(const xxh_u64* XXH_RESTRICT acc, const xxh_u8* XXH_RESTRICT secret, xxh_u64 start)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API size_t
+XXH3_saveState(XXH_NOESCAPE const XXH3_state_t* statePtr, XXH_NOESCAPE void* dst, size_t dstCapacity)
+{
+    xxh_u8* const op = (xxh_u8*)dst;
+    size_t const secretSize = statePtr->secretLimit + XXH_STRIPE_LEN;
+    size_t const catchupSize = XXH3_catchupSize(statePtr);
+    size_t const size = XXH3_SAVESTATE_HEADERSIZE + statePtr->bufferedSize + catchupSize;
+    xxh_u8 flags = statePtr->useSeed ? XXH3_SAVESTATE_USESEED : 0;
+    xxh_u64 fingerprint = 0;
+    size_t i;
+
+    XXH_ASSERT(statePtr->bufferedSize <= XXH3_INTERNALBUFFER_SIZE);
+    if (dst == NULL || dstCapacity < size) return 0;
+    if ((xxh_u32)secretSize != secretSize) return 0;
+    if (statePtr->extSecret == NULL) {
+        flags |= XXH3_SAVESTATE_SEEDSECRET;
+    } else if (statePtr->extSecret != XXH3_kSecret
+      /* each translation unit has its own copy of XXH3_kSecret, compare contents too */
+      && (secretSize != sizeof(XXH3_kSecret)
+       || memcmp(statePtr->extSecret, XXH3_kSecret, sizeof(XXH3_kSecret)))) {
+        flags |= XXH3_SAVESTATE_EXTSECRET;
+        fingerprint = XXH3_64bits(statePtr->extSecret, secretSize);
+    }
+
+    op[0] = XXH_SAVESTATE_VERSION;
+    op[1] = XXH_SAVESTATE_ID_XXH3;
+    op[2] = flags;
+    op[3] = 0;
+    XXH_writeLE64(op + 4, statePtr->totalLen);
+    for (i = 0; i < XXH_ACC_NB; i++) XXH_writeLE64(op + 12 + 8*i, statePtr->acc[i]);
+    XXH_writeLE32(op + 76, (xxh_u32)statePtr->nbStripesSoFar);
+    XXH_writeLE32(op + 80, statePtr->bufferedSize);
+    XXH_writeLE64(op + 84, statePtr->seed);
+    XXH_writeLE32(op + 92, (xxh_u32)secretSize);
+    XXH_writeLE64(op + 96, fingerprint);
+    XXH_memcpy(op + XXH3_SAVESTATE_HEADERSIZE, statePtr->buffer, statePtr->bufferedSize);
+    XXH_memcpy(op + XXH3_SAVESTATE_HEADERSIZE + statePtr->bufferedSize,
+               statePtr->buffer + sizeof(statePtr->buffer) - catchupSize, catchupSize);
+    return size;
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_loadState(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* src, size_t srcSize,
+               const void* secret, size_t secretSize)
 {
-    xxh_u64 result64 = start;
-    size_t i = 0;
+    const xxh_u8* const ip = (const xxh_u8*)src;
+    xxh_u8 flags;
+    size_t savedSecretSize;
+    size_t i;
 
-    for (i = 0; i < 4; i++) {
-        result64 += XXH3_mix2Accs(acc+2*i, secret + 16*i);
-#if defined(__clang__)                                /* Clang */ \
-    && (defined(__arm__) || defined(__thumb__))       /* ARMv7 */ \
-    && (defined(__ARM_NEON) || defined(__ARM_NEON__)) /* NEON */  \
-    && !defined(XXH_ENABLE_AUTOVECTORIZE)             /* Define to disable */
-        /*
-         * UGLY HACK:
-         * Prevent autovectorization on Clang ARMv7-a. Exact same problem as
-         * the one in XXH3_len_129to240_64b. Speeds up shorter keys > 240b.
-         * XXH3_64bits, len == 256, Snapdragon 835:
-         *   without hack: 2063.7 MB/s
-         *   with hack:    2560.7 MB/s
-         */
-        XXH_COMPILER_GUARD(result64);
-#endif
+    if (statePtr == NULL || src == NULL || srcSize < XXH3_SAVESTATE_HEADERSIZE) return XXH_ERROR;
+    if (ip[0] != XXH_SAVESTATE_VERSION || ip[1] != XXH_SAVESTATE_ID_XXH3 || ip[3] != 0) return XXH_ERROR;
+    flags = ip[2];
+    savedSecretSize = XXH_readLE32(ip + 92);
+    if (flags & ~(XXH3_SAVESTATE_USESEED | XXH3_SAVESTATE_SEEDSECRET | XXH3_SAVESTATE_EXTSECRET)) return XXH_ERROR;
+    if (savedSecretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
+    if (flags & XXH3_SAVESTATE_EXTSECRET) {
+        if (flags & XXH3_SAVESTATE_SEEDSECRET) return XXH_ERROR;
+        if (secret == NULL || secretSize != savedSecretSize) return XXH_ERROR;
+        if (XXH3_64bits(secret, secretSize) != XXH_readLE64(ip + 96)) return XXH_ERROR;
+    } else if (savedSecretSize != XXH_SECRET_DEFAULT_SIZE) {
+        return XXH_ERROR;
     }
 
-    return XXH3_avalanche(result64);
+    statePtr->totalLen = XXH_readLE64(ip + 4);
+    for (i = 0; i < XXH_ACC_NB; i++) statePtr->acc[i] = XXH_readLE64(ip + 12 + 8*i);
+    statePtr->nbStripesSoFar = XXH_readLE32(ip + 76);
+    statePtr->bufferedSize = XXH_readLE32(ip + 80);
+    statePtr->seed = XXH_readLE64(ip + 84);
+    statePtr->useSeed = (flags & XXH3_SAVESTATE_USESEED) != 0;
+    statePtr->reserved32 = 0;
+    statePtr->secretLimit = savedSecretSize - XXH_STRIPE_LEN;
+    statePtr->nbStripesPerBlock = statePtr->secretLimit / XXH_SECRET_CONSUME_RATE;
+    if (statePtr->nbStripesSoFar >= statePtr->nbStripesPerBlock
+     || statePtr->bufferedSize > XXH3_INTERNALBUFFER_SIZE
+     || statePtr->bufferedSize > statePtr->totalLen
+     || srcSize != XXH3_SAVESTATE_HEADERSIZE + statePtr->bufferedSize + XXH3_catchupSize(statePtr))
+        return XXH_ERROR;
+
+    if (flags & XXH3_SAVESTATE_EXTSECRET) {
+        statePtr->extSecret = (const unsigned char*)secret;
+        statePtr->secretPending = 0;
+    } else if (flags & XXH3_SAVESTATE_SEEDSECRET) {
+        statePtr->extSecret = NULL;
+        statePtr->secretPending = 1;
+    } else {
+        statePtr->extSecret = XXH3_kSecret;
+        statePtr->secretPending = 0;
+    }
+    {   size_t const catchupSize = XXH3_catchupSize(statePtr);
+        XXH_memcpy(statePtr->buffer, ip + XXH3_SAVESTATE_HEADERSIZE, statePtr->bufferedSize);
+        XXH_memcpy(statePtr->buffer + sizeof(statePtr->buffer) - catchupSize,
+                   ip + XXH3_SAVESTATE_HEADERSIZE + statePtr->bufferedSize, catchupSize);
+    }
+    return XXH_OK;
 }
+#endif /* !XXH_NO_STREAM */
+/* 128-bit utility functions */
 
-#define XXH3_INIT_ACC { XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3, \
-                        XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1 }
+#include <string.h>   /* memcmp, memcpy */
 
-XXH_FORCE_INLINE XXH64_hash_t
-XXH3_hashLong_64b_internal(const void* XXH_RESTRICT input, size_t len,
-                           const void* XXH_RESTRICT secret, size_t secretSize,
-                           XXH3_f_accumulate f_acc,
-                           XXH3_f_scrambleAcc f_scramble)
+/* return : 1 is equal, 0 if different */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API int XXH128_isEqual(XXH128_hash_t h1, XXH128_hash_t h2)
 {
-    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    /* note : XXH128_hash_t is compact, it has no padding byte */
+    return !(memcmp(&h1, &h2, sizeof(h1)));
+}
 
-    XXH3_hashLong_internal_loop(acc, (const xxh_u8*)input, len, (const xxh_u8*)secret, secretSize, f_acc, f_scramble);
+/* This prototype is compatible with stdlib's qsort().
+ * @return : >0 if *h128_1  > *h128_2
+ *           <0 if *h128_1  < *h128_2
+ *           =0 if *h128_1 == *h128_2  */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API int XXH128_cmp(XXH_NOESCAPE const void* h128_1, XXH_NOESCAPE const void* h128_2)
+{
+    XXH128_hash_t const h1 = *(const XXH128_hash_t*)h128_1;
+    XXH128_hash_t const h2 = *(const XXH128_hash_t*)h128_2;
+    int const hcmp = (h1.high64 > h2.high64) - (h2.high64 > h1.high64);
+    /* note : bets that, in most cases, hash values are different */
+    if (hcmp) return hcmp;
+    return (h1.low64 > h2.low64) - (h2.low64 > h1.low64);
+}
 
-    /* converge into final hash */
-    XXH_STATIC_ASSERT(sizeof(acc) == 64);
-    /* do not align on 8, so that the secret is different from the accumulator */
-#define XXH_SECRET_MERGEACCS_START 11
-    XXH_ASSERT(secretSize >= sizeof(acc) + XXH_SECRET_MERGEACCS_START);
-    return XXH3_mergeAccs(acc, (const xxh_u8*)secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
+
+/*======   Canonical representation   ======*/
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH128_canonicalFromHash(XXH_NOESCAPE XXH128_canonical_t* dst, XXH128_hash_t hash)
+{
+    XXH_STATIC_ASSERT(sizeof(XXH128_canonical_t) == sizeof(XXH128_hash_t));
+    if (XXH_CPU_LITTLE_ENDIAN) {
+        hash.high64 = XXH_swap64(hash.high64);
+        hash.low64  = XXH_swap64(hash.low64);
+    }
+    XXH_memcpy(dst, &hash.high64, sizeof(hash.high64));
+    XXH_memcpy((char*)dst + sizeof(hash.high64), &hash.low64, sizeof(hash.low64));
 }
 
-/*
- * It's important for performance to transmit secret's size (when it's static)
- * so that the compiler can properly optimize the vectorized loop.
- * This makes a big performance difference for "medium" keys (<1 KB) when using AVX instruction set.
- * When the secret size is unknown, or on GCC 12 where the mix of NO_INLINE and FORCE_INLINE
- * breaks -Og, this is XXH_NO_INLINE.
- */
-XXH3_WITH_SECRET_INLINE XXH64_hash_t
-XXH3_hashLong_64b_withSecret(const void* XXH_RESTRICT input, size_t len,
-                             XXH64_hash_t seed64, const xxh_u8* XXH_RESTRICT secret, size_t secretLen)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH128_hashFromCanonical(XXH_NOESCAPE const XXH128_canonical_t* src)
 {
-    (void)seed64;
-    return XXH3_hashLong_64b_internal(input, len, secret, secretLen, XXH3_accumulate, XXH3_scrambleAcc);
+    XXH128_hash_t h;
+    h.high64 = XXH_readBE64(src);
+    h.low64  = XXH_readBE64(src->digest + 8);
+    return h;
 }
 
-/*
- * It's preferable for performance that XXH3_hashLong is not inlined,
- * as it results in a smaller function for small data, easier to the instruction cache.
- * Note that inside this no_inline function, we do inline the internal loop,
- * and provide a statically defined secret size to allow optimization of vector loop.
+
+
+/* ==========================================
+ * Secret generators
+ * ==========================================
  */
-XXH_NO_INLINE XXH_PUREF XXH64_hash_t
-XXH3_hashLong_64b_default(const void* XXH_RESTRICT input, size_t len,
-                          XXH64_hash_t seed64, const xxh_u8* XXH_RESTRICT secret, size_t secretLen)
+
+XXH_FORCE_INLINE void XXH3_combine16(void* dst, XXH128_hash_t h128)
 {
-    (void)seed64; (void)secret; (void)secretLen;
-    return XXH3_hashLong_64b_internal(input, len, XXH3_kSecret, sizeof(XXH3_kSecret), XXH3_accumulate, XXH3_scrambleAcc);
+    XXH_writeLE64( dst, XXH_readLE64(dst) ^ h128.low64 );
+    XXH_writeLE64( (char*)dst+8, XXH_readLE64((char*)dst+8) ^ h128.high64 );
 }
 
-/*
- * XXH3_hashLong_64b_withSeed():
- * Generate a custom key based on alteration of default XXH3_kSecret with the seed,
- * and then use this key for long mode hashing.
- *
- * This operation is decently fast but nonetheless costs a little bit of time.
- * Try to avoid it whenever possible (typically when seed==0).
- *
- * It's important for performance that XXH3_hashLong is not inlined. Not sure
- * why (uop cache maybe?), but the difference is large and easily measurable.
- */
-XXH_FORCE_INLINE XXH64_hash_t
-XXH3_hashLong_64b_withSeed_internal(const void* input, size_t len,
-                                    XXH64_hash_t seed,
-                                    XXH3_f_accumulate f_acc,
-                                    XXH3_f_scrambleAcc f_scramble,
-                                    XXH3_f_initCustomSecret f_initSec)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_generateSecret(XXH_NOESCAPE void* secretBuffer, size_t secretSize, XXH_NOESCAPE const void* customSeed, size_t customSeedSize)
 {
-#if XXH_SIZE_OPT <= 0
-    if (seed == 0)
-        return XXH3_hashLong_64b_internal(input, len,
-                                          XXH3_kSecret, sizeof(XXH3_kSecret),
-                                          f_acc, f_scramble);
+#if (XXH_DEBUGLEVEL >= 1)
+    XXH_ASSERT(secretBuffer != NULL);
+    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN);
+#else
+    /* production mode, assert() are disabled */
+    if (secretBuffer == NULL) return XXH_ERROR;
+    if (secretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
 #endif
-    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
-        f_initSec(secret, seed);
-        return XXH3_hashLong_64b_internal(input, len, secret, sizeof(secret),
-                                          f_acc, f_scramble);
+
+    if (customSeedSize == 0) {
+        customSeed = XXH3_kSecret;
+        customSeedSize = XXH_SECRET_DEFAULT_SIZE;
+    }
+#if (XXH_DEBUGLEVEL >= 1)
+    XXH_ASSERT(customSeed != NULL);
+#else
+    if (customSeed == NULL) return XXH_ERROR;
+#endif
+
+    /* Fill secretBuffer with a copy of customSeed - repeat as needed */
+    {   size_t pos = 0;
+        while (pos < secretSize) {
+            size_t const toCopy = XXH_MIN((secretSize - pos), customSeedSize);
+            memcpy((char*)secretBuffer + pos, customSeed, toCopy);
+            pos += toCopy;
+    }   }
+
+    {   size_t const nbSeg16 = secretSize / 16;
+        size_t n;
+        XXH128_canonical_t scrambler;
+        XXH128_canonicalFromHash(&scrambler, XXH128(customSeed, customSeedSize, 0));
+        for (n=0; n<nbSeg16; n++) {
+            XXH128_hash_t const h128 = XXH128(&scrambler, sizeof(scrambler), n);
+            XXH3_combine16((char*)secretBuffer + n*16, h128);
+        }
+        /* last segment */
+        XXH3_combine16((char*)secretBuffer + secretSize - 16, XXH128_hashFromCanonical(&scrambler));
     }
+    return XXH_OK;
 }
 
-/*
- * It's important for performance that XXH3_hashLong is not inlined.
- */
-XXH_NO_INLINE XXH64_hash_t
-XXH3_hashLong_64b_withSeed(const void* XXH_RESTRICT input, size_t len,
-                           XXH64_hash_t seed, const xxh_u8* XXH_RESTRICT secret, size_t secretLen)
+XXH_FORCE_INLINE void
+XXH3_generateSecret_fromSeed_internal(void* secretBuffer, XXH64_hash_t seed,
+                                      XXH3_f_initCustomSecret f_initSec)
 {
-    (void)secret; (void)secretLen;
-    return XXH3_hashLong_64b_withSeed_internal(input, len, seed,
-                XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
+    XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
+    f_initSec(secret, seed);
+    XXH_ASSERT(secretBuffer != NULL);
+    memcpy(secretBuffer, secret, XXH_SECRET_DEFAULT_SIZE);
 }
 
-
-typedef XXH64_hash_t (*XXH3_hashLong64_f)(const void* XXH_RESTRICT, size_t,
-                                          XXH64_hash_t, const xxh_u8* XXH_RESTRICT, size_t);
-
-XXH_FORCE_INLINE XXH64_hash_t
-XXH3_64bits_internal(const void* XXH_RESTRICT input, size_t len,
-                     XXH64_hash_t seed64, const void* XXH_RESTRICT secret, size_t secretLen,
-                     XXH3_hashLong64_f f_hashLong)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_generateSecret_fromSeed(XXH_NOESCAPE void* secretBuffer, XXH64_hash_t seed)
 {
-    XXH_ASSERT(secretLen >= XXH3_SECRET_SIZE_MIN);
-    /*
-     * If an action is to be taken if `secretLen` condition is not respected,
-     * it should be done here.
-     * For now, it's a contract pre-condition.
-     * Adding a check and a branch here would cost performance at every hash.
-     * Also, note that function signature doesn't offer room to return an error.
-     */
-    if (len <= 16)
-        return XXH3_len_0to16_64b((const xxh_u8*)input, len, (const xxh_u8*)secret, seed64);
-    if (len <= 128)
-        return XXH3_len_17to128_64b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64);
-    if (len <= XXH3_MIDSIZE_MAX)
-        return XXH3_len_129to240_64b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64);
-    return f_hashLong(input, len, seed64, (const xxh_u8*)secret, secretLen);
+    XXH3_generateSecret_fromSeed_internal(secretBuffer, seed, XXH3_initCustomSecret);
 }
 
 
-/* ===   Public entry point   === */
+/* ===   XXH3 seed context   === */
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH64_hash_t XXH3_64bits(XXH_NOESCAPE const void* input, size_t length)
+XXH_PUBLIC_API XXH_errorcode
+XXH3_initSeedContext(XXH_NOESCAPE XXH3_seedContext_t* context, XXH64_hash_t seed)
 {
-    return XXH3_64bits_internal(input, length, 0, XXH3_kSecret, sizeof(XXH3_kSecret), XXH3_hashLong_64b_default);
+    if (context == NULL) return XXH_ERROR;
+    XXH3_initCustomSecret(context->secret, seed);
+    context->seed = seed;
+    return XXH_OK;
 }
 
+/*
+ * The secret derived from a seed only matters for inputs > XXH3_MIDSIZE_MAX,
+ * which is precisely the contract of the _withSecretandSeed() variants.
+ */
+
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH64_hash_t
-XXH3_64bits_withSecret(XXH_NOESCAPE const void* input, size_t length, XXH_NOESCAPE const void* secret, size_t secretSize)
+XXH3_64bits_withSeedContext(XXH_NOESCAPE const void* input, size_t length,
+                            XXH_NOESCAPE const XXH3_seedContext_t* context)
 {
-    return XXH3_64bits_internal(input, length, 0, secret, secretSize, XXH3_hashLong_64b_withSecret);
+    return XXH3_64bits_withSecretandSeed(input, length,
+                                         context->secret, sizeof(context->secret),
+                                         context->seed);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_withSeedContext(XXH_NOESCAPE const void* input, size_t length,
+                             XXH_NOESCAPE const XXH3_seedContext_t* context)
+{
+    return XXH3_128bits_withSecretandSeed(input, length,
+                                          context->secret, sizeof(context->secret),
+                                          context->seed);
+}
+
+#ifndef XXH_NO_STREAM
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_reset_withSeedContext(XXH_NOESCAPE XXH3_state_t* statePtr,
+                                  XXH_NOESCAPE const XXH3_seedContext_t* context)
+{
+    if (statePtr == NULL || context == NULL) return XXH_ERROR;
+    if (context->seed == 0) return XXH3_64bits_reset(statePtr);
+    if ((context->seed != statePtr->seed) || (statePtr->extSecret != NULL) || statePtr->secretPending) {
+        XXH_memcpy(statePtr->customSecret, context->secret, sizeof(context->secret));
+        statePtr->secretPending = 0;
+    }
+    XXH3_reset_internal(statePtr, context->seed, NULL, XXH_SECRET_DEFAULT_SIZE);
+    return XXH_OK;
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH64_hash_t
-XXH3_64bits_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed)
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_reset_withSeedContext(XXH_NOESCAPE XXH3_state_t* statePtr,
+                                   XXH_NOESCAPE const XXH3_seedContext_t* context)
 {
-    return XXH3_64bits_internal(input, length, seed, XXH3_kSecret, sizeof(XXH3_kSecret), XXH3_hashLong_64b_withSeed);
+    return XXH3_64bits_reset_withSeedContext(statePtr, context);
 }
+#endif /* !XXH_NO_STREAM */
 
-XXH_PUBLIC_API XXH64_hash_t
-XXH3_64bits_withSecretandSeed(XXH_NOESCAPE const void* input, size_t length, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed)
-{
-    if (length <= XXH3_MIDSIZE_MAX)
-        return XXH3_64bits_internal(input, length, seed, XXH3_kSecret, sizeof(XXH3_kSecret), NULL);
-    return XXH3_hashLong_64b_withSecret(input, length, seed, (const xxh_u8*)secret, secretSize);
-}
 
+/* ===   XXH3 prepared secret   === */
 
-/* ===   XXH3 streaming   === */
-#ifndef XXH_NO_STREAM
 /*
- * Malloc's a pointer that is always aligned to @align.
- *
- * This must be freed with `XXH_alignedFree()`.
- *
- * malloc typically guarantees 16 byte alignment on 64-bit systems and 8 byte
- * alignment on 32-bit. This isn't enough for the 32 byte aligned loads in AVX2
- * or on 32-bit, the 16 byte aligned loads in SSE2 and NEON.
- *
- * This underalignment previously caused a rather obvious crash which went
- * completely unnoticed due to XXH3_createState() not actually being tested.
- * Credit to RedSpah for noticing this bug.
- *
- * The alignment is done manually: Functions like posix_memalign or _mm_malloc
- * are avoided: To maintain portability, we would have to write a fallback
- * like this anyways, and besides, testing for the existence of library
- * functions without relying on external build tools is impossible.
- *
- * The method is simple: Overallocate, manually align, and store the offset
- * to the original behind the returned pointer.
- *
- * Align must be a power of 2 and 8 <= align <= 128.
- */
-static XXH_MALLOCF void* XXH_alignedMalloc(size_t s, size_t align)
-{
-    XXH_ASSERT(align <= 128 && align >= 8); /* range check */
-    XXH_ASSERT((align & (align-1)) == 0);   /* power of 2 */
-    XXH_ASSERT(s != 0 && s < (s + align));  /* empty/overflow */
-    {   /* Overallocate to make room for manual realignment and an offset byte */
-        xxh_u8* base = (xxh_u8*)XXH_malloc(s + align);
-        if (base != NULL) {
-            /*
-             * Get the offset needed to align this pointer.
-             *
-             * Even if the returned pointer is aligned, there will always be
-             * at least one byte to store the offset to the original pointer.
-             */
-            size_t offset = align - ((size_t)base & (align - 1)); /* base % align */
-            /* Add the offset for the now-aligned pointer */
-            xxh_u8* ptr = base + offset;
+ * The header is followed by the copy of the secret, at the next 64-byte boundary.
+ * There is no pointer inside, so a prepared secret is position independent,
+ * as long as it stays aligned.
+ */
+struct XXH3_preparedSecret_s {
+    size_t secretSize;
+    size_t nbStripesPerBlock;
+    size_t blockLen;
+};
 
-            XXH_ASSERT((size_t)ptr % align == 0);
+#define XXH3_PREPARED_SECRET_HEADER 64
 
-            /* Store the offset immediately before the returned pointer. */
-            ptr[-1] = (xxh_u8)offset;
-            return ptr;
-        }
-        return NULL;
+XXH_FORCE_INLINE const xxh_u8*
+XXH3_preparedSecret_data(const XXH3_preparedSecret_t* prepared)
+{
+    return (const xxh_u8*)prepared + XXH3_PREPARED_SECRET_HEADER;
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH3_preparedSecret_t*
+XXH3_initPreparedSecret(void* workspace, size_t workspaceSize,
+                        XXH_NOESCAPE const void* secret, size_t secretSize)
+{
+    XXH_STATIC_ASSERT(sizeof(XXH3_preparedSecret_t) <= XXH3_PREPARED_SECRET_HEADER);
+    if (workspace == NULL || secret == NULL) return NULL;
+    if (secretSize < XXH3_SECRET_SIZE_MIN) return NULL;
+    if (workspaceSize < XXH3_PREPARED_SECRET_SIZE(secretSize)) return NULL;
+    {   size_t const misalign = (size_t)workspace & 63;
+        XXH3_preparedSecret_t* const prepared =
+            (XXH3_preparedSecret_t*)(void*)((xxh_u8*)workspace + (misalign ? 64 - misalign : 0));
+        XXH_memcpy((xxh_u8*)prepared + XXH3_PREPARED_SECRET_HEADER, secret, secretSize);
+        prepared->secretSize = secretSize;
+        prepared->nbStripesPerBlock = XXH3_NB_STRIPES_PER_BLOCK(secretSize);
+        prepared->blockLen = XXH_STRIPE_LEN * prepared->nbStripesPerBlock;
+        return prepared;
     }
 }
+
 /*
- * Frees an aligned pointer allocated by XXH_alignedMalloc(). Don't pass
- * normal malloc'd pointers, XXH_alignedMalloc has a specific data layout.
+ * Same as XXH3_hashLong_64b_withSecret(), with the geometry read from the
+ * prepared secret instead of recomputed.
  */
-static void XXH_alignedFree(void* p)
+XXH_NO_INLINE XXH_PUREF XXH64_hash_t
+XXH3_hashLong_64b_prepared(const void* XXH_RESTRICT input, size_t len,
+                           const XXH3_preparedSecret_t* XXH_RESTRICT prepared)
 {
-    if (p != NULL) {
-        xxh_u8* ptr = (xxh_u8*)p;
-        /* Get the offset byte we added in XXH_malloc. */
-        xxh_u8 offset = ptr[-1];
-        /* Free the original malloc'd pointer */
-        xxh_u8* base = ptr - offset;
-        XXH_free(base);
-    }
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    const xxh_u8* const secret = XXH3_preparedSecret_data(prepared);
+
+    XXH3_hashLong_internal_loop_geometry(acc, (const xxh_u8*)input, len,
+                                         secret, prepared->secretSize,
+                                         prepared->nbStripesPerBlock, prepared->blockLen,
+                                         XXH_PREFETCH_DIST, XXH3_accumulate, XXH3_scrambleAcc);
+    return XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
 }
-/*! @ingroup XXH3_family */
-/*!
- * @brief Allocate an @ref XXH3_state_t.
- *
- * @return An allocated pointer of @ref XXH3_state_t on success.
- * @return `NULL` on failure.
- *
- * @note Must be freed with XXH3_freeState().
- *
- * @see @ref streaming_example "Streaming Example"
- */
-XXH_PUBLIC_API XXH3_state_t* XXH3_createState(void)
+
+XXH_NO_INLINE XXH_PUREF XXH128_hash_t
+XXH3_hashLong_128b_prepared(const void* XXH_RESTRICT input, size_t len,
+                            const XXH3_preparedSecret_t* XXH_RESTRICT prepared)
 {
-    XXH3_state_t* const state = (XXH3_state_t*)XXH_alignedMalloc(sizeof(XXH3_state_t), 64);
-    if (state==NULL) return NULL;
-    XXH3_INITSTATE(state);
-    return state;
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    const xxh_u8* const secret = XXH3_preparedSecret_data(prepared);
+    size_t const secretSize = prepared->secretSize;
+
+    XXH3_hashLong_internal_loop_geometry(acc, (const xxh_u8*)input, len,
+                                         secret, secretSize,
+                                         prepared->nbStripesPerBlock, prepared->blockLen,
+                                         XXH_PREFETCH_DIST, XXH3_accumulate, XXH3_scrambleAcc);
+    {   XXH128_hash_t h128;
+        h128.low64  = XXH3_mergeAccs(acc,
+                                     secret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)len * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc,
+                                     secret + secretSize
+                                            - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)len * XXH_PRIME64_2));
+        return h128;
+    }
 }
 
 /*! @ingroup XXH3_family */
-/*!
- * @brief Frees an @ref XXH3_state_t.
- *
- * @param statePtr A pointer to an @ref XXH3_state_t allocated with @ref XXH3_createState().
- *
- * @return @ref XXH_OK.
- *
- * @note Must be allocated with XXH3_createState().
- *
- * @see @ref streaming_example "Streaming Example"
- */
-XXH_PUBLIC_API XXH_errorcode XXH3_freeState(XXH3_state_t* statePtr)
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_withPreparedSecret(XXH_NOESCAPE const void* input, size_t length,
+                               XXH_NOESCAPE const XXH3_preparedSecret_t* prepared)
 {
-    XXH_alignedFree(statePtr);
-    return XXH_OK;
+    if (length <= XXH3_MIDSIZE_MAX)
+        return XXH3_64bits_internal(input, length, 0,
+                                    XXH3_preparedSecret_data(prepared), prepared->secretSize, NULL);
+    return XXH3_hashLong_64b_prepared(input, length, prepared);
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API void
-XXH3_copyState(XXH_NOESCAPE XXH3_state_t* dst_state, XXH_NOESCAPE const XXH3_state_t* src_state)
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_withPreparedSecret(XXH_NOESCAPE const void* input, size_t length,
+                                XXH_NOESCAPE const XXH3_preparedSecret_t* prepared)
 {
-    XXH_memcpy(dst_state, src_state, sizeof(*dst_state));
+    if (length <= XXH3_MIDSIZE_MAX)
+        return XXH3_128bits_internal(input, length, 0,
+                                     XXH3_preparedSecret_data(prepared), prepared->secretSize, NULL);
+    return XXH3_hashLong_128b_prepared(input, length, prepared);
 }
 
+
+/* ===   XXH3 compact streaming state   === */
+#ifndef XXH_NO_STREAM
+
 static void
-XXH3_reset_internal(XXH3_state_t* statePtr,
-                    XXH64_hash_t seed,
-                    const void* secret, size_t secretSize)
+XXH3_compact_reset_internal(XXH3_compactState_t* statePtr,
+                            XXH64_hash_t seed, int useSeed,
+                            const unsigned char* secret, size_t secretSize)
 {
-    size_t const initStart = offsetof(XXH3_state_t, bufferedSize);
-    size_t const initLength = offsetof(XXH3_state_t, nbStripesPerBlock) - initStart;
-    XXH_ASSERT(offsetof(XXH3_state_t, nbStripesPerBlock) > initStart);
+    static const XXH64_hash_t initAcc[XXH_ACC_NB] = XXH3_INIT_ACC;
     XXH_ASSERT(statePtr != NULL);
-    /* set members from bufferedSize to nbStripesPerBlock (excluded) to 0 */
-    memset((char*)statePtr + initStart, 0, initLength);
-    statePtr->acc[0] = XXH_PRIME32_3;
-    statePtr->acc[1] = XXH_PRIME64_1;
-    statePtr->acc[2] = XXH_PRIME64_2;
-    statePtr->acc[3] = XXH_PRIME64_3;
-    statePtr->acc[4] = XXH_PRIME64_4;
-    statePtr->acc[5] = XXH_PRIME32_2;
-    statePtr->acc[6] = XXH_PRIME64_5;
-    statePtr->acc[7] = XXH_PRIME32_1;
-    statePtr->seed = seed;
-    statePtr->useSeed = (seed != 0);
-    statePtr->extSecret = (const unsigned char*)secret;
     XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN);
-    statePtr->secretLimit = secretSize - XXH_STRIPE_LEN;
-    statePtr->nbStripesPerBlock = statePtr->secretLimit / XXH_SECRET_CONSUME_RATE;
+    XXH_memcpy(statePtr->acc, initAcc, sizeof(initAcc));
+    statePtr->totalLen = 0;
+    statePtr->seed = seed;
+    statePtr->secret = secret;
+    statePtr->secretLimit = (XXH32_hash_t)(secretSize - XXH_STRIPE_LEN);
+    statePtr->nbStripesSoFar = 0;
+    statePtr->bufferedSize = 0;
+    statePtr->useSeed = (XXH32_hash_t)useSeed;
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH_errorcode
-XXH3_64bits_reset(XXH_NOESCAPE XXH3_state_t* statePtr)
+XXH3_compact_reset(XXH_NOESCAPE XXH3_compactState_t* statePtr)
 {
     if (statePtr == NULL) return XXH_ERROR;
-    XXH3_reset_internal(statePtr, 0, XXH3_kSecret, XXH_SECRET_DEFAULT_SIZE);
+    XXH3_compact_reset_internal(statePtr, 0, 0, XXH3_kSecret, sizeof(XXH3_kSecret));
     return XXH_OK;
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH_errorcode
-XXH3_64bits_reset_withSecret(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize)
+XXH3_compact_reset_withSecret(XXH_NOESCAPE XXH3_compactState_t* statePtr,
+                              XXH_NOESCAPE const void* secret, size_t secretSize)
 {
     if (statePtr == NULL) return XXH_ERROR;
-    XXH3_reset_internal(statePtr, 0, secret, secretSize);
     if (secret == NULL) return XXH_ERROR;
     if (secretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
+    if ((XXH32_hash_t)secretSize != secretSize) return XXH_ERROR;
+    XXH3_compact_reset_internal(statePtr, 0, 0, (const unsigned char*)secret, secretSize);
     return XXH_OK;
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH_errorcode
-XXH3_64bits_reset_withSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH64_hash_t seed)
-{
-    if (statePtr == NULL) return XXH_ERROR;
-    if (seed==0) return XXH3_64bits_reset(statePtr);
-    if ((seed != statePtr->seed) || (statePtr->extSecret != NULL))
-        XXH3_initCustomSecret(statePtr->customSecret, seed);
-    XXH3_reset_internal(statePtr, seed, NULL, XXH_SECRET_DEFAULT_SIZE);
-    return XXH_OK;
-}
-
-/*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH3_64bits_reset_withSecretandSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed64)
+XXH3_compact_reset_withSeedContext(XXH_NOESCAPE XXH3_compactState_t* statePtr,
+                                   XXH_NOESCAPE const XXH3_seedContext_t* context)
 {
-    if (statePtr == NULL) return XXH_ERROR;
-    if (secret == NULL) return XXH_ERROR;
-    if (secretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
-    XXH3_reset_internal(statePtr, seed64, secret, secretSize);
-    statePtr->useSeed = 1; /* always, even if seed64==0 */
+    if (statePtr == NULL || context == NULL) return XXH_ERROR;
+    if (context->seed == 0) return XXH3_compact_reset(statePtr);
+    XXH3_compact_reset_internal(statePtr, context->seed, 1, context->secret, sizeof(context->secret));
     return XXH_OK;
 }
 
-/*!
- * @internal
- * @brief Processes a large input for XXH3_update() and XXH3_digest_long().
- *
- * Unlike XXH3_hashLong_internal_loop(), this can process data that overlaps a block.
- *
- * @param acc                Pointer to the 8 accumulator lanes
- * @param nbStripesSoFarPtr  In/out pointer to the number of leftover stripes in the block*
- * @param nbStripesPerBlock  Number of stripes in a block
- * @param input              Input pointer
- * @param nbStripes          Number of stripes to process
- * @param secret             Secret pointer
- * @param secretLimit        Offset of the last block in @p secret
- * @param f_acc              Pointer to an XXH3_accumulate implementation
- * @param f_scramble         Pointer to an XXH3_scrambleAcc implementation
- * @return                   Pointer past the end of @p input after processing
- */
-XXH_FORCE_INLINE const xxh_u8 *
-XXH3_consumeStripes(xxh_u64* XXH_RESTRICT acc,
-                    size_t* XXH_RESTRICT nbStripesSoFarPtr, size_t nbStripesPerBlock,
-                    const xxh_u8* XXH_RESTRICT input, size_t nbStripes,
-                    const xxh_u8* XXH_RESTRICT secret, size_t secretLimit,
-                    XXH3_f_accumulate f_acc,
-                    XXH3_f_scrambleAcc f_scramble)
-{
-    const xxh_u8* initialSecret = secret + *nbStripesSoFarPtr * XXH_SECRET_CONSUME_RATE;
-    /* Process full blocks */
-    if (nbStripes >= (nbStripesPerBlock - *nbStripesSoFarPtr)) {
-        /* Process the initial partial block... */
-        size_t nbStripesThisIter = nbStripesPerBlock - *nbStripesSoFarPtr;
-
-        do {
-            /* Accumulate and scramble */
-            f_acc(acc, input, initialSecret, nbStripesThisIter);
-            f_scramble(acc, secret + secretLimit);
-            input += nbStripesThisIter * XXH_STRIPE_LEN;
-            nbStripes -= nbStripesThisIter;
-            /* Then continue the loop with the full block size */
-            nbStripesThisIter = nbStripesPerBlock;
-            initialSecret = secret;
-        } while (nbStripes >= nbStripesPerBlock);
-        *nbStripesSoFarPtr = 0;
-    }
-    /* Process a partial block */
-    if (nbStripes > 0) {
-        f_acc(acc, input, initialSecret, nbStripes);
-        input += nbStripes * XXH_STRIPE_LEN;
-        *nbStripesSoFarPtr += nbStripes;
-    }
-    /* Return end pointer */
-    return input;
-}
-
-#ifndef XXH3_STREAM_USE_STACK
-# if XXH_SIZE_OPT <= 0 && !defined(__clang__) /* clang doesn't need additional stack space */
-#   define XXH3_STREAM_USE_STACK 1
-# endif
-#endif
 /*
- * Both XXH3_64bits_update and XXH3_128bits_update use this routine.
+ * Same logic as XXH3_update(), without secret derivation:
+ * the accumulators are always operated on the stack,
+ * since they aren't aligned within the state.
  */
 XXH_FORCE_INLINE XXH_errorcode
-XXH3_update(XXH3_state_t* XXH_RESTRICT const state,
-            const xxh_u8* XXH_RESTRICT input, size_t len,
-            XXH3_f_accumulate f_acc,
-            XXH3_f_scrambleAcc f_scramble)
+XXH3_compact_update_internal(XXH3_compactState_t* XXH_RESTRICT const state,
+                             const xxh_u8* XXH_RESTRICT input, size_t len,
+                             XXH3_f_accumulate f_acc,
+                             XXH3_f_scrambleAcc f_scramble)
 {
     if (input==NULL) {
         XXH_ASSERT(len == 0);
@@ -6306,762 +9618,1178 @@ XXH3_update(XXH3_state_t* XXH_RESTRICT const state,
     }
 
     XXH_ASSERT(state != NULL);
-    {   const xxh_u8* const bEnd = input + len;
-        const unsigned char* const secret = (state->extSecret == NULL) ? state->customSecret : state->extSecret;
-#if defined(XXH3_STREAM_USE_STACK) && XXH3_STREAM_USE_STACK >= 1
-        /* For some reason, gcc and MSVC seem to suffer greatly
-         * when operating accumulators directly into state.
-         * Operating into stack space seems to enable proper optimization.
-         * clang, on the other hand, doesn't seem to need this trick */
-        XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[8];
-        XXH_memcpy(acc, state->acc, sizeof(acc));
-#else
-        xxh_u64* XXH_RESTRICT const acc = state->acc;
-#endif
-        state->totalLen += len;
-        XXH_ASSERT(state->bufferedSize <= XXH3_INTERNALBUFFER_SIZE);
-
-        /* small input : just fill in tmp buffer */
-        if (len <= XXH3_INTERNALBUFFER_SIZE - state->bufferedSize) {
-            XXH_memcpy(state->buffer + state->bufferedSize, input, len);
-            state->bufferedSize += (XXH32_hash_t)len;
-            return XXH_OK;
-        }
-
-        /* total input is now > XXH3_INTERNALBUFFER_SIZE */
-        #define XXH3_INTERNALBUFFER_STRIPES (XXH3_INTERNALBUFFER_SIZE / XXH_STRIPE_LEN)
-        XXH_STATIC_ASSERT(XXH3_INTERNALBUFFER_SIZE % XXH_STRIPE_LEN == 0);   /* clean multiple */
+    XXH_ASSERT(state->bufferedSize <= XXH3_INTERNALBUFFER_SIZE);
+    state->totalLen += len;
 
-        /*
-         * Internal buffer is partially filled (always, except at beginning)
-         * Complete it, then consume it.
-         */
-        if (state->bufferedSize) {
-            size_t const loadSize = XXH3_INTERNALBUFFER_SIZE - state->bufferedSize;
-            XXH_memcpy(state->buffer + state->bufferedSize, input, loadSize);
-            input += loadSize;
-            XXH3_consumeStripes(acc,
-                               &state->nbStripesSoFar, state->nbStripesPerBlock,
-                                state->buffer, XXH3_INTERNALBUFFER_STRIPES,
-                                secret, state->secretLimit,
-                                f_acc, f_scramble);
-            state->bufferedSize = 0;
-        }
-        XXH_ASSERT(input < bEnd);
-        if (bEnd - input > XXH3_INTERNALBUFFER_SIZE) {
-            size_t nbStripes = (size_t)(bEnd - 1 - input) / XXH_STRIPE_LEN;
-            input = XXH3_consumeStripes(acc,
-                                       &state->nbStripesSoFar, state->nbStripesPerBlock,
-                                       input, nbStripes,
-                                       secret, state->secretLimit,
-                                       f_acc, f_scramble);
-            XXH_memcpy(state->buffer + sizeof(state->buffer) - XXH_STRIPE_LEN, input - XXH_STRIPE_LEN, XXH_STRIPE_LEN);
+    /* small input : just fill in tmp buffer */
+    if (len <= XXH3_INTERNALBUFFER_SIZE - state->bufferedSize) {
+        XXH_memcpy(state->buffer + state->bufferedSize, input, len);
+        state->bufferedSize += (XXH32_hash_t)len;
+        return XXH_OK;
+    }
 
-        }
-        /* Some remaining input (always) : buffer it */
-        XXH_ASSERT(input < bEnd);
-        XXH_ASSERT(bEnd - input <= XXH3_INTERNALBUFFER_SIZE);
-        XXH_ASSERT(state->bufferedSize == 0);
-        XXH_memcpy(state->buffer, input, (size_t)(bEnd-input));
-        state->bufferedSize = (XXH32_hash_t)(bEnd-input);
-#if defined(XXH3_STREAM_USE_STACK) && XXH3_STREAM_USE_STACK >= 1
-        /* save stack accumulators into state */
+    {   size_t const nbStripesPerBlock = state->secretLimit / XXH_SECRET_CONSUME_RATE;
+        size_t nbStripesSoFar = state->nbStripesSoFar;
+        XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB];
+        XXH_memcpy(acc, state->acc, sizeof(acc));
+        XXH3_update_long_internal(acc,
+                                 &nbStripesSoFar, nbStripesPerBlock,
+                                  state->buffer, &state->bufferedSize,
+                                  input, len,
+                                  state->secret, state->secretLimit,
+                                  f_acc, f_scramble);
+        state->nbStripesSoFar = (XXH32_hash_t)nbStripesSoFar;
         XXH_memcpy(state->acc, acc, sizeof(acc));
-#endif
     }
-
     return XXH_OK;
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH_errorcode
-XXH3_64bits_update(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
+XXH3_compact_update(XXH_NOESCAPE XXH3_compactState_t* statePtr,
+                    XXH_NOESCAPE const void* input, size_t length)
 {
-    return XXH3_update(state, (const xxh_u8*)input, len,
-                       XXH3_accumulate, XXH3_scrambleAcc);
+    return XXH3_compact_update_internal(statePtr, (const xxh_u8*)input, length,
+                                        XXH3_accumulate, XXH3_scrambleAcc);
 }
 
-
 XXH_FORCE_INLINE void
-XXH3_digest_long (XXH64_hash_t* acc,
-                  const XXH3_state_t* state,
-                  const unsigned char* secret)
+XXH3_compact_digest_long(XXH64_hash_t* acc, const XXH3_compactState_t* state)
 {
-    xxh_u8 lastStripe[XXH_STRIPE_LEN];
-    const xxh_u8* lastStripePtr;
+    XXH3_digest_long_internal(acc, state->acc,
+                              state->buffer, state->bufferedSize,
+                              state->nbStripesSoFar, state->secretLimit / XXH_SECRET_CONSUME_RATE,
+                              state->secret, state->secretLimit,
+                              XXH3_accumulate, XXH3_scrambleAcc);
+}
 
-    /*
-     * Digest on a local copy. This way, the state remains unaltered, and it can
-     * continue ingesting more input afterwards.
-     */
-    XXH_memcpy(acc, state->acc, sizeof(state->acc));
-    if (state->bufferedSize >= XXH_STRIPE_LEN) {
-        /* Consume remaining stripes then point to remaining data in buffer */
-        size_t const nbStripes = (state->bufferedSize - 1) / XXH_STRIPE_LEN;
-        size_t nbStripesSoFar = state->nbStripesSoFar;
-        XXH3_consumeStripes(acc,
-                           &nbStripesSoFar, state->nbStripesPerBlock,
-                            state->buffer, nbStripes,
-                            secret, state->secretLimit,
-                            XXH3_accumulate, XXH3_scrambleAcc);
-        lastStripePtr = state->buffer + state->bufferedSize - XXH_STRIPE_LEN;
-    } else {  /* bufferedSize < XXH_STRIPE_LEN */
-        /* Copy to temp buffer */
-        size_t const catchupSize = XXH_STRIPE_LEN - state->bufferedSize;
-        XXH_ASSERT(state->bufferedSize > 0);  /* there is always some input buffered */
-        XXH_memcpy(lastStripe, state->buffer + sizeof(state->buffer) - catchupSize, catchupSize);
-        XXH_memcpy(lastStripe + catchupSize, state->buffer, state->bufferedSize);
-        lastStripePtr = lastStripe;
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_compact_64bits_digest(XXH_NOESCAPE const XXH3_compactState_t* statePtr)
+{
+    if (statePtr->totalLen > XXH3_MIDSIZE_MAX) {
+        XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
+        XXH3_compact_digest_long(acc, statePtr);
+        return XXH3_mergeAccs(acc,
+                              statePtr->secret + XXH_SECRET_MERGEACCS_START,
+                              (xxh_u64)statePtr->totalLen * XXH_PRIME64_1);
     }
-    /* Last stripe */
-    XXH3_accumulate_512(acc,
-                        lastStripePtr,
-                        secret + state->secretLimit - XXH_SECRET_LASTACC_START);
+    /* totalLen <= XXH3_MIDSIZE_MAX: digesting a short input */
+    if (statePtr->useSeed)
+        return XXH3_64bits_withSeed(statePtr->buffer, (size_t)statePtr->totalLen, statePtr->seed);
+    return XXH3_64bits_withSecret(statePtr->buffer, (size_t)statePtr->totalLen,
+                                  statePtr->secret, statePtr->secretLimit + XXH_STRIPE_LEN);
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH64_hash_t XXH3_64bits_digest (XXH_NOESCAPE const XXH3_state_t* state)
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_compact_128bits_digest(XXH_NOESCAPE const XXH3_compactState_t* statePtr)
 {
-    const unsigned char* const secret = (state->extSecret == NULL) ? state->customSecret : state->extSecret;
-    if (state->totalLen > XXH3_MIDSIZE_MAX) {
+    if (statePtr->totalLen > XXH3_MIDSIZE_MAX) {
         XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
-        XXH3_digest_long(acc, state, secret);
-        return XXH3_mergeAccs(acc,
-                              secret + XXH_SECRET_MERGEACCS_START,
-                              (xxh_u64)state->totalLen * XXH_PRIME64_1);
+        XXH128_hash_t h128;
+        XXH3_compact_digest_long(acc, statePtr);
+        h128.low64  = XXH3_mergeAccs(acc,
+                                     statePtr->secret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)statePtr->totalLen * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc,
+                                     statePtr->secret + statePtr->secretLimit + XXH_STRIPE_LEN
+                                                      - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)statePtr->totalLen * XXH_PRIME64_2));
+        return h128;
     }
     /* totalLen <= XXH3_MIDSIZE_MAX: digesting a short input */
-    if (state->useSeed)
-        return XXH3_64bits_withSeed(state->buffer, (size_t)state->totalLen, state->seed);
-    return XXH3_64bits_withSecret(state->buffer, (size_t)(state->totalLen),
-                                  secret, state->secretLimit + XXH_STRIPE_LEN);
+    if (statePtr->useSeed)
+        return XXH3_128bits_withSeed(statePtr->buffer, (size_t)statePtr->totalLen, statePtr->seed);
+    return XXH3_128bits_withSecret(statePtr->buffer, (size_t)statePtr->totalLen,
+                                   statePtr->secret, statePtr->secretLimit + XXH_STRIPE_LEN);
 }
+
 #endif /* !XXH_NO_STREAM */
 
 
-/* ==========================================
- * XXH3 128 bits (a.k.a XXH128)
- * ==========================================
- * XXH3's 128-bit variant has better mixing and strength than the 64-bit variant,
- * even without counting the significantly larger output size.
- *
- * For example, extra steps are taken to avoid the seed-dependent collisions
- * in 17-240 byte inputs (See XXH3_mix16B and XXH128_mix32B).
- *
- * This strength naturally comes at the cost of some speed, especially on short
- * lengths. Note that longer hashes are about as fast as the 64-bit version
- * due to it using only a slight modification of the 64-bit loop.
- *
- * XXH128 is also more oriented towards 64-bit machines. It is still extremely
- * fast for a _128-bit_ hash on 32-bit (it usually clears XXH64).
+/* ===   XXH3 scatter-gather   === */
+
+/*
+ * Segments of input: either an array of XXH_iovec_t,
+ * or the rows of a 2D region when @iov is NULL.
  */
+typedef struct {
+    const XXH_iovec_t* iov;
+    const xxh_u8* base;
+    size_t rowSize;
+    size_t pitch;
+    size_t nbSegments;
+} XXH3_gather_t;
+
+XXH_FORCE_INLINE const xxh_u8*
+XXH3_gather_segment(const XXH3_gather_t* g, size_t n, size_t* sizePtr)
+{
+    if (g->iov != NULL) {
+        *sizePtr = g->iov[n].size;
+        return (const xxh_u8*)g->iov[n].ptr;
+    }
+    *sizePtr = g->rowSize;
+    return g->base + n * g->pitch;
+}
 
-XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
-XXH3_len_1to3_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+/*
+ * Sets *@totalLenPtr to the total size of the input.
+ * Segments may alias each other, so their sum can exceed the address space:
+ * returns XXH_ERROR if it doesn't fit in a size_t.
+ */
+static XXH_errorcode XXH3_gather_totalLen(const XXH3_gather_t* g, size_t* totalLenPtr)
 {
-    /* A doubled version of 1to3_64b with different constants. */
-    XXH_ASSERT(input != NULL);
-    XXH_ASSERT(1 <= len && len <= 3);
-    XXH_ASSERT(secret != NULL);
-    /*
-     * len = 1: combinedl = { input[0], 0x01, input[0], input[0] }
-     * len = 2: combinedl = { input[1], 0x02, input[0], input[1] }
-     * len = 3: combinedl = { input[2], 0x03, input[0], input[1] }
-     */
-    {   xxh_u8 const c1 = input[0];
-        xxh_u8 const c2 = input[len >> 1];
-        xxh_u8 const c3 = input[len - 1];
-        xxh_u32 const combinedl = ((xxh_u32)c1 <<16) | ((xxh_u32)c2 << 24)
-                                | ((xxh_u32)c3 << 0) | ((xxh_u32)len << 8);
-        xxh_u32 const combinedh = XXH_rotl32(XXH_swap32(combinedl), 13);
-        xxh_u64 const bitflipl = (XXH_readLE32(secret) ^ XXH_readLE32(secret+4)) + seed;
-        xxh_u64 const bitfliph = (XXH_readLE32(secret+8) ^ XXH_readLE32(secret+12)) - seed;
-        xxh_u64 const keyed_lo = (xxh_u64)combinedl ^ bitflipl;
-        xxh_u64 const keyed_hi = (xxh_u64)combinedh ^ bitfliph;
-        XXH128_hash_t h128;
-        h128.low64  = XXH64_avalanche(keyed_lo);
-        h128.high64 = XXH64_avalanche(keyed_hi);
-        return h128;
+    size_t total = 0;
+    size_t n;
+    if (g->iov == NULL) {
+        if (g->nbSegments != 0 && g->rowSize > (size_t)-1 / g->nbSegments) return XXH_ERROR;
+        *totalLenPtr = g->rowSize * g->nbSegments;
+        return XXH_OK;
+    }
+    for (n = 0; n < g->nbSegments; n++) {
+        if (g->iov[n].size > (size_t)-1 - total) return XXH_ERROR;
+        total += g->iov[n].size;
     }
+    *totalLenPtr = total;
+    return XXH_OK;
 }
 
-XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
-XXH3_len_4to8_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+/* Copies the whole input into @dst, which must be large enough. */
+static void XXH3_gather_copy(xxh_u8* dst, const XXH3_gather_t* g)
 {
-    XXH_ASSERT(input != NULL);
-    XXH_ASSERT(secret != NULL);
-    XXH_ASSERT(4 <= len && len <= 8);
-    seed ^= (xxh_u64)XXH_swap32((xxh_u32)seed) << 32;
-    {   xxh_u32 const input_lo = XXH_readLE32(input);
-        xxh_u32 const input_hi = XXH_readLE32(input + len - 4);
-        xxh_u64 const input_64 = input_lo + ((xxh_u64)input_hi << 32);
-        xxh_u64 const bitflip = (XXH_readLE64(secret+16) ^ XXH_readLE64(secret+24)) + seed;
-        xxh_u64 const keyed = input_64 ^ bitflip;
+    size_t n;
+    for (n = 0; n < g->nbSegments; n++) {
+        size_t size;
+        const xxh_u8* const src = XXH3_gather_segment(g, n, &size);
+        if (size == 0) continue;
+        XXH_memcpy(dst, src, size);
+        dst += size;
+    }
+}
 
-        /* Shift len to the left to ensure it is even, this avoids even multiplies. */
-        XXH128_hash_t m128 = XXH_mult64to128(keyed, XXH_PRIME64_1 + (len << 2));
+/*
+ * Returns the last XXH_STRIPE_LEN bytes of input, @totalLen >= XXH_STRIPE_LEN.
+ * They are gathered into @tmp only if they span several segments.
+ */
+static const xxh_u8*
+XXH3_gather_lastStripe(const XXH3_gather_t* g, xxh_u8* tmp)
+{
+    size_t needed = XXH_STRIPE_LEN;
+    size_t n = g->nbSegments;
+    while (n > 0) {
+        size_t size;
+        const xxh_u8* const src = XXH3_gather_segment(g, --n, &size);
+        if (size == 0) continue;
+        if (needed == XXH_STRIPE_LEN && size >= XXH_STRIPE_LEN)
+            return src + size - XXH_STRIPE_LEN;
+        {   size_t const take = XXH_MIN(size, needed);
+            XXH_memcpy(tmp + needed - take, src + size - take, take);
+            needed -= take;
+        }
+        if (needed == 0) break;
+    }
+    XXH_ASSERT(needed == 0);
+    return tmp;
+}
 
-        m128.high64 += (m128.low64 << 1);
-        m128.low64  ^= (m128.high64 >> 3);
+/*
+ * Same as XXH3_hashLong_internal_loop(), on segmented input:
+ * stripes are consumed in place, except those straddling two segments.
+ * As in streaming mode, XXH3_consumeStripes() keeps track of block boundaries.
+ */
+XXH_FORCE_INLINE void
+XXH3_hashLong_gather_loop(xxh_u64* XXH_RESTRICT acc,
+                          const XXH3_gather_t* g, size_t totalLen,
+                          const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                          XXH3_f_accumulate f_acc,
+                          XXH3_f_scrambleAcc f_scramble)
+{
+    size_t const secretLimit = secretSize - XXH_STRIPE_LEN;
+    size_t const nbStripesPerBlock = secretLimit / XXH_SECRET_CONSUME_RATE;
+    size_t nbStripesLeft = (totalLen - 1) / XXH_STRIPE_LEN;
+    size_t nbStripesSoFar = 0;
+    /* room for the prefetch of f_acc, which would otherwise be flagged out of bounds */
+    xxh_u8 stripe[XXH_STRIPE_LEN + XXH_PREFETCH_DIST];
+    size_t stripeSize = 0;
+    size_t n;
 
-        m128.low64   = XXH_xorshift64(m128.low64, 35);
-        m128.low64  *= PRIME_MX2;
-        m128.low64   = XXH_xorshift64(m128.low64, 28);
-        m128.high64  = XXH3_avalanche(m128.high64);
-        return m128;
+    XXH_ASSERT(totalLen > XXH_STRIPE_LEN);
+    for (n = 0; n < g->nbSegments && nbStripesLeft > 0; n++) {
+        size_t size;
+        const xxh_u8* input = XXH3_gather_segment(g, n, &size);
+        if (stripeSize > 0) {
+            /* complete the stripe started in previous segments */
+            size_t const loadSize = XXH_MIN(size, XXH_STRIPE_LEN - stripeSize);
+            if (loadSize > 0) XXH_memcpy(stripe + stripeSize, input, loadSize);
+            stripeSize += loadSize;
+            input += loadSize;
+            size -= loadSize;
+            if (stripeSize < XXH_STRIPE_LEN) continue;
+            XXH3_consumeStripes(acc, &nbStripesSoFar, nbStripesPerBlock,
+                                stripe, 1, secret, secretLimit, f_acc, f_scramble);
+            stripeSize = 0;
+            if (--nbStripesLeft == 0) break;
+        }
+        {   size_t const nbStripes = XXH_MIN(size / XXH_STRIPE_LEN, nbStripesLeft);
+            if (nbStripes > 0) {
+                input = XXH3_consumeStripes(acc, &nbStripesSoFar, nbStripesPerBlock,
+                                            input, nbStripes, secret, secretLimit, f_acc, f_scramble);
+                size -= nbStripes * XXH_STRIPE_LEN;
+                nbStripesLeft -= nbStripes;
+            }
+        }
+        if (nbStripesLeft > 0 && size > 0) {
+            XXH_ASSERT(size < XXH_STRIPE_LEN);
+            XXH_memcpy(stripe, input, size);
+            stripeSize = size;
+        }
     }
+    XXH_ASSERT(nbStripesLeft == 0);
+
+    /* last stripe */
+    f_acc(acc, XXH3_gather_lastStripe(g, stripe),
+          secret + secretLimit - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
 }
 
-XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
-XXH3_len_9to16_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+XXH_NO_INLINE XXH_PUREF XXH64_hash_t
+XXH3_64bits_gather(const XXH3_gather_t* g, size_t totalLen)
 {
-    XXH_ASSERT(input != NULL);
-    XXH_ASSERT(secret != NULL);
-    XXH_ASSERT(9 <= len && len <= 16);
-    {   xxh_u64 const bitflipl = (XXH_readLE64(secret+32) ^ XXH_readLE64(secret+40)) - seed;
-        xxh_u64 const bitfliph = (XXH_readLE64(secret+48) ^ XXH_readLE64(secret+56)) + seed;
-        xxh_u64 const input_lo = XXH_readLE64(input);
-        xxh_u64       input_hi = XXH_readLE64(input + len - 8);
-        XXH128_hash_t m128 = XXH_mult64to128(input_lo ^ input_hi ^ bitflipl, XXH_PRIME64_1);
-        /*
-         * Put len in the middle of m128 to ensure that the length gets mixed to
-         * both the low and high bits in the 128x64 multiply below.
-         */
-        m128.low64 += (xxh_u64)(len - 1) << 54;
-        input_hi   ^= bitfliph;
-        /*
-         * Add the high 32 bits of input_hi to the high 32 bits of m128, then
-         * add the long product of the low 32 bits of input_hi and XXH_PRIME32_2 to
-         * the high 64 bits of m128.
-         *
-         * The best approach to this operation is different on 32-bit and 64-bit.
-         */
-        if (sizeof(void *) < sizeof(xxh_u64)) { /* 32-bit */
-            /*
-             * 32-bit optimized version, which is more readable.
-             *
-             * On 32-bit, it removes an ADC and delays a dependency between the two
-             * halves of m128.high64, but it generates an extra mask on 64-bit.
-             */
-            m128.high64 += (input_hi & 0xFFFFFFFF00000000ULL) + XXH_mult32to64((xxh_u32)input_hi, XXH_PRIME32_2);
-        } else {
-            /*
-             * 64-bit optimized (albeit more confusing) version.
-             *
-             * Uses some properties of addition and multiplication to remove the mask:
-             *
-             * Let:
-             *    a = input_hi.lo = (input_hi & 0x00000000FFFFFFFF)
-             *    b = input_hi.hi = (input_hi & 0xFFFFFFFF00000000)
-             *    c = XXH_PRIME32_2
-             *
-             *    a + (b * c)
-             * Inverse Property: x + y - x == y
-             *    a + (b * (1 + c - 1))
-             * Distributive Property: x * (y + z) == (x * y) + (x * z)
-             *    a + (b * 1) + (b * (c - 1))
-             * Identity Property: x * 1 == x
-             *    a + b + (b * (c - 1))
-             *
-             * Substitute a, b, and c:
-             *    input_hi.hi + input_hi.lo + ((xxh_u64)input_hi.lo * (XXH_PRIME32_2 - 1))
-             *
-             * Since input_hi.hi + input_hi.lo == input_hi, we get this:
-             *    input_hi + ((xxh_u64)input_hi.lo * (XXH_PRIME32_2 - 1))
-             */
-            m128.high64 += input_hi + XXH_mult32to64((xxh_u32)input_hi, XXH_PRIME32_2 - 1);
-        }
-        /* m128 ^= XXH_swap64(m128 >> 64); */
-        m128.low64  ^= XXH_swap64(m128.high64);
+    if (totalLen <= XXH3_MIDSIZE_MAX) {
+        xxh_u8 buffer[XXH3_MIDSIZE_MAX];
+        XXH3_gather_copy(buffer, g);
+        return XXH3_64bits(buffer, totalLen);
+    }
+    {   XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        XXH3_hashLong_gather_loop(acc, g, totalLen, XXH3_kSecret, sizeof(XXH3_kSecret),
+                                  XXH3_accumulate, XXH3_scrambleAcc);
+        return XXH3_mergeAccs(acc, XXH3_kSecret + XXH_SECRET_MERGEACCS_START,
+                              (xxh_u64)totalLen * XXH_PRIME64_1);
+    }
+}
 
-        {   /* 128x64 multiply: h128 = m128 * XXH_PRIME64_2; */
-            XXH128_hash_t h128 = XXH_mult64to128(m128.low64, XXH_PRIME64_2);
-            h128.high64 += m128.high64 * XXH_PRIME64_2;
+XXH_NO_INLINE XXH_PUREF XXH128_hash_t
+XXH3_128bits_gather(const XXH3_gather_t* g, size_t totalLen)
+{
+    if (totalLen <= XXH3_MIDSIZE_MAX) {
+        xxh_u8 buffer[XXH3_MIDSIZE_MAX];
+        XXH3_gather_copy(buffer, g);
+        return XXH3_128bits(buffer, totalLen);
+    }
+    {   XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        XXH128_hash_t h128;
+        XXH3_hashLong_gather_loop(acc, g, totalLen, XXH3_kSecret, sizeof(XXH3_kSecret),
+                                  XXH3_accumulate, XXH3_scrambleAcc);
+        h128.low64  = XXH3_mergeAccs(acc,
+                                     XXH3_kSecret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)totalLen * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc,
+                                     XXH3_kSecret + sizeof(XXH3_kSecret)
+                                                  - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)totalLen * XXH_PRIME64_2));
+        return h128;
+    }
+}
 
-            h128.low64   = XXH3_avalanche(h128.low64);
-            h128.high64  = XXH3_avalanche(h128.high64);
-            return h128;
-    }   }
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_iov(XXH_NOESCAPE const XXH_iovec_t* iov, size_t iovcnt,
+                XXH_NOESCAPE XXH64_hash_t* result)
+{
+    XXH3_gather_t g;
+    size_t totalLen;
+    XXH_ASSERT(result != NULL);
+    g.iov = iov; g.base = NULL; g.rowSize = 0; g.pitch = 0; g.nbSegments = iovcnt;
+    if (XXH3_gather_totalLen(&g, &totalLen) != XXH_OK) return XXH_ERROR;
+    *result = XXH3_64bits_gather(&g, totalLen);
+    return XXH_OK;
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_iov(XXH_NOESCAPE const XXH_iovec_t* iov, size_t iovcnt,
+                 XXH_NOESCAPE XXH128_hash_t* result)
+{
+    XXH3_gather_t g;
+    size_t totalLen;
+    XXH_ASSERT(result != NULL);
+    g.iov = iov; g.base = NULL; g.rowSize = 0; g.pitch = 0; g.nbSegments = iovcnt;
+    if (XXH3_gather_totalLen(&g, &totalLen) != XXH_OK) return XXH_ERROR;
+    *result = XXH3_128bits_gather(&g, totalLen);
+    return XXH_OK;
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_2D(XXH_NOESCAPE const void* base, size_t rowSize, size_t nbRows, size_t pitch,
+               XXH_NOESCAPE XXH64_hash_t* result)
+{
+    XXH3_gather_t g;
+    size_t totalLen;
+    XXH_ASSERT(result != NULL);
+    g.iov = NULL; g.base = (const xxh_u8*)base; g.rowSize = rowSize; g.pitch = pitch; g.nbSegments = nbRows;
+    if (XXH3_gather_totalLen(&g, &totalLen) != XXH_OK) return XXH_ERROR;
+    *result = XXH3_64bits_gather(&g, totalLen);
+    return XXH_OK;
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_2D(XXH_NOESCAPE const void* base, size_t rowSize, size_t nbRows, size_t pitch,
+                XXH_NOESCAPE XXH128_hash_t* result)
+{
+    XXH3_gather_t g;
+    size_t totalLen;
+    XXH_ASSERT(result != NULL);
+    g.iov = NULL; g.base = (const xxh_u8*)base; g.rowSize = rowSize; g.pitch = pitch; g.nbSegments = nbRows;
+    if (XXH3_gather_totalLen(&g, &totalLen) != XXH_OK) return XXH_ERROR;
+    *result = XXH3_128bits_gather(&g, totalLen);
+    return XXH_OK;
+}
+
+
+/* ===   XXH3 copy and hash   === */
+
+/*
+ * Same as XXH3_hashLong_internal_loop(), but each block is first copied
+ * from @src into @dst, then accumulated while it is still in L1 cache.
+ */
+XXH_FORCE_INLINE void
+XXH3_hashLong_copy_loop(xxh_u64* XXH_RESTRICT acc,
+                        xxh_u8* XXH_RESTRICT dst, const xxh_u8* XXH_RESTRICT src, size_t len,
+                        const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
+                        XXH3_f_accumulate f_acc,
+                        XXH3_f_scrambleAcc f_scramble)
+{
+    size_t const nbStripesPerBlock = XXH3_NB_STRIPES_PER_BLOCK(secretSize);
+    size_t const block_len = XXH_STRIPE_LEN * nbStripesPerBlock;
+    size_t const nb_blocks = (len - 1) / block_len;
+    size_t n;
+
+    XXH_ASSERT(len > XXH_STRIPE_LEN);
+    for (n = 0; n < nb_blocks; n++) {
+        XXH_memcpy(dst + n*block_len, src + n*block_len, block_len);
+        f_acc(acc, src + n*block_len, secret, nbStripesPerBlock, XXH_PREFETCH_DIST);
+        f_scramble(acc, secret + secretSize - XXH_STRIPE_LEN);
+    }
+
+    /* last partial block, and last stripe */
+    {   size_t const done = nb_blocks * block_len;
+        size_t const nbStripes = ((len - 1) - done) / XXH_STRIPE_LEN;
+        XXH_memcpy(dst + done, src + done, len - done);
+        f_acc(acc, src + done, secret, nbStripes, XXH_PREFETCH_DIST);
+        f_acc(acc, src + len - XXH_STRIPE_LEN,
+              secret + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
+    }
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_copy(XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len)
+{
+    if (len <= XXH3_MIDSIZE_MAX) {
+        if (len > 0) XXH_memcpy(dst, src, len);
+        return XXH3_64bits(src, len);
+    }
+    {   XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        XXH3_hashLong_copy_loop(acc, (xxh_u8*)dst, (const xxh_u8*)src, len,
+                                XXH3_kSecret, sizeof(XXH3_kSecret),
+                                XXH3_accumulate, XXH3_scrambleAcc);
+        return XXH3_mergeAccs(acc, XXH3_kSecret + XXH_SECRET_MERGEACCS_START,
+                              (xxh_u64)len * XXH_PRIME64_1);
+    }
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_copy(XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len)
+{
+    if (len <= XXH3_MIDSIZE_MAX) {
+        if (len > 0) XXH_memcpy(dst, src, len);
+        return XXH3_128bits(src, len);
+    }
+    {   XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+        XXH128_hash_t h128;
+        XXH3_hashLong_copy_loop(acc, (xxh_u8*)dst, (const xxh_u8*)src, len,
+                                XXH3_kSecret, sizeof(XXH3_kSecret),
+                                XXH3_accumulate, XXH3_scrambleAcc);
+        h128.low64  = XXH3_mergeAccs(acc,
+                                     XXH3_kSecret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)len * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc,
+                                     XXH3_kSecret + sizeof(XXH3_kSecret)
+                                                  - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)len * XXH_PRIME64_2));
+        return h128;
+    }
 }
 
-/*
- * Assumption: `secret` size is >= XXH3_SECRET_SIZE_MIN
- */
-XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
-XXH3_len_0to16_128b(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+#ifndef XXH_NO_STREAM
+/* Inputs are copied, then consumed, by chunks small enough to stay in L1 cache. */
+#define XXH3_COPY_CHUNK_SIZE 4096
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_64bits_update_copy(XXH_NOESCAPE XXH3_state_t* statePtr,
+                        XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len)
 {
-    XXH_ASSERT(len <= 16);
-    {   if (len > 8) return XXH3_len_9to16_128b(input, len, secret, seed);
-        if (len >= 4) return XXH3_len_4to8_128b(input, len, secret, seed);
-        if (len) return XXH3_len_1to3_128b(input, len, secret, seed);
-        {   XXH128_hash_t h128;
-            xxh_u64 const bitflipl = XXH_readLE64(secret+64) ^ XXH_readLE64(secret+72);
-            xxh_u64 const bitfliph = XXH_readLE64(secret+80) ^ XXH_readLE64(secret+88);
-            h128.low64 = XXH64_avalanche(seed ^ bitflipl);
-            h128.high64 = XXH64_avalanche( seed ^ bitfliph);
-            return h128;
-    }   }
+    xxh_u8* d = (xxh_u8*)dst;
+    const xxh_u8* s = (const xxh_u8*)src;
+    while (len > 0) {
+        size_t const chunkSize = XXH_MIN(len, (size_t)XXH3_COPY_CHUNK_SIZE);
+        XXH_memcpy(d, s, chunkSize);
+        if (XXH3_64bits_update(statePtr, s, chunkSize) != XXH_OK) return XXH_ERROR;
+        d += chunkSize;
+        s += chunkSize;
+        len -= chunkSize;
+    }
+    return XXH_OK;
 }
 
-/*
- * A bit slower than XXH3_mix16B, but handles multiply by zero better.
- */
-XXH_FORCE_INLINE XXH128_hash_t
-XXH128_mix32B(XXH128_hash_t acc, const xxh_u8* input_1, const xxh_u8* input_2,
-              const xxh_u8* secret, XXH64_hash_t seed)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH_errorcode
+XXH3_128bits_update_copy(XXH_NOESCAPE XXH3_state_t* statePtr,
+                         XXH_NOESCAPE void* dst, XXH_NOESCAPE const void* src, size_t len)
 {
-    acc.low64  += XXH3_mix16B (input_1, secret+0, seed);
-    acc.low64  ^= XXH_readLE64(input_2) + XXH_readLE64(input_2 + 8);
-    acc.high64 += XXH3_mix16B (input_2, secret+16, seed);
-    acc.high64 ^= XXH_readLE64(input_1) + XXH_readLE64(input_1 + 8);
-    return acc;
+    return XXH3_64bits_update_copy(statePtr, dst, src, len);
 }
+#endif /* !XXH_NO_STREAM */
 
 
-XXH_FORCE_INLINE XXH_PUREF XXH128_hash_t
-XXH3_len_17to128_128b(const xxh_u8* XXH_RESTRICT input, size_t len,
-                      const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
-                      XXH64_hash_t seed)
+/* ===   XXH3 prefetch distance   === */
+
+XXH_NO_INLINE XXH_PUREF XXH64_hash_t
+XXH3_hashLong_64b_withPrefetchDist(const void* XXH_RESTRICT input, size_t len, size_t prefetchDist)
 {
-    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
-    XXH_ASSERT(16 < len && len <= 128);
+    return XXH3_hashLong_64b_internal(input, len, XXH3_kSecret, sizeof(XXH3_kSecret), prefetchDist,
+                                      XXH3_accumulate, XXH3_scrambleAcc);
+}
 
-    {   XXH128_hash_t acc;
-        acc.low64 = len * XXH_PRIME64_1;
-        acc.high64 = 0;
+XXH_NO_INLINE XXH_PUREF XXH128_hash_t
+XXH3_hashLong_128b_withPrefetchDist(const void* XXH_RESTRICT input, size_t len, size_t prefetchDist)
+{
+    return XXH3_hashLong_128b_internal(input, len, XXH3_kSecret, sizeof(XXH3_kSecret), prefetchDist,
+                                       XXH3_accumulate, XXH3_scrambleAcc);
+}
 
-#if XXH_SIZE_OPT >= 1
-        {
-            /* Smaller, but slightly slower. */
-            unsigned int i = (unsigned int)(len - 1) / 32;
-            do {
-                acc = XXH128_mix32B(acc, input+16*i, input+len-16*(i+1), secret+32*i, seed);
-            } while (i-- != 0);
-        }
-#else
-        if (len > 32) {
-            if (len > 64) {
-                if (len > 96) {
-                    acc = XXH128_mix32B(acc, input+48, input+len-64, secret+96, seed);
-                }
-                acc = XXH128_mix32B(acc, input+32, input+len-48, secret+64, seed);
-            }
-            acc = XXH128_mix32B(acc, input+16, input+len-32, secret+32, seed);
-        }
-        acc = XXH128_mix32B(acc, input, input+len-16, secret, seed);
-#endif
-        {   XXH128_hash_t h128;
-            h128.low64  = acc.low64 + acc.high64;
-            h128.high64 = (acc.low64    * XXH_PRIME64_1)
-                        + (acc.high64   * XXH_PRIME64_4)
-                        + ((len - seed) * XXH_PRIME64_2);
-            h128.low64  = XXH3_avalanche(h128.low64);
-            h128.high64 = (XXH64_hash_t)0 - XXH3_avalanche(h128.high64);
-            return h128;
-        }
-    }
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_withPrefetchDistance(XXH_NOESCAPE const void* input, size_t length, size_t prefetchDistance)
+{
+    if (length <= XXH3_MIDSIZE_MAX) return XXH3_64bits(input, length);
+    return XXH3_hashLong_64b_withPrefetchDist(input, length, XXH_MIN(prefetchDistance, XXH3_PREFETCH_DIST_MAX));
 }
 
-XXH_NO_INLINE XXH_PUREF XXH128_hash_t
-XXH3_len_129to240_128b(const xxh_u8* XXH_RESTRICT input, size_t len,
-                       const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
-                       XXH64_hash_t seed)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH128_hash_t
+XXH3_128bits_withPrefetchDistance(XXH_NOESCAPE const void* input, size_t length, size_t prefetchDistance)
 {
-    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN); (void)secretSize;
-    XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
+    if (length <= XXH3_MIDSIZE_MAX) return XXH3_128bits(input, length);
+    return XXH3_hashLong_128b_withPrefetchDist(input, length, XXH_MIN(prefetchDistance, XXH3_PREFETCH_DIST_MAX));
+}
 
-    {   XXH128_hash_t acc;
-        unsigned i;
-        acc.low64 = len * XXH_PRIME64_1;
-        acc.high64 = 0;
-        /*
-         *  We set as `i` as offset + 32. We do this so that unchanged
-         * `len` can be used as upper bound. This reaches a sweet spot
-         * where both x86 and aarch64 get simple agen and good codegen
-         * for the loop.
-         */
-        for (i = 32; i < 160; i += 32) {
-            acc = XXH128_mix32B(acc,
-                                input  + i - 32,
-                                input  + i - 16,
-                                secret + i - 32,
-                                seed);
-        }
-        acc.low64 = XXH3_avalanche(acc.low64);
-        acc.high64 = XXH3_avalanche(acc.high64);
-        /*
-         * NB: `i <= len` will duplicate the last 32-bytes if
-         * len % 32 was zero. This is an unfortunate necessity to keep
-         * the hash result stable.
-         */
-        for (i=160; i <= len; i += 32) {
-            acc = XXH128_mix32B(acc,
-                                input + i - 32,
-                                input + i - 16,
-                                secret + XXH3_MIDSIZE_STARTOFFSET + i - 160,
-                                seed);
-        }
-        /* last bytes */
-        acc = XXH128_mix32B(acc,
-                            input + len - 16,
-                            input + len - 32,
-                            secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET - 16,
-                            (XXH64_hash_t)0 - seed);
+#if defined(XXH_CALIBRATE) && (XXH_CALIBRATE) && !defined(XXH_NO_STDLIB)
+#include <time.h>   /* clock */
 
-        {   XXH128_hash_t h128;
-            h128.low64  = acc.low64 + acc.high64;
-            h128.high64 = (acc.low64    * XXH_PRIME64_1)
-                        + (acc.high64   * XXH_PRIME64_4)
-                        + ((len - seed) * XXH_PRIME64_2);
-            h128.low64  = XXH3_avalanche(h128.low64);
-            h128.high64 = (XXH64_hash_t)0 - XXH3_avalanche(h128.high64);
-            return h128;
-        }
+/* Large enough to not fit in the L2 cache of current CPUs */
+#define XXH3_CALIBRATION_SIZE (8 << 20)
+
+/*
+ * Times XXH3_64bits_withPrefetchDistance() over the calibration buffer
+ * with each candidate distance, keeping the best of a few rounds
+ * so that a single interruption doesn't matter.
+ * Each measurement lasts at least a few ticks of clock().
+ */
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API size_t XXH3_calibrate(void)
+{
+    static const size_t candidates[] = { 192, 256, 320, 384, 448, 512, 640, 768 };
+    size_t const nbCandidates = sizeof(candidates) / sizeof(candidates[0]);
+    clock_t bestTimes[sizeof(candidates) / sizeof(candidates[0])];
+    clock_t const minDuration = (clock_t)(CLOCKS_PER_SEC / 100) + 1;
+    size_t best = XXH_PREFETCH_DIST;
+    unsigned nbLoops = 1;
+    XXH64_hash_t volatile sink = 0;  /* keeps the hashes from being optimized out */
+    xxh_u8* buffer;
+    size_t c, i;
+    int round;
+
+    buffer = (xxh_u8*)XXH_malloc(XXH3_CALIBRATION_SIZE);
+    if (buffer == NULL) return best;
+    for (i = 0; i < XXH3_CALIBRATION_SIZE; i++) buffer[i] = (xxh_u8)(i * XXH_PRIME32_1 >> 24);
+
+    /* find how many passes last long enough to be timed */
+    for (;;) {
+        clock_t const start = clock();
+        unsigned n;
+        for (n = 0; n < nbLoops; n++)
+            sink += XXH3_64bits_withPrefetchDistance(buffer, XXH3_CALIBRATION_SIZE, XXH_PREFETCH_DIST);
+        if (clock() - start >= minDuration || nbLoops >= 1024) break;
+        nbLoops *= 2;
     }
+
+    for (round = 0; round < 3; round++) {
+        for (c = 0; c < nbCandidates; c++) {
+            clock_t start, duration;
+            unsigned n;
+            start = clock();
+            for (n = 0; n < nbLoops; n++)
+                sink += XXH3_64bits_withPrefetchDistance(buffer, XXH3_CALIBRATION_SIZE, candidates[c]);
+            duration = clock() - start;
+            if (round == 0 || duration < bestTimes[c]) bestTimes[c] = duration;
+    }   }
+
+    /* ties go to the default distance, then to the first candidate */
+    {   clock_t bestTime = bestTimes[0];
+        best = candidates[0];
+        for (c = 1; c < nbCandidates; c++) {
+            if (bestTimes[c] < bestTime || (bestTimes[c] == bestTime && candidates[c] == XXH_PREFETCH_DIST)) {
+                bestTime = bestTimes[c];
+                best = candidates[c];
+    }   }   }
+
+    XXH_free(buffer);
+    return best;
 }
+#endif /* XXH_CALIBRATE && !XXH_NO_STDLIB */
 
-XXH_FORCE_INLINE XXH128_hash_t
-XXH3_hashLong_128b_internal(const void* XXH_RESTRICT input, size_t len,
-                            const xxh_u8* XXH_RESTRICT secret, size_t secretSize,
-                            XXH3_f_accumulate f_acc,
-                            XXH3_f_scrambleAcc f_scramble)
+
+/* ===   XXH3 padded inputs   === */
+
+/* All bits set when @cond is true, 0 otherwise. Hidden from the optimizer, to keep it branchless. */
+XXH_FORCE_INLINE xxh_u64 XXH3_mask64(int cond)
 {
-    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    xxh_u64 mask = (xxh_u64)0 - (xxh_u64)(cond != 0);
+    XXH_COMPILER_GUARD(mask);
+    return mask;
+}
 
-    XXH3_hashLong_internal_loop(acc, (const xxh_u8*)input, len, secret, secretSize, f_acc, f_scramble);
+XXH_FORCE_INLINE size_t XXH3_clampLen(size_t len, size_t lo, size_t hi)
+{
+    return (len < lo) ? lo : (len > hi) ? hi : len;
+}
 
-    /* converge into final hash */
-    XXH_STATIC_ASSERT(sizeof(acc) == 64);
-    XXH_ASSERT(secretSize >= sizeof(acc) + XXH_SECRET_MERGEACCS_START);
-    {   XXH128_hash_t h128;
-        h128.low64  = XXH3_mergeAccs(acc,
-                                     secret + XXH_SECRET_MERGEACCS_START,
-                                     (xxh_u64)len * XXH_PRIME64_1);
-        h128.high64 = XXH3_mergeAccs(acc,
-                                     secret + secretSize
-                                            - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
-                                     ~((xxh_u64)len * XXH_PRIME64_2));
-        return h128;
+/*
+ * Same as XXH3_len_0to16_64b(): the length classes are all computed,
+ * on lengths clamped to their range, then the right one is selected.
+ * Lengths 0 and 1-3 share their final XXH64_avalanche().
+ * Reads at most 9 bytes past the end, when @len == 0.
+ */
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_0to16_64b_padded(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
+{
+    XXH_ASSERT(len <= 16);
+    {   size_t const len1to3 = XXH3_clampLen(len, 1, 3);
+        xxh_u32 const combined = ((xxh_u32)input[0] << 16) | ((xxh_u32)input[len1to3 >> 1] << 24)
+                               | ((xxh_u32)input[len1to3 - 1] << 0) | ((xxh_u32)len1to3 << 8);
+        xxh_u64 const m0 = XXH3_mask64(len == 0);
+        xxh_u64 const keyed0 = seed ^ (XXH_readLE64(secret+56) ^ XXH_readLE64(secret+64));
+        xxh_u64 const keyed1to3 = (xxh_u64)combined ^ ((XXH_readLE32(secret) ^ XXH_readLE32(secret+4)) + seed);
+        xxh_u64 const h0to3  = XXH64_avalanche((keyed0 & m0) | (keyed1to3 & ~m0));
+        xxh_u64 const h4to8  = XXH3_len_4to8_64b(input, XXH3_clampLen(len, 4, 8), secret, seed, XXH3_asIs);
+        xxh_u64 const h9to16 = XXH3_len_9to16_64b(input, XXH3_clampLen(len, 9, 16), secret, seed, XXH3_asIs);
+        xxh_u64 const m9 = XXH3_mask64(len > 8);
+        xxh_u64 const m4 = XXH3_mask64(len >= 4) & ~m9;
+        return (h9to16 & m9) | (h4to8 & m4) | (h0to3 & ~(m9 | m4));
     }
 }
 
 /*
- * It's important for performance that XXH3_hashLong() is not inlined.
+ * Same as XXH3_len_17to128_64b(), always computing the 4 pairs of rounds.
+ * Unused rounds read from the start of the input, and are masked out.
  */
-XXH_NO_INLINE XXH_PUREF XXH128_hash_t
-XXH3_hashLong_128b_default(const void* XXH_RESTRICT input, size_t len,
-                           XXH64_hash_t seed64,
-                           const void* XXH_RESTRICT secret, size_t secretLen)
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_17to128_64b_padded(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
 {
-    (void)seed64; (void)secret; (void)secretLen;
-    return XXH3_hashLong_128b_internal(input, len, XXH3_kSecret, sizeof(XXH3_kSecret),
-                                       XXH3_accumulate, XXH3_scrambleAcc);
+    xxh_u64 acc = len * XXH_PRIME64_1;
+    size_t i;
+    XXH_ASSERT(16 < len && len <= 128);
+    for (i = 0; i < 4; i++) {
+        xxh_u64 const mask = XXH3_mask64(len > 32 * i);
+        size_t const front = (size_t)(16 * i) & (size_t)mask;
+        size_t const back = (len - 16 * (i + 1)) & (size_t)mask;
+        acc += (XXH3_mix16B(input + front, secret + 32*i, seed, XXH3_asIs)
+              + XXH3_mix16B(input + back, secret + 32*i + 16, seed, XXH3_asIs)) & mask;
+    }
+    return XXH3_avalanche(acc);
 }
 
 /*
- * It's important for performance to pass @p secretLen (when it's static)
- * to the compiler, so that it can properly optimize the vectorized loop.
- *
- * When the secret size is unknown, or on GCC 12 where the mix of NO_INLINE and FORCE_INLINE
- * breaks -Og, this is XXH_NO_INLINE.
+ * Same as XXH3_len_129to240_64b(), always computing the 7 optional rounds.
+ * Unused rounds read from the start of the input, and are masked out.
  */
-XXH3_WITH_SECRET_INLINE XXH128_hash_t
-XXH3_hashLong_128b_withSecret(const void* XXH_RESTRICT input, size_t len,
-                              XXH64_hash_t seed64,
-                              const void* XXH_RESTRICT secret, size_t secretLen)
+XXH_FORCE_INLINE XXH_PUREF XXH64_hash_t
+XXH3_len_129to240_64b_padded(const xxh_u8* input, size_t len, const xxh_u8* secret, XXH64_hash_t seed)
 {
-    (void)seed64;
-    return XXH3_hashLong_128b_internal(input, len, (const xxh_u8*)secret, secretLen,
-                                       XXH3_accumulate, XXH3_scrambleAcc);
+    xxh_u64 acc = len * XXH_PRIME64_1;
+    xxh_u64 acc_end;
+    size_t const nbRounds = len / 16;
+    size_t i;
+    XXH_ASSERT(128 < len && len <= XXH3_MIDSIZE_MAX);
+    for (i = 0; i < 8; i++) {
+        acc += XXH3_mix16B(input + 16*i, secret + 16*i, seed, XXH3_asIs);
+    }
+    acc_end = XXH3_mix16B(input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed, XXH3_asIs);
+    acc = XXH3_avalanche(acc);
+    for (i = 8; i < XXH3_MIDSIZE_MAX / 16; i++) {
+        xxh_u64 const mask = XXH3_mask64(i < nbRounds);
+        size_t const offset = (size_t)(16 * i) & (size_t)mask;
+        acc_end += XXH3_mix16B(input + offset, secret + 16*(i-8) + XXH3_MIDSIZE_STARTOFFSET, seed, XXH3_asIs) & mask;
+    }
+    return XXH3_avalanche(acc + acc_end);
 }
 
-XXH_FORCE_INLINE XXH128_hash_t
-XXH3_hashLong_128b_withSeed_internal(const void* XXH_RESTRICT input, size_t len,
-                                XXH64_hash_t seed64,
-                                XXH3_f_accumulate f_acc,
-                                XXH3_f_scrambleAcc f_scramble,
-                                XXH3_f_initCustomSecret f_initSec)
+XXH_FORCE_INLINE XXH64_hash_t
+XXH3_64bits_padded_internal(const xxh_u8* input, size_t len, XXH64_hash_t seed)
 {
-    if (seed64 == 0)
-        return XXH3_hashLong_128b_internal(input, len,
-                                           XXH3_kSecret, sizeof(XXH3_kSecret),
-                                           f_acc, f_scramble);
-    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
-        f_initSec(secret, seed64);
-        return XXH3_hashLong_128b_internal(input, len, (const xxh_u8*)secret, sizeof(secret),
-                                           f_acc, f_scramble);
+    XXH_ASSERT(input != NULL);
+    if (len <= 16)
+        return XXH3_len_0to16_64b_padded(input, len, XXH3_kSecret, seed);
+    if (len <= 128)
+        return XXH3_len_17to128_64b_padded(input, len, XXH3_kSecret, seed);
+    if (len <= XXH3_MIDSIZE_MAX)
+        return XXH3_len_129to240_64b_padded(input, len, XXH3_kSecret, seed);
+    return XXH3_64bits_withSeed(input, len, seed);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_padded(XXH_NOESCAPE const void* input, size_t length)
+{
+    return XXH3_64bits_padded_internal((const xxh_u8*)input, length, 0);
+}
+
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_padded_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed)
+{
+    return XXH3_64bits_padded_internal((const xxh_u8*)input, length, seed);
+}
+
+
+/* ===   XXH3 ASCII case-insensitive   === */
+
+/*
+ * Up to XXH3_MIDSIZE_MAX bytes, the short and mid-size paths fold their input as they load it.
+ * Longer inputs are folded by blocks into a stack buffer, then accumulated while still in L1.
+ */
+
+/* Size of a block, for a secret of XXH_SECRET_DEFAULT_SIZE bytes */
+#define XXH3_FOLD_BLOCK_SIZE \
+    (((XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE) * XXH_STRIPE_LEN)
+
+/*
+ * Folds @len bytes of @src into @dst.
+ * The last step overlaps the previous one: folding @src again gives the same bytes.
+ */
+static void XXH3_asciiFold(xxh_u8* XXH_RESTRICT dst, const xxh_u8* XXH_RESTRICT src, size_t len)
+{
+    size_t i;
+    if (len >= XXH3_FOLD_STEP) {
+        for (i = 0; i + XXH3_FOLD_STEP <= len; i += XXH3_FOLD_STEP)
+            XXH3_asciiFoldStep(dst + i, src + i);
+        if (i < len)
+            XXH3_asciiFoldStep(dst + len - XXH3_FOLD_STEP, src + len - XXH3_FOLD_STEP);
+        return;
+    }
+    for (i = 0; i < len; i++)
+        dst[i] = (xxh_u8)XXH3_fold64(src[i], XXH3_foldAscii);
+}
+
+/*
+ * Same as XXH3_hashLong_internal_loop(), for a default-sized secret,
+ * except that each block is folded into a stack buffer before being accumulated.
+ */
+XXH_FORCE_INLINE void
+XXH3_hashLong_asciiFold_loop(xxh_u64* XXH_RESTRICT acc,
+                             const xxh_u8* XXH_RESTRICT input, size_t len,
+                             const xxh_u8* XXH_RESTRICT secret,
+                             XXH3_f_accumulate f_acc,
+                             XXH3_f_scrambleAcc f_scramble)
+{
+    size_t const secretLimit = XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN;
+    size_t const nbStripesPerBlock = secretLimit / XXH_SECRET_CONSUME_RATE;
+    size_t const block_len = XXH3_FOLD_BLOCK_SIZE;
+    size_t const nb_blocks = (len - 1) / block_len;
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u8 folded[XXH3_FOLD_BLOCK_SIZE];
+    size_t n;
+
+    XXH_ASSERT(len > XXH_STRIPE_LEN);
+
+    for (n = 0; n < nb_blocks; n++) {
+        XXH3_asciiFold(folded, input + n * block_len, block_len);
+        f_acc(acc, folded, secret, nbStripesPerBlock, XXH_PREFETCH_DIST);
+        f_scramble(acc, secret + secretLimit);
+    }
+
+    /* last partial block */
+    {   size_t const done = nb_blocks * block_len;
+        size_t const rem = len - done;
+        size_t const nbStripes = (rem - 1) / XXH_STRIPE_LEN;
+        XXH3_asciiFold(folded, input + done, rem);
+        f_acc(acc, folded, secret, nbStripes, XXH_PREFETCH_DIST);
+
+        /* last stripe, which may start in the previous block */
+        if (rem < XXH_STRIPE_LEN) {
+            XXH3_asciiFold(folded, input + len - XXH_STRIPE_LEN, XXH_STRIPE_LEN);
+            f_acc(acc, folded, secret + secretLimit - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
+        } else {
+            f_acc(acc, folded + rem - XXH_STRIPE_LEN, secret + secretLimit - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
+        }
     }
 }
 
-/*
- * It's important for performance that XXH3_hashLong is not inlined.
- */
-XXH_NO_INLINE XXH128_hash_t
-XXH3_hashLong_128b_withSeed(const void* input, size_t len,
-                            XXH64_hash_t seed64, const void* XXH_RESTRICT secret, size_t secretLen)
-{
-    (void)secret; (void)secretLen;
-    return XXH3_hashLong_128b_withSeed_internal(input, len, seed64,
-                XXH3_accumulate, XXH3_scrambleAcc, XXH3_initCustomSecret);
-}
-
-typedef XXH128_hash_t (*XXH3_hashLong128_f)(const void* XXH_RESTRICT, size_t,
-                                            XXH64_hash_t, const void* XXH_RESTRICT, size_t);
-
-XXH_FORCE_INLINE XXH128_hash_t
-XXH3_128bits_internal(const void* input, size_t len,
-                      XXH64_hash_t seed64, const void* XXH_RESTRICT secret, size_t secretLen,
-                      XXH3_hashLong128_f f_hl128)
+XXH_NO_INLINE XXH_PUREF XXH64_hash_t
+XXH3_64bits_asciiFold_long(const xxh_u8* input, size_t len, const xxh_u8* secret)
 {
-    XXH_ASSERT(secretLen >= XXH3_SECRET_SIZE_MIN);
-    /*
-     * If an action is to be taken if `secret` conditions are not respected,
-     * it should be done here.
-     * For now, it's a contract pre-condition.
-     * Adding a check and a branch here would cost performance at every hash.
-     */
-    if (len <= 16)
-        return XXH3_len_0to16_128b((const xxh_u8*)input, len, (const xxh_u8*)secret, seed64);
-    if (len <= 128)
-        return XXH3_len_17to128_128b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64);
-    if (len <= XXH3_MIDSIZE_MAX)
-        return XXH3_len_129to240_128b((const xxh_u8*)input, len, (const xxh_u8*)secret, secretLen, seed64);
-    return f_hl128(input, len, seed64, secret, secretLen);
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    XXH3_hashLong_asciiFold_loop(acc, input, len, secret, XXH3_accumulate, XXH3_scrambleAcc);
+    return XXH3_mergeAccs(acc, secret + XXH_SECRET_MERGEACCS_START, (xxh_u64)len * XXH_PRIME64_1);
 }
 
-
-/* ===   Public XXH128 API   === */
-
-/*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH128_hash_t XXH3_128bits(XXH_NOESCAPE const void* input, size_t len)
+XXH_NO_INLINE XXH_PUREF XXH128_hash_t
+XXH3_128bits_asciiFold_long(const xxh_u8* input, size_t len, const xxh_u8* secret)
 {
-    return XXH3_128bits_internal(input, len, 0,
-                                 XXH3_kSecret, sizeof(XXH3_kSecret),
-                                 XXH3_hashLong_128b_default);
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 acc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    XXH128_hash_t h128;
+    XXH3_hashLong_asciiFold_loop(acc, input, len, secret, XXH3_accumulate, XXH3_scrambleAcc);
+    h128.low64  = XXH3_mergeAccs(acc,
+                                 secret + XXH_SECRET_MERGEACCS_START,
+                                 (xxh_u64)len * XXH_PRIME64_1);
+    h128.high64 = XXH3_mergeAccs(acc,
+                                 secret + XXH_SECRET_DEFAULT_SIZE - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                 ~((xxh_u64)len * XXH_PRIME64_2));
+    return h128;
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH128_hash_t
-XXH3_128bits_withSecret(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretSize)
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_asciiFold_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed)
 {
-    return XXH3_128bits_internal(input, len, 0,
-                                 (const xxh_u8*)secret, secretSize,
-                                 XXH3_hashLong_128b_withSecret);
+    const xxh_u8* const p = (const xxh_u8*)input;
+    if (length <= 16)
+        return XXH3_len_0to16_64b(p, length, XXH3_kSecret, seed, XXH3_foldAscii);
+    if (length <= 128)
+        return XXH3_len_17to128_64b(p, length, XXH3_kSecret, sizeof(XXH3_kSecret), seed, XXH3_foldAscii);
+    if (length <= XXH3_MIDSIZE_MAX)
+        return XXH3_len_129to240_64b_internal(p, length, XXH3_kSecret, sizeof(XXH3_kSecret), seed, XXH3_foldAscii);
+    if (seed == 0)
+        return XXH3_64bits_asciiFold_long(p, length, XXH3_kSecret);
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
+        XXH3_initCustomSecret(secret, seed);
+        return XXH3_64bits_asciiFold_long(p, length, secret);
+    }
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH128_hash_t
-XXH3_128bits_withSeed(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_asciiFold(XXH_NOESCAPE const void* input, size_t length)
 {
-    return XXH3_128bits_internal(input, len, seed,
-                                 XXH3_kSecret, sizeof(XXH3_kSecret),
-                                 XXH3_hashLong_128b_withSeed);
+    return XXH3_64bits_asciiFold_withSeed(input, length, 0);
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH128_hash_t
-XXH3_128bits_withSecretandSeed(XXH_NOESCAPE const void* input, size_t len, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed)
+XXH3_128bits_asciiFold_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed)
 {
-    if (len <= XXH3_MIDSIZE_MAX)
-        return XXH3_128bits_internal(input, len, seed, XXH3_kSecret, sizeof(XXH3_kSecret), NULL);
-    return XXH3_hashLong_128b_withSecret(input, len, seed, secret, secretSize);
+    const xxh_u8* const p = (const xxh_u8*)input;
+    if (length <= 16)
+        return XXH3_len_0to16_128b(p, length, XXH3_kSecret, seed, XXH3_foldAscii);
+    if (length <= 128)
+        return XXH3_len_17to128_128b(p, length, XXH3_kSecret, sizeof(XXH3_kSecret), seed, XXH3_foldAscii);
+    if (length <= XXH3_MIDSIZE_MAX)
+        return XXH3_len_129to240_128b_internal(p, length, XXH3_kSecret, sizeof(XXH3_kSecret), seed, XXH3_foldAscii);
+    if (seed == 0)
+        return XXH3_128bits_asciiFold_long(p, length, XXH3_kSecret);
+    {   XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
+        XXH3_initCustomSecret(secret, seed);
+        return XXH3_128bits_asciiFold_long(p, length, secret);
+    }
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH128_hash_t
-XXH128(XXH_NOESCAPE const void* input, size_t len, XXH64_hash_t seed)
+XXH3_128bits_asciiFold(XXH_NOESCAPE const void* input, size_t length)
 {
-    return XXH3_128bits_withSeed(input, len, seed);
+    return XXH3_128bits_asciiFold_withSeed(input, length, 0);
 }
 
 
-/* ===   XXH3 128-bit streaming   === */
 #ifndef XXH_NO_STREAM
+/* ===   XXH3 typed appends   === */
+
 /*
- * All initialization and update functions are identical to 64-bit streaming variant.
- * The only difference is the finalization routine.
+ * Same as XXH3_update(), for an append of @len bytes that fits in the internal buffer.
+ * Otherwise, defers to XXH3_64bits_update(), which consumes the buffer.
  */
+XXH_FORCE_INLINE XXH_errorcode
+XXH3_update_small(XXH3_state_t* state, const xxh_u8* bytes, size_t len)
+{
+    XXH_ASSERT(state != NULL);
+    XXH_ASSERT(state->bufferedSize <= XXH3_INTERNALBUFFER_SIZE);
+    if (XXH_likely(len <= XXH3_INTERNALBUFFER_SIZE - state->bufferedSize)) {
+        XXH_memcpy(state->buffer + state->bufferedSize, bytes, len);
+        state->bufferedSize += (XXH32_hash_t)len;
+        state->totalLen += len;
+        return XXH_OK;
+    }
+    return XXH3_64bits_update(state, bytes, len);
+}
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH3_128bits_reset(XXH_NOESCAPE XXH3_state_t* statePtr)
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u8(XXH_NOESCAPE XXH3_state_t* statePtr, unsigned char value)
 {
-    return XXH3_64bits_reset(statePtr);
+    xxh_u8 const byte = (xxh_u8)value;
+    return XXH3_update_small(statePtr, &byte, 1);
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH3_128bits_reset_withSecret(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize)
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u16(XXH_NOESCAPE XXH3_state_t* statePtr, unsigned short value)
 {
-    return XXH3_64bits_reset_withSecret(statePtr, secret, secretSize);
+    xxh_u8 bytes[2];
+    bytes[0] = (xxh_u8)value;
+    bytes[1] = (xxh_u8)(value >> 8);
+    return XXH3_update_small(statePtr, bytes, sizeof(bytes));
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH3_128bits_reset_withSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH64_hash_t seed)
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u32(XXH_NOESCAPE XXH3_state_t* statePtr, XXH32_hash_t value)
 {
-    return XXH3_64bits_reset_withSeed(statePtr, seed);
+    xxh_u8 bytes[4];
+    XXH_writeLE32(bytes, value);
+    return XXH3_update_small(statePtr, bytes, sizeof(bytes));
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH3_128bits_reset_withSecretandSeed(XXH_NOESCAPE XXH3_state_t* statePtr, XXH_NOESCAPE const void* secret, size_t secretSize, XXH64_hash_t seed)
+XXH_PUBLIC_API XXH_errorcode XXH3_update_u64(XXH_NOESCAPE XXH3_state_t* statePtr, XXH64_hash_t value)
 {
-    return XXH3_64bits_reset_withSecretandSeed(statePtr, secret, secretSize, seed);
+    xxh_u8 bytes[8];
+    XXH_writeLE64(bytes, value);
+    return XXH3_update_small(statePtr, bytes, sizeof(bytes));
 }
 
+
+/* ===   XXH3 prefix checkpoints   === */
+
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH_errorcode
-XXH3_128bits_update(XXH_NOESCAPE XXH3_state_t* state, XXH_NOESCAPE const void* input, size_t len)
-{
-    return XXH3_64bits_update(state, input, len);
+XXH3_prefix_capture(XXH_NOESCAPE XXH3_prefix_t* prefix, XXH_NOESCAPE const XXH3_state_t* statePtr)
+{
+    if (prefix == NULL || statePtr == NULL) return XXH_ERROR;
+    XXH_memcpy(prefix->acc, statePtr->acc, sizeof(prefix->acc));
+    prefix->totalLen = statePtr->totalLen;
+    prefix->seed = statePtr->seed;
+    prefix->extSecret = statePtr->extSecret;
+    prefix->secretLimit = (XXH32_hash_t)statePtr->secretLimit;
+    prefix->nbStripesSoFar = (XXH32_hash_t)statePtr->nbStripesSoFar;
+    prefix->bufferedSize = statePtr->bufferedSize;
+    prefix->useSeed = statePtr->useSeed;
+    if (statePtr->extSecret == NULL) {
+        XXH_ALIGN(XXH_SEC_ALIGN) unsigned char secretBuffer[XXH_SECRET_DEFAULT_SIZE];
+        XXH_memcpy(prefix->customSecret,
+                   XXH3_digestSecret(statePtr, secretBuffer, XXH3_initCustomSecret),
+                   sizeof(prefix->customSecret));
+    }
+    /* the end of the buffer is needed when the last stripe reaches back into it */
+    XXH_memcpy(prefix->buffer, statePtr->buffer, sizeof(prefix->buffer));
+    return XXH_OK;
 }
 
-/*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH128_hash_t XXH3_128bits_digest (XXH_NOESCAPE const XXH3_state_t* state)
+XXH_FORCE_INLINE const unsigned char*
+XXH3_prefix_secret(const XXH3_prefix_t* prefix)
 {
-    const unsigned char* const secret = (state->extSecret == NULL) ? state->customSecret : state->extSecret;
-    if (state->totalLen > XXH3_MIDSIZE_MAX) {
-        XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
-        XXH3_digest_long(acc, state, secret);
-        XXH_ASSERT(state->secretLimit + XXH_STRIPE_LEN >= sizeof(acc) + XXH_SECRET_MERGEACCS_START);
-        {   XXH128_hash_t h128;
-            h128.low64  = XXH3_mergeAccs(acc,
-                                         secret + XXH_SECRET_MERGEACCS_START,
-                                         (xxh_u64)state->totalLen * XXH_PRIME64_1);
-            h128.high64 = XXH3_mergeAccs(acc,
-                                         secret + state->secretLimit + XXH_STRIPE_LEN
-                                                - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
-                                         ~((xxh_u64)state->totalLen * XXH_PRIME64_2));
-            return h128;
+    return (prefix->extSecret != NULL) ? prefix->extSecret : prefix->customSecret;
+}
+
+/*
+ * Same as XXH3_update() of @p suffix followed by XXH3_digest_long(),
+ * without modifying @p prefix: only the accumulators and the live part
+ * of the buffer are copied, the rest of @p suffix is consumed in place.
+ * The stripes of a stream are consumed in order whatever their segmentation,
+ * then the last stripe is always the last 64 bytes of the input.
+ */
+XXH_FORCE_INLINE void
+XXH3_prefix_digest_long(XXH64_hash_t* acc, const XXH3_prefix_t* prefix,
+                        const xxh_u8* suffix, size_t len,
+                        const unsigned char* secret)
+{
+    size_t const bufferedSize = prefix->bufferedSize;
+    size_t const secretLimit = prefix->secretLimit;
+    size_t const nbStripesPerBlock = secretLimit / XXH_SECRET_CONSUME_RATE;
+    size_t nbStripesSoFar = prefix->nbStripesSoFar;
+    /* room for the end of the previous stripe, then the buffer */
+    xxh_u8 window[XXH_STRIPE_LEN + XXH3_INTERNALBUFFER_SIZE];
+    xxh_u8* const buffer = window + XXH_STRIPE_LEN;
+
+    XXH_ASSERT(bufferedSize <= XXH3_INTERNALBUFFER_SIZE);
+    XXH_memcpy(acc, prefix->acc, sizeof(prefix->acc));
+    XXH_memcpy(buffer, prefix->buffer, bufferedSize);
+
+    if (len <= XXH3_INTERNALBUFFER_SIZE - bufferedSize) {
+        /* the suffix fits in the buffer: the last stripe is contiguous */
+        size_t const newSize = bufferedSize + len;
+        XXH_ASSERT(newSize > 0);  /* the input is longer than XXH3_MIDSIZE_MAX */
+        if (newSize < XXH_STRIPE_LEN) {
+            size_t const catchupSize = XXH_STRIPE_LEN - newSize;
+            XXH_memcpy(buffer - catchupSize,
+                       prefix->buffer + XXH3_INTERNALBUFFER_SIZE - catchupSize, catchupSize);
         }
+        if (len) XXH_memcpy(buffer + bufferedSize, suffix, len);
+        XXH3_consumeStripes(acc,
+                           &nbStripesSoFar, nbStripesPerBlock,
+                            buffer, (newSize - 1) / XXH_STRIPE_LEN,
+                            secret, secretLimit,
+                            XXH3_accumulate, XXH3_scrambleAcc);
+        XXH3_accumulate(acc, buffer + newSize - XXH_STRIPE_LEN,
+                        secret + secretLimit - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
+        return;
     }
-    /* len <= XXH3_MIDSIZE_MAX : short code */
-    if (state->useSeed)
-        return XXH3_128bits_withSeed(state->buffer, (size_t)state->totalLen, state->seed);
-    return XXH3_128bits_withSecret(state->buffer, (size_t)(state->totalLen),
-                                   secret, state->secretLimit + XXH_STRIPE_LEN);
-}
-#endif /* !XXH_NO_STREAM */
-/* 128-bit utility functions */
 
-#include <string.h>   /* memcmp, memcpy */
+    {   size_t const loadSize = XXH3_INTERNALBUFFER_SIZE - bufferedSize;
+        const xxh_u8* const bEnd = suffix + len;
+        const xxh_u8* lastStripePtr;
 
-/* return : 1 is equal, 0 if different */
-/*! @ingroup XXH3_family */
-XXH_PUBLIC_API int XXH128_isEqual(XXH128_hash_t h1, XXH128_hash_t h2)
-{
-    /* note : XXH128_hash_t is compact, it has no padding byte */
-    return !(memcmp(&h1, &h2, sizeof(h1)));
+        /* complete the buffer, then consume it */
+        XXH_memcpy(buffer + bufferedSize, suffix, loadSize);
+        suffix += loadSize;
+        XXH3_consumeStripes(acc,
+                           &nbStripesSoFar, nbStripesPerBlock,
+                            buffer, XXH3_INTERNALBUFFER_STRIPES,
+                            secret, secretLimit,
+                            XXH3_accumulate, XXH3_scrambleAcc);
+        /* then the rest of the suffix, but its last stripe */
+        XXH_ASSERT(suffix < bEnd);
+        XXH3_consumeStripes(acc,
+                           &nbStripesSoFar, nbStripesPerBlock,
+                            suffix, (size_t)(bEnd - 1 - suffix) / XXH_STRIPE_LEN,
+                            secret, secretLimit,
+                            XXH3_accumulate, XXH3_scrambleAcc);
+        if (bEnd - suffix >= XXH_STRIPE_LEN) {
+            lastStripePtr = bEnd - XXH_STRIPE_LEN;
+        } else {
+            /* the last stripe starts in the buffer: the window is free to join them */
+            size_t const remaining = (size_t)(bEnd - suffix);
+            size_t const catchupSize = XXH_STRIPE_LEN - remaining;
+            XXH_memcpy(window, buffer + XXH3_INTERNALBUFFER_SIZE - catchupSize, catchupSize);
+            XXH_memcpy(window + catchupSize, suffix, remaining);
+            lastStripePtr = window;
+        }
+        XXH3_accumulate(acc, lastStripePtr, secret + secretLimit - XXH_SECRET_LASTACC_START, 1, XXH_PREFETCH_DIST);
+    }
 }
 
-/* This prototype is compatible with stdlib's qsort().
- * @return : >0 if *h128_1  > *h128_2
- *           <0 if *h128_1  < *h128_2
- *           =0 if *h128_1 == *h128_2  */
-/*! @ingroup XXH3_family */
-XXH_PUBLIC_API int XXH128_cmp(XXH_NOESCAPE const void* h128_1, XXH_NOESCAPE const void* h128_2)
+/*
+ * Joins prefix and suffix of a short input into @p buffer.
+ * Their total length is at most XXH3_MIDSIZE_MAX,
+ * so the whole prefix is still in the buffer of the checkpoint.
+ */
+XXH_FORCE_INLINE size_t
+XXH3_prefix_join(xxh_u8* buffer, const XXH3_prefix_t* prefix, const void* suffix, size_t len)
 {
-    XXH128_hash_t const h1 = *(const XXH128_hash_t*)h128_1;
-    XXH128_hash_t const h2 = *(const XXH128_hash_t*)h128_2;
-    int const hcmp = (h1.high64 > h2.high64) - (h2.high64 > h1.high64);
-    /* note : bets that, in most cases, hash values are different */
-    if (hcmp) return hcmp;
-    return (h1.low64 > h2.low64) - (h2.low64 > h1.low64);
+    size_t const prefixLen = (size_t)prefix->totalLen;
+    XXH_ASSERT(prefixLen + len <= XXH3_MIDSIZE_MAX);
+    XXH_memcpy(buffer, prefix->buffer, prefixLen);
+    if (len) XXH_memcpy(buffer + prefixLen, suffix, len);
+    return prefixLen + len;
 }
 
-
-/*======   Canonical representation   ======*/
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API void
-XXH128_canonicalFromHash(XXH_NOESCAPE XXH128_canonical_t* dst, XXH128_hash_t hash)
+XXH_PUBLIC_API XXH64_hash_t
+XXH3_64bits_withPrefix(XXH_NOESCAPE const XXH3_prefix_t* prefix,
+                       XXH_NOESCAPE const void* suffix, size_t length)
 {
-    XXH_STATIC_ASSERT(sizeof(XXH128_canonical_t) == sizeof(XXH128_hash_t));
-    if (XXH_CPU_LITTLE_ENDIAN) {
-        hash.high64 = XXH_swap64(hash.high64);
-        hash.low64  = XXH_swap64(hash.low64);
+    const unsigned char* const secret = XXH3_prefix_secret(prefix);
+    XXH64_hash_t const totalLen = prefix->totalLen + length;
+    if (totalLen > XXH3_MIDSIZE_MAX) {
+        XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
+        XXH3_prefix_digest_long(acc, prefix, (const xxh_u8*)suffix, length, secret);
+        return XXH3_mergeAccs(acc,
+                              secret + XXH_SECRET_MERGEACCS_START,
+                              (xxh_u64)totalLen * XXH_PRIME64_1);
+    }
+    {   xxh_u8 buffer[XXH3_MIDSIZE_MAX];
+        size_t const len = XXH3_prefix_join(buffer, prefix, suffix, length);
+        if (prefix->useSeed)
+            return XXH3_64bits_withSeed(buffer, len, prefix->seed);
+        return XXH3_64bits_withSecret(buffer, len, secret, prefix->secretLimit + XXH_STRIPE_LEN);
     }
-    XXH_memcpy(dst, &hash.high64, sizeof(hash.high64));
-    XXH_memcpy((char*)dst + sizeof(hash.high64), &hash.low64, sizeof(hash.low64));
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API XXH128_hash_t
-XXH128_hashFromCanonical(XXH_NOESCAPE const XXH128_canonical_t* src)
+XXH3_128bits_withPrefix(XXH_NOESCAPE const XXH3_prefix_t* prefix,
+                        XXH_NOESCAPE const void* suffix, size_t length)
 {
-    XXH128_hash_t h;
-    h.high64 = XXH_readBE64(src);
-    h.low64  = XXH_readBE64(src->digest + 8);
-    return h;
+    const unsigned char* const secret = XXH3_prefix_secret(prefix);
+    XXH64_hash_t const totalLen = prefix->totalLen + length;
+    if (totalLen > XXH3_MIDSIZE_MAX) {
+        XXH_ALIGN(XXH_ACC_ALIGN) XXH64_hash_t acc[XXH_ACC_NB];
+        XXH128_hash_t h128;
+        XXH3_prefix_digest_long(acc, prefix, (const xxh_u8*)suffix, length, secret);
+        h128.low64  = XXH3_mergeAccs(acc,
+                                     secret + XXH_SECRET_MERGEACCS_START,
+                                     (xxh_u64)totalLen * XXH_PRIME64_1);
+        h128.high64 = XXH3_mergeAccs(acc,
+                                     secret + prefix->secretLimit + XXH_STRIPE_LEN
+                                            - sizeof(acc) - XXH_SECRET_MERGEACCS_START,
+                                     ~((xxh_u64)totalLen * XXH_PRIME64_2));
+        return h128;
+    }
+    {   xxh_u8 buffer[XXH3_MIDSIZE_MAX];
+        size_t const len = XXH3_prefix_join(buffer, prefix, suffix, length);
+        if (prefix->useSeed)
+            return XXH3_128bits_withSeed(buffer, len, prefix->seed);
+        return XXH3_128bits_withSecret(buffer, len, secret, prefix->secretLimit + XXH_STRIPE_LEN);
+    }
 }
+#endif /* !XXH_NO_STREAM */
 
 
+/* ===   XXH3 dual width   === */
 
-/* ==========================================
- * Secret generators
- * ==========================================
+/*
+ * Beyond XXH3_MIDSIZE_MAX, the 64-bit hash merges the accumulators
+ * exactly like the low half of the 128-bit hash: it is reused.
  */
-#define XXH_MIN(x, y) (((x) > (y)) ? (y) : (x))
 
-XXH_FORCE_INLINE void XXH3_combine16(void* dst, XXH128_hash_t h128)
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_dual_withSeed(XXH_NOESCAPE const void* input, size_t length, XXH64_hash_t seed,
+                   XXH_NOESCAPE XXH64_hash_t* h64, XXH_NOESCAPE XXH128_hash_t* h128)
 {
-    XXH_writeLE64( dst, XXH_readLE64(dst) ^ h128.low64 );
-    XXH_writeLE64( (char*)dst+8, XXH_readLE64((char*)dst+8) ^ h128.high64 );
+    XXH128_hash_t const result = XXH3_128bits_withSeed(input, length, seed);
+    XXH_ASSERT(h64 != NULL && h128 != NULL);
+    *h64 = (length > XXH3_MIDSIZE_MAX) ? result.low64
+                                        : XXH3_64bits_withSeed(input, length, seed);
+    *h128 = result;
 }
 
 /*! @ingroup XXH3_family */
-XXH_PUBLIC_API XXH_errorcode
-XXH3_generateSecret(XXH_NOESCAPE void* secretBuffer, size_t secretSize, XXH_NOESCAPE const void* customSeed, size_t customSeedSize)
+XXH_PUBLIC_API void
+XXH3_dual(XXH_NOESCAPE const void* input, size_t length,
+          XXH_NOESCAPE XXH64_hash_t* h64, XXH_NOESCAPE XXH128_hash_t* h128)
 {
-#if (XXH_DEBUGLEVEL >= 1)
-    XXH_ASSERT(secretBuffer != NULL);
-    XXH_ASSERT(secretSize >= XXH3_SECRET_SIZE_MIN);
-#else
-    /* production mode, assert() are disabled */
-    if (secretBuffer == NULL) return XXH_ERROR;
-    if (secretSize < XXH3_SECRET_SIZE_MIN) return XXH_ERROR;
-#endif
+    XXH3_dual_withSeed(input, length, 0, h64, h128);
+}
 
-    if (customSeedSize == 0) {
-        customSeed = XXH3_kSecret;
-        customSeedSize = XXH_SECRET_DEFAULT_SIZE;
-    }
-#if (XXH_DEBUGLEVEL >= 1)
-    XXH_ASSERT(customSeed != NULL);
-#else
-    if (customSeed == NULL) return XXH_ERROR;
-#endif
+#ifndef XXH_NO_STREAM
+/*! @ingroup XXH3_family */
+XXH_PUBLIC_API void
+XXH3_dual_digest(XXH_NOESCAPE const XXH3_state_t* statePtr,
+                 XXH_NOESCAPE XXH64_hash_t* h64, XXH_NOESCAPE XXH128_hash_t* h128)
+{
+    XXH128_hash_t const result = XXH3_128bits_digest(statePtr);
+    XXH_ASSERT(h64 != NULL && h128 != NULL);
+    *h64 = (statePtr->totalLen > XXH3_MIDSIZE_MAX) ? result.low64
+                                                    : XXH3_64bits_digest(statePtr);
+    *h128 = result;
+}
+#endif /* !XXH_NO_STREAM */
 
-    /* Fill secretBuffer with a copy of customSeed - repeat as needed */
-    {   size_t pos = 0;
-        while (pos < secretSize) {
-            size_t const toCopy = XXH_MIN((secretSize - pos), customSeedSize);
-            memcpy((char*)secretBuffer + pos, customSeed, toCopy);
-            pos += toCopy;
-    }   }
 
-    {   size_t const nbSeg16 = secretSize / 16;
-        size_t n;
-        XXH128_canonical_t scrambler;
-        XXH128_canonicalFromHash(&scrambler, XXH128(customSeed, customSeedSize, 0));
-        for (n=0; n<nbSeg16; n++) {
-            XXH128_hash_t const h128 = XXH128(&scrambler, sizeof(scrambler), n);
-            XXH3_combine16((char*)secretBuffer + n*16, h128);
+/* ===   XXH3 multiple seeds   === */
+
+/*
+ * Lock-step variant of XXH3_hashLong_internal_loop(), for one input
+ * and up to XXH3_MULTI_MAX secrets of XXH_SECRET_DEFAULT_SIZE bytes.
+ * Each accumulator ends up exactly as if it was processed alone.
+ *
+ * Same idea as XXH3_hashLong_multi(), except that all accumulators share
+ * each stripe of input.
+ * @p nbSeeds is a compile-time constant after inlining.
+ */
+XXH_FORCE_INLINE void
+XXH3_hashLong_multiSeed(xxh_u64 (*XXH_RESTRICT accs)[XXH_ACC_NB],
+                        const xxh_u8 (*XXH_RESTRICT secrets)[XXH_SECRET_DEFAULT_SIZE],
+                        size_t nbSeeds,
+                        const xxh_u8* XXH_RESTRICT input, size_t len)
+{
+    size_t const secretSize = XXH_SECRET_DEFAULT_SIZE;
+    size_t const nbStripesPerBlock = XXH3_NB_STRIPES_PER_BLOCK(secretSize);
+    size_t s, n;
+
+    XXH_ASSERT(nbSeeds <= XXH3_MULTI_MAX);
+    XXH_ASSERT(len > XXH3_MIDSIZE_MAX);
+    /* all stripes except the last one, which may overlap */
+    for (n = 0; n < (len - 1) / XXH_STRIPE_LEN; n++) {
+        const xxh_u8* const in = input + n * XXH_STRIPE_LEN;
+        size_t const secretOffset = (n % nbStripesPerBlock) * XXH_SECRET_CONSUME_RATE;
+        XXH_PREFETCH_INPUT(in + XXH_PREFETCH_DIST);
+        for (s = 0; s < nbSeeds; s++)
+            XXH3_accumulate_512(accs[s], in, secrets[s] + secretOffset);
+        if ((n + 1) % nbStripesPerBlock == 0) {
+            for (s = 0; s < nbSeeds; s++)
+                XXH3_scrambleAcc(accs[s], secrets[s] + secretSize - XXH_STRIPE_LEN);
         }
-        /* last segment */
-        XXH3_combine16((char*)secretBuffer + secretSize - 16, XXH128_hashFromCanonical(&scrambler));
     }
-    return XXH_OK;
+    /* last stripe */
+    for (s = 0; s < nbSeeds; s++)
+        XXH3_accumulate_512(accs[s], input + len - XXH_STRIPE_LEN,
+                            secrets[s] + secretSize - XXH_STRIPE_LEN - XXH_SECRET_LASTACC_START);
+}
+
+/*
+ * Hashes a long input with a group of up to XXH3_MULTI_MAX seeds,
+ * as XXH3_hashLong_64b_withSeed() does for each one.
+ * A seed of 0 derives the default secret, so it needs no special case.
+ *
+ * When XXH3_MULTI_LOCKSTEP is disabled, each seed runs the regular loop:
+ * its accumulators must stay in registers, which sharing stripes,
+ * even block by block, prevents (-15% to -30% with AVX2).
+ * Otherwise, each group size gets its own instance,
+ * so that XXH3_hashLong_multiSeed() is unrolled.
+ */
+XXH_NO_INLINE void
+XXH3_hashLong_64b_multiSeed(const xxh_u8* XXH_RESTRICT input, size_t len,
+                            const XXH64_hash_t* seeds, size_t nbSeeds,
+                            XXH64_hash_t* out)
+{
+    static const xxh_u64 initAcc[XXH_ACC_NB] = XXH3_INIT_ACC;
+    XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secrets[XXH3_MULTI_MAX][XXH_SECRET_DEFAULT_SIZE];
+    XXH_ALIGN(XXH_ACC_ALIGN) xxh_u64 accs[XXH3_MULTI_MAX][XXH_ACC_NB];
+    const xxh_u8 (*const constSecrets)[XXH_SECRET_DEFAULT_SIZE] = (const xxh_u8 (*)[XXH_SECRET_DEFAULT_SIZE])secrets;
+    size_t s;
+
+    XXH_ASSERT(1 <= nbSeeds && nbSeeds <= XXH3_MULTI_MAX);
+    for (s = 0; s < nbSeeds; s++)
+        XXH3_initCustomSecret(secrets[s], seeds[s]);
+    if (!XXH3_MULTI_LOCKSTEP) {
+        for (s = 0; s < nbSeeds; s++)
+            out[s] = XXH3_hashLong_64b_internal(input, len, secrets[s], sizeof(secrets[s]), XXH_PREFETCH_DIST,
+                                                XXH3_accumulate, XXH3_scrambleAcc);
+        return;
+    }
+
+    for (s = 0; s < nbSeeds; s++)
+        XXH_memcpy(accs[s], initAcc, sizeof(initAcc));
+    switch (nbSeeds) {
+    case 4: XXH3_hashLong_multiSeed(accs, constSecrets, 4, input, len); break;
+    case 3: XXH3_hashLong_multiSeed(accs, constSecrets, 3, input, len); break;
+    case 2: XXH3_hashLong_multiSeed(accs, constSecrets, 2, input, len); break;
+    default: XXH3_hashLong_multiSeed(accs, constSecrets, 1, input, len); break;
+    }
+    for (s = 0; s < nbSeeds; s++)
+        out[s] = XXH3_mergeAccs(accs[s], secrets[s] + XXH_SECRET_MERGEACCS_START,
+                                (xxh_u64)len * XXH_PRIME64_1);
 }
 
 /*! @ingroup XXH3_family */
 XXH_PUBLIC_API void
-XXH3_generateSecret_fromSeed(XXH_NOESCAPE void* secretBuffer, XXH64_hash_t seed)
-{
-    XXH_ALIGN(XXH_SEC_ALIGN) xxh_u8 secret[XXH_SECRET_DEFAULT_SIZE];
-    XXH3_initCustomSecret(secret, seed);
-    XXH_ASSERT(secretBuffer != NULL);
-    memcpy(secretBuffer, secret, XXH_SECRET_DEFAULT_SIZE);
+XXH3_64bits_multiSeed(XXH_NOESCAPE const void* input, size_t length,
+                      XXH_NOESCAPE const XXH64_hash_t* seeds, size_t nbSeeds,
+                      XXH_NOESCAPE XXH64_hash_t* out)
+{
+    size_t s;
+    XXH_ASSERT(nbSeeds == 0 || (seeds != NULL && out != NULL));
+    if (length <= XXH3_MIDSIZE_MAX) {
+        for (s = 0; s < nbSeeds; s++)
+            out[s] = XXH3_64bits_withSeed(input, length, seeds[s]);
+        return;
+    }
+    for (s = 0; s < nbSeeds; s += XXH3_MULTI_MAX)
+        XXH3_hashLong_64b_multiSeed((const xxh_u8*)input, length,
+                                    seeds + s, XXH_MIN(nbSeeds - s, XXH3_MULTI_MAX),
+                                    out + s);
 }
 
 